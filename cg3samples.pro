@@ -17,6 +17,7 @@ FINAL_RELEASE {
 
 TEMPLATE = app
 CONFIG += c++11
+CONFIG += thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
@@ -38,6 +39,57 @@ CONFIG += SAMPLES
 
 DEFINES += "CG3_SAMPLES_HOME='$$_PRO_FILE_PWD_'"
 
+#extensions of the cg3lib data structures and algorithms
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    extensions/utilities/parallel.h \
+    extensions/utilities/parallel.tpp \
+    extensions/data_structures/trees/static_aabbtree.h \
+    extensions/data_structures/trees/static_aabbtree.tpp \
+    extensions/data_structures/graphs/compiled_graph.h \
+    extensions/data_structures/graphs/compiled_graph.tpp \
+    extensions/data_structures/graphs/indexed_graph.h \
+    extensions/data_structures/graphs/indexed_graph.tpp \
+    extensions/data_structures/graphs/indexed_bipartite_graph.h \
+    extensions/data_structures/graphs/indexed_bipartite_graph.tpp \
+    extensions/data_structures/graphs/edge_weights.h \
+    extensions/data_structures/graphs/edge_weights.tpp \
+    extensions/data_structures/graphs/binary_graph.h \
+    extensions/data_structures/graphs/binary_graph.tpp \
+    extensions/data_structures/graphs/distance_matrix.h \
+    extensions/data_structures/graphs/distance_matrix.tpp \
+    extensions/data_structures/queues/dijkstra_queues.h \
+    extensions/data_structures/queues/dijkstra_queues.tpp \
+    extensions/algorithms/compiled_graph_algorithms.h \
+    extensions/algorithms/compiled_graph_algorithms.tpp \
+    extensions/algorithms/graph_traversal.h \
+    extensions/algorithms/graph_traversal.tpp \
+    extensions/algorithms/minimum_spanning_tree.h \
+    extensions/algorithms/minimum_spanning_tree.tpp \
+    extensions/algorithms/dynamic_shortest_paths.h \
+    extensions/algorithms/dynamic_shortest_paths.tpp \
+    extensions/algorithms/graph_reordering.h \
+    extensions/algorithms/graph_reordering.tpp \
+    extensions/algorithms/max_flow.h \
+    extensions/algorithms/max_flow.tpp \
+    extensions/algorithms/bipartite_matching.h \
+    extensions/algorithms/bipartite_matching.tpp \
+    extensions/algorithms/bipartite_assignment.h \
+    extensions/algorithms/bipartite_assignment.tpp \
+    extensions/algorithms/bipartite_projection.h \
+    extensions/algorithms/bipartite_projection.tpp \
+    extensions/io/edge_list.h \
+    extensions/io/edge_list.tpp
+
+CG3_MESHES {
+    HEADERS += \
+        extensions/meshes/dcel/dcel_aabbtree.h
+
+    SOURCES += \
+        extensions/meshes/dcel/dcel_aabbtree.cpp
+}
+
 TESTS {
     DEFINES += TESTS
 
@@ -51,6 +103,8 @@ TESTS {
     DEFINES += CHTEST
     #uncomment if you want to run convex hull tests
     DEFINES += GRAPHTEST
+    #uncomment if you want to run bipartite graph tests
+    DEFINES += BIPARTITEGRAPHTEST
 
 
 
@@ -59,7 +113,9 @@ TESTS {
         tests/rttest.cpp \
         tests/aabbtest.cpp \
         tests/chtest.cpp \
-        tests/graphtest.cpp
+        tests/graphtest.cpp \
+        tests/bipartitegraphtest.cpp \
+        tests/testdata.cpp
 
 
     HEADERS += \
@@ -67,7 +123,9 @@ TESTS {
         tests/rttest.h \
         tests/aabbtest.h \
         tests/chtest.h \
-        tests/graphtest.h
+        tests/graphtest.h \
+        tests/bipartitegraphtest.h \
+        tests/testdata.h
 }
 SAMPLES {
     DEFINES += SAMPLES
@@ -0,0 +1,49 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_BIPARTITE_ASSIGNMENT_H
+#define CG3_BIPARTITE_ASSIGNMENT_H
+
+#include <vector>
+
+#include "extensions/data_structures/graphs/indexed_bipartite_graph.h"
+
+namespace cg3 {
+
+/* Algorithms */
+
+enum AssignmentAlgorithm {
+    JONKER_VOLGENANT, //Shortest augmenting paths on the dense cost matrix
+    AUCTION //Auction on the arcs, with epsilon scaling
+};
+
+
+/* Minimum cost assignment */
+
+template <class T1, class T2>
+double jonkerVolgenant(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches);
+
+template <class T1, class T2>
+double auctionAssignment(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads = 0);
+
+template <class T1, class T2>
+double minimumCostAssignment(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        AssignmentAlgorithm algorithm = JONKER_VOLGENANT,
+        unsigned int nThreads = 0);
+
+}
+
+#include "bipartite_assignment.tpp"
+
+#endif // CG3_BIPARTITE_ASSIGNMENT_H
@@ -0,0 +1,570 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "bipartite_assignment.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "bipartite_matching.h"
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Number of bidders assigned to a thread at a time */
+static const size_t AUCTION_CHUNK_SIZE = 256;
+
+/* Factor by which epsilon is reduced at each phase of the auction */
+static const double AUCTION_EPSILON_FACTOR = 5;
+
+template <class T1, class T2>
+bool hasCompleteAssignment(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads);
+
+inline bool augmentShortestPath(
+        const std::vector<double>& costs,
+        size_t row,
+        std::vector<double>& leftPotentials,
+        std::vector<double>& rightPotentials,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<double>& distances,
+        std::vector<size_t>& predecessors,
+        std::vector<bool>& scanned,
+        std::vector<size_t>& scannedColumns);
+
+template <class T1, class T2>
+void auctionBid(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        size_t u,
+        const std::vector<double>& prices,
+        double range,
+        double epsilon,
+        size_t& object,
+        double& bid);
+
+template <class T1, class T2>
+void gaussSeidelAuction(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<double>& prices,
+        double range,
+        double epsilon);
+
+template <class T1, class T2>
+void jacobiAuction(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<double>& prices,
+        double range,
+        double epsilon,
+        unsigned int nThreads);
+
+template <class T1, class T2>
+double assignmentCost(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        const std::vector<size_t>& leftMatches);
+
+}
+
+
+/* ----- MINIMUM COST ASSIGNMENT ----- */
+
+/**
+ * @brief Minimum cost assignment with the shortest augmenting path method
+ * of Jonker and Volgenant, in O(L^2 R) for L left nodes and R right
+ * nodes. The arcs are copied in a dense L x R cost matrix (the missing
+ * arcs have infinite cost), so it is meant for dense graphs. The
+ * potentials are initialized by reducing the rows, and each left node
+ * which is not assigned to the minimum of its row is assigned along a
+ * shortest augmenting path in the reduced costs (Dijkstra on the dense
+ * rows), updating the potentials.
+ * Each left node is assigned to a different right node, so the graph
+ * must have at most as many left nodes as right nodes (deleted nodes are
+ * not assigned).
+ * @param[in] graph Input graph, the weights of the arcs are the costs
+ * @param[out] leftMatches Right node assigned to each left node
+ * @param[out] rightMatches Left node assigned to each right node
+ * (NOT_FOUND for the right nodes which are not assigned)
+ * @return Total cost of the assignment, MAX_WEIGHT if there is no
+ * assignment of all the left nodes (the matches are all NOT_FOUND)
+ */
+template <class T1, class T2>
+double jonkerVolgenant(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches)
+{
+    typedef typename IndexedBipartiteGraph<T1, T2>::AdjacentRange AdjacentRange;
+    typedef typename IndexedBipartiteGraph<T1, T2>::WeightRange WeightRange;
+
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+    const size_t nLeft = graph.leftIdBound();
+    const size_t nRight = graph.rightIdBound();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    if (!internal::hasCompleteAssignment(graph, leftMatches, rightMatches, 1))
+        return IndexedBipartiteGraph<T1, T2>::MAX_WEIGHT;
+
+    //Dense cost matrix
+    std::vector<double> costs(nLeft * nRight, infinity);
+    for (size_t u = 0; u < nLeft; u++) {
+        AdjacentRange adjacent = graph.adjacentRightNodes(u);
+        const double* weight = graph.adjacentRightWeights(u).begin();
+        for (size_t v : adjacent)
+            costs[u * nRight + v] = *weight++;
+    }
+
+    //Reduction of the rows: the minimum of each row is assigned if its
+    //column is free
+    std::vector<double> leftPotentials(nLeft);
+    std::vector<double> rightPotentials(nRight, 0);
+    leftMatches.assign(nLeft, notFound);
+    rightMatches.assign(nRight, notFound);
+
+    for (size_t u = 0; u < nLeft; u++) {
+        if (!graph.isValidLeft(u))
+            continue;
+
+        AdjacentRange adjacent = graph.adjacentRightNodes(u);
+        WeightRange weights = graph.adjacentRightWeights(u);
+
+        size_t k = std::min_element(weights.begin(), weights.end()) - weights.begin();
+        size_t v = adjacent.begin()[k];
+
+        leftPotentials[u] = weights.begin()[k];
+        if (rightMatches[v] == notFound) {
+            leftMatches[u] = v;
+            rightMatches[v] = u;
+        }
+    }
+
+    //Shortest augmenting paths from the other left nodes
+    std::vector<double> distances(nRight);
+    std::vector<size_t> predecessors(nRight);
+    std::vector<bool> scanned(nRight);
+    std::vector<size_t> scannedColumns;
+
+    for (size_t u = 0; u < nLeft; u++) {
+        if (leftMatches[u] == notFound && graph.isValidLeft(u)) {
+            internal::augmentShortestPath(
+                        costs, u, leftPotentials, rightPotentials,
+                        leftMatches, rightMatches,
+                        distances, predecessors, scanned, scannedColumns);
+        }
+    }
+
+    return internal::assignmentCost(graph, leftMatches);
+}
+
+/**
+ * @brief Minimum cost assignment with the auction algorithm of Bertsekas,
+ * which visits only the arcs, so it is meant for sparse graphs. Each
+ * unassigned left node bids for the right node with the best value
+ * (cost plus price), raising its price by the difference with the second
+ * best value plus epsilon; the previous owner of the right node becomes
+ * unassigned. Epsilon is scaled down at each phase, and the last phase
+ * uses 1 / (L + 1), so the assignment is optimal when the costs are
+ * integers (with real costs, its cost is within L epsilon of the
+ * optimum). When there are more right nodes than left nodes the prices
+ * of the unassigned right nodes must stay equal, so a single phase is
+ * run with the final epsilon.
+ * With one thread, the bids are placed one at a time (Gauss-Seidel);
+ * with more threads, all the unassigned left nodes bid in parallel with
+ * the same prices and each right node takes its best bid (Jacobi).
+ * @param[in] graph Input graph, the weights of the arcs are the costs
+ * @param[out] leftMatches Right node assigned to each left node
+ * @param[out] rightMatches Left node assigned to each right node
+ * (NOT_FOUND for the right nodes which are not assigned)
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Total cost of the assignment, MAX_WEIGHT if there is no
+ * assignment of all the left nodes (the matches are all NOT_FOUND)
+ */
+template <class T1, class T2>
+double auctionAssignment(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+    const size_t nLeft = graph.leftIdBound();
+    const size_t nRight = graph.rightIdBound();
+
+    nThreads = numberOfThreads(nThreads);
+
+    if (!internal::hasCompleteAssignment(graph, leftMatches, rightMatches, nThreads))
+        return IndexedBipartiteGraph<T1, T2>::MAX_WEIGHT;
+
+    double minWeight = std::numeric_limits<double>::infinity();
+    double maxWeight = -minWeight;
+    for (size_t u = 0; u < nLeft; u++) {
+        for (double weight : graph.adjacentRightWeights(u)) {
+            minWeight = std::min(minWeight, weight);
+            maxWeight = std::max(maxWeight, weight);
+        }
+    }
+    const double range = graph.numLeftNodes() > 0 ? maxWeight - minWeight : 0;
+
+    const double finalEpsilon = 1.0 / (graph.numLeftNodes() + 1);
+    double epsilon = finalEpsilon;
+    if (graph.numLeftNodes() == graph.numRightNodes())
+        epsilon = std::max(range / internal::AUCTION_EPSILON_FACTOR, finalEpsilon);
+
+    std::vector<double> prices(nRight, 0);
+
+    while (true) {
+        leftMatches.assign(nLeft, notFound);
+        rightMatches.assign(nRight, notFound);
+
+        if (nThreads > 1)
+            internal::jacobiAuction(graph, leftMatches, rightMatches, prices, range, epsilon, nThreads);
+        else
+            internal::gaussSeidelAuction(graph, leftMatches, rightMatches, prices, range, epsilon);
+
+        if (epsilon <= finalEpsilon)
+            break;
+
+        epsilon = std::max(epsilon / internal::AUCTION_EPSILON_FACTOR, finalEpsilon);
+    }
+
+    return internal::assignmentCost(graph, leftMatches);
+}
+
+/**
+ * @brief Minimum cost assignment of the left nodes to distinct right
+ * nodes (see jonkerVolgenant and auctionAssignment)
+ * @param[in] graph Input graph, the weights of the arcs are the costs
+ * @param[out] leftMatches Right node assigned to each left node
+ * @param[out] rightMatches Left node assigned to each right node
+ * (NOT_FOUND for the right nodes which are not assigned)
+ * @param[in] algorithm Algorithm to be used
+ * @param[in] nThreads Number of threads of the auction, 0 for the number
+ * of hardware threads
+ * @return Total cost of the assignment, MAX_WEIGHT if there is no
+ * assignment of all the left nodes (the matches are all NOT_FOUND)
+ */
+template <class T1, class T2>
+double minimumCostAssignment(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        AssignmentAlgorithm algorithm,
+        unsigned int nThreads)
+{
+    if (algorithm == AUCTION)
+        return auctionAssignment(graph, leftMatches, rightMatches, nThreads);
+
+    return jonkerVolgenant(graph, leftMatches, rightMatches);
+}
+
+
+namespace internal {
+
+/**
+ * @brief Check if all the left nodes can be assigned, with a maximum
+ * cardinality matching. It also builds the graph, which is then read
+ * by more than one thread.
+ * @param[out] leftMatches Set to NOT_FOUND if there is no assignment
+ * @param[out] rightMatches Set to NOT_FOUND if there is no assignment
+ * @return True if there is a matching of all the left nodes
+ */
+template <class T1, class T2>
+bool hasCompleteAssignment(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+
+    if (graph.numLeftNodes() <= graph.numRightNodes() &&
+            maximumMatching(graph, leftMatches, rightMatches, nThreads) == graph.numLeftNodes())
+        return true;
+
+    leftMatches.assign(graph.leftIdBound(), notFound);
+    rightMatches.assign(graph.rightIdBound(), notFound);
+
+    return false;
+}
+
+/**
+ * @brief Assign a left node along a shortest augmenting path in the
+ * reduced costs (cost - left potential - right potential, which are
+ * non negative), and update the potentials so that the reduced costs of
+ * the assigned pairs stay 0
+ * @param[in] costs Dense cost matrix, a row for each left node
+ * @param[in] row Left node to be assigned
+ * @param[out] distances Tentative distance of each right node
+ * @param[out] predecessors Right node from whose left node each right
+ * node has been reached (NOT_FOUND if reached from row)
+ * @param[out] scanned Right nodes whose distance is final
+ * @param[out] scannedColumns List of the scanned right nodes
+ * @return False if there is no augmenting path
+ */
+inline bool augmentShortestPath(
+        const std::vector<double>& costs,
+        size_t row,
+        std::vector<double>& leftPotentials,
+        std::vector<double>& rightPotentials,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<double>& distances,
+        std::vector<size_t>& predecessors,
+        std::vector<bool>& scanned,
+        std::vector<size_t>& scannedColumns)
+{
+    const size_t notFound = std::numeric_limits<size_t>::max();
+    const size_t nRight = rightPotentials.size();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    distances.assign(nRight, infinity);
+    predecessors.assign(nRight, notFound);
+    scanned.assign(nRight, false);
+    scannedColumns.clear();
+
+    size_t u = row;
+    size_t from = notFound;
+    size_t last;
+    while (true) {
+        const double* rowCosts = costs.data() + u * nRight;
+
+        double delta = infinity;
+        last = notFound;
+        for (size_t v = 0; v < nRight; v++) {
+            if (!scanned[v]) {
+                double reduced = rowCosts[v] - leftPotentials[u] - rightPotentials[v];
+                if (reduced < distances[v]) {
+                    distances[v] = reduced;
+                    predecessors[v] = from;
+                }
+                if (distances[v] < delta) {
+                    delta = distances[v];
+                    last = v;
+                }
+            }
+        }
+
+        if (last == notFound)
+            return false;
+
+        //The potentials are updated so that the distances are relative to
+        //the right node which is scanned
+        leftPotentials[row] += delta;
+        for (size_t v : scannedColumns) {
+            leftPotentials[rightMatches[v]] += delta;
+            rightPotentials[v] -= delta;
+        }
+        for (size_t v = 0; v < nRight; v++) {
+            if (!scanned[v])
+                distances[v] -= delta;
+        }
+
+        scanned[last] = true;
+        scannedColumns.push_back(last);
+
+        if (rightMatches[last] == notFound)
+            break;
+
+        u = rightMatches[last];
+        from = last;
+    }
+
+    //Augmentation along the predecessors
+    for (size_t v = last; v != notFound; ) {
+        size_t previous = predecessors[v];
+        size_t w = previous == notFound ? row : rightMatches[previous];
+        rightMatches[v] = w;
+        leftMatches[w] = v;
+        v = previous;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Bid of a left node: the right node with the minimum cost plus
+ * price, and its new price
+ * @param[in] range Difference between the maximum and the minimum cost,
+ * used as second best value when the node has a single arc
+ * @param[out] object Right node of the bid
+ * @param[out] bid New price of the right node
+ */
+template <class T1, class T2>
+void auctionBid(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        size_t u,
+        const std::vector<double>& prices,
+        double range,
+        double epsilon,
+        size_t& object,
+        double& bid)
+{
+    typedef typename IndexedBipartiteGraph<T1, T2>::AdjacentRange AdjacentRange;
+
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    AdjacentRange adjacent = graph.adjacentRightNodes(u);
+    const double* weight = graph.adjacentRightWeights(u).begin();
+
+    double best = infinity;
+    double second = infinity;
+    for (size_t v : adjacent) {
+        double value = *weight++ + prices[v];
+        if (value < best) {
+            second = best;
+            best = value;
+            object = v;
+        }
+        else if (value < second) {
+            second = value;
+        }
+    }
+
+    if (second == infinity)
+        second = best + range + 1;
+
+    bid = prices[object] + second - best + epsilon;
+}
+
+/**
+ * @brief Phase of the auction with the bids placed one at a time
+ */
+template <class T1, class T2>
+void gaussSeidelAuction(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<double>& prices,
+        double range,
+        double epsilon)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+
+    std::vector<size_t> unassigned;
+    for (size_t u = leftMatches.size(); u > 0; u--) {
+        if (graph.isValidLeft(u - 1))
+            unassigned.push_back(u - 1);
+    }
+
+    while (!unassigned.empty()) {
+        size_t u = unassigned.back();
+        unassigned.pop_back();
+
+        size_t v;
+        double bid;
+        auctionBid(graph, u, prices, range, epsilon, v, bid);
+
+        if (rightMatches[v] != notFound) {
+            leftMatches[rightMatches[v]] = notFound;
+            unassigned.push_back(rightMatches[v]);
+        }
+
+        leftMatches[u] = v;
+        rightMatches[v] = u;
+        prices[v] = bid;
+    }
+}
+
+/**
+ * @brief Phase of the auction with the bids of all the unassigned left
+ * nodes computed in parallel, then assigned to the best bidder of each
+ * right node
+ */
+template <class T1, class T2>
+void jacobiAuction(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<double>& prices,
+        double range,
+        double epsilon,
+        unsigned int nThreads)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+    const size_t nLeft = leftMatches.size();
+
+    std::vector<size_t> unassigned;
+    for (size_t u = 0; u < nLeft; u++) {
+        if (graph.isValidLeft(u))
+            unassigned.push_back(u);
+    }
+
+    std::vector<size_t> objects(nLeft);
+    std::vector<double> bids(nLeft);
+    std::vector<size_t> winners(rightMatches.size(), notFound);
+    std::vector<size_t> touched;
+    std::vector<size_t> next;
+
+    while (!unassigned.empty()) {
+        parallelForChunks(unassigned.size(), AUCTION_CHUNK_SIZE, [&] (unsigned int, size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                size_t u = unassigned[i];
+                auctionBid(graph, u, prices, range, epsilon, objects[u], bids[u]);
+            }
+        }, nThreads);
+
+        //Best bid of each right node (the first one on ties)
+        touched.clear();
+        for (size_t u : unassigned) {
+            size_t v = objects[u];
+            if (winners[v] == notFound) {
+                winners[v] = u;
+                touched.push_back(v);
+            }
+            else if (bids[u] > bids[winners[v]]) {
+                winners[v] = u;
+            }
+        }
+
+        next.clear();
+        for (size_t u : unassigned) {
+            if (winners[objects[u]] != u)
+                next.push_back(u);
+        }
+
+        for (size_t v : touched) {
+            size_t u = winners[v];
+            if (rightMatches[v] != notFound) {
+                leftMatches[rightMatches[v]] = notFound;
+                next.push_back(rightMatches[v]);
+            }
+
+            leftMatches[u] = v;
+            rightMatches[v] = u;
+            prices[v] = bids[u];
+            winners[v] = notFound;
+        }
+
+        unassigned.swap(next);
+    }
+}
+
+/**
+ * @brief Sum of the weights of the arcs of an assignment
+ */
+template <class T1, class T2>
+double assignmentCost(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        const std::vector<size_t>& leftMatches)
+{
+    double cost = 0;
+    for (size_t u = 0; u < leftMatches.size(); u++) {
+        if (graph.isValidLeft(u))
+            cost += graph.getWeight(u, leftMatches[u]);
+    }
+
+    return cost;
+}
+
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_BIPARTITE_MATCHING_H
+#define CG3_BIPARTITE_MATCHING_H
+
+#include <vector>
+#include <utility>
+
+#include <cg3/data_structures/graphs/bipartite_graph.h>
+
+#include "extensions/data_structures/graphs/indexed_bipartite_graph.h"
+
+namespace cg3 {
+
+/* Maximal matching */
+
+template <class T1, class T2>
+size_t greedyMatching(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches);
+
+
+/* Maximum matching */
+
+template <class T1, class T2>
+size_t hopcroftKarp(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads = 0);
+
+template <class T1, class T2>
+size_t maximumMatching(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads = 0);
+
+template <class T1, class T2>
+std::vector<std::pair<T1, T2>> maximumMatching(
+        const BipartiteGraph<T1, T2>& graph,
+        unsigned int nThreads = 0);
+
+}
+
+#include "bipartite_matching.tpp"
+
+#endif // CG3_BIPARTITE_MATCHING_H
@@ -0,0 +1,408 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "bipartite_matching.h"
+
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Number of frontier nodes assigned to a thread at a time */
+static const size_t MATCHING_CHUNK_SIZE = 1024;
+
+/* Minimum size of a frontier which is visited in parallel */
+static const size_t MATCHING_PARALLEL_FRONTIER = 4096;
+
+template <class T1, class T2>
+size_t matchingLayers(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        const std::vector<size_t>& leftMatches,
+        const std::vector<size_t>& rightMatches,
+        std::vector<size_t>& layers,
+        std::vector<std::atomic<bool>>& claimed,
+        unsigned int nThreads);
+
+template <class T1, class T2>
+size_t augmentLayers(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<size_t>& layers,
+        size_t lastLayer,
+        std::vector<size_t>& arcs,
+        std::vector<size_t>& stack);
+
+template <class T1, class T2>
+void augmentPath(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        const std::vector<size_t>& arcs,
+        const std::vector<size_t>& stack);
+
+}
+
+
+/* ----- MAXIMAL MATCHING ----- */
+
+/**
+ * @brief Greedy maximal matching, used as warm start of Hopcroft-Karp:
+ * the left nodes are visited by increasing degree, and each one is matched
+ * to its free neighbor of minimum degree. The nodes with few choices are
+ * matched first, so the matching is usually close to the maximum one.
+ * @param[in] graph Input graph
+ * @param[out] leftMatches Right node matched to each left node (NOT_FOUND
+ * for the free nodes)
+ * @param[out] rightMatches Left node matched to each right node (NOT_FOUND
+ * for the free nodes)
+ * @return Number of pairs of the matching
+ */
+template <class T1, class T2>
+size_t greedyMatching(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches)
+{
+    typedef typename IndexedBipartiteGraph<T1, T2>::AdjacentRange AdjacentRange;
+
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+    const size_t nLeft = graph.leftIdBound();
+
+    leftMatches.assign(nLeft, notFound);
+    rightMatches.assign(graph.rightIdBound(), notFound);
+
+    //Left nodes sorted by degree (counting sort)
+    size_t maxDegree = 0;
+    for (size_t u = 0; u < nLeft; u++)
+        maxDegree = std::max(maxDegree, graph.leftDegree(u));
+
+    std::vector<size_t> degreeOffsets(maxDegree + 2, 0);
+    for (size_t u = 0; u < nLeft; u++)
+        degreeOffsets[graph.leftDegree(u) + 1]++;
+    std::partial_sum(degreeOffsets.begin(), degreeOffsets.end(), degreeOffsets.begin());
+
+    std::vector<size_t> order(nLeft);
+    for (size_t u = 0; u < nLeft; u++)
+        order[degreeOffsets[graph.leftDegree(u)]++] = u;
+
+    size_t size = 0;
+    for (size_t u : order) {
+        AdjacentRange adjacent = graph.adjacentRightNodes(u);
+
+        size_t best = notFound;
+        size_t bestDegree = notFound;
+        for (size_t v : adjacent) {
+            if (rightMatches[v] == notFound && graph.rightDegree(v) < bestDegree) {
+                best = v;
+                bestDegree = graph.rightDegree(v);
+            }
+        }
+
+        if (best != notFound) {
+            leftMatches[u] = best;
+            rightMatches[best] = u;
+            size++;
+        }
+    }
+
+    return size;
+}
+
+
+
+/* ----- MAXIMUM MATCHING ----- */
+
+/**
+ * @brief Hopcroft-Karp maximum cardinality matching, in O(E sqrt(V)).
+ * Each phase computes the layers of the alternating paths from the free
+ * left nodes with a breadth first search, then augments the matching
+ * along a maximal set of disjoint shortest augmenting paths, found by
+ * depth first searches restricted to the layers. The searches are
+ * iterative, so long paths do not overflow the stack.
+ * With more than one thread, the levels of the breadth first search with
+ * a large frontier are visited in parallel (the first thread which reaches
+ * a left node claims it); the depth first searches are sequential.
+ * @param[in] graph Input graph
+ * @param[in,out] leftMatches Right node matched to each left node (NOT_FOUND
+ * for the free nodes). If its size is the number of left nodes, it is
+ * the initial matching (with rightMatches), otherwise the initial matching
+ * is empty.
+ * @param[in,out] rightMatches Left node matched to each right node
+ * (NOT_FOUND for the free nodes)
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Number of pairs of the matching
+ */
+template <class T1, class T2>
+size_t hopcroftKarp(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+    const size_t nLeft = graph.leftIdBound();
+
+    nThreads = numberOfThreads(nThreads);
+
+    if (leftMatches.size() != nLeft || rightMatches.size() != graph.rightIdBound()) {
+        leftMatches.assign(nLeft, notFound);
+        rightMatches.assign(graph.rightIdBound(), notFound);
+    }
+
+    size_t size = nLeft - std::count(leftMatches.begin(), leftMatches.end(), notFound);
+
+    //The arcs are read by more than one thread
+    graph.build();
+
+    std::vector<size_t> layers(nLeft);
+    std::vector<std::atomic<bool>> claimed(nThreads > 1 ? nLeft : 0);
+    std::vector<size_t> arcs(nLeft);
+    std::vector<size_t> stack;
+
+    size_t lastLayer;
+    while ((lastLayer = internal::matchingLayers(graph, leftMatches, rightMatches, layers, claimed, nThreads)) != notFound) {
+        size += internal::augmentLayers(graph, leftMatches, rightMatches, layers, lastLayer, arcs, stack);
+    }
+
+    return size;
+}
+
+/**
+ * @brief Maximum cardinality matching: Hopcroft-Karp with a greedy warm
+ * start (see greedyMatching and hopcroftKarp)
+ * @param[in] graph Input graph
+ * @param[out] leftMatches Right node matched to each left node (NOT_FOUND
+ * for the free nodes)
+ * @param[out] rightMatches Left node matched to each right node (NOT_FOUND
+ * for the free nodes)
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Number of pairs of the matching
+ */
+template <class T1, class T2>
+size_t maximumMatching(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        unsigned int nThreads)
+{
+    greedyMatching(graph, leftMatches, rightMatches);
+    return hopcroftKarp(graph, leftMatches, rightMatches, nThreads);
+}
+
+/**
+ * @brief Maximum cardinality matching of a cg3::BipartiteGraph (the graph
+ * is indexed, then see maximumMatching)
+ * @param graph Input graph
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ * @return Pairs left/right of the matching
+ */
+template <class T1, class T2>
+std::vector<std::pair<T1, T2>> maximumMatching(
+        const BipartiteGraph<T1, T2>& graph,
+        unsigned int nThreads)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+
+    IndexedBipartiteGraph<T1, T2> indexedGraph(graph);
+
+    std::vector<size_t> leftMatches;
+    std::vector<size_t> rightMatches;
+    size_t size = maximumMatching(indexedGraph, leftMatches, rightMatches, nThreads);
+
+    std::vector<std::pair<T1, T2>> matching;
+    matching.reserve(size);
+    for (size_t u = 0; u < leftMatches.size(); u++) {
+        if (leftMatches[u] != notFound)
+            matching.push_back(std::make_pair(indexedGraph.leftValue(u), indexedGraph.rightValue(leftMatches[u])));
+    }
+
+    return matching;
+}
+
+
+namespace internal {
+
+/**
+ * @brief Breadth first search of a phase of Hopcroft-Karp: the free left
+ * nodes are in layer 0, the left nodes matched to the right neighbors of
+ * layer k are in layer k+1. The search stops at the first layer which is
+ * adjacent to a free right node.
+ * @param[out] layers Layer of each left node (NOT_FOUND if not reached)
+ * @param[out] claimed Left nodes reached by the search (used only with
+ * more than one thread)
+ * @return Last layer (the layer adjacent to the free right nodes),
+ * NOT_FOUND if there are no augmenting paths
+ */
+template <class T1, class T2>
+size_t matchingLayers(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        const std::vector<size_t>& leftMatches,
+        const std::vector<size_t>& rightMatches,
+        std::vector<size_t>& layers,
+        std::vector<std::atomic<bool>>& claimed,
+        unsigned int nThreads)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+    const size_t nLeft = graph.leftIdBound();
+    const bool parallel = nThreads > 1;
+
+    std::vector<size_t> frontier;
+    for (size_t u = 0; u < nLeft; u++) {
+        bool free = leftMatches[u] == notFound;
+        layers[u] = free ? 0 : notFound;
+        if (parallel)
+            claimed[u].store(free, std::memory_order_relaxed);
+        if (free)
+            frontier.push_back(u);
+    }
+
+    std::vector<size_t> next;
+    std::vector<std::vector<size_t>> localFrontiers(nThreads);
+    std::vector<char> localFound(nThreads, false);
+
+    for (size_t layer = 0; !frontier.empty(); layer++) {
+        bool found = false;
+        next.clear();
+
+        if (parallel && frontier.size() >= MATCHING_PARALLEL_FRONTIER) {
+            for (unsigned int t = 0; t < nThreads; t++)
+                localFrontiers[t].clear();
+
+            parallelForChunks(frontier.size(), MATCHING_CHUNK_SIZE,
+                [&] (unsigned int thread, size_t, size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        for (size_t v : graph.adjacentRightNodes(frontier[i])) {
+                            size_t w = rightMatches[v];
+                            if (w == notFound) {
+                                localFound[thread] = true;
+                            }
+                            else if (!claimed[w].load(std::memory_order_relaxed) &&
+                                     !claimed[w].exchange(true, std::memory_order_relaxed))
+                            {
+                                layers[w] = layer + 1;
+                                localFrontiers[thread].push_back(w);
+                            }
+                        }
+                    }
+            }, nThreads);
+
+            for (unsigned int t = 0; t < nThreads; t++) {
+                next.insert(next.end(), localFrontiers[t].begin(), localFrontiers[t].end());
+                found = found || localFound[t];
+            }
+        }
+        else {
+            for (size_t u : frontier) {
+                for (size_t v : graph.adjacentRightNodes(u)) {
+                    size_t w = rightMatches[v];
+                    if (w == notFound) {
+                        found = true;
+                    }
+                    else if (layers[w] == notFound) {
+                        layers[w] = layer + 1;
+                        if (parallel)
+                            claimed[w].store(true, std::memory_order_relaxed);
+                        next.push_back(w);
+                    }
+                }
+            }
+        }
+
+        if (found)
+            return layer;
+
+        frontier.swap(next);
+    }
+
+    return notFound;
+}
+
+/**
+ * @brief Depth first searches of a phase of Hopcroft-Karp: from each free
+ * left node, the search follows the arcs to the next layer until it finds
+ * a free right node, then the matching is augmented along the path. Each
+ * left node keeps the position of the next arc to be tried, and the nodes
+ * of the augmenting paths and the dead ends are removed from the layers,
+ * so each arc is visited once and the paths are disjoint.
+ * @return Number of augmenting paths
+ */
+template <class T1, class T2>
+size_t augmentLayers(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        std::vector<size_t>& layers,
+        size_t lastLayer,
+        std::vector<size_t>& arcs,
+        std::vector<size_t>& stack)
+{
+    const size_t notFound = IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+    const size_t nLeft = graph.leftIdBound();
+
+    std::fill(arcs.begin(), arcs.end(), 0);
+
+    size_t augmented = 0;
+    for (size_t root = 0; root < nLeft; root++) {
+        if (leftMatches[root] != notFound || layers[root] != 0)
+            continue;
+
+        stack.assign(1, root);
+        while (!stack.empty()) {
+            size_t u = stack.back();
+            const size_t* adjacent = graph.adjacentRightNodes(u).begin();
+
+            if (arcs[u] == graph.leftDegree(u)) {
+                layers[u] = notFound;
+                stack.pop_back();
+                continue;
+            }
+
+            size_t w = rightMatches[adjacent[arcs[u]]];
+
+            if (w == notFound) {
+                augmentPath(graph, leftMatches, rightMatches, arcs, stack);
+                for (size_t x : stack)
+                    layers[x] = notFound;
+                augmented++;
+                break;
+            }
+
+            if (layers[u] < lastLayer && layers[w] == layers[u] + 1)
+                stack.push_back(w);
+            else
+                arcs[u]++;
+        }
+    }
+
+    return augmented;
+}
+
+/**
+ * @brief Augment the matching along a path: each left node of the path
+ * is matched to the right node of its current arc
+ */
+template <class T1, class T2>
+void augmentPath(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<size_t>& leftMatches,
+        std::vector<size_t>& rightMatches,
+        const std::vector<size_t>& arcs,
+        const std::vector<size_t>& stack)
+{
+    for (size_t x : stack) {
+        size_t v = graph.adjacentRightNodes(x).begin()[arcs[x]];
+        leftMatches[x] = v;
+        rightMatches[v] = x;
+    }
+}
+
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_BIPARTITE_PROJECTION_H
+#define CG3_BIPARTITE_PROJECTION_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <cg3/data_structures/graphs/graph.h>
+#include <cg3/data_structures/graphs/bipartite_graph.h>
+
+#include "extensions/data_structures/graphs/indexed_bipartite_graph.h"
+
+namespace cg3 {
+
+/**
+ * @brief Two-hop queries on an indexed bipartite graph: the left nodes
+ * which share at least a right neighbor with a left node (and the right
+ * nodes which share a left neighbor with a right node).
+ *
+ * The nodes reached by the paths of length two are collected in a bitset
+ * (reused by all the queries), so each of them is reported once however
+ * many paths reach it: a query takes time linear in the number of paths,
+ * plus the sort of the non-zero words of the bitset. The neighbors are
+ * reported sorted by id, without the queried node.
+ *
+ * The graph must not be modified while it is queried. A query object is
+ * not thread safe: each thread must use its own one, after build() has
+ * been called on the graph.
+ */
+template <class T1, class T2>
+class TwoHopQuery
+{
+
+public:
+
+    /* Typedefs */
+
+    typedef typename IndexedBipartiteGraph<T1, T2>::LeftId LeftId;
+    typedef typename IndexedBipartiteGraph<T1, T2>::RightId RightId;
+
+
+    /* Constructors */
+
+    TwoHopQuery(const IndexedBipartiteGraph<T1, T2>& graph);
+
+
+    /* Public methods */
+
+    size_t leftNeighbors(LeftId u, std::vector<LeftId>& neighbors);
+    size_t rightNeighbors(RightId v, std::vector<RightId>& neighbors);
+
+
+protected:
+
+    /* Protected fields */
+
+    const IndexedBipartiteGraph<T1, T2>& graph;
+
+    std::vector<uint64_t> words; //Bitset of the nodes reached by the query
+    std::vector<size_t> touchedWords; //Indices of the non-zero words
+
+
+    /* Helpers */
+
+    void resize(size_t idBound);
+    void insert(size_t id);
+    size_t extract(size_t excluded, std::vector<size_t>& neighbors);
+
+};
+
+
+/* One-mode projection */
+
+template <class T1, class T2>
+size_t leftProjection(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<std::pair<size_t, size_t>>& edges,
+        std::vector<double>& weights,
+        unsigned int nThreads = 0);
+
+template <class T1, class T2>
+size_t rightProjection(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<std::pair<size_t, size_t>>& edges,
+        std::vector<double>& weights,
+        unsigned int nThreads = 0);
+
+template <class T1, class T2>
+Graph<T1> leftProjection(
+        const BipartiteGraph<T1, T2>& graph,
+        unsigned int nThreads = 0);
+
+template <class T1, class T2>
+Graph<T2> rightProjection(
+        const BipartiteGraph<T1, T2>& graph,
+        unsigned int nThreads = 0);
+
+}
+
+#include "bipartite_projection.tpp"
+
+#endif // CG3_BIPARTITE_PROJECTION_H
@@ -0,0 +1,392 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "bipartite_projection.h"
+
+#include <algorithm>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Number of bits of a word of the bitset of the two-hop queries */
+static const size_t TWO_HOP_WORD_BITS = 64;
+
+/* Number of source nodes assigned to a thread at a time by the projections */
+static const size_t PROJECTION_CHUNK_SIZE = 256;
+
+inline size_t countTrailingZeros(uint64_t value);
+
+template <class V, class F, class S>
+size_t projectionEdges(
+        size_t idBound,
+        V isValid,
+        F firstHop,
+        S secondHop,
+        std::vector<std::pair<size_t, size_t>>& edges,
+        std::vector<double>& weights,
+        unsigned int nThreads);
+
+}
+
+
+/* ----- CONSTRUCTORS ----- */
+
+/**
+ * @brief Constructor. The graph must outlive this object.
+ * @param graph Input graph
+ */
+template <class T1, class T2>
+TwoHopQuery<T1, T2>::TwoHopQuery(const IndexedBipartiteGraph<T1, T2>& graph) :
+    graph(graph)
+{
+
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Get the left nodes which share at least a right neighbor with
+ * a left node
+ * @param[in] u Id of the left node
+ * @param[out] neighbors Ids of the left nodes, sorted, without u (empty
+ * if u is not a valid id)
+ * @return Number of left nodes
+ */
+template <class T1, class T2>
+size_t TwoHopQuery<T1, T2>::leftNeighbors(LeftId u, std::vector<LeftId>& neighbors)
+{
+    neighbors.clear();
+    if (!graph.isValidLeft(u))
+        return 0;
+
+    resize(graph.leftIdBound());
+    for (RightId v : graph.adjacentRightNodes(u)) {
+        for (LeftId w : graph.adjacentLeftNodes(v))
+            insert(w);
+    }
+
+    return extract(u, neighbors);
+}
+
+/**
+ * @brief Get the right nodes which share at least a left neighbor with
+ * a right node
+ * @param[in] v Id of the right node
+ * @param[out] neighbors Ids of the right nodes, sorted, without v (empty
+ * if v is not a valid id)
+ * @return Number of right nodes
+ */
+template <class T1, class T2>
+size_t TwoHopQuery<T1, T2>::rightNeighbors(RightId v, std::vector<RightId>& neighbors)
+{
+    neighbors.clear();
+    if (!graph.isValidRight(v))
+        return 0;
+
+    resize(graph.rightIdBound());
+    for (LeftId u : graph.adjacentLeftNodes(v)) {
+        for (RightId w : graph.adjacentRightNodes(u))
+            insert(w);
+    }
+
+    return extract(v, neighbors);
+}
+
+
+
+/* ----- ONE-MODE PROJECTION ----- */
+
+/**
+ * @brief One-mode projection on the left nodes: an edge between two left
+ * nodes for each pair of left nodes with common right neighbors, weighted
+ * with the number of common right neighbors (co-occurrences).
+ *
+ * The left nodes are split in chunks which are visited in parallel: each
+ * thread counts the paths of length two from a node to the nodes with a
+ * greater id in a dense array of counters (one for each thread, of size
+ * leftIdBound()), so each edge is found once. The edges of each chunk are
+ * then concatenated in order, so the result does not depend on the number
+ * of threads.
+ * @param[in] graph Input graph
+ * @param[out] edges Edges of the projection, as pairs of left ids (the
+ * first one is the smallest), sorted
+ * @param[out] weights Number of common right neighbors of each edge
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Number of edges of the projection
+ */
+template <class T1, class T2>
+size_t leftProjection(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<std::pair<size_t, size_t>>& edges,
+        std::vector<double>& weights,
+        unsigned int nThreads)
+{
+    graph.build();
+
+    return internal::projectionEdges(
+                graph.leftIdBound(),
+                [&graph] (size_t u) { return graph.isValidLeft(u); },
+                [&graph] (size_t u) { return graph.adjacentRightNodes(u); },
+                [&graph] (size_t v) { return graph.adjacentLeftNodes(v); },
+                edges, weights, nThreads);
+}
+
+/**
+ * @brief One-mode projection on the right nodes: an edge between two right
+ * nodes for each pair of right nodes with common left neighbors, weighted
+ * with the number of common left neighbors (see leftProjection)
+ * @param[in] graph Input graph
+ * @param[out] edges Edges of the projection, as pairs of right ids (the
+ * first one is the smallest), sorted
+ * @param[out] weights Number of common left neighbors of each edge
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Number of edges of the projection
+ */
+template <class T1, class T2>
+size_t rightProjection(
+        const IndexedBipartiteGraph<T1, T2>& graph,
+        std::vector<std::pair<size_t, size_t>>& edges,
+        std::vector<double>& weights,
+        unsigned int nThreads)
+{
+    graph.build();
+
+    return internal::projectionEdges(
+                graph.rightIdBound(),
+                [&graph] (size_t v) { return graph.isValidRight(v); },
+                [&graph] (size_t v) { return graph.adjacentLeftNodes(v); },
+                [&graph] (size_t u) { return graph.adjacentRightNodes(u); },
+                edges, weights, nThreads);
+}
+
+/**
+ * @brief One-mode projection on the left nodes of a cg3::BipartiteGraph:
+ * an undirected graph with all the left nodes, whose edges are weighted
+ * with the number of common right neighbors. The graph is indexed and the
+ * edges are counted in parallel (see leftProjection), then they are
+ * inserted in the cg3::Graph by the calling thread.
+ * @param graph Input graph
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ * @return Projection of the graph
+ */
+template <class T1, class T2>
+Graph<T1> leftProjection(
+        const BipartiteGraph<T1, T2>& graph,
+        unsigned int nThreads)
+{
+    IndexedBipartiteGraph<T1, T2> indexedGraph(graph);
+
+    std::vector<std::pair<size_t, size_t>> edges;
+    std::vector<double> weights;
+    leftProjection(indexedGraph, edges, weights, nThreads);
+
+    Graph<T1> projection(Graph<T1>::UNDIRECTED);
+    for (size_t u = 0; u < indexedGraph.leftIdBound(); u++)
+        projection.addNode(indexedGraph.leftValue(u));
+
+    for (size_t i = 0; i < edges.size(); i++) {
+        projection.addEdge(
+                    indexedGraph.leftValue(edges[i].first),
+                    indexedGraph.leftValue(edges[i].second),
+                    weights[i]);
+    }
+
+    return projection;
+}
+
+/**
+ * @brief One-mode projection on the right nodes of a cg3::BipartiteGraph:
+ * an undirected graph with all the right nodes, whose edges are weighted
+ * with the number of common left neighbors (see leftProjection)
+ * @param graph Input graph
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ * @return Projection of the graph
+ */
+template <class T1, class T2>
+Graph<T2> rightProjection(
+        const BipartiteGraph<T1, T2>& graph,
+        unsigned int nThreads)
+{
+    IndexedBipartiteGraph<T1, T2> indexedGraph(graph);
+
+    std::vector<std::pair<size_t, size_t>> edges;
+    std::vector<double> weights;
+    rightProjection(indexedGraph, edges, weights, nThreads);
+
+    Graph<T2> projection(Graph<T2>::UNDIRECTED);
+    for (size_t v = 0; v < indexedGraph.rightIdBound(); v++)
+        projection.addNode(indexedGraph.rightValue(v));
+
+    for (size_t i = 0; i < edges.size(); i++) {
+        projection.addEdge(
+                    indexedGraph.rightValue(edges[i].first),
+                    indexedGraph.rightValue(edges[i].second),
+                    weights[i]);
+    }
+
+    return projection;
+}
+
+
+
+/* ----- HELPERS ----- */
+
+/**
+ * @brief Resize the bitset for the ids in [0, idBound). The words are
+ * zero between two queries, so the new ones are just appended.
+ */
+template <class T1, class T2>
+void TwoHopQuery<T1, T2>::resize(size_t idBound)
+{
+    size_t numWords = (idBound + internal::TWO_HOP_WORD_BITS - 1) / internal::TWO_HOP_WORD_BITS;
+    if (words.size() < numWords)
+        words.resize(numWords, 0);
+}
+
+/**
+ * @brief Set the bit of an id, recording its word the first time it
+ * becomes non-zero
+ */
+template <class T1, class T2>
+void TwoHopQuery<T1, T2>::insert(size_t id)
+{
+    size_t index = id / internal::TWO_HOP_WORD_BITS;
+    uint64_t& word = words[index];
+    if (word == 0)
+        touchedWords.push_back(index);
+    word |= ((uint64_t) 1) << (id % internal::TWO_HOP_WORD_BITS);
+}
+
+/**
+ * @brief Extract the ids set in the bitset, sorted, and clear it
+ * @param[in] excluded Id which is not reported
+ * @param[out] neighbors Ids set in the bitset
+ * @return Number of ids reported
+ */
+template <class T1, class T2>
+size_t TwoHopQuery<T1, T2>::extract(size_t excluded, std::vector<size_t>& neighbors)
+{
+    std::sort(touchedWords.begin(), touchedWords.end());
+
+    for (size_t index : touchedWords) {
+        uint64_t word = words[index];
+        words[index] = 0;
+
+        while (word != 0) {
+            size_t id = index * internal::TWO_HOP_WORD_BITS + internal::countTrailingZeros(word);
+            if (id != excluded)
+                neighbors.push_back(id);
+            word &= word - 1;
+        }
+    }
+    touchedWords.clear();
+
+    return neighbors.size();
+}
+
+
+namespace internal {
+
+/**
+ * @brief Number of trailing zero bits of a non-zero word
+ */
+inline size_t countTrailingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    size_t count = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Edges of a one-mode projection, with the number of paths of
+ * length two between their nodes as weights. The adjacency ranges are
+ * sorted by id, so the second hop skips the nodes with an id which is not
+ * greater than the source with a binary search.
+ * @param[in] idBound Bound of the ids of the nodes of the projection
+ * @param[in] isValid Function which tells if an id is valid
+ * @param[in] firstHop Function which returns the neighbors of a node
+ * @param[in] secondHop Function which returns the neighbors of a node of
+ * the other side
+ * @param[out] edges Edges of the projection
+ * @param[out] weights Weights of the edges
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Number of edges
+ */
+template <class V, class F, class S>
+size_t projectionEdges(
+        size_t idBound,
+        V isValid,
+        F firstHop,
+        S secondHop,
+        std::vector<std::pair<size_t, size_t>>& edges,
+        std::vector<double>& weights,
+        unsigned int nThreads)
+{
+    size_t numChunks = (idBound + PROJECTION_CHUNK_SIZE - 1) / PROJECTION_CHUNK_SIZE;
+    std::vector<std::vector<std::pair<size_t, size_t>>> chunkEdges(numChunks);
+    std::vector<std::vector<double>> chunkWeights(numChunks);
+
+    unsigned int maxThreads = numberOfThreads(nThreads);
+    std::vector<std::vector<size_t>> threadCounts(maxThreads);
+    std::vector<std::vector<size_t>> threadTouched(maxThreads);
+
+    parallelForChunks(idBound, PROJECTION_CHUNK_SIZE,
+            [&] (unsigned int threadIndex, size_t chunk, size_t begin, size_t end) {
+        std::vector<size_t>& counts = threadCounts[threadIndex];
+        std::vector<size_t>& touched = threadTouched[threadIndex];
+        counts.resize(idBound, 0);
+
+        for (size_t u = begin; u < end; u++) {
+            if (!isValid(u))
+                continue;
+
+            for (size_t v : firstHop(u)) {
+                auto range = secondHop(v);
+                for (const size_t* w = std::upper_bound(range.begin(), range.end(), u); w != range.end(); ++w) {
+                    if (counts[*w]++ == 0)
+                        touched.push_back(*w);
+                }
+            }
+
+            std::sort(touched.begin(), touched.end());
+            for (size_t w : touched) {
+                chunkEdges[chunk].push_back(std::make_pair(u, w));
+                chunkWeights[chunk].push_back(counts[w]);
+                counts[w] = 0;
+            }
+            touched.clear();
+        }
+    }, nThreads);
+
+    size_t numEdges = 0;
+    for (size_t chunk = 0; chunk < numChunks; chunk++)
+        numEdges += chunkEdges[chunk].size();
+
+    edges.clear();
+    weights.clear();
+    edges.reserve(numEdges);
+    weights.reserve(numEdges);
+    for (size_t chunk = 0; chunk < numChunks; chunk++) {
+        edges.insert(edges.end(), chunkEdges[chunk].begin(), chunkEdges[chunk].end());
+        weights.insert(weights.end(), chunkWeights[chunk].begin(), chunkWeights[chunk].end());
+    }
+
+    return numEdges;
+}
+
+}
+
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_COMPILED_GRAPH_ALGORITHMS_H
+#define CG3_COMPILED_GRAPH_ALGORITHMS_H
+
+#include <vector>
+
+#include <cg3/algorithms/graph_algorithms.h>
+
+#include "extensions/data_structures/graphs/compiled_graph.h"
+#include "extensions/data_structures/graphs/distance_matrix.h"
+#include "extensions/data_structures/queues/dijkstra_queues.h"
+
+namespace cg3 {
+
+/* Dijkstra */
+
+template <class T, class W>
+void dijkstra(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        std::vector<double>& distances,
+        std::vector<size_t>& predecessors);
+
+template <class T, class W, class Queue>
+void dijkstra(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        std::vector<double>& distances,
+        std::vector<size_t>& predecessors,
+        Queue& queue);
+
+template <class T, class W>
+DijkstraResult<T> dijkstra(
+        const CompiledGraph<T, W>& graph,
+        const T& source);
+
+template <class T, class W>
+GraphPath<T> dijkstra(
+        const CompiledGraph<T, W>& graph,
+        const T& source,
+        const T& destination);
+
+
+/* Point to point shortest paths */
+
+template <class T, class W>
+GraphPath<T> shortestPath(
+        const CompiledGraph<T, W>& graph,
+        const T& source,
+        const T& destination);
+
+template <class T>
+GraphPath<T> shortestPath(
+        const Graph<T>& graph,
+        const T& source,
+        const T& destination);
+
+template <class T, class W, class Heuristic>
+GraphPath<T> aStar(
+        const CompiledGraph<T, W>& graph,
+        const T& source,
+        const T& destination,
+        Heuristic heuristic);
+
+template <class T, class Heuristic>
+GraphPath<T> aStar(
+        const Graph<T>& graph,
+        const T& source,
+        const T& destination,
+        Heuristic heuristic);
+
+/**
+ * @brief Heuristic for aStar on graphs whose nodes are points (e.g.
+ * cg3::Point2D or cg3::Pointd): the euclidean distance between a node
+ * and the destination. It is admissible if the weight of each edge is
+ * at least the distance between its nodes.
+ */
+struct EuclideanHeuristic {
+    template <class P>
+    double operator()(const P& node, const P& destination) const
+    {
+        return node.dist(destination);
+    }
+};
+
+
+/* All pairs shortest paths */
+
+template <class T, class W>
+DistanceMatrix allPairsShortestPaths(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads = 0);
+
+template <class Queue, class T, class W>
+DistanceMatrix allPairsShortestPaths(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads = 0);
+
+template <class T>
+DistanceMatrix allPairsShortestPaths(
+        const Graph<T>& graph,
+        unsigned int nThreads = 0);
+
+template <class T, class W>
+DistanceMatrix floydWarshall(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads = 0);
+
+template <class T>
+DistanceMatrix floydWarshall(
+        const Graph<T>& graph,
+        unsigned int nThreads = 0);
+
+
+/* Utilities */
+
+template <class T, class W>
+GraphPath<T> graphPath(
+        const CompiledGraph<T, W>& graph,
+        size_t destination,
+        const std::vector<double>& distances,
+        const std::vector<size_t>& predecessors);
+
+}
+
+#include "compiled_graph_algorithms.tpp"
+
+#endif // CG3_COMPILED_GRAPH_ALGORITHMS_H
@@ -0,0 +1,685 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "compiled_graph_algorithms.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Number of sources assigned to a thread at a time */
+static const size_t APSP_CHUNK_SIZE = 16;
+
+/* Side of the blocks of the blocked Floyd-Warshall (64x64 doubles fit in L1/L2) */
+static const size_t FLOYD_WARSHALL_BLOCK_SIZE = 64;
+
+template <class T>
+void floydWarshallBlock(
+        DistanceMatrix& matrix,
+        size_t iBlock,
+        size_t jBlock,
+        size_t kBlock);
+
+}
+
+/* ----- DIJKSTRA ----- */
+
+/**
+ * @brief Dijkstra algorithm on a compiled graph, using node indices and
+ * a binary heap. Weights must be non-negative.
+ * @param[in] graph Input graph
+ * @param[in] source Index of the source node
+ * @param[out] distances Distance of each node from the source
+ * (Graph<T>::MAX_WEIGHT for unreachable nodes)
+ * @param[out] predecessors Predecessor of each node in the shortest path
+ * from the source (CompiledGraph<T>::NOT_FOUND for the source and for
+ * unreachable nodes)
+ */
+template <class T, class W>
+void dijkstra(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        std::vector<double>& distances,
+        std::vector<size_t>& predecessors)
+{
+    BinaryHeapQueue queue;
+    dijkstra(graph, source, distances, predecessors, queue);
+}
+
+/**
+ * @brief Dijkstra algorithm on a compiled graph, using node indices and
+ * a given priority queue policy (see dijkstra_queues.h):
+ *
+ * - BinaryHeapQueue: any non-negative weights
+ * - QuaternaryHeapQueue (DaryHeapQueue<D>): any non-negative weights,
+ *   with decrease-key
+ * - RadixHeapQueue: non-negative integer weights
+ * - DialQueue: small non-negative integer weights (it allocates
+ *   graph.maxWeight()+1 buckets)
+ *
+ * The integer key queues (RadixHeapQueue and DialQueue) would truncate
+ * fractional distances: if the weights of the graph are not all integers
+ * (see CompiledGraph::integerWeights), a binary heap is used instead.
+ * If the maximum weight is out of the range of the queue (see
+ * supportsMaxWeight, e.g. too many buckets for DialQueue), a radix heap
+ * is used instead, or a binary heap if it is out of its range too.
+ *
+ * The queue is passed by reference, so its buffers can be reused for
+ * many sources.
+ *
+ * @param[in] graph Input graph
+ * @param[in] source Index of the source node
+ * @param[out] distances Distance of each node from the source
+ * (Graph<T>::MAX_WEIGHT for unreachable nodes)
+ * @param[out] predecessors Predecessor of each node in the shortest path
+ * from the source (CompiledGraph<T>::NOT_FOUND for the source and for
+ * unreachable nodes)
+ * @param[in] queue Priority queue
+ */
+template <class T, class W, class Queue>
+void dijkstra(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        std::vector<double>& distances,
+        std::vector<size_t>& predecessors,
+        Queue& queue)
+{
+    const size_t n = graph.numNodes();
+
+    if (Queue::INTEGER_KEYS && !graph.integerWeights()) {
+        BinaryHeapQueue binaryQueue;
+        dijkstra(graph, source, distances, predecessors, binaryQueue);
+        return;
+    }
+    if (!Queue::supportsMaxWeight(n, graph.maxWeight())) {
+        if (RadixHeapQueue::supportsMaxWeight(n, graph.maxWeight())) {
+            RadixHeapQueue radixQueue;
+            dijkstra(graph, source, distances, predecessors, radixQueue);
+        }
+        else {
+            BinaryHeapQueue binaryQueue;
+            dijkstra(graph, source, distances, predecessors, binaryQueue);
+        }
+        return;
+    }
+
+    distances.assign(n, Graph<T>::MAX_WEIGHT);
+    predecessors.assign(n, CompiledGraph<T, W>::NOT_FOUND);
+
+    if (source >= n)
+        return;
+
+    queue.initialize(n, graph.maxWeight());
+
+    distances[source] = 0;
+    queue.push(source, 0);
+
+    while (!queue.empty()) {
+        double key;
+        size_t u = queue.pop(key);
+
+        //Outdated entry
+        if (key > distances[u])
+            continue;
+
+        for (size_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+            size_t v = graph.target(e);
+            double distance = key + graph.weight(e);
+
+            if (distance < distances[v]) {
+                distances[v] = distance;
+                predecessors[v] = u;
+                queue.push(v, distance);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Dijkstra algorithm on a compiled graph, with the same result
+ * of cg3::dijkstra on a cg3::Graph
+ * @param[in] graph Input graph
+ * @param[in] source Value of the source node
+ * @return Shortest path from the source to each reachable node
+ */
+template <class T, class W>
+DijkstraResult<T> dijkstra(
+        const CompiledGraph<T, W>& graph,
+        const T& source)
+{
+    DijkstraResult<T> result;
+
+    size_t sourceIndex = graph.index(source);
+    if (sourceIndex == CompiledGraph<T, W>::NOT_FOUND)
+        return result;
+
+    std::vector<double> distances;
+    std::vector<size_t> predecessors;
+
+    dijkstra(graph, sourceIndex, distances, predecessors);
+
+    for (size_t i = 0; i < graph.numNodes(); i++) {
+        if (distances[i] != Graph<T>::MAX_WEIGHT) {
+            result[graph.value(i)] = graphPath(graph, i, distances, predecessors);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Dijkstra algorithm on a compiled graph between two nodes
+ * @param[in] graph Input graph
+ * @param[in] source Value of the source node
+ * @param[in] destination Value of the destination node
+ * @return Shortest path from the source to the destination
+ */
+template <class T, class W>
+GraphPath<T> dijkstra(
+        const CompiledGraph<T, W>& graph,
+        const T& source,
+        const T& destination)
+{
+    size_t sourceIndex = graph.index(source);
+    size_t destinationIndex = graph.index(destination);
+
+    if (sourceIndex == CompiledGraph<T, W>::NOT_FOUND || destinationIndex == CompiledGraph<T, W>::NOT_FOUND)
+        return GraphPath<T>();
+
+    std::vector<double> distances;
+    std::vector<size_t> predecessors;
+
+    dijkstra(graph, sourceIndex, distances, predecessors);
+
+    return graphPath(graph, destinationIndex, distances, predecessors);
+}
+
+
+
+/* ----- POINT TO POINT SHORTEST PATHS ----- */
+
+/**
+ * @brief Shortest path between two nodes of a compiled graph, computed
+ * with a bidirectional Dijkstra: a forward visit from the source and a
+ * backward visit (on the incoming edges) from the destination are
+ * alternated, and the search stops when the sum of the distances of the
+ * two frontiers is not smaller than the best path found.
+ * Weights must be non-negative.
+ * @param[in] graph Input graph
+ * @param[in] source Value of the source node
+ * @param[in] destination Value of the destination node
+ * @return Shortest path from the source to the destination (empty path
+ * with cost Graph<T>::MAX_WEIGHT if the destination is not reachable)
+ */
+template <class T, class W>
+GraphPath<T> shortestPath(
+        const CompiledGraph<T, W>& graph,
+        const T& source,
+        const T& destination)
+{
+    const size_t notFound = CompiledGraph<T, W>::NOT_FOUND;
+    const double maxWeight = Graph<T>::MAX_WEIGHT;
+
+    size_t s = graph.index(source);
+    size_t t = graph.index(destination);
+
+    GraphPath<T> path;
+    path.cost = maxWeight;
+
+    if (s == notFound || t == notFound)
+        return path;
+
+    const size_t n = graph.numNodes();
+
+    std::vector<double> forwardDistances(n, maxWeight);
+    std::vector<double> backwardDistances(n, maxWeight);
+    std::vector<size_t> predecessors(n, notFound);
+    std::vector<size_t> successors(n, notFound);
+
+    BinaryHeapQueue forwardQueue;
+    BinaryHeapQueue backwardQueue;
+    forwardQueue.initialize(n, graph.maxWeight());
+    backwardQueue.initialize(n, graph.maxWeight());
+
+    forwardDistances[s] = 0;
+    backwardDistances[t] = 0;
+    forwardQueue.push(s, 0);
+    backwardQueue.push(t, 0);
+
+    double bestCost = (s == t) ? 0 : maxWeight;
+    size_t meetingNode = (s == t) ? s : notFound;
+
+    //Keys of the last nodes extracted by the two visits (lower bounds of the queues)
+    double lastForwardKey = 0;
+    double lastBackwardKey = 0;
+
+    bool forward = true;
+
+    while (!forwardQueue.empty() && !backwardQueue.empty()) {
+        double key;
+
+        if (forward) {
+            size_t u = forwardQueue.pop(key);
+
+            if (key <= forwardDistances[u]) {
+                lastForwardKey = key;
+                if (lastForwardKey + lastBackwardKey >= bestCost)
+                    break;
+
+                for (size_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                    size_t v = graph.target(e);
+                    double distance = key + graph.weight(e);
+
+                    if (distance < forwardDistances[v]) {
+                        forwardDistances[v] = distance;
+                        predecessors[v] = u;
+                        forwardQueue.push(v, distance);
+                    }
+                    if (backwardDistances[v] != maxWeight && distance + backwardDistances[v] < bestCost) {
+                        bestCost = distance + backwardDistances[v];
+                        meetingNode = v;
+                    }
+                }
+            }
+        }
+        else {
+            size_t u = backwardQueue.pop(key);
+
+            if (key <= backwardDistances[u]) {
+                lastBackwardKey = key;
+                if (lastForwardKey + lastBackwardKey >= bestCost)
+                    break;
+
+                for (size_t e = graph.reverseEdgeBegin(u); e < graph.reverseEdgeEnd(u); e++) {
+                    size_t v = graph.source(e);
+                    double distance = key + graph.reverseWeight(e);
+
+                    if (distance < backwardDistances[v]) {
+                        backwardDistances[v] = distance;
+                        successors[v] = u;
+                        backwardQueue.push(v, distance);
+                    }
+                    if (forwardDistances[v] != maxWeight && distance + forwardDistances[v] < bestCost) {
+                        bestCost = distance + forwardDistances[v];
+                        meetingNode = v;
+                    }
+                }
+            }
+        }
+
+        forward = !forward;
+    }
+
+    if (meetingNode == notFound)
+        return path;
+
+    //Path from the source to the meeting node and from the meeting node to the destination
+    path.cost = bestCost;
+    for (size_t node = meetingNode; node != notFound; node = predecessors[node])
+        path.path.push_front(graph.value(node));
+    for (size_t node = successors[meetingNode]; node != notFound; node = successors[node])
+        path.path.push_back(graph.value(node));
+
+    return path;
+}
+
+/**
+ * @brief Shortest path between two nodes of a graph with a bidirectional
+ * Dijkstra (see the compiled graph version). The graph is compiled at
+ * each call: compile it once if many queries are needed.
+ * @param[in] graph Input graph
+ * @param[in] source Value of the source node
+ * @param[in] destination Value of the destination node
+ * @return Shortest path from the source to the destination
+ */
+template <class T>
+GraphPath<T> shortestPath(
+        const Graph<T>& graph,
+        const T& source,
+        const T& destination)
+{
+    return shortestPath(compile(graph), source, destination);
+}
+
+/**
+ * @brief Shortest path between two nodes of a compiled graph, computed
+ * with the A* algorithm: nodes are visited in order of distance from the
+ * source plus estimated distance to the destination, and the visit stops
+ * when the destination is extracted.
+ *
+ * The heuristic is called as heuristic(node, destination) with the values
+ * of the nodes. It must be consistent (never greater than the weight of
+ * an edge plus the heuristic of its target, e.g. EuclideanHeuristic on
+ * geometric graphs), otherwise the path may not be the shortest.
+ *
+ * @param[in] graph Input graph
+ * @param[in] source Value of the source node
+ * @param[in] destination Value of the destination node
+ * @param[in] heuristic Estimated distance between a node and the destination
+ * @return Shortest path from the source to the destination (empty path
+ * with cost Graph<T>::MAX_WEIGHT if the destination is not reachable)
+ */
+template <class T, class W, class Heuristic>
+GraphPath<T> aStar(
+        const CompiledGraph<T, W>& graph,
+        const T& source,
+        const T& destination,
+        Heuristic heuristic)
+{
+    const size_t notFound = CompiledGraph<T, W>::NOT_FOUND;
+    const double maxWeight = Graph<T>::MAX_WEIGHT;
+
+    size_t s = graph.index(source);
+    size_t t = graph.index(destination);
+
+    if (s == notFound || t == notFound) {
+        GraphPath<T> path;
+        path.cost = maxWeight;
+        return path;
+    }
+
+    const size_t n = graph.numNodes();
+
+    std::vector<double> distances(n, maxWeight);
+    std::vector<size_t> predecessors(n, notFound);
+    std::vector<bool> settled(n, false);
+
+    BinaryHeapQueue queue;
+    queue.initialize(n, graph.maxWeight());
+
+    distances[s] = 0;
+    queue.push(s, heuristic(source, destination));
+
+    while (!queue.empty()) {
+        double key;
+        size_t u = queue.pop(key);
+
+        if (settled[u])
+            continue;
+        settled[u] = true;
+
+        if (u == t)
+            break;
+
+        for (size_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+            size_t v = graph.target(e);
+            double distance = distances[u] + graph.weight(e);
+
+            if (!settled[v] && distance < distances[v]) {
+                distances[v] = distance;
+                predecessors[v] = u;
+                queue.push(v, distance + heuristic(graph.value(v), destination));
+            }
+        }
+    }
+
+    return graphPath(graph, t, distances, predecessors);
+}
+
+/**
+ * @brief Shortest path between two nodes of a graph with the A* algorithm
+ * (see the compiled graph version). The graph is compiled at each call:
+ * compile it once if many queries are needed.
+ * @param[in] graph Input graph
+ * @param[in] source Value of the source node
+ * @param[in] destination Value of the destination node
+ * @param[in] heuristic Estimated distance between a node and the destination
+ * @return Shortest path from the source to the destination
+ */
+template <class T, class Heuristic>
+GraphPath<T> aStar(
+        const Graph<T>& graph,
+        const T& source,
+        const T& destination,
+        Heuristic heuristic)
+{
+    return aStar(compile(graph), source, destination, heuristic);
+}
+
+
+
+/* ----- ALL PAIRS SHORTEST PATHS ----- */
+
+/**
+ * @brief Distances between all the pairs of nodes of a compiled graph,
+ * computed with a Dijkstra visit from each node (binary heap queue).
+ * Sources are visited in parallel.
+ * @param[in] graph Input graph
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Distance matrix (Graph<T>::MAX_WEIGHT for unreachable pairs)
+ */
+template <class T, class W>
+DistanceMatrix allPairsShortestPaths(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads)
+{
+    return allPairsShortestPaths<BinaryHeapQueue>(graph, nThreads);
+}
+
+/**
+ * @brief Distances between all the pairs of nodes of a compiled graph,
+ * computed with a Dijkstra visit from each node using the given queue
+ * policy (see dijkstra; a binary heap or a radix heap is used instead of
+ * an integer key queue if the weights are not integers or out of its
+ * range). Sources are assigned dynamically
+ * to the threads, and each thread reuses its own queue and buffers for all
+ * its sources.
+ * @param[in] graph Input graph
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Distance matrix (Graph<T>::MAX_WEIGHT for unreachable pairs)
+ */
+template <class Queue, class T, class W>
+DistanceMatrix allPairsShortestPaths(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads)
+{
+    const size_t n = graph.numNodes();
+
+    if (Queue::INTEGER_KEYS && !graph.integerWeights())
+        return allPairsShortestPaths<BinaryHeapQueue>(graph, nThreads);
+    if (!Queue::supportsMaxWeight(n, graph.maxWeight())) {
+        if (RadixHeapQueue::supportsMaxWeight(n, graph.maxWeight()))
+            return allPairsShortestPaths<RadixHeapQueue>(graph, nThreads);
+        return allPairsShortestPaths<BinaryHeapQueue>(graph, nThreads);
+    }
+
+    DistanceMatrix matrix(n, Graph<T>::MAX_WEIGHT);
+
+    std::atomic<size_t> nextSource(0);
+
+    parallelForThreads([&] (unsigned int) {
+        //Buffers of the thread, reused for all its sources
+        Queue queue;
+        std::vector<double> distances;
+        std::vector<size_t> predecessors;
+
+        size_t begin;
+        while ((begin = nextSource.fetch_add(internal::APSP_CHUNK_SIZE)) < n) {
+            size_t end = std::min(n, begin + internal::APSP_CHUNK_SIZE);
+
+            for (size_t source = begin; source < end; source++) {
+                dijkstra(graph, source, distances, predecessors, queue);
+                std::copy(distances.begin(), distances.end(), matrix.row(source));
+            }
+        }
+    }, (unsigned int) std::min((size_t) numberOfThreads(nThreads), std::max(n, (size_t) 1)));
+
+    return matrix;
+}
+
+/**
+ * @brief Distances between all the pairs of nodes of a graph (see the
+ * compiled graph version). Rows and columns of the matrix are the nodes
+ * in the order of the node iterator of the graph.
+ * @param[in] graph Input graph
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Distance matrix (Graph<T>::MAX_WEIGHT for unreachable pairs)
+ */
+template <class T>
+DistanceMatrix allPairsShortestPaths(
+        const Graph<T>& graph,
+        unsigned int nThreads)
+{
+    return allPairsShortestPaths(compile(graph), nThreads);
+}
+
+/**
+ * @brief Distances between all the pairs of nodes of a compiled graph,
+ * computed with a blocked Floyd-Warshall algorithm. For each diagonal
+ * block, the block itself is updated first, then the blocks in its row
+ * and column, then all the others: the blocks of the last two phases
+ * are updated in parallel. The complexity is O(n^3), so it is convenient
+ * only for dense graphs.
+ * @param[in] graph Input graph
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Distance matrix (Graph<T>::MAX_WEIGHT for unreachable pairs)
+ */
+template <class T, class W>
+DistanceMatrix floydWarshall(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads)
+{
+    const size_t n = graph.numNodes();
+    const size_t blockSize = internal::FLOYD_WARSHALL_BLOCK_SIZE;
+    const size_t nBlocks = (n + blockSize - 1) / blockSize;
+
+    DistanceMatrix matrix(n, Graph<T>::MAX_WEIGHT);
+
+    for (size_t i = 0; i < n; i++) {
+        matrix(i, i) = 0;
+        for (size_t e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+            size_t j = graph.target(e);
+            matrix(i, j) = std::min(matrix(i, j), graph.weight(e));
+        }
+    }
+
+    for (size_t k = 0; k < nBlocks; k++) {
+        //Diagonal block
+        internal::floydWarshallBlock<T>(matrix, k, k, k);
+
+        //Blocks in the row and in the column of the diagonal block
+        parallelFor(2 * nBlocks, [&] (size_t index) {
+            size_t other = index / 2;
+            if (other == k)
+                return;
+            if (index % 2 == 0)
+                internal::floydWarshallBlock<T>(matrix, k, other, k);
+            else
+                internal::floydWarshallBlock<T>(matrix, other, k, k);
+        }, nThreads);
+
+        //Remaining blocks
+        parallelFor(nBlocks * nBlocks, [&] (size_t index) {
+            size_t i = index / nBlocks;
+            size_t j = index % nBlocks;
+            if (i != k && j != k)
+                internal::floydWarshallBlock<T>(matrix, i, j, k);
+        }, nThreads);
+    }
+
+    return matrix;
+}
+
+/**
+ * @brief Distances between all the pairs of nodes of a graph (see the
+ * compiled graph version). Rows and columns of the matrix are the nodes
+ * in the order of the node iterator of the graph.
+ * @param[in] graph Input graph
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Distance matrix (Graph<T>::MAX_WEIGHT for unreachable pairs)
+ */
+template <class T>
+DistanceMatrix floydWarshall(
+        const Graph<T>& graph,
+        unsigned int nThreads)
+{
+    return floydWarshall(compile(graph), nThreads);
+}
+
+namespace internal {
+
+/**
+ * @brief Update the block (iBlock, jBlock) of the matrix using the paths
+ * passing through the nodes of the block kBlock
+ */
+template <class T>
+void floydWarshallBlock(
+        DistanceMatrix& matrix,
+        size_t iBlock,
+        size_t jBlock,
+        size_t kBlock)
+{
+    const size_t n = matrix.numNodes();
+    const size_t blockSize = FLOYD_WARSHALL_BLOCK_SIZE;
+
+    const size_t iEnd = std::min(n, (iBlock + 1) * blockSize);
+    const size_t jBegin = jBlock * blockSize;
+    const size_t jEnd = std::min(n, (jBlock + 1) * blockSize);
+    const size_t kEnd = std::min(n, (kBlock + 1) * blockSize);
+
+    for (size_t k = kBlock * blockSize; k < kEnd; k++) {
+        const double* rowK = matrix.row(k);
+
+        for (size_t i = iBlock * blockSize; i < iEnd; i++) {
+            double* rowI = matrix.row(i);
+            const double distanceIK = rowI[k];
+
+            if (distanceIK == Graph<T>::MAX_WEIGHT)
+                continue;
+
+            for (size_t j = jBegin; j < jEnd; j++) {
+                double distance = distanceIK + rowK[j];
+                if (distance < rowI[j])
+                    rowI[j] = distance;
+            }
+        }
+    }
+}
+
+}
+
+
+
+/* ----- UTILITIES ----- */
+
+/**
+ * @brief Build the path to a node from the predecessors computed by
+ * a shortest path algorithm on a compiled graph
+ * @param[in] graph Input graph
+ * @param[in] destination Index of the destination node
+ * @param[in] distances Distances of the nodes from the source
+ * @param[in] predecessors Predecessors of the nodes
+ * @return Path from the source to the destination (empty path with cost
+ * Graph<T>::MAX_WEIGHT if the destination is not reachable)
+ */
+template <class T, class W>
+GraphPath<T> graphPath(
+        const CompiledGraph<T, W>& graph,
+        size_t destination,
+        const std::vector<double>& distances,
+        const std::vector<size_t>& predecessors)
+{
+    GraphPath<T> path;
+    path.cost = Graph<T>::MAX_WEIGHT;
+
+    if (distances[destination] == Graph<T>::MAX_WEIGHT)
+        return path;
+
+    path.cost = distances[destination];
+
+    size_t node = destination;
+    while (node != CompiledGraph<T, W>::NOT_FOUND) {
+        path.path.push_front(graph.value(node));
+        node = predecessors[node];
+    }
+
+    return path;
+}
+
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_DYNAMIC_SHORTEST_PATHS_H
+#define CG3_DYNAMIC_SHORTEST_PATHS_H
+
+#include <vector>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+#include "extensions/data_structures/graphs/indexed_graph.h"
+#include "extensions/data_structures/queues/dijkstra_queues.h"
+
+namespace cg3 {
+
+/**
+ * @brief Single source shortest paths of an indexed graph, maintained
+ * while the edges of the graph are modified (Ramalingam-Reps).
+ *
+ * The edges must be modified through setWeight, addEdge and deleteEdge of
+ * this class, which update the graph and then the distances:
+ * - if an edge becomes shorter (or it is added), a Dijkstra visit starts
+ *   from its target and stops at the nodes whose distance does not change;
+ * - if an edge of the shortest path tree becomes longer (or it is
+ *   deleted), only the nodes of its subtree are recomputed, starting from
+ *   their incoming edges from the rest of the tree. Changes of the other
+ *   edges do not affect the distances.
+ *
+ * The incoming edges of each node are stored by the class. Weights must
+ * be non-negative. Nodes can be added to the graph directly; if the graph
+ * is modified in any other way, recompute must be called.
+ */
+template <class T>
+class DynamicShortestPaths
+{
+
+public:
+
+    /* Typedefs */
+
+    typedef typename IndexedGraph<T>::NodeId NodeId;
+    typedef typename IndexedGraph<T>::Edge Edge;
+
+    static const NodeId NOT_FOUND = IndexedGraph<T>::NOT_FOUND;
+
+
+    /* Constructors */
+
+    DynamicShortestPaths(IndexedGraph<T>& graph, NodeId source);
+
+
+    /* Public methods */
+
+    NodeId source() const;
+    double distance(NodeId node) const;
+    NodeId predecessor(NodeId node) const;
+    const std::vector<double>& distances() const;
+    std::vector<NodeId> path(NodeId node) const;
+
+    void setWeight(NodeId source, NodeId target, double weight);
+    void addEdge(NodeId source, NodeId target, double weight = 0);
+    bool deleteEdge(NodeId source, NodeId target);
+
+    void recompute();
+    size_t numAffectedNodes() const;
+
+
+protected:
+
+    /* Protected fields */
+
+    IndexedGraph<T>& graph;
+    NodeId sourceNode;
+
+    std::vector<double> nodeDistances;
+    std::vector<NodeId> predecessors; //Parent in the shortest path tree
+    std::vector<std::vector<Edge>> incoming; //Incoming edges, with the source in Edge::target
+
+    BinaryHeapQueue queue;
+    std::vector<bool> affected;
+    std::vector<NodeId> affectedNodes;
+    size_t lastAffected; //Nodes updated by the last modification
+
+
+    /* Helpers */
+
+    void resize();
+    void updateEdge(NodeId source, NodeId target, double oldWeight, double newWeight);
+
+    void setIncoming(NodeId source, NodeId target, double weight);
+    void eraseIncoming(NodeId source, NodeId target);
+
+    void decrease(NodeId source, NodeId target, double weight);
+    void increase(NodeId target);
+    size_t propagate();
+
+};
+
+}
+
+#include "dynamic_shortest_paths.tpp"
+
+#endif // CG3_DYNAMIC_SHORTEST_PATHS_H
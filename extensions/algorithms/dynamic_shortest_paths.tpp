@@ -0,0 +1,432 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "dynamic_shortest_paths.h"
+
+#include <algorithm>
+
+namespace cg3 {
+
+template <class T>
+const typename DynamicShortestPaths<T>::NodeId DynamicShortestPaths<T>::NOT_FOUND;
+
+
+/* ----- CONSTRUCTORS ----- */
+
+/**
+ * @brief Constructor: compute the shortest paths from the source node.
+ * The graph must outlive this object.
+ * @param graph Input graph
+ * @param source Id of the source node
+ */
+template <class T>
+DynamicShortestPaths<T>::DynamicShortestPaths(IndexedGraph<T>& graph, NodeId source) :
+    graph(graph),
+    sourceNode(source),
+    lastAffected(0)
+{
+    recompute();
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Get the id of the source node
+ */
+template <class T>
+typename DynamicShortestPaths<T>::NodeId DynamicShortestPaths<T>::source() const
+{
+    return sourceNode;
+}
+
+/**
+ * @brief Get the distance of a node from the source
+ * @param node Id of the node
+ * @return Distance, Graph<T>::MAX_WEIGHT if the node is not reachable
+ */
+template <class T>
+double DynamicShortestPaths<T>::distance(NodeId node) const
+{
+    if (node >= nodeDistances.size())
+        return Graph<T>::MAX_WEIGHT;
+
+    return nodeDistances[node];
+}
+
+/**
+ * @brief Get the predecessor of a node in the shortest path tree
+ * @param node Id of the node
+ * @return Id of the predecessor, NOT_FOUND for the source and for the
+ * nodes which are not reachable
+ */
+template <class T>
+typename DynamicShortestPaths<T>::NodeId DynamicShortestPaths<T>::predecessor(NodeId node) const
+{
+    if (node >= predecessors.size())
+        return NOT_FOUND;
+
+    return predecessors[node];
+}
+
+/**
+ * @brief Get the distances of all the nodes, indexed by id
+ */
+template <class T>
+const std::vector<double>& DynamicShortestPaths<T>::distances() const
+{
+    return nodeDistances;
+}
+
+/**
+ * @brief Get the shortest path from the source to a node
+ * @param node Id of the destination node
+ * @return Ids of the nodes of the path, empty if the node is not reachable
+ */
+template <class T>
+std::vector<typename DynamicShortestPaths<T>::NodeId> DynamicShortestPaths<T>::path(NodeId node) const
+{
+    std::vector<NodeId> result;
+    if (distance(node) == Graph<T>::MAX_WEIGHT)
+        return result;
+
+    for (NodeId current = node; current != NOT_FOUND; current = predecessors[current])
+        result.push_back(current);
+
+    std::reverse(result.begin(), result.end());
+
+    return result;
+}
+
+/**
+ * @brief Set the weight of an existing edge of the graph and update the
+ * distances
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @param weight New weight of the edge
+ */
+template <class T>
+void DynamicShortestPaths<T>::setWeight(NodeId source, NodeId target, double weight)
+{
+    resize();
+    lastAffected = 0;
+
+    double oldWeight = graph.getWeight(source, target);
+    if (oldWeight == Graph<T>::MAX_WEIGHT)
+        return;
+
+    graph.setWeight(source, target, weight);
+    updateEdge(source, target, oldWeight, weight);
+}
+
+/**
+ * @brief Add an edge to the graph (or set its weight, if it exists) and
+ * update the distances
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @param weight Weight of the edge
+ */
+template <class T>
+void DynamicShortestPaths<T>::addEdge(NodeId source, NodeId target, double weight)
+{
+    resize();
+    lastAffected = 0;
+
+    if (!graph.isValid(source) || !graph.isValid(target))
+        return;
+
+    double oldWeight = graph.getWeight(source, target);
+
+    graph.addEdge(source, target, weight);
+    updateEdge(source, target, oldWeight, weight);
+}
+
+/**
+ * @brief Delete an edge of the graph and update the distances
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @return True if the edge existed
+ */
+template <class T>
+bool DynamicShortestPaths<T>::deleteEdge(NodeId source, NodeId target)
+{
+    resize();
+    lastAffected = 0;
+
+    double oldWeight = graph.getWeight(source, target);
+    if (oldWeight == Graph<T>::MAX_WEIGHT)
+        return false;
+
+    graph.deleteEdge(source, target);
+    updateEdge(source, target, oldWeight, Graph<T>::MAX_WEIGHT);
+
+    return true;
+}
+
+/**
+ * @brief Compute the shortest paths from scratch, with a Dijkstra visit
+ * of the graph, and rebuild the incoming edges. It must be called if the
+ * graph has been modified without using this class.
+ */
+template <class T>
+void DynamicShortestPaths<T>::recompute()
+{
+    const NodeId n = graph.idBound();
+
+    nodeDistances.assign(n, Graph<T>::MAX_WEIGHT);
+    predecessors.assign(n, NOT_FOUND);
+    affected.assign(n, false);
+
+    incoming.resize(n);
+    for (NodeId id = 0; id < n; id++)
+        incoming[id].clear();
+
+    for (NodeId id = 0; id < n; id++) {
+        if (graph.isValid(id)) {
+            for (const Edge& edge : graph.adjacentEdges(id)) {
+                Edge reverse;
+                reverse.target = id;
+                reverse.weight = edge.weight;
+                incoming[edge.target].push_back(reverse);
+            }
+        }
+    }
+
+    queue.initialize(n, 0);
+    lastAffected = 0;
+
+    if (!graph.isValid(sourceNode))
+        return;
+
+    nodeDistances[sourceNode] = 0;
+    queue.push(sourceNode, 0);
+
+    lastAffected = propagate();
+}
+
+/**
+ * @brief Get the number of nodes whose distance has been recomputed by the
+ * last modification (all the reachable nodes after recompute)
+ */
+template <class T>
+size_t DynamicShortestPaths<T>::numAffectedNodes() const
+{
+    return lastAffected;
+}
+
+
+
+/* ----- HELPERS ----- */
+
+/**
+ * @brief Extend the arrays to the nodes added to the graph after the last
+ * update (they are not reachable, since they have no edges)
+ */
+template <class T>
+void DynamicShortestPaths<T>::resize()
+{
+    const NodeId n = graph.idBound();
+    if (nodeDistances.size() >= n)
+        return;
+
+    nodeDistances.resize(n, Graph<T>::MAX_WEIGHT);
+    predecessors.resize(n, NOT_FOUND);
+    incoming.resize(n);
+    affected.resize(n, false);
+}
+
+/**
+ * @brief Update the incoming edges and the distances after an edge of the
+ * graph has been modified (both the directions, if the graph is undirected)
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @param oldWeight Previous weight (MAX_WEIGHT if the edge did not exist)
+ * @param newWeight New weight (MAX_WEIGHT if the edge has been deleted)
+ */
+template <class T>
+void DynamicShortestPaths<T>::updateEdge(
+        NodeId source,
+        NodeId target,
+        double oldWeight,
+        double newWeight)
+{
+    const bool undirected = graph.type() == IndexedGraph<T>::UNDIRECTED && source != target;
+
+    if (newWeight == Graph<T>::MAX_WEIGHT) {
+        eraseIncoming(source, target);
+        if (undirected)
+            eraseIncoming(target, source);
+    }
+    else {
+        setIncoming(source, target, newWeight);
+        if (undirected)
+            setIncoming(target, source, newWeight);
+    }
+
+    //At most one of the two directions is in the shortest path tree
+    if (newWeight < oldWeight) {
+        decrease(source, target, newWeight);
+        if (undirected)
+            decrease(target, source, newWeight);
+    }
+    else if (newWeight > oldWeight) {
+        if (predecessors[target] == source)
+            increase(target);
+        else if (undirected && predecessors[source] == target)
+            increase(source);
+    }
+}
+
+/**
+ * @brief Set the weight of an incoming edge, adding it if it does not exist
+ */
+template <class T>
+void DynamicShortestPaths<T>::setIncoming(NodeId source, NodeId target, double weight)
+{
+    for (Edge& edge : incoming[target]) {
+        if (edge.target == source) {
+            edge.weight = weight;
+            return;
+        }
+    }
+
+    Edge edge;
+    edge.target = source;
+    edge.weight = weight;
+    incoming[target].push_back(edge);
+}
+
+/**
+ * @brief Erase an incoming edge (the last edge takes its place)
+ */
+template <class T>
+void DynamicShortestPaths<T>::eraseIncoming(NodeId source, NodeId target)
+{
+    std::vector<Edge>& edges = incoming[target];
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edges[i].target == source) {
+            edges[i] = edges.back();
+            edges.pop_back();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Update the distances after the weight of an edge has decreased:
+ * if the edge improves the distance of its target, a Dijkstra visit starts
+ * from the target and relaxes only the nodes whose distance improves
+ */
+template <class T>
+void DynamicShortestPaths<T>::decrease(NodeId source, NodeId target, double weight)
+{
+    if (nodeDistances[source] == Graph<T>::MAX_WEIGHT)
+        return;
+
+    double distance = nodeDistances[source] + weight;
+    if (distance >= nodeDistances[target])
+        return;
+
+    nodeDistances[target] = distance;
+    predecessors[target] = source;
+
+    queue.initialize(nodeDistances.size(), 0);
+    queue.push(target, distance);
+
+    lastAffected += propagate();
+}
+
+/**
+ * @brief Update the distances after the weight of an edge of the shortest
+ * path tree has increased (or the edge has been deleted). The distances
+ * of the nodes outside the subtree of the target cannot change: the nodes
+ * of the subtree are reset, then each of them takes the best distance
+ * through its incoming edges from outside the subtree, and a Dijkstra visit
+ * restricted to the subtree computes the final distances.
+ */
+template <class T>
+void DynamicShortestPaths<T>::increase(NodeId target)
+{
+    //Subtree of the target
+    affectedNodes.clear();
+    affectedNodes.push_back(target);
+    affected[target] = true;
+
+    for (size_t i = 0; i < affectedNodes.size(); i++) {
+        NodeId node = affectedNodes[i];
+        for (const Edge& edge : graph.adjacentEdges(node)) {
+            if (!affected[edge.target] && predecessors[edge.target] == node) {
+                affected[edge.target] = true;
+                affectedNodes.push_back(edge.target);
+            }
+        }
+    }
+
+    //The modified edge, if it still exists, is among the incoming edges
+    for (NodeId node : affectedNodes) {
+        nodeDistances[node] = Graph<T>::MAX_WEIGHT;
+        predecessors[node] = NOT_FOUND;
+    }
+
+    //Best incoming edges from outside the subtree
+    queue.initialize(nodeDistances.size(), 0);
+
+    for (NodeId node : affectedNodes) {
+        for (const Edge& edge : incoming[node]) {
+            if (affected[edge.target] || nodeDistances[edge.target] == Graph<T>::MAX_WEIGHT)
+                continue;
+
+            double distance = nodeDistances[edge.target] + edge.weight;
+            if (distance < nodeDistances[node]) {
+                nodeDistances[node] = distance;
+                predecessors[node] = edge.target;
+            }
+        }
+
+        if (nodeDistances[node] != Graph<T>::MAX_WEIGHT)
+            queue.push(node, nodeDistances[node]);
+    }
+
+    for (NodeId node : affectedNodes)
+        affected[node] = false;
+
+    propagate();
+
+    lastAffected += affectedNodes.size();
+}
+
+/**
+ * @brief Dijkstra visit from the nodes in the queue: a node is relaxed only
+ * if its distance improves, so the visit stops at the unchanged nodes
+ * @return Number of nodes settled by the visit
+ */
+template <class T>
+size_t DynamicShortestPaths<T>::propagate()
+{
+    size_t settled = 0;
+
+    while (!queue.empty()) {
+        double key;
+        NodeId node = queue.pop(key);
+
+        if (key > nodeDistances[node])
+            continue;
+
+        settled++;
+
+        for (const Edge& edge : graph.adjacentEdges(node)) {
+            double distance = key + edge.weight;
+            if (distance < nodeDistances[edge.target]) {
+                nodeDistances[edge.target] = distance;
+                predecessors[edge.target] = node;
+                queue.push(edge.target, distance);
+            }
+        }
+    }
+
+    return settled;
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_GRAPH_REORDERING_H
+#define CG3_GRAPH_REORDERING_H
+
+#include <vector>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+#include "extensions/data_structures/graphs/compiled_graph.h"
+
+namespace cg3 {
+
+/**
+ * @brief Order of the nodes used to reorder a graph. The orderings which
+ * visit the graph ignore the direction of the edges.
+ * - BFS_ORDER: breadth first visit of each component, in order of index
+ * - REVERSE_CUTHILL_MCKEE: breadth first visit from a node of minimum
+ *   degree, with the neighbors sorted by degree, then reversed
+ * - DEGREE_ORDER: nodes sorted by decreasing degree (hubs first)
+ * - PARTITION_ORDER: parts of a multilevel partition, each one in
+ *   Cuthill-McKee order
+ */
+enum NodeOrdering { BFS_ORDER, REVERSE_CUTHILL_MCKEE, DEGREE_ORDER, PARTITION_ORDER };
+
+
+/* Reordering */
+
+template <class T, class W>
+std::vector<size_t> nodeOrdering(
+        const CompiledGraph<T, W>& graph,
+        NodeOrdering ordering);
+
+template <class T, class W>
+CompiledGraph<T, W> reorder(
+        const CompiledGraph<T, W>& graph,
+        const std::vector<size_t>& order);
+
+template <class T, class W>
+CompiledGraph<T, W> reorder(
+        const CompiledGraph<T, W>& graph,
+        NodeOrdering ordering);
+
+template <class T>
+CompiledGraph<T> reorder(
+        const Graph<T>& graph,
+        NodeOrdering ordering);
+
+
+/* Partitioning */
+
+template <class T, class W>
+std::vector<size_t> partitionGraph(
+        const CompiledGraph<T, W>& graph,
+        size_t numParts);
+
+template <class T, class W>
+size_t edgeCut(
+        const CompiledGraph<T, W>& graph,
+        const std::vector<size_t>& parts);
+
+}
+
+#include "graph_reordering.tpp"
+
+#endif // CG3_GRAPH_REORDERING_H
@@ -0,0 +1,632 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "graph_reordering.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Number of nodes of each part of the partition used by PARTITION_ORDER
+ * (the distances and the edges of a part fit in the L2 cache) */
+static const size_t PARTITION_ORDER_PART_SIZE = 4096;
+
+/* The coarsening stops when the graph has at most this number of nodes
+ * for each part... */
+static const size_t COARSEST_NODES_PER_PART = 32;
+
+/* ...or when a level has more than this fraction of the nodes of the
+ * previous level */
+static const double COARSENING_MIN_REDUCTION = 0.9;
+
+/* Maximum weight of a coarse node, in nodes for each part of the
+ * coarsest graph */
+static const size_t COARSE_NODE_MAX_WEIGHT = 3;
+
+/* Maximum weight of a part, relative to the average weight */
+static const double PARTITION_IMBALANCE = 1.03;
+
+/* Maximum number of passes of the refinement at each level */
+static const size_t REFINEMENT_PASSES = 4;
+
+/* Node which has not been assigned (to a part, a match or a coarse node) */
+static const size_t UNASSIGNED = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief Undirected graph with weighted nodes and edges, used by the
+ * orderings and by the levels of the multilevel partitioning
+ */
+struct SymmetricGraph {
+    std::vector<size_t> offsets;
+    std::vector<size_t> neighbors;
+    std::vector<size_t> edgeWeights;
+    std::vector<size_t> nodeWeights;
+
+    size_t numNodes() const { return nodeWeights.size(); }
+    size_t degree(size_t node) const { return offsets[node + 1] - offsets[node]; }
+};
+
+template <class T, class W>
+void buildSymmetricGraph(
+        const CompiledGraph<T, W>& graph,
+        SymmetricGraph& symmetric);
+
+inline std::vector<size_t> breadthFirstOrder(
+        const SymmetricGraph& graph,
+        bool sortByDegree);
+
+inline void coarsenGraph(
+        const SymmetricGraph& fine,
+        size_t maxNodeWeight,
+        SymmetricGraph& coarse,
+        std::vector<size_t>& coarseNodes);
+
+inline void growPartition(
+        const SymmetricGraph& graph,
+        size_t numParts,
+        std::vector<size_t>& parts);
+
+inline void refinePartition(
+        const SymmetricGraph& graph,
+        size_t numParts,
+        std::vector<size_t>& parts);
+
+}
+
+
+/* ----- REORDERING ----- */
+
+/**
+ * @brief Compute an order of the nodes of a graph which improves the
+ * locality of its visits
+ * @param graph Input graph
+ * @param ordering Ordering to be computed
+ * @return Indices of the nodes in the new order: order[i] is the node
+ * which takes the index i
+ */
+template <class T, class W>
+std::vector<size_t> nodeOrdering(
+        const CompiledGraph<T, W>& graph,
+        NodeOrdering ordering)
+{
+    const size_t n = graph.numNodes();
+
+    if (ordering == DEGREE_ORDER) {
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&] (size_t a, size_t b) {
+            return graph.outDegree(a) + graph.inDegree(a) > graph.outDegree(b) + graph.inDegree(b);
+        });
+        return order;
+    }
+
+    internal::SymmetricGraph symmetric;
+    internal::buildSymmetricGraph(graph, symmetric);
+
+    if (ordering == BFS_ORDER)
+        return internal::breadthFirstOrder(symmetric, false);
+
+    std::vector<size_t> order = internal::breadthFirstOrder(symmetric, true);
+
+    if (ordering == REVERSE_CUTHILL_MCKEE) {
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    //Partition order: counting sort of the breadth first order by part
+    size_t numParts = (n + internal::PARTITION_ORDER_PART_SIZE - 1) / internal::PARTITION_ORDER_PART_SIZE;
+    std::vector<size_t> parts = partitionGraph(graph, numParts);
+
+    std::vector<size_t> partOffsets(numParts + 1, 0);
+    for (size_t i = 0; i < n; i++)
+        partOffsets[parts[i] + 1]++;
+    for (size_t p = 0; p < numParts; p++)
+        partOffsets[p + 1] += partOffsets[p];
+
+    std::vector<size_t> partitionOrder(n);
+    for (size_t node : order)
+        partitionOrder[partOffsets[parts[node]]++] = node;
+
+    return partitionOrder;
+}
+
+/**
+ * @brief Build a copy of a graph with the nodes in a given order. The
+ * outgoing edges of each node are sorted by target, so the visits of the
+ * new graph scan the nodes and the edges in order of memory.
+ * @param graph Input graph
+ * @param order Indices of the nodes in the new order (a permutation)
+ * @return Reordered graph: the node i is the node order[i] of the input
+ */
+template <class T, class W>
+CompiledGraph<T, W> reorder(
+        const CompiledGraph<T, W>& graph,
+        const std::vector<size_t>& order)
+{
+    const size_t n = graph.numNodes();
+
+    std::vector<size_t> ranks(n);
+    for (size_t i = 0; i < n; i++)
+        ranks[order[i]] = i;
+
+    std::vector<T> values;
+    std::vector<size_t> offsets, targets;
+    std::vector<double> weights;
+
+    values.reserve(n);
+    offsets.reserve(n + 1);
+    targets.reserve(graph.numEdges());
+    weights.reserve(graph.numEdges());
+    offsets.push_back(0);
+
+    std::vector<std::pair<size_t, double>> edges;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t node = order[i];
+        values.push_back(graph.value(node));
+
+        edges.clear();
+        for (size_t e = graph.edgeBegin(node); e < graph.edgeEnd(node); e++)
+            edges.push_back(std::make_pair(ranks[graph.target(e)], graph.weight(e)));
+        std::sort(edges.begin(), edges.end());
+
+        for (const std::pair<size_t, double>& edge : edges) {
+            targets.push_back(edge.first);
+            weights.push_back(edge.second);
+        }
+        offsets.push_back(targets.size());
+    }
+
+    return CompiledGraph<T, W>(values, offsets, targets, weights);
+}
+
+/**
+ * @brief Build a copy of a graph with the nodes in the given ordering
+ * @param graph Input graph
+ * @param ordering Ordering of the nodes
+ * @return Reordered graph
+ */
+template <class T, class W>
+CompiledGraph<T, W> reorder(
+        const CompiledGraph<T, W>& graph,
+        NodeOrdering ordering)
+{
+    return reorder(graph, nodeOrdering(graph, ordering));
+}
+
+/**
+ * @brief Compile a graph with the nodes in the given ordering (the storage
+ * of cg3::Graph cannot be permuted: the snapshot is reordered)
+ * @param graph Input graph
+ * @param ordering Ordering of the nodes
+ * @return Reordered compiled graph
+ */
+template <class T>
+CompiledGraph<T> reorder(
+        const Graph<T>& graph,
+        NodeOrdering ordering)
+{
+    return reorder(CompiledGraph<T>(graph), ordering);
+}
+
+
+
+/* ----- PARTITIONING ----- */
+
+/**
+ * @brief Split the nodes of a graph in parts of balanced size, cutting few
+ * edges (the direction and the weights of the edges are ignored).
+ *
+ * Multilevel scheme: the graph is coarsened by contracting a heavy edge
+ * matching until it has a few nodes for each part, the coarsest graph is
+ * partitioned by growing the parts with breadth first visits, then the
+ * partition is projected back to each finer level and refined by moving
+ * the boundary nodes which reduce the cut.
+ *
+ * @param graph Input graph
+ * @param numParts Number of parts
+ * @return Part of each node, in [0, numParts)
+ */
+template <class T, class W>
+std::vector<size_t> partitionGraph(
+        const CompiledGraph<T, W>& graph,
+        size_t numParts)
+{
+    const size_t n = graph.numNodes();
+
+    std::vector<size_t> parts(n, 0);
+    if (numParts <= 1 || n == 0)
+        return parts;
+
+    //Coarsening: levels[l + 1] is the contraction of levels[l]
+    std::vector<internal::SymmetricGraph> levels(1);
+    std::vector<std::vector<size_t>> coarseNodes;
+    internal::buildSymmetricGraph(graph, levels[0]);
+
+    const size_t maxNodeWeight = std::max((size_t) 1,
+            internal::COARSE_NODE_MAX_WEIGHT * n / (numParts * internal::COARSEST_NODES_PER_PART));
+
+    while (levels.back().numNodes() > numParts * internal::COARSEST_NODES_PER_PART) {
+        size_t fineNodes = levels.back().numNodes();
+
+        levels.push_back(internal::SymmetricGraph());
+        coarseNodes.push_back(std::vector<size_t>());
+        internal::coarsenGraph(levels[levels.size() - 2], maxNodeWeight, levels.back(), coarseNodes.back());
+
+        if (levels.back().numNodes() > fineNodes * internal::COARSENING_MIN_REDUCTION)
+            break;
+    }
+
+    //Partition of the coarsest graph, then projection and refinement
+    std::vector<size_t> levelParts;
+    internal::growPartition(levels.back(), numParts, levelParts);
+    internal::refinePartition(levels.back(), numParts, levelParts);
+
+    for (size_t l = coarseNodes.size(); l > 0; l--) {
+        std::vector<size_t> fineParts(levels[l - 1].numNodes());
+        for (size_t i = 0; i < fineParts.size(); i++)
+            fineParts[i] = levelParts[coarseNodes[l - 1][i]];
+
+        levelParts.swap(fineParts);
+        internal::refinePartition(levels[l - 1], numParts, levelParts);
+    }
+
+    return levelParts;
+}
+
+/**
+ * @brief Count the edges whose nodes are in different parts
+ * @param graph Input graph
+ * @param parts Part of each node
+ * @return Number of (directed) edges cut by the partition
+ */
+template <class T, class W>
+size_t edgeCut(
+        const CompiledGraph<T, W>& graph,
+        const std::vector<size_t>& parts)
+{
+    size_t cut = 0;
+    for (size_t i = 0; i < graph.numNodes(); i++) {
+        for (size_t e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+            if (parts[graph.target(e)] != parts[i])
+                cut++;
+        }
+    }
+    return cut;
+}
+
+
+
+namespace internal {
+
+/**
+ * @brief Build the undirected version of a graph: the neighbors of a node
+ * are its targets and its sources, the weight of an edge is the number of
+ * edges between its nodes. Self loops are removed.
+ */
+template <class T, class W>
+void buildSymmetricGraph(
+        const CompiledGraph<T, W>& graph,
+        SymmetricGraph& symmetric)
+{
+    const size_t n = graph.numNodes();
+
+    symmetric.offsets.assign(1, 0);
+    symmetric.offsets.reserve(n + 1);
+    symmetric.neighbors.clear();
+    symmetric.neighbors.reserve(2 * graph.numEdges());
+    symmetric.edgeWeights.clear();
+    symmetric.edgeWeights.reserve(2 * graph.numEdges());
+    symmetric.nodeWeights.assign(n, 1);
+
+    std::vector<size_t> adjacent;
+
+    for (size_t i = 0; i < n; i++) {
+        adjacent.clear();
+        for (size_t e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+            if (graph.target(e) != i)
+                adjacent.push_back(graph.target(e));
+        }
+        for (size_t e = graph.reverseEdgeBegin(i); e < graph.reverseEdgeEnd(i); e++) {
+            if (graph.source(e) != i)
+                adjacent.push_back(graph.source(e));
+        }
+        std::sort(adjacent.begin(), adjacent.end());
+
+        for (size_t j = 0; j < adjacent.size(); j++) {
+            if (j > 0 && adjacent[j] == adjacent[j - 1]) {
+                symmetric.edgeWeights.back()++;
+            }
+            else {
+                symmetric.neighbors.push_back(adjacent[j]);
+                symmetric.edgeWeights.push_back(1);
+            }
+        }
+        symmetric.offsets.push_back(symmetric.neighbors.size());
+    }
+}
+
+/**
+ * @brief Breadth first order of all the nodes of a graph. Without sorting,
+ * the components are visited from their node of minimum index and the
+ * neighbors in order of index; otherwise (Cuthill-McKee) each component
+ * is visited from a node of minimum degree, and the neighbors of each node
+ * are visited in order of degree.
+ */
+inline std::vector<size_t> breadthFirstOrder(
+        const SymmetricGraph& graph,
+        bool sortByDegree)
+{
+    const size_t n = graph.numNodes();
+
+    std::vector<size_t> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+
+    auto degreeLess = [&] (size_t a, size_t b) {
+        return graph.degree(a) < graph.degree(b);
+    };
+
+    if (sortByDegree)
+        std::stable_sort(starts.begin(), starts.end(), degreeLess);
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+
+    for (size_t start : starts) {
+        if (visited[start])
+            continue;
+
+        visited[start] = true;
+        order.push_back(start);
+
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            size_t node = order[head];
+            size_t first = order.size();
+
+            for (size_t e = graph.offsets[node]; e < graph.offsets[node + 1]; e++) {
+                size_t neighbor = graph.neighbors[e];
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    order.push_back(neighbor);
+                }
+            }
+
+            if (sortByDegree)
+                std::stable_sort(order.begin() + first, order.end(), degreeLess);
+        }
+    }
+
+    return order;
+}
+
+/**
+ * @brief Contract a heavy edge matching of a graph: the nodes, in order of
+ * degree, are matched with the unmatched neighbor connected by the heaviest
+ * edge (if the weight of the coarse node does not exceed maxNodeWeight).
+ * @param[in] fine Graph to be coarsened
+ * @param[in] maxNodeWeight Maximum weight of a coarse node
+ * @param[out] coarse Coarse graph: node and edge weights are the sums of
+ * the contracted ones
+ * @param[out] coarseNodes Coarse node of each node of the fine graph
+ */
+inline void coarsenGraph(
+        const SymmetricGraph& fine,
+        size_t maxNodeWeight,
+        SymmetricGraph& coarse,
+        std::vector<size_t>& coarseNodes)
+{
+    const size_t n = fine.numNodes();
+
+    std::vector<size_t> visitOrder(n);
+    std::iota(visitOrder.begin(), visitOrder.end(), 0);
+    std::stable_sort(visitOrder.begin(), visitOrder.end(), [&] (size_t a, size_t b) {
+        return fine.degree(a) < fine.degree(b);
+    });
+
+    //Heavy edge matching (unmatched nodes are matched with themselves)
+    std::vector<size_t> matches(n, UNASSIGNED);
+    for (size_t node : visitOrder) {
+        if (matches[node] != UNASSIGNED)
+            continue;
+
+        size_t match = node;
+        size_t matchWeight = 0;
+        for (size_t e = fine.offsets[node]; e < fine.offsets[node + 1]; e++) {
+            size_t neighbor = fine.neighbors[e];
+            if (matches[neighbor] == UNASSIGNED &&
+                    fine.edgeWeights[e] > matchWeight &&
+                    fine.nodeWeights[node] + fine.nodeWeights[neighbor] <= maxNodeWeight)
+            {
+                match = neighbor;
+                matchWeight = fine.edgeWeights[e];
+            }
+        }
+
+        matches[node] = match;
+        matches[match] = node;
+    }
+
+    //Coarse nodes, numbered in order of their first fine node
+    coarseNodes.assign(n, UNASSIGNED);
+    size_t numCoarse = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (coarseNodes[i] == UNASSIGNED) {
+            coarseNodes[i] = numCoarse;
+            coarseNodes[matches[i]] = numCoarse;
+            numCoarse++;
+        }
+    }
+
+    coarse.nodeWeights.assign(numCoarse, 0);
+    for (size_t i = 0; i < n; i++)
+        coarse.nodeWeights[coarseNodes[i]] += fine.nodeWeights[i];
+
+    //Coarse edges: the edges of the two fine nodes, merged
+    coarse.offsets.assign(1, 0);
+    coarse.offsets.reserve(numCoarse + 1);
+    coarse.neighbors.clear();
+    coarse.edgeWeights.clear();
+
+    std::vector<size_t> positions(numCoarse, UNASSIGNED);
+
+    for (size_t i = 0; i < n; i++) {
+        if (matches[i] < i)
+            continue;
+
+        const size_t coarseNode = coarseNodes[i];
+        const size_t first = coarse.neighbors.size();
+        const size_t members[] = { i, matches[i] };
+
+        for (size_t m = 0; m < (matches[i] == i ? 1 : 2); m++) {
+            size_t node = members[m];
+            for (size_t e = fine.offsets[node]; e < fine.offsets[node + 1]; e++) {
+                size_t neighbor = coarseNodes[fine.neighbors[e]];
+                if (neighbor == coarseNode)
+                    continue;
+
+                if (positions[neighbor] != UNASSIGNED && positions[neighbor] >= first) {
+                    coarse.edgeWeights[positions[neighbor]] += fine.edgeWeights[e];
+                }
+                else {
+                    positions[neighbor] = coarse.neighbors.size();
+                    coarse.neighbors.push_back(neighbor);
+                    coarse.edgeWeights.push_back(fine.edgeWeights[e]);
+                }
+            }
+        }
+
+        coarse.offsets.push_back(coarse.neighbors.size());
+    }
+}
+
+/**
+ * @brief Initial partition: each part is grown with a breadth first visit
+ * (from the first unassigned node) until it reaches its share of the
+ * remaining weight
+ */
+inline void growPartition(
+        const SymmetricGraph& graph,
+        size_t numParts,
+        std::vector<size_t>& parts)
+{
+    const size_t n = graph.numNodes();
+
+    parts.assign(n, UNASSIGNED);
+
+    size_t remainingWeight = std::accumulate(graph.nodeWeights.begin(), graph.nodeWeights.end(), (size_t) 0);
+    size_t seed = 0;
+    std::vector<size_t> queue;
+
+    for (size_t p = 0; p < numParts; p++) {
+        const size_t targetWeight = remainingWeight / (numParts - p);
+        size_t partWeight = 0;
+        size_t head = 0;
+        queue.clear();
+
+        while (partWeight < targetWeight) {
+            //New seed when the visit is finished (disconnected graphs)
+            if (head == queue.size()) {
+                while (seed < n && parts[seed] != UNASSIGNED)
+                    seed++;
+                if (seed == n)
+                    break;
+
+                parts[seed] = p;
+                partWeight += graph.nodeWeights[seed];
+                queue.push_back(seed);
+                continue;
+            }
+
+            size_t node = queue[head++];
+            for (size_t e = graph.offsets[node]; e < graph.offsets[node + 1] && partWeight < targetWeight; e++) {
+                size_t neighbor = graph.neighbors[e];
+                if (parts[neighbor] == UNASSIGNED) {
+                    parts[neighbor] = p;
+                    partWeight += graph.nodeWeights[neighbor];
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        remainingWeight -= partWeight;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (parts[i] == UNASSIGNED)
+            parts[i] = numParts - 1;
+    }
+}
+
+/**
+ * @brief Greedy refinement: each node is moved to the adjacent part which
+ * reduces the cut the most, if that part does not exceed the maximum
+ * weight. The passes stop when no node is moved.
+ */
+inline void refinePartition(
+        const SymmetricGraph& graph,
+        size_t numParts,
+        std::vector<size_t>& parts)
+{
+    const size_t n = graph.numNodes();
+
+    std::vector<size_t> partWeights(numParts, 0);
+    for (size_t i = 0; i < n; i++)
+        partWeights[parts[i]] += graph.nodeWeights[i];
+
+    const size_t totalWeight = std::accumulate(partWeights.begin(), partWeights.end(), (size_t) 0);
+    const size_t maxPartWeight = (size_t) (PARTITION_IMBALANCE * totalWeight / numParts) + 1;
+
+    //Weight of the edges from the current node to each part
+    std::vector<size_t> connections(numParts, 0);
+    std::vector<size_t> adjacentParts;
+
+    for (size_t pass = 0; pass < REFINEMENT_PASSES; pass++) {
+        size_t moved = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            const size_t part = parts[i];
+
+            adjacentParts.clear();
+            for (size_t e = graph.offsets[i]; e < graph.offsets[i + 1]; e++) {
+                size_t neighborPart = parts[graph.neighbors[e]];
+                if (connections[neighborPart] == 0)
+                    adjacentParts.push_back(neighborPart);
+                connections[neighborPart] += graph.edgeWeights[e];
+            }
+
+            size_t bestPart = part;
+            size_t bestConnection = connections[part];
+            for (size_t adjacentPart : adjacentParts) {
+                if (connections[adjacentPart] > bestConnection &&
+                        partWeights[adjacentPart] + graph.nodeWeights[i] <= maxPartWeight)
+                {
+                    bestPart = adjacentPart;
+                    bestConnection = connections[adjacentPart];
+                }
+            }
+
+            for (size_t adjacentPart : adjacentParts)
+                connections[adjacentPart] = 0;
+
+            if (bestPart != part) {
+                parts[i] = bestPart;
+                partWeights[part] -= graph.nodeWeights[i];
+                partWeights[bestPart] += graph.nodeWeights[i];
+                moved++;
+            }
+        }
+
+        if (moved == 0)
+            break;
+    }
+}
+
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_GRAPH_TRAVERSAL_H
+#define CG3_GRAPH_TRAVERSAL_H
+
+#include <vector>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+#include "extensions/data_structures/graphs/compiled_graph.h"
+
+namespace cg3 {
+
+/**
+ * @brief Algorithm used to compute the strongly connected components
+ */
+enum SCCAlgorithm { TARJAN, KOSARAJU };
+
+
+/* Breadth first search */
+
+template <class T, class W>
+void bfs(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        std::vector<size_t>& levels,
+        std::vector<size_t>& parents,
+        unsigned int nThreads = 0);
+
+
+/* Connected components */
+
+template <class T, class W>
+size_t connectedComponents(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components,
+        unsigned int nThreads = 0);
+
+template <class T>
+std::vector<std::vector<T>> connectedComponents(
+        const Graph<T>& graph,
+        unsigned int nThreads = 0);
+
+
+/* Strongly connected components */
+
+template <class T, class W>
+size_t stronglyConnectedComponents(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components,
+        SCCAlgorithm algorithm = TARJAN);
+
+template <class T>
+std::vector<std::vector<T>> stronglyConnectedComponents(
+        const Graph<T>& graph,
+        SCCAlgorithm algorithm = TARJAN);
+
+}
+
+#include "graph_traversal.tpp"
+
+#endif // CG3_GRAPH_TRAVERSAL_H
@@ -0,0 +1,580 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "graph_traversal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Number of nodes (or frontier nodes) assigned to a thread at a time */
+static const size_t TRAVERSAL_CHUNK_SIZE = 1024;
+
+/* Direction-optimizing BFS: switch to bottom-up when the edges of the
+ * frontier are more than 1/ALPHA of the unexplored edges, switch back to
+ * top-down when the frontier has less than 1/BETA of the nodes */
+static const size_t BFS_ALPHA = 14;
+static const size_t BFS_BETA = 24;
+
+/* Afforest: number of neighbors of each node linked before sampling the
+ * largest component, and number of sampled nodes */
+static const size_t AFFOREST_NEIGHBOR_ROUNDS = 2;
+static const size_t AFFOREST_SAMPLES = 1024;
+
+inline void afforestLink(
+        std::vector<std::atomic<size_t>>& components,
+        size_t u,
+        size_t v);
+
+inline void afforestCompress(
+        std::vector<std::atomic<size_t>>& components,
+        size_t node);
+
+template <class T, class W>
+size_t tarjan(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components);
+
+template <class T, class W>
+size_t kosaraju(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components);
+
+template <class T, class W>
+std::vector<std::vector<T>> groupComponents(
+        const CompiledGraph<T, W>& graph,
+        const std::vector<size_t>& components,
+        size_t numComponents);
+
+}
+
+
+/* ----- BREADTH FIRST SEARCH ----- */
+
+/**
+ * @brief Parallel direction-optimizing breadth first search on a compiled
+ * graph. Each level is visited top-down (the edges of the frontier nodes
+ * are scanned) when the frontier is small, or bottom-up (the unvisited
+ * nodes look for a parent in the frontier through their incoming edges)
+ * when the frontier is large, which avoids scanning most of the edges of
+ * low diameter graphs.
+ * @param[in] graph Input graph
+ * @param[in] source Index of the source node
+ * @param[out] levels Number of edges of the shortest path from the source
+ * to each node (NOT_FOUND for unreachable nodes)
+ * @param[out] parents Parent of each node in the BFS tree (NOT_FOUND for
+ * the source and the unreachable nodes). With more than one thread the
+ * tree may change between executions, the levels do not.
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <class T, class W>
+void bfs(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        std::vector<size_t>& levels,
+        std::vector<size_t>& parents,
+        unsigned int nThreads)
+{
+    const size_t notFound = CompiledGraph<T, W>::NOT_FOUND;
+    const size_t n = graph.numNodes();
+
+    nThreads = numberOfThreads(nThreads);
+
+    levels.assign(n, notFound);
+    parents.assign(n, notFound);
+
+    if (source >= n)
+        return;
+
+    //The parent of the source is the source itself during the visit
+    std::vector<std::atomic<size_t>> visitParents(n);
+    parallelFor(n, [&] (size_t i) {
+        visitParents[i].store(notFound, std::memory_order_relaxed);
+    }, nThreads);
+
+    visitParents[source].store(source, std::memory_order_relaxed);
+    levels[source] = 0;
+
+    std::vector<size_t> frontier(1, source);
+    std::vector<char> frontierMap;
+    std::vector<char> nextMap;
+
+    std::vector<std::vector<size_t>> localFrontiers(nThreads);
+    std::vector<size_t> localEdges(nThreads);
+
+    size_t frontierEdges = graph.outDegree(source);
+    size_t uncheckedEdges = graph.numEdges();
+    bool bottomUp = false;
+
+    for (size_t level = 1; !frontier.empty(); level++) {
+        //Choose the direction of the step
+        if (!bottomUp && frontierEdges > uncheckedEdges / internal::BFS_ALPHA) {
+            bottomUp = true;
+
+            frontierMap.assign(n, 0);
+            for (size_t node : frontier)
+                frontierMap[node] = 1;
+        }
+        else if (bottomUp && frontier.size() < n / internal::BFS_BETA) {
+            bottomUp = false;
+        }
+
+        for (unsigned int t = 0; t < nThreads; t++) {
+            localFrontiers[t].clear();
+            localEdges[t] = 0;
+        }
+
+        if (!bottomUp) {
+            //Top-down step: the first thread which reaches a node claims it
+            parallelForChunks(frontier.size(), internal::TRAVERSAL_CHUNK_SIZE,
+                [&] (unsigned int thread, size_t, size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        size_t u = frontier[i];
+                        for (size_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                            size_t v = graph.target(e);
+                            size_t expected = notFound;
+
+                            if (visitParents[v].load(std::memory_order_relaxed) == notFound &&
+                                    visitParents[v].compare_exchange_strong(expected, u, std::memory_order_relaxed))
+                            {
+                                levels[v] = level;
+                                localFrontiers[thread].push_back(v);
+                                localEdges[thread] += graph.outDegree(v);
+                            }
+                        }
+                    }
+            }, nThreads);
+        }
+        else {
+            //Bottom-up step: each unvisited node is processed by a single thread
+            nextMap.assign(n, 0);
+
+            parallelForChunks(n, internal::TRAVERSAL_CHUNK_SIZE,
+                [&] (unsigned int thread, size_t, size_t begin, size_t end) {
+                    for (size_t v = begin; v < end; v++) {
+                        if (visitParents[v].load(std::memory_order_relaxed) != notFound)
+                            continue;
+
+                        for (size_t e = graph.reverseEdgeBegin(v); e < graph.reverseEdgeEnd(v); e++) {
+                            size_t u = graph.source(e);
+                            if (frontierMap[u]) {
+                                visitParents[v].store(u, std::memory_order_relaxed);
+                                levels[v] = level;
+                                nextMap[v] = 1;
+                                localFrontiers[thread].push_back(v);
+                                localEdges[thread] += graph.outDegree(v);
+                                break;
+                            }
+                        }
+                    }
+            }, nThreads);
+
+            frontierMap.swap(nextMap);
+        }
+
+        //Next frontier
+        frontier.clear();
+        frontierEdges = 0;
+        for (unsigned int t = 0; t < nThreads; t++) {
+            frontier.insert(frontier.end(), localFrontiers[t].begin(), localFrontiers[t].end());
+            frontierEdges += localEdges[t];
+        }
+        uncheckedEdges -= std::min(uncheckedEdges, frontierEdges);
+    }
+
+    for (size_t i = 0; i < n; i++)
+        parents[i] = visitParents[i].load(std::memory_order_relaxed);
+    parents[source] = notFound;
+}
+
+
+
+/* ----- CONNECTED COMPONENTS ----- */
+
+/**
+ * @brief Connected components of a compiled graph (weakly connected
+ * components for directed graphs), computed with the Afforest algorithm:
+ * a parallel union-find first links a few neighbors of each node, then
+ * samples the largest component and links the remaining edges only for
+ * the nodes which are not in it.
+ * @param[in] graph Input graph
+ * @param[out] components Index of the component of each node (components
+ * are numbered in order of their first node)
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Number of components
+ */
+template <class T, class W>
+size_t connectedComponents(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components,
+        unsigned int nThreads)
+{
+    const size_t n = graph.numNodes();
+
+    components.assign(n, 0);
+    if (n == 0)
+        return 0;
+
+    std::vector<std::atomic<size_t>> parents(n);
+    parallelFor(n, [&] (size_t i) {
+        parents[i].store(i, std::memory_order_relaxed);
+    }, nThreads);
+
+    //Link the first neighbors of each node
+    for (size_t round = 0; round < internal::AFFOREST_NEIGHBOR_ROUNDS; round++) {
+        parallelForChunks(n, internal::TRAVERSAL_CHUNK_SIZE,
+            [&] (unsigned int, size_t, size_t begin, size_t end) {
+                for (size_t u = begin; u < end; u++) {
+                    size_t e = graph.edgeBegin(u) + round;
+                    if (e < graph.edgeEnd(u))
+                        internal::afforestLink(parents, u, graph.target(e));
+                }
+        }, nThreads);
+
+        parallelFor(n, [&] (size_t i) {
+            internal::afforestCompress(parents, i);
+        }, nThreads);
+    }
+
+    //Most frequent component in a sample of the nodes
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<size_t> distNode(0, n - 1);
+
+    std::vector<size_t> sample(internal::AFFOREST_SAMPLES);
+    for (size_t& node : sample)
+        node = parents[distNode(rng)].load(std::memory_order_relaxed);
+    std::sort(sample.begin(), sample.end());
+
+    size_t largest = sample[0];
+    size_t largestCount = 0;
+    for (size_t i = 0, j = 0; i < sample.size(); i = j) {
+        while (j < sample.size() && sample[j] == sample[i])
+            j++;
+        if (j - i > largestCount) {
+            largest = sample[i];
+            largestCount = j - i;
+        }
+    }
+
+    //Link the remaining edges of the nodes which are not in the largest component
+    parallelForChunks(n, internal::TRAVERSAL_CHUNK_SIZE,
+        [&] (unsigned int, size_t, size_t begin, size_t end) {
+            for (size_t u = begin; u < end; u++) {
+                if (parents[u].load(std::memory_order_relaxed) == largest)
+                    continue;
+
+                for (size_t e = graph.edgeBegin(u) + internal::AFFOREST_NEIGHBOR_ROUNDS; e < graph.edgeEnd(u); e++)
+                    internal::afforestLink(parents, u, graph.target(e));
+                for (size_t e = graph.reverseEdgeBegin(u); e < graph.reverseEdgeEnd(u); e++)
+                    internal::afforestLink(parents, u, graph.source(e));
+            }
+    }, nThreads);
+
+    parallelFor(n, [&] (size_t i) {
+        internal::afforestCompress(parents, i);
+    }, nThreads);
+
+    //Dense component indices
+    const size_t notFound = CompiledGraph<T, W>::NOT_FOUND;
+    std::vector<size_t> labels(n, notFound);
+    size_t numComponents = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t root = parents[i].load(std::memory_order_relaxed);
+        if (labels[root] == notFound)
+            labels[root] = numComponents++;
+        components[i] = labels[root];
+    }
+
+    return numComponents;
+}
+
+/**
+ * @brief Connected components of a graph (see the compiled graph version)
+ * @param[in] graph Input graph
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Values of the nodes of each component
+ */
+template <class T>
+std::vector<std::vector<T>> connectedComponents(
+        const Graph<T>& graph,
+        unsigned int nThreads)
+{
+    CompiledGraph<T> compiledGraph(graph);
+
+    std::vector<size_t> components;
+    size_t numComponents = connectedComponents(compiledGraph, components, nThreads);
+
+    return internal::groupComponents(compiledGraph, components, numComponents);
+}
+
+
+
+/* ----- STRONGLY CONNECTED COMPONENTS ----- */
+
+/**
+ * @brief Strongly connected components of a compiled graph, computed
+ * with the Tarjan algorithm (a single depth first visit) or with the
+ * Kosaraju algorithm (a depth first visit of the graph and one of the
+ * reverse graph). Both the visits are iterative.
+ * @param[in] graph Input graph
+ * @param[out] components Index of the component of each node
+ * @param[in] algorithm Algorithm to be used
+ * @return Number of components
+ */
+template <class T, class W>
+size_t stronglyConnectedComponents(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components,
+        SCCAlgorithm algorithm)
+{
+    if (algorithm == KOSARAJU)
+        return internal::kosaraju(graph, components);
+
+    return internal::tarjan(graph, components);
+}
+
+/**
+ * @brief Strongly connected components of a graph (see the compiled graph version)
+ * @param[in] graph Input graph
+ * @param[in] algorithm Algorithm to be used
+ * @return Values of the nodes of each component
+ */
+template <class T>
+std::vector<std::vector<T>> stronglyConnectedComponents(
+        const Graph<T>& graph,
+        SCCAlgorithm algorithm)
+{
+    CompiledGraph<T> compiledGraph(graph);
+
+    std::vector<size_t> components;
+    size_t numComponents = stronglyConnectedComponents(compiledGraph, components, algorithm);
+
+    return internal::groupComponents(compiledGraph, components, numComponents);
+}
+
+
+
+namespace internal {
+
+/**
+ * @brief Link the trees of two nodes: the root with the greater index is
+ * attached to the other one with a compare and swap, so concurrent links
+ * never create cycles
+ */
+inline void afforestLink(
+        std::vector<std::atomic<size_t>>& components,
+        size_t u,
+        size_t v)
+{
+    size_t p1 = components[u].load(std::memory_order_relaxed);
+    size_t p2 = components[v].load(std::memory_order_relaxed);
+
+    while (p1 != p2) {
+        size_t high = std::max(p1, p2);
+        size_t low = std::min(p1, p2);
+        size_t highParent = components[high].load(std::memory_order_relaxed);
+
+        if (highParent == low)
+            break;
+        if (highParent == high && components[high].compare_exchange_strong(highParent, low, std::memory_order_relaxed))
+            break;
+
+        p1 = components[components[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+        p2 = components[low].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Path compression: the parent of the node becomes the root of its tree
+ */
+inline void afforestCompress(
+        std::vector<std::atomic<size_t>>& components,
+        size_t node)
+{
+    size_t parent = components[node].load(std::memory_order_relaxed);
+    size_t grandParent = components[parent].load(std::memory_order_relaxed);
+
+    while (parent != grandParent) {
+        components[node].store(grandParent, std::memory_order_relaxed);
+        parent = grandParent;
+        grandParent = components[parent].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Tarjan algorithm with an explicit stack of pairs node/next edge
+ */
+template <class T, class W>
+size_t tarjan(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components)
+{
+    const size_t notFound = CompiledGraph<T, W>::NOT_FOUND;
+    const size_t n = graph.numNodes();
+
+    components.assign(n, notFound);
+
+    std::vector<size_t> indices(n, notFound);
+    std::vector<size_t> lowLinks(n, 0);
+    std::vector<size_t> stack;
+    std::vector<std::pair<size_t, size_t>> callStack;
+
+    size_t nextIndex = 0;
+    size_t numComponents = 0;
+
+    for (size_t root = 0; root < n; root++) {
+        if (indices[root] != notFound)
+            continue;
+
+        indices[root] = lowLinks[root] = nextIndex++;
+        stack.push_back(root);
+        callStack.push_back(std::make_pair(root, graph.edgeBegin(root)));
+
+        while (!callStack.empty()) {
+            size_t v = callStack.back().first;
+            size_t e = callStack.back().second;
+
+            if (e < graph.edgeEnd(v)) {
+                callStack.back().second++;
+
+                size_t w = graph.target(e);
+                if (indices[w] == notFound) {
+                    indices[w] = lowLinks[w] = nextIndex++;
+                    stack.push_back(w);
+                    callStack.push_back(std::make_pair(w, graph.edgeBegin(w)));
+                }
+                else if (components[w] == notFound) {
+                    //w is on the stack
+                    lowLinks[v] = std::min(lowLinks[v], indices[w]);
+                }
+            }
+            else {
+                callStack.pop_back();
+                if (!callStack.empty()) {
+                    size_t parent = callStack.back().first;
+                    lowLinks[parent] = std::min(lowLinks[parent], lowLinks[v]);
+                }
+
+                if (lowLinks[v] == indices[v]) {
+                    size_t w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        components[w] = numComponents;
+                    } while (w != v);
+
+                    numComponents++;
+                }
+            }
+        }
+    }
+
+    return numComponents;
+}
+
+/**
+ * @brief Kosaraju algorithm: nodes are sorted by finishing time of a depth
+ * first visit, then the reverse graph is visited in reverse order
+ */
+template <class T, class W>
+size_t kosaraju(
+        const CompiledGraph<T, W>& graph,
+        std::vector<size_t>& components)
+{
+    const size_t notFound = CompiledGraph<T, W>::NOT_FOUND;
+    const size_t n = graph.numNodes();
+
+    //Finishing order
+    std::vector<size_t> order;
+    order.reserve(n);
+
+    std::vector<bool> visited(n, false);
+    std::vector<std::pair<size_t, size_t>> callStack;
+
+    for (size_t root = 0; root < n; root++) {
+        if (visited[root])
+            continue;
+
+        visited[root] = true;
+        callStack.push_back(std::make_pair(root, graph.edgeBegin(root)));
+
+        while (!callStack.empty()) {
+            size_t v = callStack.back().first;
+            size_t e = callStack.back().second;
+
+            if (e < graph.edgeEnd(v)) {
+                callStack.back().second++;
+
+                size_t w = graph.target(e);
+                if (!visited[w]) {
+                    visited[w] = true;
+                    callStack.push_back(std::make_pair(w, graph.edgeBegin(w)));
+                }
+            }
+            else {
+                callStack.pop_back();
+                order.push_back(v);
+            }
+        }
+    }
+
+    //Visit of the reverse graph
+    components.assign(n, notFound);
+
+    std::vector<size_t> stack;
+    size_t numComponents = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        size_t root = order[i - 1];
+        if (components[root] != notFound)
+            continue;
+
+        components[root] = numComponents;
+        stack.push_back(root);
+
+        while (!stack.empty()) {
+            size_t v = stack.back();
+            stack.pop_back();
+
+            for (size_t e = graph.reverseEdgeBegin(v); e < graph.reverseEdgeEnd(v); e++) {
+                size_t w = graph.source(e);
+                if (components[w] == notFound) {
+                    components[w] = numComponents;
+                    stack.push_back(w);
+                }
+            }
+        }
+
+        numComponents++;
+    }
+
+    return numComponents;
+}
+
+/**
+ * @brief Values of the nodes of each component
+ */
+template <class T, class W>
+std::vector<std::vector<T>> groupComponents(
+        const CompiledGraph<T, W>& graph,
+        const std::vector<size_t>& components,
+        size_t numComponents)
+{
+    std::vector<std::vector<T>> result(numComponents);
+    for (size_t i = 0; i < components.size(); i++)
+        result[components[i]].push_back(graph.value(i));
+
+    return result;
+}
+
+}
+
+}
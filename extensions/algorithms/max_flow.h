@@ -0,0 +1,70 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_MAX_FLOW_H
+#define CG3_MAX_FLOW_H
+
+#include <vector>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+#include "extensions/data_structures/graphs/compiled_graph.h"
+
+namespace cg3 {
+
+/**
+ * @brief Algorithm used to compute the maximum flow
+ * - PUSH_RELABEL: highest label push-relabel, with global relabeling and
+ *   gap heuristic
+ * - BOYKOV_KOLMOGOROV: augmenting paths on two search trees which are
+ *   reused between augmentations (fast on grid graphs of vision and
+ *   geometry processing)
+ */
+enum MaxFlowAlgorithm { PUSH_RELABEL, BOYKOV_KOLMOGOROV };
+
+/**
+ * @brief Flow on an edge: N is the type of the nodes
+ */
+template <class N>
+struct FlowEdge {
+    N source;
+    N target;
+    double flow;
+};
+
+/**
+ * @brief Maximum flow between two nodes of a graph and the minimum cut
+ */
+template <class T>
+struct MaxFlowResult {
+    double flow; //Value of the flow
+    std::vector<FlowEdge<T>> edgeFlows; //Edges with positive flow
+    std::vector<T> sourceSide; //Nodes on the side of the source of the cut
+    std::vector<T> sinkSide; //Nodes on the side of the sink of the cut
+};
+
+
+/* Maximum flow */
+
+template <class T, class W>
+double maxFlow(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        size_t sink,
+        std::vector<double>& flows,
+        std::vector<bool>& sourceSide,
+        MaxFlowAlgorithm algorithm = PUSH_RELABEL);
+
+template <class T>
+MaxFlowResult<T> maxFlow(
+        const Graph<T>& graph,
+        const T& source,
+        const T& sink,
+        MaxFlowAlgorithm algorithm = PUSH_RELABEL);
+
+}
+
+#include "max_flow.tpp"
+
+#endif // CG3_MAX_FLOW_H
@@ -0,0 +1,696 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "max_flow.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Push-relabel: number of relabels, relative to the number of nodes,
+ * between two global relabelings */
+static const double GLOBAL_RELABEL_FREQUENCY = 1.0;
+
+/* Arc which does not exist */
+static const size_t NO_ARC = std::numeric_limits<size_t>::max();
+
+/* Push-relabel: end of the lists of the nodes of a height */
+static const size_t NO_NODE = std::numeric_limits<size_t>::max();
+
+/* Boykov-Kolmogorov: parent arc of the terminals */
+static const size_t TERMINAL_ARC = std::numeric_limits<size_t>::max() - 1;
+
+/* Boykov-Kolmogorov: trees of the nodes */
+static const unsigned char FREE_NODE = 0;
+static const unsigned char SOURCE_TREE = 1;
+static const unsigned char SINK_TREE = 2;
+
+/**
+ * @brief Residual network: each edge is an arc with its capacity, paired
+ * with a reverse arc of capacity 0. The arcs of a node (outgoing and
+ * reverse) are contiguous.
+ */
+struct FlowNetwork {
+    std::vector<size_t> offsets;
+    std::vector<size_t> heads;
+    std::vector<size_t> reverses;
+    std::vector<double> capacities; //Residual capacities
+    std::vector<size_t> edgeArcs; //Arc of each edge of the graph (NO_ARC for self loops)
+
+    size_t numNodes() const { return offsets.size() - 1; }
+};
+
+template <class T, class W>
+void buildFlowNetwork(
+        const CompiledGraph<T, W>& graph,
+        FlowNetwork& network);
+
+inline double pushRelabel(
+        FlowNetwork& network,
+        size_t source,
+        size_t sink);
+
+inline void globalRelabel(
+        const FlowNetwork& network,
+        size_t source,
+        size_t sink,
+        std::vector<size_t>& heights);
+
+inline double boykovKolmogorov(
+        FlowNetwork& network,
+        size_t source,
+        size_t sink,
+        std::vector<bool>& sourceSide);
+
+inline void residualReachable(
+        const FlowNetwork& network,
+        size_t source,
+        std::vector<bool>& reached);
+
+}
+
+
+/* ----- MAXIMUM FLOW ----- */
+
+/**
+ * @brief Compute the maximum flow between two nodes of a compiled graph,
+ * whose weights are the capacities of the edges (they must be non-negative),
+ * and the minimum cut which separates them.
+ * @param[in] graph Input graph
+ * @param[in] source Index of the source node
+ * @param[in] sink Index of the sink node
+ * @param[out] flows Flow on each edge of the graph
+ * @param[out] sourceSide For each node, true if it is on the side of the
+ * source of the minimum cut
+ * @param[in] algorithm Algorithm to be used
+ * @return Value of the maximum flow (capacity of the minimum cut)
+ */
+template <class T, class W>
+double maxFlow(
+        const CompiledGraph<T, W>& graph,
+        size_t source,
+        size_t sink,
+        std::vector<double>& flows,
+        std::vector<bool>& sourceSide,
+        MaxFlowAlgorithm algorithm)
+{
+    const size_t n = graph.numNodes();
+
+    flows.assign(graph.numEdges(), 0);
+    sourceSide.assign(n, false);
+
+    if (source >= n || sink >= n || source == sink) {
+        if (source < n)
+            sourceSide[source] = true;
+        return 0;
+    }
+
+    internal::FlowNetwork network;
+    internal::buildFlowNetwork(graph, network);
+
+    double flow;
+    if (algorithm == BOYKOV_KOLMOGOROV) {
+        flow = internal::boykovKolmogorov(network, source, sink, sourceSide);
+    }
+    else {
+        flow = internal::pushRelabel(network, source, sink);
+        internal::residualReachable(network, source, sourceSide);
+    }
+
+    for (size_t e = 0; e < graph.numEdges(); e++) {
+        if (network.edgeArcs[e] != internal::NO_ARC)
+            flows[e] = network.capacities[network.reverses[network.edgeArcs[e]]];
+    }
+
+    return flow;
+}
+
+/**
+ * @brief Compute the maximum flow between two nodes of a graph, whose
+ * weights are the capacities of the edges (they must be non-negative),
+ * and the minimum cut which separates them
+ * @param graph Input graph
+ * @param source Source node
+ * @param sink Sink node
+ * @param algorithm Algorithm to be used
+ * @return Value of the flow, flow on the edges and the two sides of the
+ * minimum cut (if a node is not in the graph, the flow is 0 and the sides
+ * are empty)
+ */
+template <class T>
+MaxFlowResult<T> maxFlow(
+        const Graph<T>& graph,
+        const T& source,
+        const T& sink,
+        MaxFlowAlgorithm algorithm)
+{
+    MaxFlowResult<T> result;
+    result.flow = 0;
+
+    CompiledGraph<T> compiledGraph(graph);
+
+    size_t sourceIndex = compiledGraph.index(source);
+    size_t sinkIndex = compiledGraph.index(sink);
+    if (sourceIndex == CompiledGraph<T>::NOT_FOUND || sinkIndex == CompiledGraph<T>::NOT_FOUND)
+        return result;
+
+    std::vector<double> flows;
+    std::vector<bool> sourceSide;
+    result.flow = maxFlow(compiledGraph, sourceIndex, sinkIndex, flows, sourceSide, algorithm);
+
+    for (size_t i = 0; i < compiledGraph.numNodes(); i++) {
+        if (sourceSide[i])
+            result.sourceSide.push_back(compiledGraph.value(i));
+        else
+            result.sinkSide.push_back(compiledGraph.value(i));
+
+        for (size_t e = compiledGraph.edgeBegin(i); e < compiledGraph.edgeEnd(i); e++) {
+            if (flows[e] > 0) {
+                FlowEdge<T> edge = { compiledGraph.value(i), compiledGraph.value(compiledGraph.target(e)), flows[e] };
+                result.edgeFlows.push_back(edge);
+            }
+        }
+    }
+
+    return result;
+}
+
+
+
+namespace internal {
+
+/**
+ * @brief Build the residual network of a graph
+ */
+template <class T, class W>
+void buildFlowNetwork(
+        const CompiledGraph<T, W>& graph,
+        FlowNetwork& network)
+{
+    const size_t n = graph.numNodes();
+
+    network.offsets.assign(n + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+            if (graph.target(e) != i) {
+                network.offsets[i + 1]++;
+                network.offsets[graph.target(e) + 1]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+        network.offsets[i + 1] += network.offsets[i];
+
+    const size_t numArcs = network.offsets[n];
+    network.heads.resize(numArcs);
+    network.reverses.resize(numArcs);
+    network.capacities.resize(numArcs);
+    network.edgeArcs.assign(graph.numEdges(), NO_ARC);
+
+    std::vector<size_t> positions(network.offsets.begin(), network.offsets.end() - 1);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+            size_t target = graph.target(e);
+            if (target == i)
+                continue;
+
+            size_t arc = positions[i]++;
+            size_t reverse = positions[target]++;
+
+            network.heads[arc] = target;
+            network.heads[reverse] = i;
+            network.reverses[arc] = reverse;
+            network.reverses[reverse] = arc;
+            network.capacities[arc] = graph.weight(e);
+            network.capacities[reverse] = 0;
+            network.edgeArcs[e] = arc;
+        }
+    }
+}
+
+/**
+ * @brief Push-relabel (Goldberg-Tarjan), processing the active node with
+ * the highest label. The heights are periodically set to the exact
+ * distances from the sink (or from the source, plus n, for the nodes which
+ * cannot reach the sink) by a global relabeling; when no node is left at a
+ * height h < n (gap), the nodes above h are lifted over n, since they cannot
+ * reach the sink anymore. The excess of those nodes is pushed back to the
+ * source, so the result is a flow.
+ *
+ * The nodes with height below n are kept in a doubly linked list for each
+ * height, and the highest of these heights is tracked: a gap lifts only the
+ * nodes of the lists above h, so each node is lifted at most once between
+ * two global relabelings and the gaps take linear time overall. The search
+ * of the highest active node skips the empty heights between the highest
+ * list and n.
+ * @return Value of the flow
+ */
+inline double pushRelabel(
+        FlowNetwork& network,
+        size_t source,
+        size_t sink)
+{
+    const size_t n = network.numNodes();
+    const size_t maxHeight = 2 * n;
+
+    std::vector<double> excess(n, 0);
+    std::vector<size_t> heights(n);
+    std::vector<size_t> current(n);
+    std::vector<std::vector<size_t>> buckets(maxHeight + 1); //Active nodes for each height (may be outdated)
+    size_t highest = 0;
+
+    //Nodes of each height below n, in doubly linked lists
+    std::vector<size_t> levelFirst(n, NO_NODE);
+    std::vector<size_t> levelNext(n);
+    std::vector<size_t> levelPrevious(n);
+    size_t highestLevel = 0; //Upper bound of the occupied heights below n
+
+    auto addToLevel = [&] (size_t node) {
+        size_t height = heights[node];
+        levelPrevious[node] = NO_NODE;
+        levelNext[node] = levelFirst[height];
+        if (levelFirst[height] != NO_NODE)
+            levelPrevious[levelFirst[height]] = node;
+        levelFirst[height] = node;
+        highestLevel = std::max(highestLevel, height);
+    };
+
+    auto removeFromLevel = [&] (size_t node) {
+        if (levelPrevious[node] != NO_NODE)
+            levelNext[levelPrevious[node]] = levelNext[node];
+        else
+            levelFirst[heights[node]] = levelNext[node];
+        if (levelNext[node] != NO_NODE)
+            levelPrevious[levelNext[node]] = levelPrevious[node];
+    };
+
+    //Saturate the arcs of the source
+    for (size_t a = network.offsets[source]; a < network.offsets[source + 1]; a++) {
+        double capacity = network.capacities[a];
+        if (capacity > 0) {
+            network.capacities[a] = 0;
+            network.capacities[network.reverses[a]] += capacity;
+            excess[network.heads[a]] += capacity;
+            excess[source] -= capacity;
+        }
+    }
+
+    size_t relabels = n; //Global relabeling at the start
+
+    while (true) {
+        if (relabels >= GLOBAL_RELABEL_FREQUENCY * n) {
+            globalRelabel(network, source, sink, heights);
+
+            std::fill(levelFirst.begin(), levelFirst.end(), NO_NODE);
+            highestLevel = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (heights[i] < n)
+                    addToLevel(i);
+                current[i] = network.offsets[i];
+            }
+
+            for (std::vector<size_t>& bucket : buckets)
+                bucket.clear();
+            highest = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (excess[i] > 0 && i != source && i != sink) {
+                    buckets[heights[i]].push_back(i);
+                    highest = std::max(highest, heights[i]);
+                }
+            }
+
+            relabels = 0;
+        }
+
+        while (highest > 0 && buckets[highest].empty()) {
+            highest--;
+            //No node has a height between highestLevel and n
+            if (highest < n && highest > highestLevel)
+                highest = highestLevel;
+        }
+        if (buckets[highest].empty())
+            break;
+
+        size_t node = buckets[highest].back();
+        buckets[highest].pop_back();
+        if (excess[node] <= 0 || heights[node] != highest)
+            continue;
+
+        //Discharge
+        while (excess[node] > 0) {
+            if (current[node] == network.offsets[node + 1]) {
+                //Relabel
+                size_t oldHeight = heights[node];
+                size_t newHeight = maxHeight;
+                for (size_t a = network.offsets[node]; a < network.offsets[node + 1]; a++) {
+                    if (network.capacities[a] > 0)
+                        newHeight = std::min(newHeight, heights[network.heads[a]] + 1);
+                }
+
+                relabels++;
+
+                if (oldHeight < n) {
+                    removeFromLevel(node);
+
+                    //Gap: the nodes between oldHeight and n cannot reach the sink
+                    if (levelFirst[oldHeight] == NO_NODE) {
+                        for (size_t h = oldHeight + 1; h <= highestLevel; h++) {
+                            for (size_t i = levelFirst[h]; i != NO_NODE; i = levelNext[i]) {
+                                heights[i] = n + 1;
+                                current[i] = network.offsets[i];
+                                if (excess[i] > 0 && i != sink)
+                                    buckets[n + 1].push_back(i);
+                            }
+                            levelFirst[h] = NO_NODE;
+                        }
+                        highestLevel = oldHeight - 1;
+                        newHeight = std::max(newHeight, n + 1);
+                    }
+                }
+
+                heights[node] = newHeight;
+                if (newHeight < n)
+                    addToLevel(node);
+                current[node] = network.offsets[node];
+
+                if (newHeight >= maxHeight)
+                    break;
+                highest = std::max(highest, newHeight);
+                continue;
+            }
+
+            size_t arc = current[node];
+            size_t head = network.heads[arc];
+
+            if (network.capacities[arc] > 0 && heights[node] == heights[head] + 1) {
+                double delta = std::min(excess[node], network.capacities[arc]);
+                network.capacities[arc] -= delta;
+                network.capacities[network.reverses[arc]] += delta;
+
+                if (excess[head] <= 0 && head != source && head != sink)
+                    buckets[heights[head]].push_back(head);
+
+                excess[node] -= delta;
+                excess[head] += delta;
+            }
+            else {
+                current[node]++;
+            }
+        }
+    }
+
+    return excess[sink];
+}
+
+/**
+ * @brief Set the heights to the distances from the sink in the residual
+ * network; the nodes which cannot reach the sink get n plus their distance
+ * from the source, the ones which cannot reach any of them get 2n
+ */
+inline void globalRelabel(
+        const FlowNetwork& network,
+        size_t source,
+        size_t sink,
+        std::vector<size_t>& heights)
+{
+    const size_t n = network.numNodes();
+
+    heights.assign(n, 2 * n);
+    heights[sink] = 0;
+    heights[source] = n;
+
+    std::vector<size_t> queue;
+    queue.reserve(n);
+
+    for (size_t root : {sink, source}) {
+        queue.clear();
+        queue.push_back(root);
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            size_t node = queue[head];
+            for (size_t a = network.offsets[node]; a < network.offsets[node + 1]; a++) {
+                size_t neighbor = network.heads[a];
+                //Residual arc from the neighbor to the node
+                if (heights[neighbor] == 2 * n && network.capacities[network.reverses[a]] > 0) {
+                    heights[neighbor] = heights[node] + 1;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Boykov-Kolmogorov: a search tree grows from the source and one
+ * from the sink; when they touch, the flow is augmented along the path,
+ * and the nodes which lose their parent (orphans) are adopted by other
+ * nodes of their tree or freed. The trees are kept between augmentations,
+ * so most of the search is not repeated. Orphans are adopted by the
+ * parent closest to the root (distances marked with timestamps).
+ * @param[out] sourceSide Nodes of the source tree at the end (the side of
+ * the source of the minimum cut)
+ * @return Value of the flow
+ */
+inline double boykovKolmogorov(
+        FlowNetwork& network,
+        size_t source,
+        size_t sink,
+        std::vector<bool>& sourceSide)
+{
+    const size_t n = network.numNodes();
+    const std::vector<size_t>& heads = network.heads;
+    const std::vector<size_t>& reverses = network.reverses;
+    std::vector<double>& capacities = network.capacities;
+
+    std::vector<unsigned char> trees(n, FREE_NODE);
+    std::vector<size_t> parents(n, NO_ARC); //Arc from each node to its parent
+    std::vector<size_t> timestamps(n, 0);
+    std::vector<size_t> distances(n, 0);
+    std::vector<bool> isActive(n, false);
+    std::vector<size_t> currentArcs(network.offsets.begin(), network.offsets.end() - 1); //Next arc to grow
+
+    std::deque<size_t> active;
+    std::deque<size_t> orphans;
+    size_t time = 1;
+
+    trees[source] = SOURCE_TREE;
+    trees[sink] = SINK_TREE;
+    parents[source] = TERMINAL_ARC;
+    parents[sink] = TERMINAL_ARC;
+    timestamps[source] = timestamps[sink] = time;
+    active.push_back(source);
+    active.push_back(sink);
+    isActive[source] = isActive[sink] = true;
+
+    double flow = 0;
+
+    while (!active.empty()) {
+        size_t node = active.front();
+        active.pop_front();
+        isActive[node] = false;
+
+        if (trees[node] == FREE_NODE)
+            continue;
+
+        //Growth: the bridge is the arc from the source tree to the sink tree
+        const unsigned char tree = trees[node];
+        size_t bridge = NO_ARC;
+
+        size_t a = currentArcs[node];
+        for (; a < network.offsets[node + 1] && bridge == NO_ARC; a++) {
+            size_t neighbor = heads[a];
+            double residual = tree == SOURCE_TREE ? capacities[a] : capacities[reverses[a]];
+            if (residual <= 0)
+                continue;
+
+            if (trees[neighbor] == FREE_NODE) {
+                trees[neighbor] = tree;
+                parents[neighbor] = reverses[a];
+                timestamps[neighbor] = timestamps[node];
+                distances[neighbor] = distances[node] + 1;
+                if (!isActive[neighbor]) {
+                    active.push_back(neighbor);
+                    isActive[neighbor] = true;
+                    currentArcs[neighbor] = network.offsets[neighbor];
+                }
+            }
+            else if (trees[neighbor] != tree) {
+                bridge = tree == SOURCE_TREE ? a : reverses[a];
+            }
+        }
+
+        if (bridge == NO_ARC)
+            continue;
+
+        //The node can have other paths: it is processed again, from the
+        //arc of the bridge (the previous arcs have already been grown)
+        currentArcs[node] = a - 1;
+        if (!isActive[node]) {
+            active.push_front(node);
+            isActive[node] = true;
+        }
+
+        time++;
+
+        //Augmentation
+        const size_t sourceEnd = heads[reverses[bridge]];
+        const size_t sinkEnd = heads[bridge];
+
+        double bottleneck = capacities[bridge];
+        for (size_t v = sourceEnd; parents[v] != TERMINAL_ARC; v = heads[parents[v]])
+            bottleneck = std::min(bottleneck, capacities[reverses[parents[v]]]);
+        for (size_t v = sinkEnd; parents[v] != TERMINAL_ARC; v = heads[parents[v]])
+            bottleneck = std::min(bottleneck, capacities[parents[v]]);
+
+        capacities[bridge] -= bottleneck;
+        capacities[reverses[bridge]] += bottleneck;
+
+        for (size_t v = sourceEnd; parents[v] != TERMINAL_ARC; ) {
+            size_t arc = parents[v];
+            size_t parent = heads[arc];
+            capacities[reverses[arc]] -= bottleneck;
+            capacities[arc] += bottleneck;
+            if (capacities[reverses[arc]] <= 0) {
+                parents[v] = NO_ARC;
+                orphans.push_back(v);
+            }
+            v = parent;
+        }
+        for (size_t v = sinkEnd; parents[v] != TERMINAL_ARC; ) {
+            size_t arc = parents[v];
+            size_t parent = heads[arc];
+            capacities[arc] -= bottleneck;
+            capacities[reverses[arc]] += bottleneck;
+            if (capacities[arc] <= 0) {
+                parents[v] = NO_ARC;
+                orphans.push_back(v);
+            }
+            v = parent;
+        }
+
+        flow += bottleneck;
+
+        //Adoption
+        while (!orphans.empty()) {
+            size_t orphan = orphans.front();
+            orphans.pop_front();
+
+            const unsigned char orphanTree = trees[orphan];
+            size_t bestArc = NO_ARC;
+            size_t bestDistance = std::numeric_limits<size_t>::max();
+
+            for (size_t a = network.offsets[orphan]; a < network.offsets[orphan + 1]; a++) {
+                size_t neighbor = heads[a];
+                double residual = orphanTree == SOURCE_TREE ? capacities[reverses[a]] : capacities[a];
+                if (trees[neighbor] != orphanTree || residual <= 0)
+                    continue;
+
+                //Check that the neighbor is connected to the root
+                size_t distance = 0;
+                size_t v = neighbor;
+                bool valid = false;
+                while (true) {
+                    if (timestamps[v] == time) {
+                        distance += distances[v];
+                        valid = true;
+                        break;
+                    }
+                    if (parents[v] == TERMINAL_ARC) {
+                        timestamps[v] = time;
+                        distances[v] = 0;
+                        valid = true;
+                        break;
+                    }
+                    if (parents[v] == NO_ARC)
+                        break;
+                    distance++;
+                    v = heads[parents[v]];
+                }
+
+                if (!valid)
+                    continue;
+
+                if (distance < bestDistance) {
+                    bestArc = a;
+                    bestDistance = distance;
+                }
+
+                //Mark the distances of the path
+                for (v = neighbor; timestamps[v] != time; v = heads[parents[v]]) {
+                    timestamps[v] = time;
+                    distances[v] = distance--;
+                }
+            }
+
+            if (bestArc != NO_ARC) {
+                parents[orphan] = bestArc;
+                timestamps[orphan] = time;
+                distances[orphan] = bestDistance + 1;
+                continue;
+            }
+
+            //No parent: the children become orphans, the neighbors which
+            //can reach the node become active
+            for (size_t a = network.offsets[orphan]; a < network.offsets[orphan + 1]; a++) {
+                size_t neighbor = heads[a];
+                if (trees[neighbor] != orphanTree)
+                    continue;
+
+                double residual = orphanTree == SOURCE_TREE ? capacities[reverses[a]] : capacities[a];
+                if (residual > 0) {
+                    if (!isActive[neighbor]) {
+                        active.push_back(neighbor);
+                        isActive[neighbor] = true;
+                    }
+                    currentArcs[neighbor] = network.offsets[neighbor];
+                }
+
+                if (parents[neighbor] != NO_ARC && parents[neighbor] != TERMINAL_ARC && heads[parents[neighbor]] == orphan) {
+                    parents[neighbor] = NO_ARC;
+                    orphans.push_back(neighbor);
+                }
+            }
+
+            trees[orphan] = FREE_NODE;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+        sourceSide[i] = trees[i] == SOURCE_TREE;
+
+    return flow;
+}
+
+/**
+ * @brief Nodes reachable from the source in the residual network (the
+ * side of the source of the minimum cut)
+ */
+inline void residualReachable(
+        const FlowNetwork& network,
+        size_t source,
+        std::vector<bool>& reached)
+{
+    reached.assign(network.numNodes(), false);
+    reached[source] = true;
+
+    std::vector<size_t> queue(1, source);
+    for (size_t head = 0; head < queue.size(); head++) {
+        size_t node = queue[head];
+        for (size_t a = network.offsets[node]; a < network.offsets[node + 1]; a++) {
+            size_t neighbor = network.heads[a];
+            if (!reached[neighbor] && network.capacities[a] > 0) {
+                reached[neighbor] = true;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+}
+
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_MINIMUM_SPANNING_TREE_H
+#define CG3_MINIMUM_SPANNING_TREE_H
+
+#include <vector>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+#include "extensions/data_structures/graphs/compiled_graph.h"
+
+namespace cg3 {
+
+/**
+ * @brief Algorithm used to compute the minimum spanning tree
+ */
+enum MSTAlgorithm { KRUSKAL, BORUVKA };
+
+/**
+ * @brief Edge of a spanning tree: N is the type of the nodes (indices
+ * for compiled graphs, values for graphs)
+ */
+template <class N>
+struct SpanningTreeEdge {
+    N source;
+    N target;
+    double weight;
+};
+
+
+/* Minimum spanning tree */
+
+template <class T, class W>
+std::vector<SpanningTreeEdge<size_t>> minimumSpanningTree(
+        const CompiledGraph<T, W>& graph,
+        MSTAlgorithm algorithm = KRUSKAL,
+        unsigned int nThreads = 0);
+
+template <class T>
+std::vector<SpanningTreeEdge<T>> minimumSpanningTree(
+        const Graph<T>& graph,
+        MSTAlgorithm algorithm = KRUSKAL,
+        unsigned int nThreads = 0);
+
+template <class N>
+double spanningTreeWeight(const std::vector<SpanningTreeEdge<N>>& edges);
+
+}
+
+#include "minimum_spanning_tree.tpp"
+
+#endif // CG3_MINIMUM_SPANNING_TREE_H
@@ -0,0 +1,300 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "minimum_spanning_tree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <limits>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Number of edges (or nodes) assigned to a thread at a time */
+static const size_t MST_CHUNK_SIZE = 4096;
+
+typedef SpanningTreeEdge<size_t> IndexEdge;
+
+inline bool lighterEdge(const IndexEdge& edge1, const IndexEdge& edge2);
+inline size_t findRoot(std::vector<size_t>& parents, size_t node);
+
+template <class T, class W>
+std::vector<IndexEdge> undirectedEdges(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads);
+
+inline std::vector<IndexEdge> kruskal(
+        std::vector<IndexEdge>& edges,
+        size_t numNodes,
+        unsigned int nThreads);
+
+inline std::vector<IndexEdge> boruvka(
+        std::vector<IndexEdge>& edges,
+        size_t numNodes,
+        unsigned int nThreads);
+
+}
+
+
+/* ----- MINIMUM SPANNING TREE ----- */
+
+/**
+ * @brief Minimum spanning tree (minimum spanning forest if the graph is
+ * not connected) of an undirected compiled graph. The graph must store
+ * both the directions of each edge, as undirected cg3::Graph does: only
+ * the edges with source index smaller than the target index are used.
+ *
+ * KRUSKAL sorts the edges by weight with a parallel sort and adds them
+ * with a union-find. BORUVKA, at each round, finds in parallel the
+ * lightest edge leaving each component and merges the components; the
+ * edges inside a component are discarded after each round, so it is
+ * usually faster on large sparse graphs.
+ *
+ * @param[in] graph Input graph
+ * @param[in] algorithm Algorithm to be used
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Edges of the tree (indices of the nodes), sorted by weight for
+ * KRUSKAL, in order of insertion for BORUVKA
+ */
+template <class T, class W>
+std::vector<SpanningTreeEdge<size_t>> minimumSpanningTree(
+        const CompiledGraph<T, W>& graph,
+        MSTAlgorithm algorithm,
+        unsigned int nThreads)
+{
+    std::vector<internal::IndexEdge> edges = internal::undirectedEdges(graph, nThreads);
+
+    if (algorithm == BORUVKA)
+        return internal::boruvka(edges, graph.numNodes(), nThreads);
+
+    return internal::kruskal(edges, graph.numNodes(), nThreads);
+}
+
+/**
+ * @brief Minimum spanning tree of an undirected graph (see the compiled
+ * graph version)
+ * @param[in] graph Input graph
+ * @param[in] algorithm Algorithm to be used
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return Edges of the tree (values of the nodes)
+ */
+template <class T>
+std::vector<SpanningTreeEdge<T>> minimumSpanningTree(
+        const Graph<T>& graph,
+        MSTAlgorithm algorithm,
+        unsigned int nThreads)
+{
+    CompiledGraph<T> compiledGraph(graph);
+
+    std::vector<SpanningTreeEdge<size_t>> indexEdges =
+            minimumSpanningTree(compiledGraph, algorithm, nThreads);
+
+    std::vector<SpanningTreeEdge<T>> edges;
+    edges.reserve(indexEdges.size());
+    for (const SpanningTreeEdge<size_t>& indexEdge : indexEdges) {
+        SpanningTreeEdge<T> edge = {
+            compiledGraph.value(indexEdge.source),
+            compiledGraph.value(indexEdge.target),
+            indexEdge.weight
+        };
+        edges.push_back(edge);
+    }
+
+    return edges;
+}
+
+/**
+ * @brief Total weight of the edges of a spanning tree
+ */
+template <class N>
+double spanningTreeWeight(const std::vector<SpanningTreeEdge<N>>& edges)
+{
+    double weight = 0;
+    for (const SpanningTreeEdge<N>& edge : edges)
+        weight += edge.weight;
+
+    return weight;
+}
+
+
+
+namespace internal {
+
+/**
+ * @brief Strict total order of the edges: by weight, then by nodes. It
+ * makes the lightest edge of each component unique, so the edges chosen
+ * by a Boruvka round never form a cycle.
+ */
+inline bool lighterEdge(const IndexEdge& edge1, const IndexEdge& edge2)
+{
+    if (edge1.weight != edge2.weight)
+        return edge1.weight < edge2.weight;
+    if (edge1.source != edge2.source)
+        return edge1.source < edge2.source;
+    return edge1.target < edge2.target;
+}
+
+/**
+ * @brief Root of a node in a union-find, with path halving
+ */
+inline size_t findRoot(std::vector<size_t>& parents, size_t node)
+{
+    while (parents[node] != node) {
+        parents[node] = parents[parents[node]];
+        node = parents[node];
+    }
+    return node;
+}
+
+/**
+ * @brief Edges of an undirected compiled graph with source < target,
+ * collected in parallel
+ */
+template <class T, class W>
+std::vector<IndexEdge> undirectedEdges(
+        const CompiledGraph<T, W>& graph,
+        unsigned int nThreads)
+{
+    const size_t n = graph.numNodes();
+    const size_t nChunks = (n + MST_CHUNK_SIZE - 1) / MST_CHUNK_SIZE;
+
+    //Edges of each chunk of nodes, concatenated in order of chunk
+    std::vector<std::vector<IndexEdge>> chunkEdges(nChunks);
+
+    parallelForChunks(n, MST_CHUNK_SIZE, [&] (unsigned int, size_t chunk, size_t begin, size_t end) {
+        for (size_t u = begin; u < end; u++) {
+            for (size_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                if (u < graph.target(e)) {
+                    IndexEdge edge = { u, graph.target(e), graph.weight(e) };
+                    chunkEdges[chunk].push_back(edge);
+                }
+            }
+        }
+    }, nThreads);
+
+    std::vector<IndexEdge> edges;
+    edges.reserve(graph.numEdges() / 2);
+    for (const std::vector<IndexEdge>& chunk : chunkEdges)
+        edges.insert(edges.end(), chunk.begin(), chunk.end());
+
+    return edges;
+}
+
+/**
+ * @brief Kruskal algorithm: parallel sort of the edges and union-find
+ */
+inline std::vector<IndexEdge> kruskal(
+        std::vector<IndexEdge>& edges,
+        size_t numNodes,
+        unsigned int nThreads)
+{
+    parallelSort(edges.begin(), edges.end(), lighterEdge, nThreads);
+
+    std::vector<size_t> parents(numNodes);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    std::vector<IndexEdge> tree;
+    for (const IndexEdge& edge : edges) {
+        if (numNodes == 0 || tree.size() == numNodes - 1)
+            break;
+
+        size_t root1 = findRoot(parents, edge.source);
+        size_t root2 = findRoot(parents, edge.target);
+
+        if (root1 != root2) {
+            parents[std::max(root1, root2)] = std::min(root1, root2);
+            tree.push_back(edge);
+        }
+    }
+
+    return tree;
+}
+
+/**
+ * @brief Parallel Boruvka algorithm. Each round: the lightest edge of each
+ * component is found with an atomic minimum, the components are merged,
+ * the labels of the nodes are updated and the edges inside a component
+ * are removed.
+ */
+inline std::vector<IndexEdge> boruvka(
+        std::vector<IndexEdge>& edges,
+        size_t numNodes,
+        unsigned int nThreads)
+{
+    const size_t notFound = std::numeric_limits<size_t>::max();
+
+    std::vector<size_t> components(numNodes);
+    std::iota(components.begin(), components.end(), 0);
+
+    std::vector<size_t> parents(components);
+    std::vector<std::atomic<size_t>> lightest(numNodes);
+
+    std::vector<IndexEdge> tree;
+
+    while (!edges.empty()) {
+        parallelFor(numNodes, [&] (size_t i) {
+            lightest[i].store(notFound, std::memory_order_relaxed);
+        }, nThreads);
+
+        //Lightest edge leaving each component (atomic minimum on the edge index)
+        parallelForChunks(edges.size(), MST_CHUNK_SIZE, [&] (unsigned int, size_t, size_t begin, size_t end) {
+            for (size_t e = begin; e < end; e++) {
+                size_t c[2] = { components[edges[e].source], components[edges[e].target] };
+
+                for (size_t k = 0; k < 2; k++) {
+                    size_t current = lightest[c[k]].load(std::memory_order_relaxed);
+                    while ((current == notFound || lighterEdge(edges[e], edges[current])) &&
+                           !lightest[c[k]].compare_exchange_weak(current, e, std::memory_order_relaxed));
+                }
+            }
+        }, nThreads);
+
+        //Merge the components
+        for (size_t c = 0; c < numNodes; c++) {
+            size_t e = lightest[c].load(std::memory_order_relaxed);
+            if (e == notFound)
+                continue;
+
+            size_t root1 = findRoot(parents, components[edges[e].source]);
+            size_t root2 = findRoot(parents, components[edges[e].target]);
+
+            if (root1 != root2) {
+                parents[std::max(root1, root2)] = std::min(root1, root2);
+                tree.push_back(edges[e]);
+            }
+        }
+
+        for (size_t c = 0; c < numNodes; c++)
+            parents[c] = findRoot(parents, c);
+
+        parallelFor(numNodes, [&] (size_t i) {
+            components[i] = parents[components[i]];
+        }, nThreads);
+
+        //Remove the edges inside the components
+        const size_t nChunks = (edges.size() + MST_CHUNK_SIZE - 1) / MST_CHUNK_SIZE;
+        std::vector<std::vector<IndexEdge>> chunkEdges(nChunks);
+
+        parallelForChunks(edges.size(), MST_CHUNK_SIZE, [&] (unsigned int, size_t chunk, size_t begin, size_t end) {
+            for (size_t e = begin; e < end; e++) {
+                if (components[edges[e].source] != components[edges[e].target])
+                    chunkEdges[chunk].push_back(edges[e]);
+            }
+        }, nThreads);
+
+        edges.clear();
+        for (const std::vector<IndexEdge>& chunk : chunkEdges)
+            edges.insert(edges.end(), chunk.begin(), chunk.end());
+    }
+
+    return tree;
+}
+
+}
+
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_BINARY_GRAPH_H
+#define CG3_BINARY_GRAPH_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+#include "compiled_graph.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/**
+ * @brief Header of the binary graph format. It is followed by the arrays
+ * of the compressed sparse row format, each one aligned to 8 bytes:
+ * offsets (numNodes + 1 uint64), targets (numEdges uint64), weights
+ * (numEdges double), node values (numNodes raw values) and the indices of
+ * the nodes sorted by value (numNodes uint64). Numbers are stored with
+ * the byte order of the machine which wrote the file.
+ */
+struct BinaryGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t valueSize;
+    uint64_t numNodes;
+    uint64_t numEdges;
+    double maxWeight;
+};
+
+/**
+ * @brief Positions (in bytes) of the arrays of a binary graph file
+ */
+struct BinaryGraphLayout {
+    uint64_t offsets;
+    uint64_t targets;
+    uint64_t weights;
+    uint64_t values;
+    uint64_t sortedIndices;
+    uint64_t size;
+};
+
+}
+
+/**
+ * @brief Read-only view of a graph stored in the binary graph format
+ * (see saveBinaryGraph), with the same accessors of cg3::CompiledGraph.
+ *
+ * The file is memory-mapped where mmap is available: opening takes
+ * constant time and memory, and the pages are loaded by the operating
+ * system when they are accessed. On other platforms the file is read in
+ * memory. Use toCompiledGraph (or loadBinaryGraph) to get a CompiledGraph
+ * for the algorithms which need the incoming edges.
+ *
+ * open checks only the header and the size of the file, so the accessors
+ * assume a trusted file: the offsets, the targets and the sorted indices
+ * are read without bound checks, and index() assumes that the indices are
+ * sorted by value. validate checks them in linear time; toCompiledGraph
+ * (and so loadBinaryGraph) always does.
+ *
+ * T must be trivially copyable.
+ */
+template <class T>
+class MappedGraph
+{
+
+public:
+
+    /* Typedefs */
+
+    static const size_t NOT_FOUND = CompiledGraph<T>::NOT_FOUND;
+
+
+    /* Constructors */
+
+    MappedGraph();
+    MappedGraph(const std::string& filename);
+    ~MappedGraph();
+
+    MappedGraph(const MappedGraph& other) = delete;
+    MappedGraph& operator=(const MappedGraph& other) = delete;
+
+
+    /* Public methods */
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+    bool validate() const;
+
+    size_t numNodes() const;
+    size_t numEdges() const;
+    bool empty() const;
+
+    const T& value(size_t node) const;
+    size_t index(const T& value) const;
+
+    size_t edgeBegin(size_t node) const;
+    size_t edgeEnd(size_t node) const;
+    size_t outDegree(size_t node) const;
+    size_t target(size_t edge) const;
+    double weight(size_t edge) const;
+    double maxWeight() const;
+
+    template <class W = double>
+    CompiledGraph<T, W> toCompiledGraph() const;
+
+
+protected:
+
+    /* Protected fields */
+
+    const char* data;
+    size_t size;
+    bool mapped; //True if data is memory-mapped, false if it is in buffer
+    std::vector<uint64_t> buffer;
+
+    const internal::BinaryGraphHeader* header;
+    const uint64_t* offsets;
+    const uint64_t* targets;
+    const double* weights;
+    const T* values;
+    const uint64_t* sortedIndices;
+
+};
+
+
+/* Binary graph files */
+
+template <class T, class W>
+bool saveBinaryGraph(const CompiledGraph<T, W>& graph, const std::string& filename);
+
+template <class T>
+bool saveBinaryGraph(const Graph<T>& graph, const std::string& filename);
+
+template <class T, class W>
+bool loadBinaryGraph(const std::string& filename, CompiledGraph<T, W>& graph);
+
+}
+
+#include "binary_graph.tpp"
+
+#endif // CG3_BINARY_GRAPH_H
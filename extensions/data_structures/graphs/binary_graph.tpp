@@ -0,0 +1,583 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "binary_graph.h"
+
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <cstring>
+#include <type_traits>
+#include <limits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CG3_BINARY_GRAPH_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace cg3 {
+
+namespace internal {
+
+static const char BINARY_GRAPH_MAGIC[8] = { 'C', 'G', '3', 'G', 'R', 'A', 'P', 'H' };
+static const uint32_t BINARY_GRAPH_VERSION = 1;
+
+/* Number of entries written at a time */
+static const size_t BINARY_GRAPH_WRITE_BLOCK = 65536;
+
+inline uint64_t binaryGraphAlign(uint64_t position);
+
+inline bool binaryGraphLayout(
+        uint64_t numNodes,
+        uint64_t numEdges,
+        uint64_t valueSize,
+        BinaryGraphLayout& layout);
+
+inline bool addBinaryArray(
+        uint64_t& position,
+        uint64_t count,
+        uint64_t elementSize);
+
+template <class F>
+void writeBinaryArray(std::ofstream& file, size_t n, F f);
+
+inline void writeBinaryPadding(std::ofstream& file);
+
+}
+
+template <class T>
+const size_t MappedGraph<T>::NOT_FOUND;
+
+
+/* ----- CONSTRUCTORS/DESTRUCTOR ----- */
+
+/**
+ * @brief Constructor of an empty (closed) view
+ */
+template <class T>
+MappedGraph<T>::MappedGraph() :
+    data(nullptr),
+    size(0),
+    mapped(false),
+    header(nullptr),
+    offsets(nullptr),
+    targets(nullptr),
+    weights(nullptr),
+    values(nullptr),
+    sortedIndices(nullptr)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "MappedGraph values must be trivially copyable");
+}
+
+/**
+ * @brief Constructor which opens a binary graph file (check isOpen)
+ * @param filename Name of the file
+ */
+template <class T>
+MappedGraph<T>::MappedGraph(const std::string& filename) :
+    MappedGraph()
+{
+    open(filename);
+}
+
+template <class T>
+MappedGraph<T>::~MappedGraph()
+{
+    close();
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Open a binary graph file
+ * @param filename Name of the file
+ * @return True if the file has been opened and it is a valid binary
+ * graph with values of type T
+ */
+template <class T>
+bool MappedGraph<T>::open(const std::string& filename)
+{
+    close();
+
+#ifdef CG3_BINARY_GRAPH_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+        return false;
+
+    data = static_cast<const char*>(address);
+    size = fileStat.st_size;
+    mapped = true;
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+
+    size = file.tellg();
+    buffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) {
+        close();
+        return false;
+    }
+
+    data = reinterpret_cast<const char*>(buffer.data());
+    mapped = false;
+#endif
+
+    //Check the header
+    header = reinterpret_cast<const internal::BinaryGraphHeader*>(data);
+
+    if (size < sizeof(internal::BinaryGraphHeader) ||
+            std::memcmp(header->magic, internal::BINARY_GRAPH_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != internal::BINARY_GRAPH_VERSION ||
+            header->valueSize != sizeof(T))
+    {
+        close();
+        return false;
+    }
+
+    internal::BinaryGraphLayout layout;
+
+    if (!internal::binaryGraphLayout(header->numNodes, header->numEdges, sizeof(T), layout) ||
+            size < layout.size)
+    {
+        close();
+        return false;
+    }
+
+    offsets = reinterpret_cast<const uint64_t*>(data + layout.offsets);
+    targets = reinterpret_cast<const uint64_t*>(data + layout.targets);
+    weights = reinterpret_cast<const double*>(data + layout.weights);
+    values = reinterpret_cast<const T*>(data + layout.values);
+    sortedIndices = reinterpret_cast<const uint64_t*>(data + layout.sortedIndices);
+
+    return true;
+}
+
+/**
+ * @brief Close the file
+ */
+template <class T>
+void MappedGraph<T>::close()
+{
+#ifdef CG3_BINARY_GRAPH_MMAP
+    if (mapped && data != nullptr)
+        munmap(const_cast<char*>(data), size);
+#endif
+
+    std::vector<uint64_t>().swap(buffer);
+
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    header = nullptr;
+    offsets = nullptr;
+    targets = nullptr;
+    weights = nullptr;
+    values = nullptr;
+    sortedIndices = nullptr;
+}
+
+/**
+ * @brief Check if a valid binary graph file is open
+ */
+template <class T>
+bool MappedGraph<T>::isOpen() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief Check the arrays of the graph in linear time: the offsets must be
+ * non-decreasing from 0 to the number of edges, the targets must be indices
+ * of nodes, and the sorted indices must be indices of nodes sorted by value
+ * (as index() assumes)
+ * @return True if a file is open and its arrays are consistent
+ */
+template <class T>
+bool MappedGraph<T>::validate() const
+{
+    if (header == nullptr)
+        return false;
+
+    const uint64_t n = header->numNodes;
+    const uint64_t m = header->numEdges;
+
+    if (offsets[0] != 0 || offsets[n] != m)
+        return false;
+    for (uint64_t i = 0; i < n; i++) {
+        if (offsets[i] > offsets[i + 1])
+            return false;
+    }
+
+    for (uint64_t e = 0; e < m; e++) {
+        if (targets[e] >= n)
+            return false;
+    }
+
+    for (uint64_t i = 0; i < n; i++) {
+        if (sortedIndices[i] >= n)
+            return false;
+        if (i > 0 && values[sortedIndices[i]] < values[sortedIndices[i - 1]])
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the number of nodes
+ */
+template <class T>
+size_t MappedGraph<T>::numNodes() const
+{
+    return header == nullptr ? 0 : header->numNodes;
+}
+
+/**
+ * @brief Get the number of (directed) edges
+ */
+template <class T>
+size_t MappedGraph<T>::numEdges() const
+{
+    return header == nullptr ? 0 : header->numEdges;
+}
+
+/**
+ * @brief Check if the graph has no nodes
+ */
+template <class T>
+bool MappedGraph<T>::empty() const
+{
+    return numNodes() == 0;
+}
+
+/**
+ * @brief Get the value of a node
+ * @param node Index of the node
+ */
+template <class T>
+const T& MappedGraph<T>::value(size_t node) const
+{
+    return values[node];
+}
+
+/**
+ * @brief Get the index of the node with a given value (binary search on
+ * the stored order of the values)
+ * @param value Value of the node
+ * @return Index of the node, NOT_FOUND if there is no node with that value
+ */
+template <class T>
+size_t MappedGraph<T>::index(const T& value) const
+{
+    const uint64_t* first = sortedIndices;
+    const uint64_t* last = sortedIndices + numNodes();
+
+    const uint64_t* it = std::lower_bound(first, last, value, [this] (uint64_t node, const T& v) {
+        return values[node] < v;
+    });
+
+    if (it == last || value < values[*it])
+        return NOT_FOUND;
+
+    return *it;
+}
+
+/**
+ * @brief Get the first outgoing edge of a node
+ */
+template <class T>
+size_t MappedGraph<T>::edgeBegin(size_t node) const
+{
+    return offsets[node];
+}
+
+/**
+ * @brief Get the end of the outgoing edges of a node
+ */
+template <class T>
+size_t MappedGraph<T>::edgeEnd(size_t node) const
+{
+    return offsets[node + 1];
+}
+
+/**
+ * @brief Get the number of outgoing edges of a node
+ */
+template <class T>
+size_t MappedGraph<T>::outDegree(size_t node) const
+{
+    return offsets[node + 1] - offsets[node];
+}
+
+/**
+ * @brief Get the index of the target node of an edge
+ */
+template <class T>
+size_t MappedGraph<T>::target(size_t edge) const
+{
+    return targets[edge];
+}
+
+/**
+ * @brief Get the weight of an edge
+ */
+template <class T>
+double MappedGraph<T>::weight(size_t edge) const
+{
+    return weights[edge];
+}
+
+/**
+ * @brief Get the maximum weight of the edges (0 if there are no edges)
+ */
+template <class T>
+double MappedGraph<T>::maxWeight() const
+{
+    return header == nullptr ? 0 : header->maxWeight;
+}
+
+/**
+ * @brief Copy the graph in a compiled graph, with weights of type W
+ * @return Compiled graph, empty if no file is open or if its arrays are
+ * not consistent (see validate)
+ */
+template <class T>
+template <class W>
+CompiledGraph<T, W> MappedGraph<T>::toCompiledGraph() const
+{
+    const size_t n = numNodes();
+    const size_t m = numEdges();
+
+    if (!validate())
+        return CompiledGraph<T, W>();
+
+    return CompiledGraph<T, W>(
+                std::vector<T>(values, values + n),
+                std::vector<size_t>(offsets, offsets + n + 1),
+                std::vector<size_t>(targets, targets + m),
+                std::vector<double>(weights, weights + m));
+}
+
+
+
+/* ----- BINARY GRAPH FILES ----- */
+
+/**
+ * @brief Write a compiled graph in the binary graph format, which can be
+ * opened with MappedGraph or loadBinaryGraph. T must be trivially copyable.
+ * @param graph Input graph
+ * @param filename Name of the file
+ * @return True if the file has been written
+ */
+template <class T, class W>
+bool saveBinaryGraph(const CompiledGraph<T, W>& graph, const std::string& filename)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Binary graph values must be trivially copyable");
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    const size_t n = graph.numNodes();
+    const size_t m = graph.numEdges();
+
+    internal::BinaryGraphHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, internal::BINARY_GRAPH_MAGIC, sizeof(header.magic));
+    header.version = internal::BINARY_GRAPH_VERSION;
+    header.valueSize = sizeof(T);
+    header.numNodes = n;
+    header.numEdges = m;
+    header.maxWeight = graph.maxWeight();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    internal::writeBinaryPadding(file);
+
+    internal::writeBinaryArray(file, n + 1, [&graph, n] (size_t i) -> uint64_t {
+        return i < n ? graph.edgeBegin(i) : graph.numEdges();
+    });
+    internal::writeBinaryArray(file, m, [&graph] (size_t e) -> uint64_t {
+        return graph.target(e);
+    });
+    internal::writeBinaryArray(file, m, [&graph] (size_t e) -> double {
+        return graph.weight(e);
+    });
+    internal::writeBinaryArray(file, n, [&graph] (size_t i) -> T {
+        return graph.value(i);
+    });
+    internal::writeBinaryPadding(file);
+
+    std::vector<uint64_t> sortedIndices(n);
+    std::iota(sortedIndices.begin(), sortedIndices.end(), 0);
+    std::sort(sortedIndices.begin(), sortedIndices.end(), [&graph] (uint64_t a, uint64_t b) {
+        return graph.value(a) < graph.value(b);
+    });
+    file.write(reinterpret_cast<const char*>(sortedIndices.data()), n * sizeof(uint64_t));
+
+    return file.good();
+}
+
+/**
+ * @brief Write a graph in the binary graph format (see the compiled graph
+ * version). Nodes are indexed in the order of the node iterator of the graph.
+ * @param graph Input graph
+ * @param filename Name of the file
+ * @return True if the file has been written
+ */
+template <class T>
+bool saveBinaryGraph(const Graph<T>& graph, const std::string& filename)
+{
+    return saveBinaryGraph(CompiledGraph<T>(graph), filename);
+}
+
+/**
+ * @brief Read a binary graph file in a compiled graph
+ * @param[in] filename Name of the file
+ * @param[out] graph Output graph
+ * @return True if the file is a valid binary graph with values of type T
+ * (the arrays are checked, see MappedGraph::validate)
+ */
+template <class T, class W>
+bool loadBinaryGraph(const std::string& filename, CompiledGraph<T, W>& graph)
+{
+    MappedGraph<T> mappedGraph;
+    if (!mappedGraph.open(filename))
+        return false;
+
+    //toCompiledGraph validates the arrays: it returns an empty graph if they
+    //are not consistent, so the sizes differ unless the file is empty
+    CompiledGraph<T, W> loadedGraph = mappedGraph.template toCompiledGraph<W>();
+    if (loadedGraph.numNodes() != mappedGraph.numNodes() || loadedGraph.numEdges() != mappedGraph.numEdges())
+        return false;
+
+    graph = std::move(loadedGraph);
+    return true;
+}
+
+
+
+namespace internal {
+
+/**
+ * @brief Round a position up to a multiple of 8 bytes
+ */
+inline uint64_t binaryGraphAlign(uint64_t position)
+{
+    return (position + 7) & ~((uint64_t) 7);
+}
+
+/**
+ * @brief Positions of the arrays of a binary graph file
+ * @return False if the size of the file would overflow (the numbers of
+ * the header are not valid)
+ */
+inline bool binaryGraphLayout(
+        uint64_t numNodes,
+        uint64_t numEdges,
+        uint64_t valueSize,
+        BinaryGraphLayout& layout)
+{
+    uint64_t position = binaryGraphAlign(sizeof(BinaryGraphHeader));
+
+    layout.offsets = position;
+    if (!addBinaryArray(position, numNodes, sizeof(uint64_t)) ||
+            !addBinaryArray(position, 1, sizeof(uint64_t)))
+        return false;
+
+    layout.targets = position;
+    if (!addBinaryArray(position, numEdges, sizeof(uint64_t)))
+        return false;
+
+    layout.weights = position;
+    if (!addBinaryArray(position, numEdges, sizeof(double)))
+        return false;
+
+    layout.values = position;
+    if (!addBinaryArray(position, numNodes, valueSize))
+        return false;
+
+    layout.sortedIndices = binaryGraphAlign(position);
+    position = layout.sortedIndices;
+    if (!addBinaryArray(position, numNodes, sizeof(uint64_t)))
+        return false;
+
+    layout.size = position;
+    return true;
+}
+
+/**
+ * @brief Move a position after an array of count elements
+ * @return False if the position would overflow (leaving room for the
+ * alignment to 8 bytes)
+ */
+inline bool addBinaryArray(
+        uint64_t& position,
+        uint64_t count,
+        uint64_t elementSize)
+{
+    const uint64_t maxPosition = std::numeric_limits<uint64_t>::max() - 7;
+
+    if (elementSize != 0 && count > (maxPosition - position) / elementSize)
+        return false;
+
+    position += count * elementSize;
+    return true;
+}
+
+/**
+ * @brief Write the array f(0), ..., f(n-1) using a buffer of fixed size
+ */
+template <class F>
+void writeBinaryArray(std::ofstream& file, size_t n, F f)
+{
+    typedef decltype(f(0)) Value;
+
+    std::vector<Value> block;
+    block.reserve(std::min(n, BINARY_GRAPH_WRITE_BLOCK));
+
+    for (size_t begin = 0; begin < n; begin += BINARY_GRAPH_WRITE_BLOCK) {
+        size_t end = std::min(n, begin + BINARY_GRAPH_WRITE_BLOCK);
+
+        block.clear();
+        for (size_t i = begin; i < end; i++)
+            block.push_back(f(i));
+
+        file.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(Value));
+    }
+}
+
+/**
+ * @brief Write zeros up to the next multiple of 8 bytes
+ */
+inline void writeBinaryPadding(std::ofstream& file)
+{
+    static const char zeros[8] = { 0 };
+
+    uint64_t position = file.tellp();
+    file.write(zeros, binaryGraphAlign(position) - position);
+}
+
+}
+
+}
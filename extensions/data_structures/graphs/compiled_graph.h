@@ -0,0 +1,141 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_COMPILED_GRAPH_H
+#define CG3_COMPILED_GRAPH_H
+
+#include <vector>
+#include <utility>
+#include <limits>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+#include "indexed_graph.h"
+#include "edge_weights.h"
+
+namespace cg3 {
+
+/**
+ * @brief Immutable snapshot of a cg3::Graph (or of a cg3::IndexedGraph)
+ * in compressed sparse row format.
+ *
+ * Nodes are identified by their index in [0, numNodes()). The outgoing
+ * edges of the node i are the edges in [edgeBegin(i), edgeEnd(i)): for
+ * each edge e, target(e) is the index of the target node and weight(e)
+ * its weight. Offsets, targets and weights are stored in contiguous
+ * vectors, so the visit of the graph is a linear scan of memory.
+ *
+ * The incoming edges are stored in the same format (reverse graph): the
+ * incoming edges of the node i are [reverseEdgeBegin(i), reverseEdgeEnd(i)),
+ * with source(e) and reverseWeight(e).
+ *
+ * The weights are stored with type W (see cg3::EdgeWeights): double by
+ * default, float or an integer type to save memory, Unweighted to store
+ * no weight at all (every edge has weight 1). weight(e) always returns
+ * a double.
+ *
+ * Undirected graphs are stored with both the directions of each edge,
+ * as in cg3::Graph. The snapshot is not updated when the original graph
+ * is modified.
+ */
+template <class T, class W = double>
+class CompiledGraph
+{
+
+public:
+
+    /* Typedefs */
+
+    static const size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief Range of the indices of the adjacent nodes, usable in range-based loops
+     */
+    struct AdjacentRange {
+        const size_t* first;
+        const size_t* last;
+        const size_t* begin() const { return first; }
+        const size_t* end() const { return last; }
+    };
+
+
+    /* Constructors */
+
+    CompiledGraph();
+    CompiledGraph(const Graph<T>& graph);
+    CompiledGraph(const IndexedGraph<T>& graph);
+    CompiledGraph(
+            const std::vector<T>& values,
+            const std::vector<size_t>& offsets,
+            const std::vector<size_t>& targets,
+            const std::vector<double>& weights);
+
+
+    /* Public methods */
+
+    size_t numNodes() const;
+    size_t numEdges() const;
+    bool empty() const;
+
+    const T& value(size_t node) const;
+    size_t index(const T& value) const;
+
+    size_t edgeBegin(size_t node) const;
+    size_t edgeEnd(size_t node) const;
+    size_t outDegree(size_t node) const;
+    size_t target(size_t edge) const;
+    double weight(size_t edge) const;
+    double maxWeight() const;
+    bool integerWeights() const;
+
+    size_t reverseEdgeBegin(size_t node) const;
+    size_t reverseEdgeEnd(size_t node) const;
+    size_t inDegree(size_t node) const;
+    size_t source(size_t reverseEdge) const;
+    double reverseWeight(size_t reverseEdge) const;
+
+    AdjacentRange adjacentIterator(size_t node) const;
+
+    template <class F>
+    void forEachEdge(F f, unsigned int nThreads = 1) const;
+
+
+protected:
+
+    /* Protected fields */
+
+    std::vector<T> values;
+    std::vector<std::pair<T, size_t>> sortedValues; //Pairs value/index sorted by value
+
+    std::vector<size_t> offsets;
+    std::vector<size_t> targets;
+    EdgeWeights<W> weights;
+
+    std::vector<size_t> reverseOffsets;
+    std::vector<size_t> sources;
+    EdgeWeights<W> reverseWeights;
+
+    double maxEdgeWeight;
+    bool integerEdgeWeights; //All the weights are non-negative integers
+
+
+    /* Helpers */
+
+    void buildIndex();
+    void buildReverse();
+    void updateWeightBounds(double weight);
+
+};
+
+template <class W = double, class T>
+CompiledGraph<T, W> compile(const Graph<T>& graph);
+
+template <class W = double, class T>
+CompiledGraph<T, W> compile(const IndexedGraph<T>& graph);
+
+}
+
+#include "compiled_graph.tpp"
+
+#endif // CG3_COMPILED_GRAPH_H
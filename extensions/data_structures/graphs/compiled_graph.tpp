@@ -0,0 +1,438 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "compiled_graph.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+template <class T, class W>
+const size_t CompiledGraph<T, W>::NOT_FOUND;
+
+
+/* ----- CONSTRUCTORS ----- */
+
+/**
+ * @brief Constructor of an empty graph
+ */
+template <class T, class W>
+CompiledGraph<T, W>::CompiledGraph() :
+    offsets(1, 0),
+    reverseOffsets(1, 0),
+    maxEdgeWeight(0),
+    integerEdgeWeights(true)
+{
+
+}
+
+/**
+ * @brief Constructor which takes a snapshot of a graph. Nodes are indexed
+ * in the order of the node iterator of the graph.
+ * @param graph Input graph
+ */
+template <class T, class W>
+CompiledGraph<T, W>::CompiledGraph(const Graph<T>& graph) :
+    maxEdgeWeight(0),
+    integerEdgeWeights(true)
+{
+    typedef typename Graph<T>::NodeIterator NodeIterator;
+    typedef typename Graph<T>::AdjacentIterator AdjacentIterator;
+
+    //Node indices
+    for (NodeIterator it = graph.nodeBegin(); it != graph.nodeEnd(); it++) {
+        values.push_back(*it);
+    }
+
+    buildIndex();
+
+    //Edges in compressed sparse row format
+    offsets.reserve(values.size() + 1);
+    offsets.push_back(0);
+
+    for (NodeIterator it = graph.nodeBegin(); it != graph.nodeEnd(); it++) {
+        for (AdjacentIterator adjIt = graph.adjacentBegin(it); adjIt != graph.adjacentEnd(it); adjIt++) {
+            targets.push_back(index(*adjIt));
+            weights.pushBack(graph.getWeight(it, adjIt));
+            updateWeightBounds(weights.get(targets.size() - 1));
+        }
+        offsets.push_back(targets.size());
+    }
+
+    buildReverse();
+}
+
+/**
+ * @brief Constructor which takes a snapshot of an indexed graph. Nodes are
+ * indexed in the order of their ids (the ids of deleted nodes are skipped,
+ * so the indices are equal to the ids if no node has been deleted).
+ * @param graph Input graph
+ */
+template <class T, class W>
+CompiledGraph<T, W>::CompiledGraph(const IndexedGraph<T>& graph) :
+    maxEdgeWeight(0),
+    integerEdgeWeights(true)
+{
+    typedef typename IndexedGraph<T>::NodeId NodeId;
+    typedef typename IndexedGraph<T>::Edge Edge;
+
+    //Node indices
+    std::vector<size_t> nodeIndex(graph.idBound(), NOT_FOUND);
+    for (NodeId id = 0; id < graph.idBound(); id++) {
+        if (graph.isValid(id)) {
+            nodeIndex[id] = values.size();
+            values.push_back(graph.value(id));
+        }
+    }
+
+    buildIndex();
+
+    //Edges in compressed sparse row format
+    offsets.reserve(values.size() + 1);
+    offsets.push_back(0);
+    targets.reserve(graph.numEdges());
+    weights.reserve(graph.numEdges());
+
+    for (NodeId id = 0; id < graph.idBound(); id++) {
+        if (graph.isValid(id)) {
+            for (const Edge& edge : graph.adjacentEdges(id)) {
+                targets.push_back(nodeIndex[edge.target]);
+                weights.pushBack(edge.weight);
+                updateWeightBounds(weights.get(targets.size() - 1));
+            }
+            offsets.push_back(targets.size());
+        }
+    }
+
+    buildReverse();
+}
+
+/**
+ * @brief Constructor from the arrays of the compressed sparse row format
+ * @param values Values of the nodes
+ * @param offsets First edge of each node (numNodes + 1 entries, the last
+ * one is the number of edges)
+ * @param targets Index of the target node of each edge
+ * @param weights Weight of each edge (converted to W)
+ */
+template <class T, class W>
+CompiledGraph<T, W>::CompiledGraph(
+        const std::vector<T>& values,
+        const std::vector<size_t>& offsets,
+        const std::vector<size_t>& targets,
+        const std::vector<double>& weights) :
+    values(values),
+    offsets(offsets),
+    targets(targets),
+    maxEdgeWeight(0),
+    integerEdgeWeights(true)
+{
+    this->weights.reserve(weights.size());
+    for (double weight : weights) {
+        this->weights.pushBack(weight);
+        updateWeightBounds(this->weights.get(this->weights.size() - 1));
+    }
+
+    buildIndex();
+    buildReverse();
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Get the number of nodes
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::numNodes() const
+{
+    return values.size();
+}
+
+/**
+ * @brief Get the number of (directed) edges
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::numEdges() const
+{
+    return targets.size();
+}
+
+/**
+ * @brief Check if the graph has no nodes
+ */
+template <class T, class W>
+bool CompiledGraph<T, W>::empty() const
+{
+    return values.empty();
+}
+
+/**
+ * @brief Get the value of a node
+ * @param node Index of the node
+ */
+template <class T, class W>
+const T& CompiledGraph<T, W>::value(size_t node) const
+{
+    return values[node];
+}
+
+/**
+ * @brief Get the index of the node with a given value
+ * @param value Value of the node
+ * @return Index of the node, NOT_FOUND if there is no node with that value
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::index(const T& value) const
+{
+    typename std::vector<std::pair<T, size_t>>::const_iterator it =
+            std::lower_bound(
+                sortedValues.begin(),
+                sortedValues.end(),
+                value,
+                [] (const std::pair<T, size_t>& pair, const T& v) {
+                    return pair.first < v;
+                });
+
+    if (it == sortedValues.end() || value < it->first)
+        return NOT_FOUND;
+
+    return it->second;
+}
+
+/**
+ * @brief Get the first outgoing edge of a node
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::edgeBegin(size_t node) const
+{
+    return offsets[node];
+}
+
+/**
+ * @brief Get the end of the outgoing edges of a node
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::edgeEnd(size_t node) const
+{
+    return offsets[node + 1];
+}
+
+/**
+ * @brief Get the number of outgoing edges of a node
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::outDegree(size_t node) const
+{
+    return offsets[node + 1] - offsets[node];
+}
+
+/**
+ * @brief Get the index of the target node of an edge
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::target(size_t edge) const
+{
+    return targets[edge];
+}
+
+/**
+ * @brief Get the weight of an edge (1 if the graph is Unweighted)
+ */
+template <class T, class W>
+double CompiledGraph<T, W>::weight(size_t edge) const
+{
+    return weights.get(edge);
+}
+
+/**
+ * @brief Get the maximum weight of the edges (0 if there are no edges)
+ */
+template <class T, class W>
+double CompiledGraph<T, W>::maxWeight() const
+{
+    return maxEdgeWeight;
+}
+
+/**
+ * @brief Check if all the weights are non-negative integers (true if
+ * there are no edges), as required by the integer key queues of dijkstra
+ */
+template <class T, class W>
+bool CompiledGraph<T, W>::integerWeights() const
+{
+    return integerEdgeWeights;
+}
+
+/**
+ * @brief Get the first incoming edge of a node
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::reverseEdgeBegin(size_t node) const
+{
+    return reverseOffsets[node];
+}
+
+/**
+ * @brief Get the end of the incoming edges of a node
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::reverseEdgeEnd(size_t node) const
+{
+    return reverseOffsets[node + 1];
+}
+
+/**
+ * @brief Get the number of incoming edges of a node
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::inDegree(size_t node) const
+{
+    return reverseOffsets[node + 1] - reverseOffsets[node];
+}
+
+/**
+ * @brief Get the index of the source node of an incoming edge
+ */
+template <class T, class W>
+size_t CompiledGraph<T, W>::source(size_t reverseEdge) const
+{
+    return sources[reverseEdge];
+}
+
+/**
+ * @brief Get the weight of an incoming edge
+ */
+template <class T, class W>
+double CompiledGraph<T, W>::reverseWeight(size_t reverseEdge) const
+{
+    return reverseWeights.get(reverseEdge);
+}
+
+/**
+ * @brief Get the indices of the nodes adjacent to a node
+ */
+template <class T, class W>
+typename CompiledGraph<T, W>::AdjacentRange CompiledGraph<T, W>::adjacentIterator(size_t node) const
+{
+    AdjacentRange range;
+    range.first = targets.data() + offsets[node];
+    range.last = targets.data() + offsets[node + 1];
+    return range;
+}
+
+/**
+ * @brief Call f(source, target, weight) for each edge of the graph, with
+ * the indices of the nodes. With more than one thread, the source nodes
+ * are split in chunks which are visited in parallel: f must be thread
+ * safe, but all the outgoing edges of a node are visited in order by the
+ * same thread.
+ * @param f Function called for each edge
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <class T, class W>
+template <class F>
+void CompiledGraph<T, W>::forEachEdge(F f, unsigned int nThreads) const
+{
+    parallelForChunks(values.size(), internal::EDGE_VISIT_CHUNK_SIZE,
+            [&] (unsigned int, size_t, size_t begin, size_t end) {
+        for (size_t source = begin; source < end; source++) {
+            for (size_t e = offsets[source]; e < offsets[source + 1]; e++)
+                f(source, targets[e], weights.get(e));
+        }
+    }, nThreads);
+}
+
+
+
+/* ----- HELPERS ----- */
+
+/**
+ * @brief Build the pairs value/index sorted by value
+ */
+template <class T, class W>
+void CompiledGraph<T, W>::buildIndex()
+{
+    sortedValues.clear();
+    sortedValues.reserve(values.size());
+    for (size_t i = 0; i < values.size(); i++)
+        sortedValues.push_back(std::make_pair(values[i], i));
+
+    std::sort(sortedValues.begin(), sortedValues.end());
+}
+
+/**
+ * @brief Build the incoming edges from the outgoing edges (counting sort
+ * on the targets)
+ */
+template <class T, class W>
+void CompiledGraph<T, W>::buildReverse()
+{
+    const size_t n = values.size();
+
+    reverseOffsets.assign(n + 1, 0);
+    for (size_t e = 0; e < targets.size(); e++)
+        reverseOffsets[targets[e] + 1]++;
+    for (size_t i = 0; i < n; i++)
+        reverseOffsets[i + 1] += reverseOffsets[i];
+
+    sources.resize(targets.size());
+    reverseWeights.resize(targets.size());
+
+    std::vector<size_t> positions(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t e = offsets[i]; e < offsets[i + 1]; e++) {
+            size_t position = positions[targets[e]]++;
+            sources[position] = i;
+            reverseWeights.set(position, weights.get(e));
+        }
+    }
+}
+
+/**
+ * @brief Update the maximum weight and the integer weights flag with the
+ * weight of a new edge
+ */
+template <class T, class W>
+void CompiledGraph<T, W>::updateWeightBounds(double weight)
+{
+    maxEdgeWeight = std::max(maxEdgeWeight, weight);
+    if (weight < 0 || weight != std::floor(weight))
+        integerEdgeWeights = false;
+}
+
+
+
+/* ----- COMPILE ----- */
+
+/**
+ * @brief Take an immutable compressed sparse row snapshot of a graph,
+ * to be used in the algorithms which visit the graph many times. The
+ * type of the weights can be chosen with the template argument W, e.g.
+ * compile<Unweighted>(graph) or compile<float>(graph).
+ * @param graph Input graph
+ * @return Compiled graph
+ */
+template <class W, class T>
+CompiledGraph<T, W> compile(const Graph<T>& graph)
+{
+    return CompiledGraph<T, W>(graph);
+}
+
+/**
+ * @brief Take an immutable compressed sparse row snapshot of an indexed graph
+ * @param graph Input graph
+ * @return Compiled graph
+ */
+template <class W, class T>
+CompiledGraph<T, W> compile(const IndexedGraph<T>& graph)
+{
+    return CompiledGraph<T, W>(graph);
+}
+
+}
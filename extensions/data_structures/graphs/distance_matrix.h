@@ -0,0 +1,56 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_DISTANCE_MATRIX_H
+#define CG3_DISTANCE_MATRIX_H
+
+#include <vector>
+#include <cstddef>
+
+namespace cg3 {
+
+/**
+ * @brief Square matrix of distances between the nodes of a graph,
+ * stored in a single contiguous vector (row-major order): the row i
+ * contains the distances from the node i.
+ */
+class DistanceMatrix
+{
+
+public:
+
+    /* Constructors */
+
+    inline DistanceMatrix();
+    inline DistanceMatrix(size_t numNodes, double value);
+
+
+    /* Public methods */
+
+    inline size_t numNodes() const;
+
+    inline double& operator()(size_t source, size_t target);
+    inline const double& operator()(size_t source, size_t target) const;
+
+    inline double* row(size_t source);
+    inline const double* row(size_t source) const;
+
+    inline bool operator==(const DistanceMatrix& other) const;
+    inline bool operator!=(const DistanceMatrix& other) const;
+
+
+protected:
+
+    /* Protected fields */
+
+    size_t n;
+    std::vector<double> distances;
+
+};
+
+}
+
+#include "distance_matrix.tpp"
+
+#endif // CG3_DISTANCE_MATRIX_H
@@ -0,0 +1,80 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "distance_matrix.h"
+
+namespace cg3 {
+
+/**
+ * @brief Constructor of an empty matrix
+ */
+inline DistanceMatrix::DistanceMatrix() :
+    n(0)
+{
+
+}
+
+/**
+ * @brief Constructor of a matrix with all the entries set to a value
+ * @param numNodes Number of nodes (rows and columns)
+ * @param value Initial value of the entries
+ */
+inline DistanceMatrix::DistanceMatrix(size_t numNodes, double value) :
+    n(numNodes),
+    distances(numNodes * numNodes, value)
+{
+
+}
+
+/**
+ * @brief Get the number of nodes (rows and columns)
+ */
+inline size_t DistanceMatrix::numNodes() const
+{
+    return n;
+}
+
+/**
+ * @brief Get the distance between two nodes
+ */
+inline double& DistanceMatrix::operator()(size_t source, size_t target)
+{
+    return distances[source * n + target];
+}
+
+/**
+ * @brief Get the distance between two nodes
+ */
+inline const double& DistanceMatrix::operator()(size_t source, size_t target) const
+{
+    return distances[source * n + target];
+}
+
+/**
+ * @brief Get the distances from a node (contiguous array of numNodes() values)
+ */
+inline double* DistanceMatrix::row(size_t source)
+{
+    return distances.data() + source * n;
+}
+
+/**
+ * @brief Get the distances from a node (contiguous array of numNodes() values)
+ */
+inline const double* DistanceMatrix::row(size_t source) const
+{
+    return distances.data() + source * n;
+}
+
+inline bool DistanceMatrix::operator==(const DistanceMatrix& other) const
+{
+    return n == other.n && distances == other.distances;
+}
+
+inline bool DistanceMatrix::operator!=(const DistanceMatrix& other) const
+{
+    return !(*this == other);
+}
+
+}
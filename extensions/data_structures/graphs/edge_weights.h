@@ -0,0 +1,80 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_EDGE_WEIGHTS_H
+#define CG3_EDGE_WEIGHTS_H
+
+#include <vector>
+#include <cstddef>
+
+namespace cg3 {
+
+/**
+ * @brief Weight type of the graphs without weights: no weight is stored
+ * and every edge has unit weight
+ */
+struct Unweighted {};
+
+/**
+ * @brief Array of edge weights stored with type W (double, float, an
+ * integer type or Unweighted). Weights are read and written as double:
+ * they are converted to W when they are stored (rounded for integer types).
+ */
+template <class W>
+class EdgeWeights
+{
+
+public:
+
+    /* Bytes used to store the weight of an edge */
+    static const size_t WEIGHT_SIZE = sizeof(W);
+
+    EdgeWeights();
+
+    size_t size() const;
+    void reserve(size_t size);
+    void resize(size_t size);
+    void pushBack(double weight);
+    void set(size_t edge, double weight);
+    double get(size_t edge) const;
+
+protected:
+
+    std::vector<W> weights;
+
+};
+
+/**
+ * @brief Specialization for graphs without weights: only the number of
+ * edges is stored
+ */
+template <>
+class EdgeWeights<Unweighted>
+{
+
+public:
+
+    /* Bytes used to store the weight of an edge */
+    static const size_t WEIGHT_SIZE = 0;
+
+    EdgeWeights();
+
+    size_t size() const;
+    void reserve(size_t size);
+    void resize(size_t size);
+    void pushBack(double weight);
+    void set(size_t edge, double weight);
+    double get(size_t edge) const;
+
+protected:
+
+    size_t numWeights;
+
+};
+
+}
+
+#include "edge_weights.tpp"
+
+#endif // CG3_EDGE_WEIGHTS_H
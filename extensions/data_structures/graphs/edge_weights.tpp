@@ -0,0 +1,128 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "edge_weights.h"
+
+#include <cmath>
+#include <type_traits>
+
+namespace cg3 {
+
+template <class W>
+const size_t EdgeWeights<W>::WEIGHT_SIZE;
+
+
+/* ----- EDGE WEIGHTS ----- */
+
+template <class W>
+EdgeWeights<W>::EdgeWeights()
+{
+
+}
+
+/**
+ * @brief Get the number of weights
+ */
+template <class W>
+size_t EdgeWeights<W>::size() const
+{
+    return weights.size();
+}
+
+/**
+ * @brief Reserve the memory for a number of weights
+ */
+template <class W>
+void EdgeWeights<W>::reserve(size_t size)
+{
+    weights.reserve(size);
+}
+
+/**
+ * @brief Set the number of weights (new weights are 0)
+ */
+template <class W>
+void EdgeWeights<W>::resize(size_t size)
+{
+    weights.resize(size);
+}
+
+/**
+ * @brief Append a weight
+ */
+template <class W>
+void EdgeWeights<W>::pushBack(double weight)
+{
+    weights.push_back(W());
+    set(weights.size() - 1, weight);
+}
+
+/**
+ * @brief Set the weight of an edge, converted to W
+ */
+template <class W>
+void EdgeWeights<W>::set(size_t edge, double weight)
+{
+    weights[edge] = static_cast<W>(std::is_integral<W>::value ? std::round(weight) : weight);
+}
+
+/**
+ * @brief Get the weight of an edge
+ */
+template <class W>
+double EdgeWeights<W>::get(size_t edge) const
+{
+    return static_cast<double>(weights[edge]);
+}
+
+
+
+/* ----- UNWEIGHTED ----- */
+
+inline EdgeWeights<Unweighted>::EdgeWeights() :
+    numWeights(0)
+{
+
+}
+
+inline size_t EdgeWeights<Unweighted>::size() const
+{
+    return numWeights;
+}
+
+inline void EdgeWeights<Unweighted>::reserve(size_t)
+{
+
+}
+
+inline void EdgeWeights<Unweighted>::resize(size_t size)
+{
+    numWeights = size;
+}
+
+/**
+ * @brief Append an edge (the weight is ignored)
+ */
+inline void EdgeWeights<Unweighted>::pushBack(double)
+{
+    numWeights++;
+}
+
+/**
+ * @brief Ignored: the weight of every edge is 1
+ */
+inline void EdgeWeights<Unweighted>::set(size_t, double)
+{
+
+}
+
+/**
+ * @brief Get the weight of an edge: always 1
+ */
+inline double EdgeWeights<Unweighted>::get(size_t) const
+{
+    return 1;
+}
+
+}
@@ -0,0 +1,202 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_INDEXED_BIPARTITE_GRAPH_H
+#define CG3_INDEXED_BIPARTITE_GRAPH_H
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <limits>
+
+#include <cg3/data_structures/graphs/bipartite_graph.h>
+
+namespace cg3 {
+
+/**
+ * @brief Bipartite graph whose left and right nodes are identified by
+ * dense integer ids.
+ *
+ * addLeftNode and addRightNode return the ids of the new nodes, which are
+ * the handles taken by every operation on the arcs: the maps from values
+ * to ids are used only when nodes are added and by tryFindLeftNode and
+ * tryFindRightNode, which report a missing value without throwing. The
+ * ids of the left nodes are in [0, leftIdBound()), the ids of the right
+ * nodes in [0, rightIdBound()); ids never change while the node exists,
+ * and the ids of deleted nodes are not valid (and not reused).
+ *
+ * The arcs are stored in compressed sparse row format in both the
+ * directions: the right nodes adjacent to each left node and the left
+ * nodes adjacent to each right node, sorted by id. The arcs added by
+ * addArc and addArcs are kept in a list of pending arcs, which build()
+ * merges in the arrays with a linear visit (repeated arcs are stored
+ * once, with the last weight). Each arc has a weight, stored in arrays
+ * aligned with the adjacency arrays: adjacentRightWeights(u) and
+ * adjacentLeftWeights(v) yield the weights of the arcs in the order of
+ * adjacentRightNodes(u) and adjacentLeftNodes(v).
+ *
+ * Deleting a node empties its own adjacency, but does not look for it
+ * in the adjacency of its neighbors: there it is left as a tombstone,
+ * and the neighbors are marked. build() removes the tombstones from the
+ * marked nodes only, so deleting a set of nodes (one at a time or with
+ * deleteLeftNodes and deleteRightNodes) takes time linear in the arcs of
+ * the deleted nodes and of their neighbors. The emptied slots of the
+ * arrays are released by a compaction when their ratio exceeds a
+ * threshold (see setCompactionPolicy).
+ *
+ * The queries on the arcs call build() if some arcs are pending or some
+ * nodes have been deleted: it must be called explicitly before the graph
+ * is read by more than one thread.
+ */
+template <class T1, class T2>
+class IndexedBipartiteGraph
+{
+
+public:
+
+    /* Typedefs */
+
+    typedef size_t LeftId;
+    typedef size_t RightId;
+
+    static const size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+    static constexpr double MAX_WEIGHT = std::numeric_limits<double>::max();
+
+    /**
+     * @brief Range of the ids of the adjacent nodes, usable in range-based loops
+     */
+    struct AdjacentRange {
+        const size_t* first;
+        const size_t* last;
+        const size_t* begin() const { return first; }
+        const size_t* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    /**
+     * @brief Range of the weights of the arcs of a node, usable in range-based loops
+     */
+    struct WeightRange {
+        const double* first;
+        const double* last;
+        const double* begin() const { return first; }
+        const double* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+
+    /* Constructors */
+
+    IndexedBipartiteGraph();
+    IndexedBipartiteGraph(const BipartiteGraph<T1, T2>& graph);
+
+
+    /* Public methods */
+
+    size_t numLeftNodes() const;
+    size_t numRightNodes() const;
+    size_t numArcs() const;
+    bool empty() const;
+    LeftId leftIdBound() const;
+    RightId rightIdBound() const;
+
+    bool isValidLeft(LeftId u) const;
+    bool isValidRight(RightId v) const;
+    const T1& leftValue(LeftId u) const;
+    const T2& rightValue(RightId v) const;
+    bool tryFindLeftNode(const T1& value, LeftId& u) const;
+    bool tryFindRightNode(const T2& value, RightId& v) const;
+
+    LeftId addLeftNode(const T1& value);
+    RightId addRightNode(const T2& value);
+    std::vector<LeftId> addLeftNodes(const std::vector<T1>& values);
+    std::vector<RightId> addRightNodes(const std::vector<T2>& values);
+    bool deleteLeftNode(LeftId u);
+    bool deleteRightNode(RightId v);
+    size_t deleteLeftNodes(const std::vector<LeftId>& ids);
+    size_t deleteRightNodes(const std::vector<RightId>& ids);
+
+    bool addArc(LeftId u, RightId v, double weight = 0);
+    void addArcs(
+            const std::vector<std::pair<LeftId, RightId>>& arcs,
+            const std::vector<double>& weights = std::vector<double>());
+
+    bool isAdjacent(LeftId u, RightId v) const;
+    double getWeight(LeftId u, RightId v) const;
+    void setWeight(LeftId u, RightId v, double weight);
+    size_t leftDegree(LeftId u) const;
+    size_t rightDegree(RightId v) const;
+    AdjacentRange adjacentRightNodes(LeftId u) const;
+    AdjacentRange adjacentLeftNodes(RightId v) const;
+    WeightRange adjacentRightWeights(LeftId u) const;
+    WeightRange adjacentLeftWeights(RightId v) const;
+
+    void build() const;
+    void reserve(size_t numLeftNodes, size_t numRightNodes, size_t numArcs);
+    void clear();
+
+
+    /* Compaction */
+
+    void setCompactionPolicy(double maxTombstoneRatio);
+    double tombstoneRatio() const;
+    void compact();
+
+
+protected:
+
+    /* Protected fields */
+
+    std::vector<T1> leftValues;
+    std::vector<T2> rightValues;
+
+    std::map<T1, LeftId> leftMap;
+    std::map<T2, RightId> rightMap;
+
+    std::vector<bool> leftDeleted;
+    std::vector<bool> rightDeleted;
+    size_t numDeletedLeft;
+    size_t numDeletedRight;
+
+    //Arrays of the compressed sparse row format, updated by build(). The
+    //arcs of a node are in [offsets[id], ends[id]), the slots up to
+    //offsets[id + 1] are empty.
+    mutable std::vector<size_t> leftOffsets; //First arc of each left node
+    mutable std::vector<size_t> leftEnds; //End of the arcs of each left node
+    mutable std::vector<RightId> leftArcs; //Right node of each arc of the left nodes
+    mutable std::vector<double> leftWeights; //Weight of each arc of the left nodes
+    mutable std::vector<size_t> rightOffsets; //First arc of each right node
+    mutable std::vector<size_t> rightEnds; //End of the arcs of each right node
+    mutable std::vector<LeftId> rightArcs; //Left node of each arc of the right nodes
+    mutable std::vector<double> rightWeights; //Weight of each arc of the right nodes
+    mutable size_t numStoredArcs; //Arcs between nodes which are not deleted
+
+    mutable std::vector<std::pair<LeftId, RightId>> pendingArcs;
+    mutable std::vector<double> pendingWeights; //Weight of each pending arc
+
+    //Nodes whose adjacency contains tombstones
+    mutable std::vector<bool> leftMarked;
+    mutable std::vector<bool> rightMarked;
+    mutable std::vector<LeftId> markedLeftIds;
+    mutable std::vector<RightId> markedRightIds;
+
+    double maxTombstoneRatio;
+
+
+    /* Helpers */
+
+    bool isBuilt() const;
+    void purgeTombstones() const;
+    void mergePendingArcs() const;
+    void packLeftArcs() const;
+    void buildRightArcs() const;
+    size_t findArc(LeftId u, RightId v) const;
+
+};
+
+}
+
+#include "indexed_bipartite_graph.tpp"
+
+#endif // CG3_INDEXED_BIPARTITE_GRAPH_H
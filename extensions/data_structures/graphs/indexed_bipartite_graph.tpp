@@ -0,0 +1,1032 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "indexed_bipartite_graph.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Default ratio of empty slots of the adjacency arrays which starts the compaction */
+static const double BIPARTITE_MAX_TOMBSTONE_RATIO = 0.25;
+
+template <class V>
+std::vector<size_t> insertIndexedValues(
+        const std::vector<V>& newValues,
+        std::vector<V>& values,
+        std::map<V, size_t>& valueMap,
+        size_t notFound);
+
+inline size_t removeDeletedArcs(
+        size_t first,
+        size_t last,
+        std::vector<size_t>& arcs,
+        std::vector<double>& weights,
+        const std::vector<bool>& deleted);
+
+}
+
+template <class T1, class T2>
+const size_t IndexedBipartiteGraph<T1, T2>::NOT_FOUND;
+
+template <class T1, class T2>
+constexpr double IndexedBipartiteGraph<T1, T2>::MAX_WEIGHT;
+
+
+/* ----- CONSTRUCTORS ----- */
+
+/**
+ * @brief Constructor of an empty graph
+ */
+template <class T1, class T2>
+IndexedBipartiteGraph<T1, T2>::IndexedBipartiteGraph() :
+    numDeletedLeft(0),
+    numDeletedRight(0),
+    leftOffsets(1, 0),
+    rightOffsets(1, 0),
+    numStoredArcs(0),
+    maxTombstoneRatio(internal::BIPARTITE_MAX_TOMBSTONE_RATIO)
+{
+
+}
+
+/**
+ * @brief Constructor which copies a cg3::BipartiteGraph. Ids are assigned
+ * in the order of the node iterators of the graph, the weights of the
+ * arcs are 0.
+ * @param graph Input graph
+ */
+template <class T1, class T2>
+IndexedBipartiteGraph<T1, T2>::IndexedBipartiteGraph(const BipartiteGraph<T1, T2>& graph) :
+    numDeletedLeft(0),
+    numDeletedRight(0),
+    leftOffsets(1, 0),
+    rightOffsets(1, 0),
+    numStoredArcs(0),
+    maxTombstoneRatio(internal::BIPARTITE_MAX_TOMBSTONE_RATIO)
+{
+    std::vector<T1> graphLeftValues;
+    for (const T1& u : graph.leftNodeIterator()) {
+        graphLeftValues.push_back(u);
+    }
+    addLeftNodes(graphLeftValues);
+
+    std::vector<T2> graphRightValues;
+    for (const T2& v : graph.rightNodeIterator()) {
+        graphRightValues.push_back(v);
+    }
+    addRightNodes(graphRightValues);
+
+    for (LeftId u = 0; u < leftValues.size(); u++) {
+        for (const T2& v : graph.adjacentLeftNodeIterator(leftValues[u])) {
+            pendingArcs.push_back(std::make_pair(u, rightMap.find(v)->second));
+        }
+    }
+    pendingWeights.assign(pendingArcs.size(), 0);
+
+    build();
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Get the number of left nodes (deleted nodes are not counted)
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::numLeftNodes() const
+{
+    return leftValues.size() - numDeletedLeft;
+}
+
+/**
+ * @brief Get the number of right nodes (deleted nodes are not counted)
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::numRightNodes() const
+{
+    return rightValues.size() - numDeletedRight;
+}
+
+/**
+ * @brief Get the number of arcs
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::numArcs() const
+{
+    build();
+    return numStoredArcs;
+}
+
+/**
+ * @brief Check if the graph has no nodes
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::empty() const
+{
+    return numLeftNodes() == 0 && numRightNodes() == 0;
+}
+
+/**
+ * @brief Get the upper bound of the ids of the left nodes: the ids are in
+ * [0, leftIdBound()), ids of deleted nodes are not valid
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::LeftId IndexedBipartiteGraph<T1, T2>::leftIdBound() const
+{
+    return leftValues.size();
+}
+
+/**
+ * @brief Get the upper bound of the ids of the right nodes: the ids are
+ * in [0, rightIdBound()), ids of deleted nodes are not valid
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::RightId IndexedBipartiteGraph<T1, T2>::rightIdBound() const
+{
+    return rightValues.size();
+}
+
+/**
+ * @brief Check if an id is the id of a left node of the graph
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::isValidLeft(LeftId u) const
+{
+    return u < leftValues.size() && !leftDeleted[u];
+}
+
+/**
+ * @brief Check if an id is the id of a right node of the graph
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::isValidRight(RightId v) const
+{
+    return v < rightValues.size() && !rightDeleted[v];
+}
+
+/**
+ * @brief Get the value of a left node
+ * @param u Id of the node
+ */
+template <class T1, class T2>
+const T1& IndexedBipartiteGraph<T1, T2>::leftValue(LeftId u) const
+{
+    return leftValues[u];
+}
+
+/**
+ * @brief Get the value of a right node
+ * @param v Id of the node
+ */
+template <class T1, class T2>
+const T2& IndexedBipartiteGraph<T1, T2>::rightValue(RightId v) const
+{
+    return rightValues[v];
+}
+
+/**
+ * @brief Find the id of the left node with a given value
+ * @param[in] value Value of the node
+ * @param[out] u Id of the node (NOT_FOUND if there is no node with that value)
+ * @return True if the node has been found
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::tryFindLeftNode(const T1& value, LeftId& u) const
+{
+    typename std::map<T1, LeftId>::const_iterator it = leftMap.find(value);
+    u = it == leftMap.end() ? NOT_FOUND : it->second;
+
+    return u != NOT_FOUND;
+}
+
+/**
+ * @brief Find the id of the right node with a given value
+ * @param[in] value Value of the node
+ * @param[out] v Id of the node (NOT_FOUND if there is no node with that value)
+ * @return True if the node has been found
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::tryFindRightNode(const T2& value, RightId& v) const
+{
+    typename std::map<T2, RightId>::const_iterator it = rightMap.find(value);
+    v = it == rightMap.end() ? NOT_FOUND : it->second;
+
+    return v != NOT_FOUND;
+}
+
+/**
+ * @brief Add a left node to the graph, with id leftIdBound()
+ * @param value Value of the node
+ * @return Id of the new node, NOT_FOUND if a left node with the same
+ * value is already in the graph
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::LeftId IndexedBipartiteGraph<T1, T2>::addLeftNode(const T1& value)
+{
+    typename std::map<T1, LeftId>::iterator it = leftMap.lower_bound(value);
+    if (it != leftMap.end() && !(value < it->first))
+        return NOT_FOUND;
+
+    LeftId id = leftValues.size();
+    leftMap.insert(it, std::make_pair(value, id));
+    leftValues.push_back(value);
+    leftDeleted.push_back(false);
+
+    return id;
+}
+
+/**
+ * @brief Add a right node to the graph, with id rightIdBound()
+ * @param value Value of the node
+ * @return Id of the new node, NOT_FOUND if a right node with the same
+ * value is already in the graph
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::RightId IndexedBipartiteGraph<T1, T2>::addRightNode(const T2& value)
+{
+    typename std::map<T2, RightId>::iterator it = rightMap.lower_bound(value);
+    if (it != rightMap.end() && !(value < it->first))
+        return NOT_FOUND;
+
+    RightId id = rightValues.size();
+    rightMap.insert(it, std::make_pair(value, id));
+    rightValues.push_back(value);
+    rightDeleted.push_back(false);
+
+    return id;
+}
+
+/**
+ * @brief Add a set of left nodes to the graph. The values are sorted
+ * before being inserted in the value map, so each insertion takes
+ * amortized constant time.
+ * @param values Values of the nodes
+ * @return Ids of the new nodes, in the order of the values (NOT_FOUND for
+ * the values which are already in the graph or repeated in the input)
+ */
+template <class T1, class T2>
+std::vector<typename IndexedBipartiteGraph<T1, T2>::LeftId> IndexedBipartiteGraph<T1, T2>::addLeftNodes(const std::vector<T1>& values)
+{
+    std::vector<LeftId> ids = internal::insertIndexedValues(values, leftValues, leftMap, NOT_FOUND);
+    leftDeleted.resize(leftValues.size(), false);
+
+    return ids;
+}
+
+/**
+ * @brief Add a set of right nodes to the graph (see addLeftNodes)
+ * @param values Values of the nodes
+ * @return Ids of the new nodes, in the order of the values (NOT_FOUND for
+ * the values which are already in the graph or repeated in the input)
+ */
+template <class T1, class T2>
+std::vector<typename IndexedBipartiteGraph<T1, T2>::RightId> IndexedBipartiteGraph<T1, T2>::addRightNodes(const std::vector<T2>& values)
+{
+    std::vector<RightId> ids = internal::insertIndexedValues(values, rightValues, rightMap, NOT_FOUND);
+    rightDeleted.resize(rightValues.size(), false);
+
+    return ids;
+}
+
+/**
+ * @brief Delete a left node. Its arcs are removed from its adjacency, and
+ * left as tombstones in the adjacency of its right nodes, which are
+ * marked to be purged by the next build(). The value of the node can be
+ * added again, with a new id.
+ * @param u Id of the node
+ * @return True if the node has been deleted, false if the id is not valid
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::deleteLeftNode(LeftId u)
+{
+    if (!isValidLeft(u))
+        return false;
+
+    leftDeleted[u] = true;
+    numDeletedLeft++;
+    leftMap.erase(leftValues[u]);
+
+    if (u < leftEnds.size()) {
+        for (size_t a = leftOffsets[u]; a < leftEnds[u]; a++) {
+            RightId v = leftArcs[a];
+            if (!rightDeleted[v]) {
+                numStoredArcs--;
+                if (!rightMarked[v]) {
+                    rightMarked[v] = true;
+                    markedRightIds.push_back(v);
+                }
+            }
+        }
+        leftEnds[u] = leftOffsets[u];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Delete a right node (see deleteLeftNode)
+ * @param v Id of the node
+ * @return True if the node has been deleted, false if the id is not valid
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::deleteRightNode(RightId v)
+{
+    if (!isValidRight(v))
+        return false;
+
+    rightDeleted[v] = true;
+    numDeletedRight++;
+    rightMap.erase(rightValues[v]);
+
+    if (v < rightEnds.size()) {
+        for (size_t a = rightOffsets[v]; a < rightEnds[v]; a++) {
+            LeftId u = rightArcs[a];
+            if (!leftDeleted[u]) {
+                numStoredArcs--;
+                if (!leftMarked[u]) {
+                    leftMarked[u] = true;
+                    markedLeftIds.push_back(u);
+                }
+            }
+        }
+        rightEnds[v] = rightOffsets[v];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Delete a set of left nodes. Each neighbor of the deleted nodes
+ * is purged once by the next build(), so the deletion takes time linear
+ * in the arcs of the deleted nodes and of their neighbors.
+ * @param ids Ids of the nodes (ids which are not valid are ignored)
+ * @return Number of deleted nodes
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::deleteLeftNodes(const std::vector<LeftId>& ids)
+{
+    size_t count = 0;
+    for (LeftId u : ids) {
+        if (deleteLeftNode(u))
+            count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Delete a set of right nodes (see deleteLeftNodes)
+ * @param ids Ids of the nodes (ids which are not valid are ignored)
+ * @return Number of deleted nodes
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::deleteRightNodes(const std::vector<RightId>& ids)
+{
+    size_t count = 0;
+    for (RightId v : ids) {
+        if (deleteRightNode(v))
+            count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Add an arc between a left node and a right node. The arc is
+ * pending until the next call of build(); if the arc is already in the
+ * graph, its weight is replaced.
+ * @param u Id of the left node
+ * @param v Id of the right node
+ * @param weight Weight of the arc
+ * @return True if the ids are valid
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::addArc(LeftId u, RightId v, double weight)
+{
+    if (!isValidLeft(u) || !isValidRight(v))
+        return false;
+
+    pendingArcs.push_back(std::make_pair(u, v));
+    pendingWeights.push_back(weight);
+
+    return true;
+}
+
+/**
+ * @brief Add a set of arcs to the graph. The arcs are pending until the
+ * next call of build() (for repeated arcs, the last weight is kept). Arcs
+ * with ids which are not valid are ignored.
+ * @param arcs Pairs left/right of the arcs
+ * @param weights Weights of the arcs (if empty, all the weights are 0)
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::addArcs(
+        const std::vector<std::pair<LeftId, RightId>>& arcs,
+        const std::vector<double>& weights)
+{
+    pendingArcs.reserve(pendingArcs.size() + arcs.size());
+    pendingWeights.reserve(pendingWeights.size() + arcs.size());
+
+    for (size_t i = 0; i < arcs.size(); i++) {
+        if (isValidLeft(arcs[i].first) && isValidRight(arcs[i].second)) {
+            pendingArcs.push_back(arcs[i]);
+            pendingWeights.push_back(weights.empty() ? 0 : weights[i]);
+        }
+    }
+}
+
+/**
+ * @brief Check if a left node and a right node are adjacent, with a
+ * binary search in the adjacency of the node with the smallest degree
+ * @param u Id of the left node
+ * @param v Id of the right node
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::isAdjacent(LeftId u, RightId v) const
+{
+    if (!isValidLeft(u) || !isValidRight(v))
+        return false;
+
+    AdjacentRange rightNodes = adjacentRightNodes(u);
+    AdjacentRange leftNodes = adjacentLeftNodes(v);
+
+    if (rightNodes.size() <= leftNodes.size())
+        return std::binary_search(rightNodes.begin(), rightNodes.end(), v);
+    else
+        return std::binary_search(leftNodes.begin(), leftNodes.end(), u);
+}
+
+/**
+ * @brief Get the weight of an arc
+ * @param u Id of the left node
+ * @param v Id of the right node
+ * @return Weight of the arc, MAX_WEIGHT if the nodes are not adjacent
+ */
+template <class T1, class T2>
+double IndexedBipartiteGraph<T1, T2>::getWeight(LeftId u, RightId v) const
+{
+    size_t a = findArc(u, v);
+    if (a == NOT_FOUND)
+        return MAX_WEIGHT;
+
+    return leftWeights[a];
+}
+
+/**
+ * @brief Set the weight of an existing arc, in the arrays of both the
+ * directions
+ * @param u Id of the left node
+ * @param v Id of the right node
+ * @param weight New weight of the arc
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::setWeight(LeftId u, RightId v, double weight)
+{
+    size_t a = findArc(u, v);
+    if (a == NOT_FOUND)
+        return;
+
+    leftWeights[a] = weight;
+
+    AdjacentRange leftNodes = adjacentLeftNodes(v);
+    size_t b = std::lower_bound(leftNodes.begin(), leftNodes.end(), u) - rightArcs.data();
+    rightWeights[b] = weight;
+}
+
+/**
+ * @brief Get the number of right nodes adjacent to a left node
+ * @param u Id of the left node
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::leftDegree(LeftId u) const
+{
+    return adjacentRightNodes(u).size();
+}
+
+/**
+ * @brief Get the number of left nodes adjacent to a right node
+ * @param v Id of the right node
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::rightDegree(RightId v) const
+{
+    return adjacentLeftNodes(v).size();
+}
+
+/**
+ * @brief Get the ids of the right nodes adjacent to a left node, sorted
+ * @param u Id of the left node
+ * @return Range of the ids (empty if the id is not valid)
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::AdjacentRange IndexedBipartiteGraph<T1, T2>::adjacentRightNodes(LeftId u) const
+{
+    build();
+
+    AdjacentRange range;
+    range.first = range.last = leftArcs.data();
+    if (isValidLeft(u)) {
+        range.first = leftArcs.data() + leftOffsets[u];
+        range.last = leftArcs.data() + leftEnds[u];
+    }
+
+    return range;
+}
+
+/**
+ * @brief Get the ids of the left nodes adjacent to a right node, sorted
+ * @param v Id of the right node
+ * @return Range of the ids (empty if the id is not valid)
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::AdjacentRange IndexedBipartiteGraph<T1, T2>::adjacentLeftNodes(RightId v) const
+{
+    build();
+
+    AdjacentRange range;
+    range.first = range.last = rightArcs.data();
+    if (isValidRight(v)) {
+        range.first = rightArcs.data() + rightOffsets[v];
+        range.last = rightArcs.data() + rightEnds[v];
+    }
+
+    return range;
+}
+
+/**
+ * @brief Get the weights of the arcs of a left node, in the order of
+ * adjacentRightNodes(u)
+ * @param u Id of the left node
+ * @return Range of the weights (empty if the id is not valid)
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::WeightRange IndexedBipartiteGraph<T1, T2>::adjacentRightWeights(LeftId u) const
+{
+    build();
+
+    WeightRange range;
+    range.first = range.last = leftWeights.data();
+    if (isValidLeft(u)) {
+        range.first = leftWeights.data() + leftOffsets[u];
+        range.last = leftWeights.data() + leftEnds[u];
+    }
+
+    return range;
+}
+
+/**
+ * @brief Get the weights of the arcs of a right node, in the order of
+ * adjacentLeftNodes(v)
+ * @param v Id of the right node
+ * @return Range of the weights (empty if the id is not valid)
+ */
+template <class T1, class T2>
+typename IndexedBipartiteGraph<T1, T2>::WeightRange IndexedBipartiteGraph<T1, T2>::adjacentLeftWeights(RightId v) const
+{
+    build();
+
+    WeightRange range;
+    range.first = range.last = rightWeights.data();
+    if (isValidRight(v)) {
+        range.first = rightWeights.data() + rightOffsets[v];
+        range.last = rightWeights.data() + rightEnds[v];
+    }
+
+    return range;
+}
+
+/**
+ * @brief Update the arrays of the compressed sparse row format. The
+ * tombstones are removed from the adjacency of the marked nodes; then,
+ * if there are pending arcs or new nodes, the pending arcs are merged in
+ * time linear in the number of arcs (plus the sort of the pending arcs
+ * of each node), otherwise the arrays are compacted if the ratio of
+ * empty slots exceeds the threshold. It takes nothing if the arrays are
+ * up to date.
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::build() const
+{
+    if (isBuilt())
+        return;
+
+    purgeTombstones();
+
+    if (!pendingArcs.empty() || leftEnds.size() != leftValues.size() || rightEnds.size() != rightValues.size()) {
+        mergePendingArcs();
+        buildRightArcs();
+    }
+
+    if (tombstoneRatio() > maxTombstoneRatio) {
+        packLeftArcs();
+        buildRightArcs();
+    }
+}
+
+/**
+ * @brief Reserve memory for the nodes and the arcs
+ * @param numLeftNodes Number of left nodes
+ * @param numRightNodes Number of right nodes
+ * @param numArcs Number of arcs
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::reserve(size_t numLeftNodes, size_t numRightNodes, size_t numArcs)
+{
+    leftValues.reserve(numLeftNodes);
+    rightValues.reserve(numRightNodes);
+    leftDeleted.reserve(numLeftNodes);
+    rightDeleted.reserve(numRightNodes);
+    leftOffsets.reserve(numLeftNodes + 1);
+    leftEnds.reserve(numLeftNodes);
+    rightOffsets.reserve(numRightNodes + 1);
+    rightEnds.reserve(numRightNodes);
+    leftArcs.reserve(numArcs);
+    leftWeights.reserve(numArcs);
+    rightArcs.reserve(numArcs);
+    rightWeights.reserve(numArcs);
+}
+
+/**
+ * @brief Remove all the nodes and the arcs
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::clear()
+{
+    leftValues.clear();
+    rightValues.clear();
+    leftMap.clear();
+    rightMap.clear();
+    leftDeleted.clear();
+    rightDeleted.clear();
+    numDeletedLeft = 0;
+    numDeletedRight = 0;
+    leftOffsets.assign(1, 0);
+    leftEnds.clear();
+    leftArcs.clear();
+    leftWeights.clear();
+    rightOffsets.assign(1, 0);
+    rightEnds.clear();
+    rightArcs.clear();
+    rightWeights.clear();
+    numStoredArcs = 0;
+    pendingArcs.clear();
+    pendingWeights.clear();
+    leftMarked.clear();
+    rightMarked.clear();
+    markedLeftIds.clear();
+    markedRightIds.clear();
+}
+
+
+
+/* ----- COMPACTION ----- */
+
+/**
+ * @brief Set the policy of the automatic compaction
+ * @param maxTombstoneRatio Ratio of empty slots of the adjacency arrays
+ * which starts the compaction in build() (1 or more to disable the
+ * automatic compaction)
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::setCompactionPolicy(double maxTombstoneRatio)
+{
+    this->maxTombstoneRatio = maxTombstoneRatio;
+}
+
+/**
+ * @brief Get the ratio of the slots of the adjacency arrays which do not
+ * contain an arc: slots emptied by the deletions and tombstones which
+ * have not been purged yet
+ */
+template <class T1, class T2>
+double IndexedBipartiteGraph<T1, T2>::tombstoneRatio() const
+{
+    size_t slots = leftArcs.size() + rightArcs.size();
+    if (slots == 0)
+        return 0;
+
+    return (double) (slots - 2 * numStoredArcs) / slots;
+}
+
+/**
+ * @brief Build the graph and release all the empty slots of the
+ * adjacency arrays, in time linear in the number of arcs
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::compact()
+{
+    build();
+
+    if (tombstoneRatio() > 0) {
+        packLeftArcs();
+        buildRightArcs();
+    }
+}
+
+
+
+/* ----- HELPERS ----- */
+
+/**
+ * @brief Check if the arrays contain all the nodes and all the arcs
+ */
+template <class T1, class T2>
+bool IndexedBipartiteGraph<T1, T2>::isBuilt() const
+{
+    return pendingArcs.empty() &&
+            markedLeftIds.empty() &&
+            markedRightIds.empty() &&
+            leftEnds.size() == leftValues.size() &&
+            rightEnds.size() == rightValues.size();
+}
+
+/**
+ * @brief Remove the tombstones (arcs to deleted nodes) from the adjacency
+ * of the marked nodes, moving their other arcs to the front of their
+ * slots
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::purgeTombstones() const
+{
+    for (LeftId u : markedLeftIds) {
+        if (!leftDeleted[u])
+            leftEnds[u] = internal::removeDeletedArcs(leftOffsets[u], leftEnds[u], leftArcs, leftWeights, rightDeleted);
+        leftMarked[u] = false;
+    }
+    markedLeftIds.clear();
+
+    for (RightId v : markedRightIds) {
+        if (!rightDeleted[v])
+            rightEnds[v] = internal::removeDeletedArcs(rightOffsets[v], rightEnds[v], rightArcs, rightWeights, leftDeleted);
+        rightMarked[v] = false;
+    }
+    markedRightIds.clear();
+}
+
+/**
+ * @brief Merge the pending arcs in the adjacency of the left nodes: the
+ * pending arcs are bucketed by left node (counting sort, which keeps the
+ * order of insertion), then the bucket of each node is sorted by right
+ * node and merged with its stored arcs. The weight of a repeated arc is
+ * the one of its last insertion.
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::mergePendingArcs() const
+{
+    const size_t n = leftValues.size();
+    const size_t numBuilt = leftEnds.size();
+
+    leftMarked.resize(n, false);
+
+    if (pendingArcs.empty()) {
+        size_t size = leftOffsets.back();
+        leftOffsets.resize(n + 1, size);
+        leftEnds.resize(n, size);
+        return;
+    }
+
+    //Buckets of the pending arcs between nodes which are not deleted:
+    //right node and position in the list
+    std::vector<size_t> pendingOffsets(n + 1, 0);
+    for (const std::pair<LeftId, RightId>& arc : pendingArcs) {
+        if (!leftDeleted[arc.first] && !rightDeleted[arc.second])
+            pendingOffsets[arc.first + 1]++;
+    }
+    std::partial_sum(pendingOffsets.begin(), pendingOffsets.end(), pendingOffsets.begin());
+
+    std::vector<std::pair<RightId, size_t>> pendingTargets(pendingOffsets.back());
+    std::vector<size_t> position(pendingOffsets.begin(), pendingOffsets.end() - 1);
+    for (size_t i = 0; i < pendingArcs.size(); i++) {
+        if (!leftDeleted[pendingArcs[i].first] && !rightDeleted[pendingArcs[i].second])
+            pendingTargets[position[pendingArcs[i].first]++] = std::make_pair(pendingArcs[i].second, i);
+    }
+
+    //Merge of the buckets with the stored arcs
+    std::vector<size_t> newOffsets;
+    std::vector<RightId> newArcs;
+    std::vector<double> newWeights;
+    newOffsets.reserve(n + 1);
+    newArcs.reserve(leftArcs.size() + pendingArcs.size());
+    newWeights.reserve(leftArcs.size() + pendingArcs.size());
+    newOffsets.push_back(0);
+
+    for (LeftId u = 0; u < n; u++) {
+        std::pair<RightId, size_t>* first = pendingTargets.data() + pendingOffsets[u];
+        std::pair<RightId, size_t>* last = pendingTargets.data() + pendingOffsets[u + 1];
+        std::sort(first, last);
+
+        size_t stored = 0;
+        size_t storedLast = 0;
+        if (u < numBuilt) {
+            stored = leftOffsets[u];
+            storedLast = leftEnds[u];
+        }
+
+        for (std::pair<RightId, size_t>* it = first; it != last; it++) {
+            //Only the last insertion of a repeated arc is merged
+            if (it + 1 != last && (it + 1)->first == it->first)
+                continue;
+
+            while (stored < storedLast && leftArcs[stored] < it->first) {
+                newArcs.push_back(leftArcs[stored]);
+                newWeights.push_back(leftWeights[stored]);
+                stored++;
+            }
+            if (stored < storedLast && leftArcs[stored] == it->first)
+                stored++;
+
+            newArcs.push_back(it->first);
+            newWeights.push_back(pendingWeights[it->second]);
+        }
+        for (; stored < storedLast; stored++) {
+            newArcs.push_back(leftArcs[stored]);
+            newWeights.push_back(leftWeights[stored]);
+        }
+
+        newOffsets.push_back(newArcs.size());
+    }
+
+    leftOffsets.swap(newOffsets);
+    leftEnds.assign(leftOffsets.begin() + 1, leftOffsets.end());
+    leftArcs.swap(newArcs);
+    leftWeights.swap(newWeights);
+    numStoredArcs = leftArcs.size();
+
+    pendingArcs.clear();
+    pendingWeights.clear();
+}
+
+/**
+ * @brief Move the arcs of the left nodes to the front of the arrays,
+ * releasing the empty slots
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::packLeftArcs() const
+{
+    size_t size = 0;
+    for (LeftId u = 0; u < leftEnds.size(); u++) {
+        size_t first = leftOffsets[u];
+        leftOffsets[u] = size;
+        for (size_t a = first; a < leftEnds[u]; a++) {
+            leftArcs[size] = leftArcs[a];
+            leftWeights[size] = leftWeights[a];
+            size++;
+        }
+        leftEnds[u] = size;
+    }
+    leftOffsets.back() = size;
+
+    leftArcs.resize(size);
+    leftWeights.resize(size);
+}
+
+/**
+ * @brief Build the adjacency of the right nodes from the adjacency of the
+ * left nodes (counting sort, so the left nodes are sorted by id)
+ */
+template <class T1, class T2>
+void IndexedBipartiteGraph<T1, T2>::buildRightArcs() const
+{
+    rightOffsets.assign(rightValues.size() + 1, 0);
+    for (LeftId u = 0; u < leftEnds.size(); u++) {
+        for (size_t a = leftOffsets[u]; a < leftEnds[u]; a++)
+            rightOffsets[leftArcs[a] + 1]++;
+    }
+    std::partial_sum(rightOffsets.begin(), rightOffsets.end(), rightOffsets.begin());
+
+    rightEnds.assign(rightOffsets.begin() + 1, rightOffsets.end());
+    rightMarked.resize(rightValues.size(), false);
+
+    rightArcs.resize(rightOffsets.back());
+    rightWeights.resize(rightOffsets.back());
+    std::vector<size_t> position(rightOffsets.begin(), rightOffsets.end() - 1);
+    for (LeftId u = 0; u < leftEnds.size(); u++) {
+        for (size_t a = leftOffsets[u]; a < leftEnds[u]; a++) {
+            size_t b = position[leftArcs[a]]++;
+            rightArcs[b] = u;
+            rightWeights[b] = leftWeights[a];
+        }
+    }
+}
+
+/**
+ * @brief Find the position of an arc in the adjacency of the left nodes
+ * @param u Id of the left node
+ * @param v Id of the right node
+ * @return Position of the arc in leftArcs, NOT_FOUND if the nodes are
+ * not adjacent
+ */
+template <class T1, class T2>
+size_t IndexedBipartiteGraph<T1, T2>::findArc(LeftId u, RightId v) const
+{
+    if (!isValidLeft(u) || !isValidRight(v))
+        return NOT_FOUND;
+
+    AdjacentRange rightNodes = adjacentRightNodes(u);
+    const RightId* it = std::lower_bound(rightNodes.begin(), rightNodes.end(), v);
+    if (it == rightNodes.end() || *it != v)
+        return NOT_FOUND;
+
+    return it - leftArcs.data();
+}
+
+
+namespace internal {
+
+/**
+ * @brief Insert values with dense ids: the values are inserted in the map
+ * in sorted order, using the position after the last insertion as hint,
+ * then the ids are assigned in the order of the input
+ * @param[in] newValues Values to be inserted
+ * @param[out] values Values indexed by id
+ * @param[out] valueMap Map from the values to the ids
+ * @param[in] notFound Id of the values which are not inserted
+ * @return Ids of the new values (notFound for the values which are
+ * already in the map or repeated in the input)
+ */
+template <class V>
+std::vector<size_t> insertIndexedValues(
+        const std::vector<V>& newValues,
+        std::vector<V>& values,
+        std::map<V, size_t>& valueMap,
+        size_t notFound)
+{
+    typedef typename std::map<V, size_t>::iterator MapIterator;
+
+    const size_t n = newValues.size();
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&newValues] (size_t a, size_t b) {
+        return newValues[a] < newValues[b];
+    });
+
+    std::vector<MapIterator> mapIterators(n);
+    std::vector<bool> inserted(n, false);
+
+    MapIterator hint = valueMap.begin();
+    for (size_t i = 0; i < n; i++) {
+        size_t k = order[i];
+        size_t previousSize = valueMap.size();
+
+        hint = valueMap.insert(hint, std::make_pair(newValues[k], notFound));
+
+        mapIterators[k] = hint;
+        inserted[k] = valueMap.size() > previousSize;
+
+        hint++;
+    }
+
+    values.reserve(values.size() + n);
+
+    std::vector<size_t> ids(n, notFound);
+    for (size_t k = 0; k < n; k++) {
+        if (inserted[k]) {
+            ids[k] = values.size();
+            mapIterators[k]->second = ids[k];
+            values.push_back(newValues[k]);
+        }
+    }
+
+    return ids;
+}
+
+/**
+ * @brief Remove the arcs to deleted nodes from the adjacency of a node,
+ * keeping the order of the other arcs
+ * @param[in] first First arc of the node
+ * @param[in] last End of the arcs of the node
+ * @param[out] arcs Adjacency array
+ * @param[out] weights Weights aligned with the adjacency array
+ * @param[in] deleted Deleted flags of the nodes of the other side
+ * @return New end of the arcs of the node
+ */
+inline size_t removeDeletedArcs(
+        size_t first,
+        size_t last,
+        std::vector<size_t>& arcs,
+        std::vector<double>& weights,
+        const std::vector<bool>& deleted)
+{
+    size_t end = first;
+    for (size_t a = first; a < last; a++) {
+        if (!deleted[arcs[a]]) {
+            arcs[end] = arcs[a];
+            weights[end] = weights[a];
+            end++;
+        }
+    }
+
+    return end;
+}
+
+}
+
+}
@@ -0,0 +1,322 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_INDEXED_GRAPH_H
+#define CG3_INDEXED_GRAPH_H
+
+#include <vector>
+#include <utility>
+#include <limits>
+
+#include <cg3/data_structures/graphs/graph.h>
+
+namespace cg3 {
+
+/**
+ * @brief Mutable graph whose nodes are identified by dense integer ids.
+ *
+ * addNode returns the id of the new node: ids never change while the node
+ * exists. Every operation on nodes and edges takes ids, so the values are
+ * looked up only by addNode and findNode. Nodes and edges can also be
+ * inserted in bulk with addNodes and addEdges. All the edges can be
+ * visited, with their source and weight, by edges() or forEachEdge (which
+ * can split the visit among threads).
+ *
+ * The values are looked up by binary search in an array of pairs value/id
+ * sorted by value. addNode inserts in a small sorted buffer (proportional to
+ * the square root of the number of nodes), which is merged in the array
+ * when it is full; addNodes merges all the values at once. The pairs of the
+ * deleted nodes are skipped, and dropped by the next merge.
+ *
+ * The outgoing edges of a node are stored in a contiguous block of pairs
+ * target/weight, so adjacency checks are linear in the degree of the node.
+ * The blocks of all the nodes are in a single edge pool: a block which has
+ * to grow is moved to the end of the pool, and the pool is repacked when
+ * most of it is unused. Copying a graph copies a few flat arrays: the edge
+ * pool is copied as it is when it has no free slots, otherwise its blocks
+ * are packed; moving it takes constant time.
+ * As in cg3::Graph, an undirected graph stores both the directions of
+ * each edge.
+ *
+ * Deleting a node of a directed graph does not look for its incoming
+ * edges: they are left in the adjacency of their sources as tombstones,
+ * which are skipped by the queries and the iterators. The tombstones are
+ * removed by an incremental compaction: when the ratio of tombstones
+ * exceeds a threshold, each modification of the graph also visits a
+ * bounded number of stored edges, until all the nodes have been visited.
+ * The ids of the deleted nodes are reused only after a complete visit.
+ */
+template <class T>
+class IndexedGraph
+{
+
+public:
+
+    /* Typedefs */
+
+    typedef size_t NodeId;
+
+    static const NodeId NOT_FOUND = std::numeric_limits<size_t>::max();
+
+    enum GraphType { DIRECTED, UNDIRECTED };
+
+    struct Edge {
+        NodeId target;
+        double weight;
+    };
+
+    /**
+     * @brief Edge of the graph with its source, built from the adjacency
+     * of the source while iterating all the edges
+     */
+    struct EdgeHandle {
+        NodeId source;
+        NodeId target;
+        double weight;
+    };
+
+    /**
+     * @brief Statistics of the compaction
+     */
+    struct CompactionStats {
+        size_t numSteps; //Number of compaction steps
+        size_t numCycles; //Number of complete visits of the nodes
+        size_t removedEdges; //Number of tombstone edges removed
+        size_t recycledIds; //Number of ids of deleted nodes made reusable
+        size_t maxStepWork; //Maximum number of edges and nodes visited in a step
+    };
+
+    class NodeIterator;
+    class EdgeIterator;
+    class GraphEdgeIterator;
+
+    /**
+     * @brief Range of iterators, usable in range-based loops
+     */
+    template <class I>
+    struct Range {
+        I first;
+        I last;
+        I begin() const { return first; }
+        I end() const { return last; }
+    };
+
+    typedef Range<NodeIterator> NodeRange;
+    typedef Range<EdgeIterator> EdgeRange;
+    typedef Range<GraphEdgeIterator> GraphEdgeRange;
+
+
+    /* Constructors */
+
+    IndexedGraph(GraphType type = DIRECTED);
+    IndexedGraph(const Graph<T>& graph, GraphType type = DIRECTED);
+
+    IndexedGraph(const IndexedGraph& other);
+    IndexedGraph(IndexedGraph&& other) noexcept;
+
+    IndexedGraph& operator=(const IndexedGraph& other);
+    IndexedGraph& operator=(IndexedGraph&& other) noexcept;
+
+
+    /* Public methods */
+
+    GraphType type() const;
+
+    size_t numNodes() const;
+    size_t numEdges() const;
+    bool empty() const;
+    NodeId idBound() const;
+
+    bool isValid(NodeId node) const;
+    const T& value(NodeId node) const;
+    NodeId findNode(const T& value) const;
+
+    NodeId addNode(const T& value);
+    std::vector<NodeId> addNodes(const std::vector<T>& values);
+    bool deleteNode(NodeId node);
+
+    void addEdge(NodeId source, NodeId target, double weight = 0);
+    void addEdges(
+            const std::vector<std::pair<NodeId, NodeId>>& edges,
+            const std::vector<double>& weights = std::vector<double>());
+    bool deleteEdge(NodeId source, NodeId target);
+
+    bool isAdjacent(NodeId source, NodeId target) const;
+    double getWeight(NodeId source, NodeId target) const;
+    void setWeight(NodeId source, NodeId target, double weight);
+
+    size_t outDegree(NodeId node) const;
+    EdgeRange adjacentEdges(NodeId node) const;
+    NodeRange nodes() const;
+    GraphEdgeRange edges() const;
+
+    template <class F>
+    void forEachEdge(F f, unsigned int nThreads = 1) const;
+
+    void reserve(size_t numNodes);
+    void clear();
+    void swap(IndexedGraph& other) noexcept;
+
+
+    /* Compaction */
+
+    void setCompactionPolicy(double maxTombstoneRatio, size_t stepSize);
+    double tombstoneRatio() const;
+    size_t numTombstoneEdges() const;
+    size_t numTombstoneNodes() const;
+    const CompactionStats& compactionStats() const;
+
+    bool compactionStep();
+    void compact();
+
+
+protected:
+
+    /**
+     * @brief Position of the edges of a node in the edge pool
+     */
+    struct EdgeBlock {
+        size_t begin;
+        size_t size;
+        size_t capacity;
+    };
+
+
+    /* Protected fields */
+
+    GraphType graphType;
+
+    std::vector<T> values;
+    std::vector<Edge> edgePool;
+    std::vector<EdgeBlock> edgeBlocks;
+    size_t numFreeSlots; //Slots of the edge pool which are not in a block
+    std::vector<bool> deleted;
+    std::vector<size_t> inDegrees; //Incoming edges from nodes which are not deleted
+
+    std::vector<std::pair<T, NodeId>> sortedValues; //Pairs value/id sorted by value
+    std::vector<std::pair<T, NodeId>> insertedValues; //Pairs of the latest added nodes, sorted by value
+    size_t numStaleValues; //Pairs of sortedValues of deleted nodes
+
+    size_t numDeletedNodes;
+    size_t numStoredEdges; //Stored edges, including the tombstones
+    size_t numDeadEdges; //Tombstone edges
+
+    std::vector<NodeId> pendingIds; //Deleted after the start of the current compaction
+    std::vector<NodeId> purgingIds; //Deleted before the start of the current compaction
+    std::vector<NodeId> freeIds; //Reusable ids
+
+    double maxTombstoneRatio;
+    size_t compactionStepSize;
+    bool compacting;
+    NodeId compactionCursor;
+    CompactionStats stats;
+
+
+    /* Helpers */
+
+    NodeId newNode(const T& value);
+
+    NodeId findValue(const std::vector<std::pair<T, NodeId>>& pairs, const T& value) const;
+    void insertValue(const T& value, NodeId node);
+    void eraseValue(const T& value, NodeId node);
+    void mergeValues();
+
+    Edge* nodeEdges(NodeId node);
+    const Edge* nodeEdges(NodeId node) const;
+    void pushEdge(NodeId node, const Edge& edge);
+    void reserveEdges(NodeId node, size_t capacity);
+    void shrinkEdges(NodeId node, size_t size);
+    void releaseEdges(NodeId node);
+    void repackEdges();
+
+    size_t findEdge(NodeId source, NodeId target) const;
+    bool insertEdge(NodeId source, NodeId target, double weight);
+    bool eraseEdge(NodeId source, NodeId target);
+    void removeDuplicateEdges(NodeId node, std::vector<size_t>& position);
+
+    size_t purgeEdges(NodeId node);
+    void autoCompact();
+
+};
+
+
+/**
+ * @brief Iterator on the ids of the nodes of an indexed graph, which
+ * skips the deleted nodes
+ */
+template <class T>
+class IndexedGraph<T>::NodeIterator
+{
+public:
+    NodeIterator(const IndexedGraph<T>* graph, NodeId node);
+
+    NodeId operator*() const;
+    NodeIterator& operator++();
+    NodeIterator operator++(int);
+    bool operator==(const NodeIterator& other) const;
+    bool operator!=(const NodeIterator& other) const;
+
+private:
+    const IndexedGraph<T>* graph;
+    NodeId node;
+};
+
+
+/**
+ * @brief Iterator on the outgoing edges of a node of an indexed graph,
+ * which skips the tombstone edges
+ */
+template <class T>
+class IndexedGraph<T>::EdgeIterator
+{
+public:
+    EdgeIterator(const IndexedGraph<T>* graph, const Edge* edge, const Edge* last);
+
+    const Edge& operator*() const;
+    const Edge* operator->() const;
+    EdgeIterator& operator++();
+    EdgeIterator operator++(int);
+    bool operator==(const EdgeIterator& other) const;
+    bool operator!=(const EdgeIterator& other) const;
+
+private:
+    const IndexedGraph<T>* graph;
+    const Edge* edge;
+    const Edge* last;
+
+    void skipDeleted();
+};
+
+
+/**
+ * @brief Iterator on all the edges of an indexed graph, node by node: it
+ * yields the source, the target and the weight of each edge, read from the
+ * adjacency of the source. Deleted nodes and tombstone edges are skipped.
+ */
+template <class T>
+class IndexedGraph<T>::GraphEdgeIterator
+{
+public:
+    GraphEdgeIterator(const IndexedGraph<T>* graph, NodeId source);
+
+    EdgeHandle operator*() const;
+    GraphEdgeIterator& operator++();
+    GraphEdgeIterator operator++(int);
+    bool operator==(const GraphEdgeIterator& other) const;
+    bool operator!=(const GraphEdgeIterator& other) const;
+
+private:
+    const IndexedGraph<T>* graph;
+    NodeId source;
+    const Edge* edge;
+    const Edge* last;
+
+    void skipDeleted();
+};
+
+}
+
+#include "indexed_graph.tpp"
+
+#endif // CG3_INDEXED_GRAPH_H
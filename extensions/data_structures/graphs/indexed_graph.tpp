@@ -0,0 +1,1414 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "indexed_graph.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Default ratio of tombstones (edges and nodes) which starts the compaction */
+static const double DEFAULT_MAX_TOMBSTONE_RATIO = 0.25;
+
+/* Default number of stored edges and nodes visited by a compaction step */
+static const size_t DEFAULT_COMPACTION_STEP_SIZE = 4096;
+
+/* Minimum capacity of a block of the edge pool which grows */
+static const size_t EDGE_BLOCK_MIN_CAPACITY = 4;
+
+/* Minimum number of free slots of the edge pool which starts a repack */
+static const size_t EDGE_POOL_MIN_REPACK = 4096;
+
+/* Number of source nodes visited by each chunk of a parallel edge visit */
+static const size_t EDGE_VISIT_CHUNK_SIZE = 1024;
+
+/* Minimum capacity of the buffer of the values added by addNode */
+static const size_t VALUE_BUFFER_MIN_CAPACITY = 64;
+
+}
+
+template <class T>
+const typename IndexedGraph<T>::NodeId IndexedGraph<T>::NOT_FOUND;
+
+
+/* ----- CONSTRUCTORS ----- */
+
+/**
+ * @brief Constructor of an empty graph
+ * @param type Type of the graph (directed or undirected)
+ */
+template <class T>
+IndexedGraph<T>::IndexedGraph(GraphType type) :
+    graphType(type),
+    numFreeSlots(0),
+    numStaleValues(0),
+    numDeletedNodes(0),
+    numStoredEdges(0),
+    numDeadEdges(0),
+    maxTombstoneRatio(internal::DEFAULT_MAX_TOMBSTONE_RATIO),
+    compactionStepSize(internal::DEFAULT_COMPACTION_STEP_SIZE),
+    compacting(false),
+    compactionCursor(0),
+    stats()
+{
+
+}
+
+/**
+ * @brief Constructor which copies a cg3::Graph. Ids are assigned in the
+ * order of the node iterator of the graph.
+ * @param graph Input graph
+ * @param type Type of the graph (it should be the type of the input graph)
+ */
+template <class T>
+IndexedGraph<T>::IndexedGraph(const Graph<T>& graph, GraphType type) :
+    graphType(type),
+    numFreeSlots(0),
+    numStaleValues(0),
+    numDeletedNodes(0),
+    numStoredEdges(0),
+    numDeadEdges(0),
+    maxTombstoneRatio(internal::DEFAULT_MAX_TOMBSTONE_RATIO),
+    compactionStepSize(internal::DEFAULT_COMPACTION_STEP_SIZE),
+    compacting(false),
+    compactionCursor(0),
+    stats()
+{
+    typedef typename Graph<T>::NodeIterator NodeIterator;
+    typedef typename Graph<T>::AdjacentIterator AdjacentIterator;
+
+    std::vector<T> graphValues;
+    for (NodeIterator it = graph.nodeBegin(); it != graph.nodeEnd(); it++) {
+        graphValues.push_back(*it);
+    }
+    addNodes(graphValues);
+
+    //The input graph already contains both the directions of undirected edges
+    NodeId source = 0;
+    for (NodeIterator it = graph.nodeBegin(); it != graph.nodeEnd(); it++, source++) {
+        for (AdjacentIterator adjIt = graph.adjacentBegin(it); adjIt != graph.adjacentEnd(it); adjIt++) {
+            Edge edge;
+            edge.target = findNode(*adjIt);
+            edge.weight = graph.getWeight(it, adjIt);
+            pushEdge(source, edge);
+            inDegrees[edge.target]++;
+        }
+        numStoredEdges += edgeBlocks[source].size;
+    }
+}
+
+/**
+ * @brief Copy constructor. The arrays are copied in bulk; if the edge
+ * pool has free slots its blocks are packed, so only the stored edges
+ * are copied.
+ * @param other Graph to be copied
+ */
+template <class T>
+IndexedGraph<T>::IndexedGraph(const IndexedGraph<T>& other) :
+    graphType(other.graphType),
+    values(other.values),
+    edgeBlocks(other.edgeBlocks),
+    numFreeSlots(0),
+    deleted(other.deleted),
+    inDegrees(other.inDegrees),
+    sortedValues(other.sortedValues),
+    insertedValues(other.insertedValues),
+    numStaleValues(other.numStaleValues),
+    numDeletedNodes(other.numDeletedNodes),
+    numStoredEdges(other.numStoredEdges),
+    numDeadEdges(other.numDeadEdges),
+    pendingIds(other.pendingIds),
+    purgingIds(other.purgingIds),
+    freeIds(other.freeIds),
+    maxTombstoneRatio(other.maxTombstoneRatio),
+    compactionStepSize(other.compactionStepSize),
+    compacting(other.compacting),
+    compactionCursor(other.compactionCursor),
+    stats(other.stats)
+{
+    //A pool without free slots is already packed
+    if (other.numFreeSlots == 0) {
+        edgePool = other.edgePool;
+        return;
+    }
+
+    edgePool.reserve(numStoredEdges);
+
+    for (EdgeBlock& block : edgeBlocks) {
+        const Edge* first = other.edgePool.data() + block.begin;
+
+        block.begin = edgePool.size();
+        block.capacity = block.size;
+        edgePool.insert(edgePool.end(), first, first + block.size);
+    }
+}
+
+/**
+ * @brief Move constructor: it takes the storage of the other graph in
+ * constant time, the other graph is left empty
+ */
+template <class T>
+IndexedGraph<T>::IndexedGraph(IndexedGraph<T>&& other) noexcept :
+    IndexedGraph(other.graphType)
+{
+    swap(other);
+}
+
+/**
+ * @brief Copy assignment (see the copy constructor)
+ */
+template <class T>
+IndexedGraph<T>& IndexedGraph<T>::operator=(const IndexedGraph<T>& other)
+{
+    if (this != &other) {
+        IndexedGraph<T> copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment: the storages of the graphs are swapped in
+ * constant time
+ */
+template <class T>
+IndexedGraph<T>& IndexedGraph<T>::operator=(IndexedGraph<T>&& other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Get the type of the graph
+ */
+template <class T>
+typename IndexedGraph<T>::GraphType IndexedGraph<T>::type() const
+{
+    return graphType;
+}
+
+/**
+ * @brief Get the number of nodes
+ */
+template <class T>
+size_t IndexedGraph<T>::numNodes() const
+{
+    return values.size() - numDeletedNodes;
+}
+
+/**
+ * @brief Get the number of edges (undirected edges are counted in both
+ * the directions)
+ */
+template <class T>
+size_t IndexedGraph<T>::numEdges() const
+{
+    return numStoredEdges - numDeadEdges;
+}
+
+/**
+ * @brief Check if the graph has no nodes
+ */
+template <class T>
+bool IndexedGraph<T>::empty() const
+{
+    return numNodes() == 0;
+}
+
+/**
+ * @brief Get the upper bound of the ids: the ids of the nodes are in
+ * [0, idBound()), ids of deleted nodes are not valid
+ */
+template <class T>
+typename IndexedGraph<T>::NodeId IndexedGraph<T>::idBound() const
+{
+    return values.size();
+}
+
+/**
+ * @brief Check if an id is the id of a node of the graph
+ */
+template <class T>
+bool IndexedGraph<T>::isValid(NodeId node) const
+{
+    return node < values.size() && !deleted[node];
+}
+
+/**
+ * @brief Get the value of a node
+ * @param node Id of the node
+ */
+template <class T>
+const T& IndexedGraph<T>::value(NodeId node) const
+{
+    return values[node];
+}
+
+/**
+ * @brief Find the id of the node with a given value
+ * @param value Value of the node
+ * @return Id of the node, NOT_FOUND if there is no node with that value
+ */
+template <class T>
+typename IndexedGraph<T>::NodeId IndexedGraph<T>::findNode(const T& value) const
+{
+    NodeId node = findValue(insertedValues, value);
+    if (node == NOT_FOUND)
+        node = findValue(sortedValues, value);
+
+    return node;
+}
+
+/**
+ * @brief Add a node to the graph. The id is the id of a deleted node
+ * if there is one which can be reused, otherwise it is idBound().
+ * @param value Value of the node
+ * @return Id of the new node, NOT_FOUND if a node with the same value
+ * is already in the graph
+ */
+template <class T>
+typename IndexedGraph<T>::NodeId IndexedGraph<T>::addNode(const T& value)
+{
+    if (findNode(value) != NOT_FOUND)
+        return NOT_FOUND;
+
+    NodeId id = newNode(value);
+    insertValue(value, id);
+
+    autoCompact();
+
+    return id;
+}
+
+/**
+ * @brief Add a set of nodes to the graph. The values are sorted and
+ * merged with the sorted array of the values, in time linear in the
+ * number of nodes of the graph.
+ * @param newValues Values of the nodes
+ * @return Ids of the new nodes, in the order of the values (NOT_FOUND for
+ * the values which are already in the graph or repeated in the input)
+ */
+template <class T>
+std::vector<typename IndexedGraph<T>::NodeId> IndexedGraph<T>::addNodes(const std::vector<T>& newValues)
+{
+    const size_t n = newValues.size();
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&newValues] (size_t a, size_t b) {
+        return newValues[a] < newValues[b];
+    });
+
+    //Only the first occurrence of each value which is not in the graph
+    //is inserted; the buffer is merged first, so a single array is searched
+    mergeValues();
+
+    std::vector<bool> inserted(n, false);
+    for (size_t i = 0; i < n; i++) {
+        size_t k = order[i];
+        if (i > 0 && !(newValues[order[i-1]] < newValues[k]))
+            continue;
+
+        inserted[k] = findValue(sortedValues, newValues[k]) == NOT_FOUND;
+    }
+
+    //Assign the ids in the order of the input
+    reserve(values.size() + n);
+
+    std::vector<NodeId> ids(n, NOT_FOUND);
+    for (size_t k = 0; k < n; k++) {
+        if (inserted[k])
+            ids[k] = newNode(newValues[k]);
+    }
+
+    //Append the new pairs in sorted order and merge them
+    const size_t middle = sortedValues.size();
+    for (size_t i = 0; i < n; i++) {
+        size_t k = order[i];
+        if (inserted[k])
+            sortedValues.push_back(std::make_pair(newValues[k], ids[k]));
+    }
+    std::inplace_merge(sortedValues.begin(), sortedValues.begin() + middle, sortedValues.end());
+
+    autoCompact();
+
+    return ids;
+}
+
+/**
+ * @brief Delete a node and all its edges. The ids of the other nodes
+ * do not change. In an undirected graph the edges are removed from the
+ * adjacent nodes, in a directed graph the incoming edges become tombstones
+ * (removed by the compaction).
+ * @param node Id of the node
+ * @return True if the node has been deleted, false if the id was not valid
+ */
+template <class T>
+bool IndexedGraph<T>::deleteNode(NodeId node)
+{
+    if (!isValid(node))
+        return false;
+
+    const Edge* edges = nodeEdges(node);
+    for (size_t i = 0; i < edgeBlocks[node].size; i++) {
+        const Edge& edge = edges[i];
+        if (edge.target == node || deleted[edge.target])
+            continue;
+
+        if (graphType == UNDIRECTED)
+            eraseEdge(edge.target, node);
+        inDegrees[edge.target]--;
+    }
+
+    //Self loop is removed with the outgoing edges
+    if (findEdge(node, node) != NOT_FOUND)
+        inDegrees[node]--;
+
+    numStoredEdges -= edgeBlocks[node].size;
+    numDeadEdges -= edgeBlocks[node].size - outDegree(node);
+    releaseEdges(node);
+
+    numDeadEdges += inDegrees[node];
+    inDegrees[node] = 0;
+
+    eraseValue(values[node], node);
+    deleted[node] = true;
+    numDeletedNodes++;
+    pendingIds.push_back(node);
+
+    autoCompact();
+
+    return true;
+}
+
+/**
+ * @brief Add an edge to the graph. If the edge already exists, its
+ * weight is updated. Ids which are not valid are ignored.
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @param weight Weight of the edge
+ */
+template <class T>
+void IndexedGraph<T>::addEdge(NodeId source, NodeId target, double weight)
+{
+    if (!isValid(source) || !isValid(target))
+        return;
+
+    insertEdge(source, target, weight);
+    if (graphType == UNDIRECTED && source != target)
+        insertEdge(target, source, weight);
+
+    autoCompact();
+}
+
+/**
+ * @brief Add a set of edges to the graph. The edges are appended to the
+ * adjacency of their nodes, then the repeated edges are removed with a
+ * linear visit of the nodes which have been modified (the last weight
+ * is kept). Edges with ids which are not valid are ignored.
+ * @param edges Pairs source/target of the edges
+ * @param weights Weights of the edges (if empty, all the weights are 0)
+ */
+template <class T>
+void IndexedGraph<T>::addEdges(
+        const std::vector<std::pair<NodeId, NodeId>>& edges,
+        const std::vector<double>& weights)
+{
+    std::vector<size_t> count(values.size(), 0);
+
+    for (const std::pair<NodeId, NodeId>& edge : edges) {
+        if (isValid(edge.first) && isValid(edge.second)) {
+            count[edge.first]++;
+            if (graphType == UNDIRECTED && edge.first != edge.second)
+                count[edge.second]++;
+        }
+    }
+
+    //The edges of the modified nodes are counted again after the insertion
+    //(the tombstones are removed)
+    for (NodeId node = 0; node < values.size(); node++) {
+        if (count[node] > 0) {
+            const Edge* storedEdges = nodeEdges(node);
+            numStoredEdges -= edgeBlocks[node].size;
+            for (size_t i = 0; i < edgeBlocks[node].size; i++) {
+                if (deleted[storedEdges[i].target])
+                    numDeadEdges--;
+                else
+                    inDegrees[storedEdges[i].target]--;
+            }
+            reserveEdges(node, edgeBlocks[node].size + count[node]);
+        }
+    }
+
+    for (size_t i = 0; i < edges.size(); i++) {
+        NodeId source = edges[i].first;
+        NodeId target = edges[i].second;
+
+        if (isValid(source) && isValid(target)) {
+            Edge edge;
+            edge.weight = weights.empty() ? 0 : weights[i];
+
+            edge.target = target;
+            pushEdge(source, edge);
+
+            if (graphType == UNDIRECTED && source != target) {
+                edge.target = source;
+                pushEdge(target, edge);
+            }
+        }
+    }
+
+    std::vector<size_t> position(values.size(), NOT_FOUND);
+    for (NodeId node = 0; node < values.size(); node++) {
+        if (count[node] > 0) {
+            removeDuplicateEdges(node, position);
+
+            const Edge* storedEdges = nodeEdges(node);
+            numStoredEdges += edgeBlocks[node].size;
+            for (size_t i = 0; i < edgeBlocks[node].size; i++)
+                inDegrees[storedEdges[i].target]++;
+        }
+    }
+
+    autoCompact();
+}
+
+/**
+ * @brief Delete an edge from the graph
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @return True if the edge has been deleted, false if it does not exist
+ */
+template <class T>
+bool IndexedGraph<T>::deleteEdge(NodeId source, NodeId target)
+{
+    if (!isValid(source) || !isValid(target))
+        return false;
+
+    bool found = eraseEdge(source, target);
+    if (graphType == UNDIRECTED && source != target)
+        eraseEdge(target, source);
+
+    autoCompact();
+
+    return found;
+}
+
+/**
+ * @brief Check if there is an edge between two nodes
+ * @param source Id of the source node
+ * @param target Id of the target node
+ */
+template <class T>
+bool IndexedGraph<T>::isAdjacent(NodeId source, NodeId target) const
+{
+    if (!isValid(source) || !isValid(target))
+        return false;
+
+    return findEdge(source, target) != NOT_FOUND;
+}
+
+/**
+ * @brief Get the weight of an edge
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @return Weight of the edge, Graph<T>::MAX_WEIGHT if the edge does not exist
+ */
+template <class T>
+double IndexedGraph<T>::getWeight(NodeId source, NodeId target) const
+{
+    if (!isValid(source) || !isValid(target))
+        return Graph<T>::MAX_WEIGHT;
+
+    size_t position = findEdge(source, target);
+    if (position == NOT_FOUND)
+        return Graph<T>::MAX_WEIGHT;
+
+    return nodeEdges(source)[position].weight;
+}
+
+/**
+ * @brief Set the weight of an existing edge
+ * @param source Id of the source node
+ * @param target Id of the target node
+ * @param weight New weight of the edge
+ */
+template <class T>
+void IndexedGraph<T>::setWeight(NodeId source, NodeId target, double weight)
+{
+    if (!isValid(source) || !isValid(target))
+        return;
+
+    size_t position = findEdge(source, target);
+    if (position == NOT_FOUND)
+        return;
+
+    nodeEdges(source)[position].weight = weight;
+
+    if (graphType == UNDIRECTED && source != target)
+        nodeEdges(target)[findEdge(target, source)].weight = weight;
+}
+
+/**
+ * @brief Get the number of outgoing edges of a node (linear in the
+ * number of stored edges of the node, tombstones are not counted)
+ */
+template <class T>
+size_t IndexedGraph<T>::outDegree(NodeId node) const
+{
+    const Edge* edges = nodeEdges(node);
+
+    size_t degree = 0;
+    for (size_t i = 0; i < edgeBlocks[node].size; i++) {
+        if (!deleted[edges[i].target])
+            degree++;
+    }
+    return degree;
+}
+
+/**
+ * @brief Get the outgoing edges of a node, as pairs target/weight
+ */
+template <class T>
+typename IndexedGraph<T>::EdgeRange IndexedGraph<T>::adjacentEdges(NodeId node) const
+{
+    const Edge* first = nodeEdges(node);
+    const Edge* last = first + edgeBlocks[node].size;
+
+    EdgeRange range = { EdgeIterator(this, first, last), EdgeIterator(this, last, last) };
+    return range;
+}
+
+/**
+ * @brief Get the ids of the nodes of the graph
+ */
+template <class T>
+typename IndexedGraph<T>::NodeRange IndexedGraph<T>::nodes() const
+{
+    NodeRange range = { NodeIterator(this, 0), NodeIterator(this, values.size()) };
+    return range;
+}
+
+/**
+ * @brief Get all the edges of the graph, as triples source/target/weight
+ * (both the directions of the edges of an undirected graph)
+ */
+template <class T>
+typename IndexedGraph<T>::GraphEdgeRange IndexedGraph<T>::edges() const
+{
+    GraphEdgeRange range = { GraphEdgeIterator(this, 0), GraphEdgeIterator(this, values.size()) };
+    return range;
+}
+
+/**
+ * @brief Call f(source, target, weight) for each edge of the graph. With
+ * more than one thread, the source nodes are split in chunks which are
+ * visited in parallel: f must be thread safe, but all the outgoing edges
+ * of a node are visited in order by the same thread (so data indexed by
+ * the source can be written without synchronization).
+ * @param f Function called for each edge
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <class T>
+template <class F>
+void IndexedGraph<T>::forEachEdge(F f, unsigned int nThreads) const
+{
+    parallelForChunks(values.size(), internal::EDGE_VISIT_CHUNK_SIZE,
+            [&] (unsigned int, size_t, size_t begin, size_t end) {
+        for (NodeId source = begin; source < end; source++) {
+            if (deleted[source])
+                continue;
+
+            const Edge* edges = nodeEdges(source);
+            for (size_t i = 0; i < edgeBlocks[source].size; i++) {
+                if (!deleted[edges[i].target])
+                    f(source, edges[i].target, edges[i].weight);
+            }
+        }
+    }, nThreads);
+}
+
+/**
+ * @brief Reserve the memory for a number of nodes
+ */
+template <class T>
+void IndexedGraph<T>::reserve(size_t numNodes)
+{
+    values.reserve(numNodes);
+    edgeBlocks.reserve(numNodes);
+    deleted.reserve(numNodes);
+    inDegrees.reserve(numNodes);
+}
+
+/**
+ * @brief Delete all the nodes and the edges of the graph
+ */
+template <class T>
+void IndexedGraph<T>::clear()
+{
+    values.clear();
+    edgePool.clear();
+    edgeBlocks.clear();
+    numFreeSlots = 0;
+    deleted.clear();
+    inDegrees.clear();
+    sortedValues.clear();
+    insertedValues.clear();
+    numStaleValues = 0;
+    numDeletedNodes = 0;
+    numStoredEdges = 0;
+    numDeadEdges = 0;
+
+    pendingIds.clear();
+    purgingIds.clear();
+    freeIds.clear();
+    compacting = false;
+    compactionCursor = 0;
+}
+
+/**
+ * @brief Swap the content of two graphs in constant time
+ */
+template <class T>
+void IndexedGraph<T>::swap(IndexedGraph<T>& other) noexcept
+{
+    std::swap(graphType, other.graphType);
+
+    values.swap(other.values);
+    edgePool.swap(other.edgePool);
+    edgeBlocks.swap(other.edgeBlocks);
+    std::swap(numFreeSlots, other.numFreeSlots);
+    deleted.swap(other.deleted);
+    inDegrees.swap(other.inDegrees);
+    sortedValues.swap(other.sortedValues);
+    insertedValues.swap(other.insertedValues);
+    std::swap(numStaleValues, other.numStaleValues);
+
+    std::swap(numDeletedNodes, other.numDeletedNodes);
+    std::swap(numStoredEdges, other.numStoredEdges);
+    std::swap(numDeadEdges, other.numDeadEdges);
+
+    pendingIds.swap(other.pendingIds);
+    purgingIds.swap(other.purgingIds);
+    freeIds.swap(other.freeIds);
+
+    std::swap(maxTombstoneRatio, other.maxTombstoneRatio);
+    std::swap(compactionStepSize, other.compactionStepSize);
+    std::swap(compacting, other.compacting);
+    std::swap(compactionCursor, other.compactionCursor);
+    std::swap(stats, other.stats);
+}
+
+
+
+/* ----- COMPACTION ----- */
+
+/**
+ * @brief Set the policy of the automatic compaction
+ * @param maxTombstoneRatio Ratio of tombstones over the stored edges and
+ * nodes which starts the compaction (1 or more to disable the automatic
+ * compaction)
+ * @param stepSize Number of stored edges and nodes visited by each
+ * modification of the graph while the compaction is running (the edges
+ * of a node are always visited in the same step)
+ */
+template <class T>
+void IndexedGraph<T>::setCompactionPolicy(double maxTombstoneRatio, size_t stepSize)
+{
+    this->maxTombstoneRatio = maxTombstoneRatio;
+    this->compactionStepSize = std::max(stepSize, (size_t) 1);
+}
+
+/**
+ * @brief Get the ratio of tombstones (tombstone edges and deleted nodes
+ * whose id cannot be reused yet) over the stored edges and nodes
+ */
+template <class T>
+double IndexedGraph<T>::tombstoneRatio() const
+{
+    size_t stored = numStoredEdges + values.size();
+    if (stored == 0)
+        return 0;
+
+    return (double) (numDeadEdges + numTombstoneNodes()) / stored;
+}
+
+/**
+ * @brief Get the number of tombstone edges (edges to deleted nodes)
+ */
+template <class T>
+size_t IndexedGraph<T>::numTombstoneEdges() const
+{
+    return numDeadEdges;
+}
+
+/**
+ * @brief Get the number of deleted nodes whose id cannot be reused yet
+ */
+template <class T>
+size_t IndexedGraph<T>::numTombstoneNodes() const
+{
+    return pendingIds.size() + purgingIds.size();
+}
+
+/**
+ * @brief Get the statistics of the compaction
+ */
+template <class T>
+const typename IndexedGraph<T>::CompactionStats& IndexedGraph<T>::compactionStats() const
+{
+    return stats;
+}
+
+/**
+ * @brief Execute a step of the compaction: the tombstones are removed from
+ * the next nodes, until the step size is reached. When all the nodes have
+ * been visited, the ids of the nodes deleted before the start of the visit
+ * can be reused.
+ * @return True if the compaction is not completed
+ */
+template <class T>
+bool IndexedGraph<T>::compactionStep()
+{
+    if (!compacting) {
+        if (pendingIds.empty())
+            return false;
+
+        purgingIds.swap(pendingIds);
+        compactionCursor = 0;
+        compacting = true;
+    }
+
+    size_t work = 0;
+    while (compactionCursor < values.size() && work < compactionStepSize) {
+        if (!deleted[compactionCursor])
+            work += purgeEdges(compactionCursor);
+        work++;
+        compactionCursor++;
+    }
+
+    stats.numSteps++;
+    stats.maxStepWork = std::max(stats.maxStepWork, work);
+
+    if (compactionCursor == values.size()) {
+        stats.numCycles++;
+        stats.recycledIds += purgingIds.size();
+
+        freeIds.insert(freeIds.end(), purgingIds.begin(), purgingIds.end());
+        purgingIds.clear();
+
+        compacting = false;
+    }
+
+    return compacting;
+}
+
+/**
+ * @brief Remove all the tombstones (the current compaction is completed,
+ * then a complete compaction is executed for the nodes deleted after
+ * its start)
+ */
+template <class T>
+void IndexedGraph<T>::compact()
+{
+    while (compactionStep());
+    while (compactionStep());
+}
+
+
+
+/* ----- HELPERS ----- */
+
+/**
+ * @brief Create a node (reusing a free id, if any) without inserting its
+ * value in the arrays of the values
+ * @return Id of the node
+ */
+template <class T>
+typename IndexedGraph<T>::NodeId IndexedGraph<T>::newNode(const T& value)
+{
+    if (!freeIds.empty()) {
+        NodeId id = freeIds.back();
+        freeIds.pop_back();
+
+        values[id] = value;
+        deleted[id] = false;
+        numDeletedNodes--;
+
+        return id;
+    }
+
+    EdgeBlock block = { edgePool.size(), 0, 0 };
+
+    values.push_back(value);
+    edgeBlocks.push_back(block);
+    deleted.push_back(false);
+    inDegrees.push_back(0);
+
+    return values.size() - 1;
+}
+
+/**
+ * @brief Find a value in a sorted array of pairs value/id, skipping the
+ * pair if its node has been deleted
+ * @return Id of the node, NOT_FOUND if there is no node with that value
+ */
+template <class T>
+typename IndexedGraph<T>::NodeId IndexedGraph<T>::findValue(
+        const std::vector<std::pair<T, NodeId>>& pairs,
+        const T& value) const
+{
+    typename std::vector<std::pair<T, NodeId>>::const_iterator it = std::lower_bound(
+                pairs.begin(),
+                pairs.end(),
+                value,
+                [] (const std::pair<T, NodeId>& pair, const T& value) {
+                    return pair.first < value;
+                });
+
+    if (it == pairs.end() || value < it->first)
+        return NOT_FOUND;
+
+    //A deleted id may have been reused by a node with another value
+    NodeId node = it->second;
+    if (!isValid(node) || values[node] < value || value < values[node])
+        return NOT_FOUND;
+
+    return node;
+}
+
+/**
+ * @brief Insert the pair of a new node in the buffer of the values, which
+ * is merged in the sorted array when it exceeds twice the square root of
+ * its size (balancing the shifts in the buffer and the merges)
+ */
+template <class T>
+void IndexedGraph<T>::insertValue(const T& value, NodeId node)
+{
+    std::pair<T, NodeId> pair(value, node);
+    insertedValues.insert(
+                std::upper_bound(insertedValues.begin(), insertedValues.end(), pair),
+                pair);
+
+    size_t capacity = std::max(
+                internal::VALUE_BUFFER_MIN_CAPACITY,
+                static_cast<size_t>(2 * std::sqrt(static_cast<double>(sortedValues.size()))));
+
+    if (insertedValues.size() > capacity)
+        mergeValues();
+}
+
+/**
+ * @brief Remove the pair of a deleted node: it is erased from the buffer,
+ * while in the sorted array it is left until the next merge (which is
+ * started when half of the array is stale)
+ */
+template <class T>
+void IndexedGraph<T>::eraseValue(const T& value, NodeId node)
+{
+    std::pair<T, NodeId> pair(value, node);
+    typename std::vector<std::pair<T, NodeId>>::iterator it =
+            std::lower_bound(insertedValues.begin(), insertedValues.end(), pair);
+
+    if (it != insertedValues.end() && it->second == node && !(value < it->first)) {
+        insertedValues.erase(it);
+        return;
+    }
+
+    numStaleValues++;
+    if (numStaleValues * 2 > sortedValues.size())
+        mergeValues();
+}
+
+/**
+ * @brief Merge the buffer of the values in the sorted array, dropping the
+ * pairs of the deleted nodes
+ */
+template <class T>
+void IndexedGraph<T>::mergeValues()
+{
+    if (insertedValues.empty() && numStaleValues == 0)
+        return;
+
+    const size_t middle = sortedValues.size();
+    sortedValues.insert(sortedValues.end(), insertedValues.begin(), insertedValues.end());
+    std::inplace_merge(sortedValues.begin(), sortedValues.begin() + middle, sortedValues.end());
+
+    insertedValues.clear();
+    if (numStaleValues == 0)
+        return;
+
+    //A stale pair may be followed by the pair of the node which reused its
+    //id with the same value, so the pairs with equal values are merged too
+    typename std::vector<std::pair<T, NodeId>>::iterator last = std::remove_if(
+                sortedValues.begin(),
+                sortedValues.end(),
+                [this] (const std::pair<T, NodeId>& pair) {
+                    return !isValid(pair.second) ||
+                            values[pair.second] < pair.first ||
+                            pair.first < values[pair.second];
+                });
+    last = std::unique(
+                sortedValues.begin(),
+                last,
+                [] (const std::pair<T, NodeId>& a, const std::pair<T, NodeId>& b) {
+                    return !(a.first < b.first) && !(b.first < a.first);
+                });
+    sortedValues.erase(last, sortedValues.end());
+
+    numStaleValues = 0;
+}
+
+/**
+ * @brief Find the position of an edge in the adjacency of the source node
+ * @return Position of the edge, NOT_FOUND if the edge does not exist
+ */
+template <class T>
+size_t IndexedGraph<T>::findEdge(NodeId source, NodeId target) const
+{
+    const Edge* edges = nodeEdges(source);
+    for (size_t i = 0; i < edgeBlocks[source].size; i++) {
+        if (edges[i].target == target)
+            return i;
+    }
+    return NOT_FOUND;
+}
+
+/**
+ * @brief Insert an edge in the adjacency of the source node, or update
+ * its weight if it already exists
+ * @return True if the edge is new
+ */
+template <class T>
+bool IndexedGraph<T>::insertEdge(NodeId source, NodeId target, double weight)
+{
+    size_t position = findEdge(source, target);
+    if (position != NOT_FOUND) {
+        nodeEdges(source)[position].weight = weight;
+        return false;
+    }
+
+    Edge edge;
+    edge.target = target;
+    edge.weight = weight;
+    pushEdge(source, edge);
+    inDegrees[target]++;
+    numStoredEdges++;
+
+    return true;
+}
+
+/**
+ * @brief Erase an edge from the adjacency of the source node (the last
+ * edge takes its place)
+ * @return True if the edge existed
+ */
+template <class T>
+bool IndexedGraph<T>::eraseEdge(NodeId source, NodeId target)
+{
+    size_t position = findEdge(source, target);
+    if (position == NOT_FOUND)
+        return false;
+
+    Edge* edges = nodeEdges(source);
+    edges[position] = edges[edgeBlocks[source].size - 1];
+    edgeBlocks[source].size--;
+    inDegrees[target]--;
+    numStoredEdges--;
+
+    return true;
+}
+
+/**
+ * @brief Remove the repeated edges from the adjacency of a node, keeping
+ * the first position and the last weight of each edge. Tombstone edges
+ * are removed too.
+ * @param node Id of the node
+ * @param position Vector of NOT_FOUND values with an entry for each id,
+ * used to store the position of the targets (it is restored at the end)
+ */
+template <class T>
+void IndexedGraph<T>::removeDuplicateEdges(NodeId node, std::vector<size_t>& position)
+{
+    Edge* edges = nodeEdges(node);
+    const size_t numEdges = edgeBlocks[node].size;
+
+    size_t size = 0;
+    for (size_t i = 0; i < numEdges; i++) {
+        NodeId target = edges[i].target;
+        if (deleted[target]) {
+            continue;
+        }
+        else if (position[target] == NOT_FOUND) {
+            position[target] = size;
+            edges[size++] = edges[i];
+        }
+        else {
+            edges[position[target]].weight = edges[i].weight;
+        }
+    }
+
+    for (size_t i = 0; i < size; i++)
+        position[edges[i].target] = NOT_FOUND;
+
+    shrinkEdges(node, size);
+}
+
+/**
+ * @brief Remove the tombstone edges from the adjacency of a node
+ * @param node Id of the node
+ * @return Number of stored edges visited
+ */
+template <class T>
+size_t IndexedGraph<T>::purgeEdges(NodeId node)
+{
+    Edge* edges = nodeEdges(node);
+    size_t visited = edgeBlocks[node].size;
+
+    size_t size = 0;
+    for (size_t i = 0; i < visited; i++) {
+        if (!deleted[edges[i].target])
+            edges[size++] = edges[i];
+    }
+
+    size_t removed = visited - size;
+    if (removed > 0) {
+        shrinkEdges(node, size);
+
+        numStoredEdges -= removed;
+        numDeadEdges -= removed;
+        stats.removedEdges += removed;
+    }
+
+    return visited;
+}
+
+/**
+ * @brief Get the edges of a node (the pointer is valid until the edge pool
+ * is modified)
+ */
+template <class T>
+typename IndexedGraph<T>::Edge* IndexedGraph<T>::nodeEdges(NodeId node)
+{
+    return edgePool.data() + edgeBlocks[node].begin;
+}
+
+template <class T>
+const typename IndexedGraph<T>::Edge* IndexedGraph<T>::nodeEdges(NodeId node) const
+{
+    return edgePool.data() + edgeBlocks[node].begin;
+}
+
+/**
+ * @brief Append an edge to the block of a node, doubling its capacity if
+ * it is full
+ */
+template <class T>
+void IndexedGraph<T>::pushEdge(NodeId node, const Edge& edge)
+{
+    if (edgeBlocks[node].size == edgeBlocks[node].capacity)
+        reserveEdges(node, std::max(2 * edgeBlocks[node].capacity, internal::EDGE_BLOCK_MIN_CAPACITY));
+
+    nodeEdges(node)[edgeBlocks[node].size++] = edge;
+}
+
+/**
+ * @brief Make the capacity of the block of a node at least the given one.
+ * The block is extended in place if it is at the end of the pool, otherwise
+ * it is moved to the end and its old slots become free.
+ */
+template <class T>
+void IndexedGraph<T>::reserveEdges(NodeId node, size_t capacity)
+{
+    EdgeBlock& block = edgeBlocks[node];
+    if (capacity <= block.capacity)
+        return;
+
+    if (block.begin + block.capacity == edgePool.size()) {
+        edgePool.resize(block.begin + capacity);
+    }
+    else {
+        size_t begin = edgePool.size();
+        edgePool.resize(begin + capacity);
+        std::copy(edgePool.begin() + block.begin, edgePool.begin() + block.begin + block.size, edgePool.begin() + begin);
+
+        numFreeSlots += block.capacity;
+        block.begin = begin;
+    }
+    block.capacity = capacity;
+
+    repackEdges();
+}
+
+/**
+ * @brief Reduce the size of the block of a node, freeing the slots of the
+ * block if less than half of them is used
+ */
+template <class T>
+void IndexedGraph<T>::shrinkEdges(NodeId node, size_t size)
+{
+    EdgeBlock& block = edgeBlocks[node];
+    block.size = size;
+
+    if (block.capacity > 2 * size) {
+        numFreeSlots += block.capacity - size;
+        block.capacity = size;
+        repackEdges();
+    }
+}
+
+/**
+ * @brief Remove all the edges of a node and free its block
+ */
+template <class T>
+void IndexedGraph<T>::releaseEdges(NodeId node)
+{
+    EdgeBlock& block = edgeBlocks[node];
+    numFreeSlots += block.capacity;
+
+    block.begin = edgePool.size();
+    block.size = 0;
+    block.capacity = 0;
+
+    repackEdges();
+}
+
+/**
+ * @brief Move the blocks to a new pool without free slots, if more than
+ * half of the slots of the pool is free (the capacity of the blocks is
+ * kept, so the cost is amortized over the operations which freed the slots)
+ */
+template <class T>
+void IndexedGraph<T>::repackEdges()
+{
+    if (numFreeSlots <= internal::EDGE_POOL_MIN_REPACK || numFreeSlots <= edgePool.size() / 2)
+        return;
+
+    std::vector<Edge> pool;
+    pool.reserve(edgePool.size() - numFreeSlots);
+
+    for (EdgeBlock& block : edgeBlocks) {
+        size_t begin = pool.size();
+        pool.insert(pool.end(), edgePool.begin() + block.begin, edgePool.begin() + block.begin + block.size);
+        pool.resize(begin + block.capacity);
+        block.begin = begin;
+    }
+
+    edgePool.swap(pool);
+    numFreeSlots = 0;
+}
+
+/**
+ * @brief Execute a compaction step if the compaction is running or the
+ * ratio of tombstones exceeds the threshold
+ */
+template <class T>
+void IndexedGraph<T>::autoCompact()
+{
+    if (compacting || (!pendingIds.empty() && tombstoneRatio() > maxTombstoneRatio))
+        compactionStep();
+}
+
+
+
+/* ----- NODE ITERATOR ----- */
+
+template <class T>
+IndexedGraph<T>::NodeIterator::NodeIterator(const IndexedGraph<T>* graph, NodeId node) :
+    graph(graph),
+    node(node)
+{
+    while (this->node < graph->values.size() && graph->deleted[this->node])
+        this->node++;
+}
+
+template <class T>
+typename IndexedGraph<T>::NodeId IndexedGraph<T>::NodeIterator::operator*() const
+{
+    return node;
+}
+
+template <class T>
+typename IndexedGraph<T>::NodeIterator& IndexedGraph<T>::NodeIterator::operator++()
+{
+    do {
+        node++;
+    } while (node < graph->values.size() && graph->deleted[node]);
+
+    return *this;
+}
+
+template <class T>
+typename IndexedGraph<T>::NodeIterator IndexedGraph<T>::NodeIterator::operator++(int)
+{
+    NodeIterator old = *this;
+    ++(*this);
+    return old;
+}
+
+template <class T>
+bool IndexedGraph<T>::NodeIterator::operator==(const NodeIterator& other) const
+{
+    return node == other.node;
+}
+
+template <class T>
+bool IndexedGraph<T>::NodeIterator::operator!=(const NodeIterator& other) const
+{
+    return node != other.node;
+}
+
+
+
+/* ----- EDGE ITERATOR ----- */
+
+template <class T>
+IndexedGraph<T>::EdgeIterator::EdgeIterator(const IndexedGraph<T>* graph, const Edge* edge, const Edge* last) :
+    graph(graph),
+    edge(edge),
+    last(last)
+{
+    skipDeleted();
+}
+
+template <class T>
+const typename IndexedGraph<T>::Edge& IndexedGraph<T>::EdgeIterator::operator*() const
+{
+    return *edge;
+}
+
+template <class T>
+const typename IndexedGraph<T>::Edge* IndexedGraph<T>::EdgeIterator::operator->() const
+{
+    return edge;
+}
+
+template <class T>
+typename IndexedGraph<T>::EdgeIterator& IndexedGraph<T>::EdgeIterator::operator++()
+{
+    edge++;
+    skipDeleted();
+    return *this;
+}
+
+template <class T>
+typename IndexedGraph<T>::EdgeIterator IndexedGraph<T>::EdgeIterator::operator++(int)
+{
+    EdgeIterator old = *this;
+    ++(*this);
+    return old;
+}
+
+template <class T>
+bool IndexedGraph<T>::EdgeIterator::operator==(const EdgeIterator& other) const
+{
+    return edge == other.edge;
+}
+
+template <class T>
+bool IndexedGraph<T>::EdgeIterator::operator!=(const EdgeIterator& other) const
+{
+    return edge != other.edge;
+}
+
+template <class T>
+void IndexedGraph<T>::EdgeIterator::skipDeleted()
+{
+    while (edge != last && graph->deleted[edge->target])
+        edge++;
+}
+
+
+
+/* ----- GRAPH EDGE ITERATOR ----- */
+
+template <class T>
+IndexedGraph<T>::GraphEdgeIterator::GraphEdgeIterator(const IndexedGraph<T>* graph, NodeId source) :
+    graph(graph),
+    source(source),
+    edge(nullptr),
+    last(nullptr)
+{
+    if (source < graph->values.size()) {
+        edge = graph->nodeEdges(source);
+        last = edge + graph->edgeBlocks[source].size;
+    }
+    skipDeleted();
+}
+
+template <class T>
+typename IndexedGraph<T>::EdgeHandle IndexedGraph<T>::GraphEdgeIterator::operator*() const
+{
+    EdgeHandle handle = { source, edge->target, edge->weight };
+    return handle;
+}
+
+template <class T>
+typename IndexedGraph<T>::GraphEdgeIterator& IndexedGraph<T>::GraphEdgeIterator::operator++()
+{
+    edge++;
+    skipDeleted();
+    return *this;
+}
+
+template <class T>
+typename IndexedGraph<T>::GraphEdgeIterator IndexedGraph<T>::GraphEdgeIterator::operator++(int)
+{
+    GraphEdgeIterator old = *this;
+    ++(*this);
+    return old;
+}
+
+template <class T>
+bool IndexedGraph<T>::GraphEdgeIterator::operator==(const GraphEdgeIterator& other) const
+{
+    return source == other.source && edge == other.edge;
+}
+
+template <class T>
+bool IndexedGraph<T>::GraphEdgeIterator::operator!=(const GraphEdgeIterator& other) const
+{
+    return !(*this == other);
+}
+
+/**
+ * @brief Move to the next edge whose nodes are not deleted, going to the
+ * following source nodes when the edges of a node are finished (past the
+ * last node, the iterator is equal to the end iterator)
+ */
+template <class T>
+void IndexedGraph<T>::GraphEdgeIterator::skipDeleted()
+{
+    const NodeId n = graph->values.size();
+
+    while (source < n) {
+        if (!graph->deleted[source]) {
+            while (edge != last && graph->deleted[edge->target])
+                edge++;
+            if (edge != last)
+                return;
+        }
+
+        source++;
+        if (source < n) {
+            edge = graph->nodeEdges(source);
+            last = edge + graph->edgeBlocks[source].size;
+        }
+    }
+
+    edge = nullptr;
+    last = nullptr;
+}
+
+}
@@ -0,0 +1,144 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_DIJKSTRA_QUEUES_H
+#define CG3_DIJKSTRA_QUEUES_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace cg3 {
+
+/*
+ * Priority queues of nodes for Dijkstra-like algorithms. All the queues
+ * have the same interface:
+ *
+ * - initialize(numNodes, maxWeight): reset the queue for a graph with
+ *   numNodes nodes and maximum edge weight maxWeight (buffers are kept,
+ *   so a queue can be reused for many visits)
+ * - push(node, key): insert a node, or decrease its key
+ * - empty(): check if the queue is empty
+ * - pop(key): extract a node with minimum key, setting its key
+ *
+ * INTEGER_KEYS is true for the queues which support only non-negative
+ * integer keys: dijkstra uses a binary heap instead of them if the
+ * weights of the graph are not integers. supportsMaxWeight(numNodes,
+ * maxWeight) checks the range of the weights: integer keys must be exact
+ * in a double, and the Dial queue has a bounded number of buckets. Above
+ * the range dijkstra uses a radix heap or a binary heap instead.
+ *
+ * Queues may return outdated entries (a node with a key greater than its
+ * current key): the algorithms must skip them.
+ */
+
+
+/**
+ * @brief Binary heap with lazy deletion: decrease-key inserts a new entry
+ */
+class BinaryHeapQueue
+{
+public:
+    static const bool INTEGER_KEYS = false;
+
+    static inline bool supportsMaxWeight(size_t numNodes, double maxWeight);
+
+    inline void initialize(size_t numNodes, double maxWeight);
+    inline void push(size_t node, double key);
+    inline bool empty() const;
+    inline size_t pop(double& key);
+
+private:
+    std::vector<std::pair<double, size_t>> heap;
+};
+
+
+/**
+ * @brief Indexed D-ary heap with decrease-key. It never returns outdated
+ * entries, and it is shallower than a binary heap.
+ */
+template <int D = 4>
+class DaryHeapQueue
+{
+public:
+    static const bool INTEGER_KEYS = false;
+
+    static bool supportsMaxWeight(size_t numNodes, double maxWeight);
+
+    void initialize(size_t numNodes, double maxWeight);
+    void push(size_t node, double key);
+    bool empty() const;
+    size_t pop(double& key);
+
+private:
+    static const size_t NOT_IN_HEAP = static_cast<size_t>(-1);
+
+    std::vector<size_t> heap;
+    std::vector<double> keys;
+    std::vector<size_t> positions;
+
+    void siftUp(size_t position);
+    void siftDown(size_t position);
+};
+
+typedef DaryHeapQueue<4> QuaternaryHeapQueue;
+
+
+/**
+ * @brief Radix heap (Ahuja, Mehlhorn, Orlin, Tarjan) for non-negative
+ * integer weights: it exploits the monotonicity of the extracted keys,
+ * entries are moved between 65 buckets at most 64 times.
+ */
+class RadixHeapQueue
+{
+public:
+    static const bool INTEGER_KEYS = true;
+
+    static inline bool supportsMaxWeight(size_t numNodes, double maxWeight);
+
+    inline void initialize(size_t numNodes, double maxWeight);
+    inline void push(size_t node, double key);
+    inline bool empty() const;
+    inline size_t pop(double& key);
+
+private:
+    static const int NUMBER_BUCKETS = 65;
+
+    std::vector<std::pair<uint64_t, size_t>> buckets[NUMBER_BUCKETS];
+    uint64_t last;
+    size_t count;
+
+    inline int bucketIndex(uint64_t key) const;
+};
+
+
+/**
+ * @brief Dial bucket queue for small non-negative integer weights: a
+ * circular array of maxWeight+1 buckets, one for each key (the maximum
+ * weight is bounded, see supportsMaxWeight).
+ */
+class DialQueue
+{
+public:
+    static const bool INTEGER_KEYS = true;
+
+    static inline bool supportsMaxWeight(size_t numNodes, double maxWeight);
+
+    inline void initialize(size_t numNodes, double maxWeight);
+    inline void push(size_t node, double key);
+    inline bool empty() const;
+    inline size_t pop(double& key);
+
+private:
+    std::vector<std::vector<size_t>> buckets;
+    uint64_t current;
+    size_t count;
+};
+
+}
+
+#include "dijkstra_queues.tpp"
+
+#endif // CG3_DIJKSTRA_QUEUES_H
@@ -0,0 +1,335 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "dijkstra_queues.h"
+
+#include <algorithm>
+#include <functional>
+#include <cassert>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Largest integer key of the integer key queues which is exact in a double */
+static const double DIJKSTRA_MAX_INTEGER_KEY = 9007199254740992.0; //2^53
+
+/* Maximum number of buckets of a Dial queue */
+static const size_t DIAL_MAX_BUCKETS = 65536;
+
+}
+
+/* ----- BINARY HEAP ----- */
+
+/**
+ * @brief Any non-negative weight is supported
+ */
+inline bool BinaryHeapQueue::supportsMaxWeight(size_t numNodes, double maxWeight)
+{
+    (void) numNodes;
+    (void) maxWeight;
+
+    return true;
+}
+
+inline void BinaryHeapQueue::initialize(size_t numNodes, double maxWeight)
+{
+    (void) numNodes;
+    (void) maxWeight;
+
+    heap.clear();
+}
+
+inline void BinaryHeapQueue::push(size_t node, double key)
+{
+    heap.push_back(std::make_pair(key, node));
+    std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<double, size_t>>());
+}
+
+inline bool BinaryHeapQueue::empty() const
+{
+    return heap.empty();
+}
+
+inline size_t BinaryHeapQueue::pop(double& key)
+{
+    std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<double, size_t>>());
+    key = heap.back().first;
+    size_t node = heap.back().second;
+    heap.pop_back();
+    return node;
+}
+
+
+
+/* ----- D-ARY HEAP ----- */
+
+template <int D>
+const size_t DaryHeapQueue<D>::NOT_IN_HEAP;
+
+/**
+ * @brief Any non-negative weight is supported
+ */
+template <int D>
+bool DaryHeapQueue<D>::supportsMaxWeight(size_t numNodes, double maxWeight)
+{
+    (void) numNodes;
+    (void) maxWeight;
+
+    return true;
+}
+
+template <int D>
+void DaryHeapQueue<D>::initialize(size_t numNodes, double maxWeight)
+{
+    (void) maxWeight;
+
+    heap.clear();
+    keys.resize(numNodes);
+    positions.assign(numNodes, NOT_IN_HEAP);
+}
+
+template <int D>
+void DaryHeapQueue<D>::push(size_t node, double key)
+{
+    keys[node] = key;
+
+    if (positions[node] == NOT_IN_HEAP) {
+        positions[node] = heap.size();
+        heap.push_back(node);
+    }
+
+    siftUp(positions[node]);
+}
+
+template <int D>
+bool DaryHeapQueue<D>::empty() const
+{
+    return heap.empty();
+}
+
+template <int D>
+size_t DaryHeapQueue<D>::pop(double& key)
+{
+    size_t node = heap[0];
+    key = keys[node];
+    positions[node] = NOT_IN_HEAP;
+
+    size_t lastNode = heap.back();
+    heap.pop_back();
+
+    if (!heap.empty()) {
+        heap[0] = lastNode;
+        positions[lastNode] = 0;
+        siftDown(0);
+    }
+
+    return node;
+}
+
+template <int D>
+void DaryHeapQueue<D>::siftUp(size_t position)
+{
+    size_t node = heap[position];
+    double key = keys[node];
+
+    while (position > 0) {
+        size_t parent = (position - 1) / D;
+        if (keys[heap[parent]] <= key)
+            break;
+
+        heap[position] = heap[parent];
+        positions[heap[position]] = position;
+        position = parent;
+    }
+
+    heap[position] = node;
+    positions[node] = position;
+}
+
+template <int D>
+void DaryHeapQueue<D>::siftDown(size_t position)
+{
+    size_t node = heap[position];
+    double key = keys[node];
+    const size_t size = heap.size();
+
+    while (true) {
+        size_t firstChild = position * D + 1;
+        if (firstChild >= size)
+            break;
+
+        size_t lastChild = std::min(firstChild + D, size);
+        size_t minChild = firstChild;
+        for (size_t child = firstChild + 1; child < lastChild; child++) {
+            if (keys[heap[child]] < keys[heap[minChild]])
+                minChild = child;
+        }
+
+        if (keys[heap[minChild]] >= key)
+            break;
+
+        heap[position] = heap[minChild];
+        positions[heap[position]] = position;
+        position = minChild;
+    }
+
+    heap[position] = node;
+    positions[node] = position;
+}
+
+
+
+/* ----- RADIX HEAP ----- */
+
+/**
+ * @brief The distances (at most numNodes-1 edges of weight maxWeight)
+ * must be exact integers in a double
+ */
+inline bool RadixHeapQueue::supportsMaxWeight(size_t numNodes, double maxWeight)
+{
+    double maxDistance = maxWeight * static_cast<double>(numNodes > 1 ? numNodes - 1 : 1);
+    return maxDistance <= internal::DIJKSTRA_MAX_INTEGER_KEY;
+}
+
+inline void RadixHeapQueue::initialize(size_t numNodes, double maxWeight)
+{
+    (void) numNodes;
+    (void) maxWeight;
+
+    for (int i = 0; i < NUMBER_BUCKETS; i++)
+        buckets[i].clear();
+    last = 0;
+    count = 0;
+}
+
+inline void RadixHeapQueue::push(size_t node, double key)
+{
+    uint64_t integerKey = static_cast<uint64_t>(key);
+    assert(integerKey >= last && static_cast<double>(integerKey) == key);
+
+    buckets[bucketIndex(integerKey)].push_back(std::make_pair(integerKey, node));
+    count++;
+}
+
+inline bool RadixHeapQueue::empty() const
+{
+    return count == 0;
+}
+
+inline size_t RadixHeapQueue::pop(double& key)
+{
+    //Redistribution of the first non-empty bucket around its minimum
+    if (buckets[0].empty()) {
+        int i = 1;
+        while (buckets[i].empty())
+            i++;
+
+        uint64_t minKey = buckets[i][0].first;
+        for (const std::pair<uint64_t, size_t>& entry : buckets[i])
+            minKey = std::min(minKey, entry.first);
+
+        last = minKey;
+
+        for (const std::pair<uint64_t, size_t>& entry : buckets[i])
+            buckets[bucketIndex(entry.first)].push_back(entry);
+
+        buckets[i].clear();
+    }
+
+    std::pair<uint64_t, size_t> entry = buckets[0].back();
+    buckets[0].pop_back();
+    count--;
+
+    key = static_cast<double>(entry.first);
+    return entry.second;
+}
+
+/**
+ * @brief Bucket of a key: 0 if it is equal to the last extracted key,
+ * otherwise 1 + the position of the highest bit which differs from it
+ */
+inline int RadixHeapQueue::bucketIndex(uint64_t key) const
+{
+    uint64_t difference = key ^ last;
+    if (difference == 0)
+        return 0;
+
+#if defined(__GNUC__) || defined(__clang__)
+    return 64 - __builtin_clzll(difference);
+#else
+    int index = 0;
+    while (difference != 0) {
+        difference >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+
+
+/* ----- DIAL ----- */
+
+/**
+ * @brief The buckets (maxWeight+1) are bounded, and the distances must be
+ * exact integers in a double
+ */
+inline bool DialQueue::supportsMaxWeight(size_t numNodes, double maxWeight)
+{
+    return maxWeight < internal::DIAL_MAX_BUCKETS &&
+            RadixHeapQueue::supportsMaxWeight(numNodes, maxWeight);
+}
+
+inline void DialQueue::initialize(size_t numNodes, double maxWeight)
+{
+    (void) numNodes;
+
+    assert(maxWeight < internal::DIAL_MAX_BUCKETS);
+    size_t numberBuckets = static_cast<size_t>(maxWeight) + 1;
+
+    if (buckets.size() != numberBuckets)
+        buckets.resize(numberBuckets);
+    for (std::vector<size_t>& bucket : buckets)
+        bucket.clear();
+
+    current = 0;
+    count = 0;
+}
+
+inline void DialQueue::push(size_t node, double key)
+{
+    uint64_t integerKey = static_cast<uint64_t>(key);
+    assert(integerKey >= current && integerKey - current < buckets.size() &&
+           static_cast<double>(integerKey) == key);
+
+    buckets[integerKey % buckets.size()].push_back(node);
+    count++;
+}
+
+inline bool DialQueue::empty() const
+{
+    return count == 0;
+}
+
+/**
+ * @brief Extract a node from the first non-empty bucket. All the keys
+ * in the queue are in [current, current + maxWeight], so the key of the
+ * nodes in the bucket of the current position is current.
+ */
+inline size_t DialQueue::pop(double& key)
+{
+    while (buckets[current % buckets.size()].empty())
+        current++;
+
+    std::vector<size_t>& bucket = buckets[current % buckets.size()];
+    size_t node = bucket.back();
+    bucket.pop_back();
+    count--;
+
+    key = static_cast<double>(current);
+    return node;
+}
+
+}
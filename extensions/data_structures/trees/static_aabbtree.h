@@ -0,0 +1,273 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_STATIC_AABBTREE_H
+#define CG3_STATIC_AABBTREE_H
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <queue>
+#include <limits>
+#include <functional>
+#include <cstdint>
+
+#include <cg3/data_structures/trees/aabbtree.h>
+
+namespace cg3 {
+
+/**
+ * @brief Immutable, flattened bounding volume hierarchy with the same
+ * construction interface of cg3::AABBTree (vector of keys or key/value
+ * pairs and an AABBValueExtractor).
+ *
+ * Nodes are stored in a single vector in depth-first order: the left child
+ * of a node is the next node, the index of the right child is stored in
+ * the node itself. Keys and values are permuted in leaf order, so iteration
+ * and queries are linear scans on contiguous memory.
+ *
+ * The tree cannot be modified after construction: use cg3::AABBTree if
+ * insertions and deletions are needed.
+ */
+template <int D, class K, class T = K>
+class StaticAABBTree
+{
+
+public:
+
+    /* Typedefs */
+
+    typedef double (*AABBValueExtractor)(const K& key, const AABBValueType& valueType, const int& dim);
+
+    typedef std::array<double, D> Point;
+
+    typedef bool (*RayIntersector)(const K& key, const Point& origin, const Point& direction, double& t);
+
+    typedef double (*DistanceFunction)(const K& key, const Point& point);
+
+    typedef bool (*KeyOverlapChecker)(const K& key1, const K& key2);
+
+    /**
+     * @brief Results of a batch of overlap queries in compressed sparse
+     * row format: the results of the i-th query are the objects
+     * begin() + indices[j] for j in [offsets[i], offsets[i+1])
+     */
+    struct OverlapQueryResult {
+        std::vector<size_t> offsets;
+        std::vector<size_t> indices;
+    };
+
+    /**
+     * @brief Construction algorithm of the hierarchy:
+     * MEDIAN_SPLIT is a top-down construction (split on the median of the
+     * centroids along the widest axis), LBVH sorts the centroids by Morton
+     * code and emits the hierarchy in linear time. LBVH construction is
+     * much faster, but the resulting tree is usually slightly worse for queries.
+     */
+    enum BuildMethod { MEDIAN_SPLIT, LBVH };
+
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+
+    /* Constructors */
+
+    StaticAABBTree(AABBValueExtractor customAABBExtractor);
+    StaticAABBTree(
+            const std::vector<K>& vec,
+            AABBValueExtractor customAABBExtractor,
+            BuildMethod buildMethod = MEDIAN_SPLIT);
+    StaticAABBTree(
+            const std::vector<std::pair<K,T>>& vec,
+            AABBValueExtractor customAABBExtractor,
+            BuildMethod buildMethod = MEDIAN_SPLIT);
+
+
+    /* Public methods */
+
+    void construction(
+            const std::vector<K>& vec,
+            BuildMethod buildMethod = MEDIAN_SPLIT);
+    void construction(
+            const std::vector<std::pair<K,T>>& vec,
+            BuildMethod buildMethod = MEDIAN_SPLIT);
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    size_t getHeight() const;
+
+    const K& key(const_iterator it) const;
+
+
+    /* Overlap queries */
+
+    bool aabbOverlapCheck(
+            const K& key,
+            KeyOverlapChecker keyOverlapChecker = nullptr) const;
+
+    template <class OutputIterator>
+    OutputIterator aabbOverlapQuery(
+            const K& key,
+            OutputIterator out,
+            KeyOverlapChecker keyOverlapChecker = nullptr);
+
+    template <class RandomAccessIterator>
+    void aabbOverlapQuery(
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            OverlapQueryResult& result,
+            KeyOverlapChecker keyOverlapChecker = nullptr,
+            unsigned int nThreads = 0) const;
+
+
+    /* Ray queries */
+
+    iterator rayCast(
+            const Point& origin,
+            const Point& direction,
+            RayIntersector intersector,
+            double& t,
+            double maxT = std::numeric_limits<double>::max());
+
+    bool rayCastAny(
+            const Point& origin,
+            const Point& direction,
+            RayIntersector intersector,
+            double maxT = std::numeric_limits<double>::max()) const;
+
+    template <class OutputIterator>
+    OutputIterator rayCastAll(
+            const Point& origin,
+            const Point& direction,
+            RayIntersector intersector,
+            OutputIterator out,
+            double maxT = std::numeric_limits<double>::max()) const;
+
+
+    /* Distance queries */
+
+    iterator nearest(
+            const Point& point,
+            DistanceFunction distanceFunction,
+            double& distance);
+
+    template <class OutputIterator>
+    OutputIterator kNearest(
+            const Point& point,
+            size_t k,
+            DistanceFunction distanceFunction,
+            OutputIterator out);
+
+
+    /* Iterators */
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+
+protected:
+
+    /* Protected typedefs */
+
+    static const size_t MAX_LEAF_SIZE = 4;
+    static const size_t INLINE_STACK_SIZE = 64;
+    static const size_t QUERY_CHUNK_SIZE = 64;
+
+    struct Box {
+        double min[D];
+        double max[D];
+    };
+
+    struct Node {
+        Box box;
+        size_t first; //First object of the leaf
+        size_t size; //Number of objects in the leaf (0 for internal nodes)
+        size_t right; //Index of the right child (left child is the next node)
+    };
+
+    struct StackEntry {
+        size_t node;
+        double t;
+    };
+
+    typedef std::pair<double, size_t> QueueEntry;
+    typedef std::priority_queue<
+        QueueEntry,
+        std::vector<QueueEntry>,
+        std::greater<QueueEntry>> NodeQueue;
+
+    class TraversalStack;
+
+
+    /* Protected fields */
+
+    std::vector<Node> nodes;
+    std::vector<Box> boxes;
+    std::vector<K> keys;
+    std::vector<T> values;
+
+    size_t height;
+
+    AABBValueExtractor aabbValueExtractor;
+
+
+    /* Helpers */
+
+    void buildTree(std::vector<std::pair<K,T>>& vec, BuildMethod buildMethod);
+    size_t buildNode(
+            std::vector<size_t>& indices,
+            const std::vector<Point>& centroids,
+            size_t begin,
+            size_t end,
+            size_t depth);
+
+    void buildLBVH(
+            std::vector<size_t>& indices,
+            const std::vector<Point>& centroids);
+    void emitLBVH(
+            const std::vector<size_t>& children,
+            const std::vector<size_t>& rangeFirst,
+            const std::vector<size_t>& rangeLast,
+            size_t n);
+
+    Box computeBox(const K& key) const;
+
+    static uint64_t mortonCode(const Point& normalizedCentroid);
+    static uint64_t expandBits2D(uint64_t value);
+    static uint64_t expandBits3D(uint64_t value);
+    static int countLeadingZeros(uint64_t value);
+    static void radixSort(
+            std::vector<uint64_t>& codes,
+            std::vector<size_t>& indices);
+
+    template <class F>
+    void overlapTraversal(
+            const K& key,
+            KeyOverlapChecker keyOverlapChecker,
+            F f) const;
+
+    static void mergeBox(Box& box, const Box& other);
+    static bool boxOverlap(const Box& box1, const Box& box2);
+    static void invertDirection(const Point& direction, Point& invDirection);
+    static double boxDistance(const Box& box, const Point& point);
+    static bool rayBoxIntersection(
+            const Box& box,
+            const Point& origin,
+            const Point& invDirection,
+            double maxT,
+            double& tEntry);
+
+};
+
+}
+
+#include "static_aabbtree.tpp"
+
+#endif // CG3_STATIC_AABBTREE_H
@@ -0,0 +1,1387 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "static_aabbtree.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+template <int D, class K, class T>
+const size_t StaticAABBTree<D,K,T>::MAX_LEAF_SIZE;
+
+template <int D, class K, class T>
+const size_t StaticAABBTree<D,K,T>::INLINE_STACK_SIZE;
+
+template <int D, class K, class T>
+const size_t StaticAABBTree<D,K,T>::QUERY_CHUNK_SIZE;
+
+
+/* ----- TRAVERSAL STACK ----- */
+
+/**
+ * @brief Stack used for the traversals. It uses a fixed size array if the
+ * height of the tree allows it, avoiding heap allocations for each query.
+ */
+template <int D, class K, class T>
+class StaticAABBTree<D,K,T>::TraversalStack
+{
+public:
+    TraversalStack(size_t height) : useVector(height + 1 >= INLINE_STACK_SIZE), top(0)
+    {
+        if (useVector)
+            vec.reserve(height + 1);
+    }
+
+    inline void push(size_t node, double t)
+    {
+        StackEntry entry;
+        entry.node = node;
+        entry.t = t;
+
+        if (useVector)
+            vec.push_back(entry);
+        else
+            inlineStack[top++] = entry;
+    }
+
+    inline StackEntry pop()
+    {
+        if (useVector) {
+            StackEntry entry = vec.back();
+            vec.pop_back();
+            return entry;
+        }
+        return inlineStack[--top];
+    }
+
+    inline bool empty() const
+    {
+        return useVector ? vec.empty() : top == 0;
+    }
+
+private:
+    bool useVector;
+    size_t top;
+    StackEntry inlineStack[INLINE_STACK_SIZE];
+    std::vector<StackEntry> vec;
+};
+
+
+
+/* ----- CONSTRUCTORS ----- */
+
+/**
+ * @brief Constructor of an empty tree
+ * @param customAABBExtractor Function to extract the bounding box values of a key
+ */
+template <int D, class K, class T>
+StaticAABBTree<D,K,T>::StaticAABBTree(AABBValueExtractor customAABBExtractor) :
+    height(0),
+    aabbValueExtractor(customAABBExtractor)
+{
+
+}
+
+/**
+ * @brief Constructor with a vector of keys (values are copies of the keys)
+ * @param vec Vector of keys
+ * @param customAABBExtractor Function to extract the bounding box values of a key
+ * @param buildMethod Construction algorithm of the hierarchy
+ */
+template <int D, class K, class T>
+StaticAABBTree<D,K,T>::StaticAABBTree(
+        const std::vector<K>& vec,
+        AABBValueExtractor customAABBExtractor,
+        BuildMethod buildMethod) :
+    height(0),
+    aabbValueExtractor(customAABBExtractor)
+{
+    this->construction(vec, buildMethod);
+}
+
+/**
+ * @brief Constructor with a vector of pairs key/value
+ * @param vec Vector of pairs
+ * @param customAABBExtractor Function to extract the bounding box values of a key
+ * @param buildMethod Construction algorithm of the hierarchy
+ */
+template <int D, class K, class T>
+StaticAABBTree<D,K,T>::StaticAABBTree(
+        const std::vector<std::pair<K,T>>& vec,
+        AABBValueExtractor customAABBExtractor,
+        BuildMethod buildMethod) :
+    height(0),
+    aabbValueExtractor(customAABBExtractor)
+{
+    this->construction(vec, buildMethod);
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Build the tree from a vector of keys. Previous content is deleted.
+ * @param vec Vector of keys
+ * @param buildMethod Construction algorithm of the hierarchy
+ */
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::construction(
+        const std::vector<K>& vec,
+        BuildMethod buildMethod)
+{
+    std::vector<std::pair<K,T>> pairVec;
+    pairVec.reserve(vec.size());
+
+    for (const K& key : vec) {
+        pairVec.push_back(std::make_pair(key, T(key)));
+    }
+
+    buildTree(pairVec, buildMethod);
+}
+
+/**
+ * @brief Build the tree from a vector of pairs key/value. Previous content is deleted.
+ * @param vec Vector of pairs
+ * @param buildMethod Construction algorithm of the hierarchy
+ */
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::construction(
+        const std::vector<std::pair<K,T>>& vec,
+        BuildMethod buildMethod)
+{
+    std::vector<std::pair<K,T>> pairVec(vec);
+
+    buildTree(pairVec, buildMethod);
+}
+
+/**
+ * @brief Get number of objects in the tree
+ * @return Size of the tree
+ */
+template <int D, class K, class T>
+size_t StaticAABBTree<D,K,T>::size() const
+{
+    return values.size();
+}
+
+/**
+ * @brief Check if the tree is empty
+ * @return True if the tree is empty
+ */
+template <int D, class K, class T>
+bool StaticAABBTree<D,K,T>::empty() const
+{
+    return values.empty();
+}
+
+/**
+ * @brief Clear the tree
+ */
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::clear()
+{
+    nodes.clear();
+    boxes.clear();
+    keys.clear();
+    values.clear();
+    height = 0;
+}
+
+/**
+ * @brief Get height of the tree
+ * @return Height of the tree
+ */
+template <int D, class K, class T>
+size_t StaticAABBTree<D,K,T>::getHeight() const
+{
+    return height;
+}
+
+/**
+ * @brief Get the key of an object of the tree
+ * @param it Iterator to the object
+ * @return Key of the object
+ */
+template <int D, class K, class T>
+const K& StaticAABBTree<D,K,T>::key(const_iterator it) const
+{
+    return keys[it - values.begin()];
+}
+
+
+
+/* ----- OVERLAP QUERIES ----- */
+
+/**
+ * @brief Check if the bounding box of a key overlaps at least an object
+ * of the tree
+ * @param key Query key
+ * @param keyOverlapChecker Custom checker applied after the box test (optional)
+ * @return True if an overlap is found
+ */
+template <int D, class K, class T>
+bool StaticAABBTree<D,K,T>::aabbOverlapCheck(
+        const K& key,
+        KeyOverlapChecker keyOverlapChecker) const
+{
+    bool found = false;
+
+    overlapTraversal(key, keyOverlapChecker, [&found] (size_t) -> bool {
+        found = true;
+        return false;
+    });
+
+    return found;
+}
+
+/**
+ * @brief Get the objects of the tree whose bounding box overlaps the
+ * bounding box of a key
+ * @param key Query key
+ * @param out Output iterator (of iterators of the tree)
+ * @param keyOverlapChecker Custom checker applied after the box test (optional)
+ * @return Output iterator after the last written element
+ */
+template <int D, class K, class T>
+template <class OutputIterator>
+OutputIterator StaticAABBTree<D,K,T>::aabbOverlapQuery(
+        const K& key,
+        OutputIterator out,
+        KeyOverlapChecker keyOverlapChecker)
+{
+    iterator first = values.begin();
+
+    overlapTraversal(key, keyOverlapChecker, [&out, first] (size_t index) -> bool {
+        *out = first + index;
+        out++;
+        return true;
+    });
+
+    return out;
+}
+
+/**
+ * @brief Batched overlap queries. The queries are split in chunks which
+ * are distributed over the threads; each thread writes in its own buffer
+ * and the buffers are finally copied in a single compressed sparse row
+ * structure, so no vector is allocated for each query.
+ * @param[in] first Iterator to the first query key
+ * @param[in] last Iterator after the last query key
+ * @param[out] result Results of the queries (see OverlapQueryResult)
+ * @param[in] keyOverlapChecker Custom checker applied after the box test (optional)
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <int D, class K, class T>
+template <class RandomAccessIterator>
+void StaticAABBTree<D,K,T>::aabbOverlapQuery(
+        RandomAccessIterator first,
+        RandomAccessIterator last,
+        OverlapQueryResult& result,
+        KeyOverlapChecker keyOverlapChecker,
+        unsigned int nThreads) const
+{
+    const size_t nQueries = last - first;
+    const size_t nChunks = (nQueries + QUERY_CHUNK_SIZE - 1) / QUERY_CHUNK_SIZE;
+
+    nThreads = numberOfThreads(nThreads);
+
+    std::vector<std::vector<size_t>> threadBuffers(nThreads);
+    std::vector<unsigned int> chunkThread(nChunks);
+    std::vector<size_t> chunkBufferBegin(nChunks);
+
+    result.offsets.assign(nQueries + 1, 0);
+
+    //Queries: the number of results of the i-th query is stored in offsets[i+1]
+    parallelForChunks(nQueries, QUERY_CHUNK_SIZE,
+        [&] (unsigned int threadIndex, size_t chunk, size_t begin, size_t end)
+    {
+        std::vector<size_t>& buffer = threadBuffers[threadIndex];
+
+        chunkThread[chunk] = threadIndex;
+        chunkBufferBegin[chunk] = buffer.size();
+
+        for (size_t i = begin; i < end; i++) {
+            size_t sizeBefore = buffer.size();
+
+            overlapTraversal(*(first + i), keyOverlapChecker, [&buffer] (size_t index) -> bool {
+                buffer.push_back(index);
+                return true;
+            });
+
+            result.offsets[i + 1] = buffer.size() - sizeBefore;
+        }
+    }, nThreads);
+
+    for (size_t i = 0; i < nQueries; i++) {
+        result.offsets[i + 1] += result.offsets[i];
+    }
+
+    //Copy of the thread buffers in the final structure
+    result.indices.resize(result.offsets[nQueries]);
+
+    parallelFor(nChunks, [&] (size_t chunk) {
+        const std::vector<size_t>& buffer = threadBuffers[chunkThread[chunk]];
+
+        size_t queryBegin = chunk * QUERY_CHUNK_SIZE;
+        size_t queryEnd = std::min(nQueries, queryBegin + QUERY_CHUNK_SIZE);
+        size_t chunkSize = result.offsets[queryEnd] - result.offsets[queryBegin];
+
+        std::copy(
+                buffer.begin() + chunkBufferBegin[chunk],
+                buffer.begin() + chunkBufferBegin[chunk] + chunkSize,
+                result.indices.begin() + result.offsets[queryBegin]);
+    }, nThreads);
+}
+
+
+
+/* ----- RAY QUERIES ----- */
+
+/**
+ * @brief Get the first object hit by a ray. The nodes are visited front-to-back
+ * and a subtree is pruned if its entry point is farther than the current
+ * best hit.
+ *
+ * A segment cast from p to q can be done using q-p as direction and 1 as maxT.
+ *
+ * @param[in] origin Origin of the ray
+ * @param[in] direction Direction of the ray (it has not to be normalized)
+ * @param[in] intersector Function that returns true if the ray hits the key,
+ * setting the parameter t of the hit point (origin + t*direction)
+ * @param[out] t Parameter of the hit point
+ * @param[in] maxT Maximum value of the parameter t
+ * @return Iterator to the closest object hit by the ray, end() if no object is hit
+ */
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::iterator StaticAABBTree<D,K,T>::rayCast(
+        const Point& origin,
+        const Point& direction,
+        RayIntersector intersector,
+        double& t,
+        double maxT)
+{
+    const size_t noHit = values.size();
+
+    size_t bestIndex = noHit;
+    double bestT = maxT;
+
+    if (nodes.empty())
+        return this->end();
+
+    Point invDirection;
+    invertDirection(direction, invDirection);
+
+    double tEntry;
+    if (!rayBoxIntersection(nodes[0].box, origin, invDirection, bestT, tEntry))
+        return this->end();
+
+    TraversalStack stack(height);
+    stack.push(0, tEntry);
+
+    while (!stack.empty()) {
+        StackEntry entry = stack.pop();
+
+        //Pruning: the node is farther than the current hit
+        if (entry.t > bestT)
+            continue;
+
+        const Node& node = nodes[entry.node];
+
+        if (node.size > 0) {
+            for (size_t i = node.first; i < node.first + node.size; i++) {
+                double objectT;
+                if (intersector(keys[i], origin, direction, objectT) &&
+                        objectT >= 0 && objectT <= bestT &&
+                        (bestIndex == noHit || objectT < bestT))
+                {
+                    bestT = objectT;
+                    bestIndex = i;
+                }
+            }
+        }
+        else {
+            size_t left = entry.node + 1;
+            size_t right = node.right;
+
+            double tLeft, tRight;
+            bool hitLeft = rayBoxIntersection(nodes[left].box, origin, invDirection, bestT, tLeft);
+            bool hitRight = rayBoxIntersection(nodes[right].box, origin, invDirection, bestT, tRight);
+
+            //The nearest child is pushed last, so it is visited first
+            if (hitLeft && hitRight) {
+                if (tLeft <= tRight) {
+                    stack.push(right, tRight);
+                    stack.push(left, tLeft);
+                }
+                else {
+                    stack.push(left, tLeft);
+                    stack.push(right, tRight);
+                }
+            }
+            else if (hitLeft) {
+                stack.push(left, tLeft);
+            }
+            else if (hitRight) {
+                stack.push(right, tRight);
+            }
+        }
+    }
+
+    if (bestIndex == noHit)
+        return this->end();
+
+    t = bestT;
+    return values.begin() + bestIndex;
+}
+
+/**
+ * @brief Check if a ray hits any object of the tree. The traversal stops
+ * at the first hit found.
+ * @param[in] origin Origin of the ray
+ * @param[in] direction Direction of the ray (it has not to be normalized)
+ * @param[in] intersector Function that returns true if the ray hits the key,
+ * setting the parameter t of the hit point (origin + t*direction)
+ * @param[in] maxT Maximum value of the parameter t
+ * @return True if the ray hits at least an object with parameter t in [0, maxT]
+ */
+template <int D, class K, class T>
+bool StaticAABBTree<D,K,T>::rayCastAny(
+        const Point& origin,
+        const Point& direction,
+        RayIntersector intersector,
+        double maxT) const
+{
+    if (nodes.empty())
+        return false;
+
+    Point invDirection;
+    invertDirection(direction, invDirection);
+
+    double tEntry;
+    if (!rayBoxIntersection(nodes[0].box, origin, invDirection, maxT, tEntry))
+        return false;
+
+    TraversalStack stack(height);
+    stack.push(0, tEntry);
+
+    while (!stack.empty()) {
+        StackEntry entry = stack.pop();
+
+        const Node& node = nodes[entry.node];
+
+        if (node.size > 0) {
+            for (size_t i = node.first; i < node.first + node.size; i++) {
+                double objectT;
+                if (intersector(keys[i], origin, direction, objectT) &&
+                        objectT >= 0 && objectT <= maxT)
+                {
+                    return true;
+                }
+            }
+        }
+        else {
+            double tChild;
+            if (rayBoxIntersection(nodes[node.right].box, origin, invDirection, maxT, tChild))
+                stack.push(node.right, tChild);
+            if (rayBoxIntersection(nodes[entry.node + 1].box, origin, invDirection, maxT, tChild))
+                stack.push(entry.node + 1, tChild);
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get all the objects hit by a ray (or a segment, using maxT),
+ * for example to count the crossings of a ray. Results are not sorted.
+ *
+ * @param[in] origin Origin of the ray
+ * @param[in] direction Direction of the ray
+ * @param[in] intersector Function which checks if the ray hits a key,
+ * setting the parameter t of the hit point (origin + t*direction)
+ * @param[out] out Output iterator for the pairs (t, const_iterator) of the hit objects
+ * @param[in] maxT Maximum value of the parameter t
+ * @return Output iterator after the last result
+ */
+template <int D, class K, class T>
+template <class OutputIterator>
+OutputIterator StaticAABBTree<D,K,T>::rayCastAll(
+        const Point& origin,
+        const Point& direction,
+        RayIntersector intersector,
+        OutputIterator out,
+        double maxT) const
+{
+    if (nodes.empty())
+        return out;
+
+    Point invDirection;
+    invertDirection(direction, invDirection);
+
+    double tEntry;
+    if (!rayBoxIntersection(nodes[0].box, origin, invDirection, maxT, tEntry))
+        return out;
+
+    TraversalStack stack(height);
+    stack.push(0, tEntry);
+
+    while (!stack.empty()) {
+        StackEntry entry = stack.pop();
+
+        const Node& node = nodes[entry.node];
+
+        if (node.size > 0) {
+            for (size_t i = node.first; i < node.first + node.size; i++) {
+                double objectT;
+                if (intersector(keys[i], origin, direction, objectT) &&
+                        objectT >= 0 && objectT <= maxT)
+                {
+                    *out = std::make_pair(objectT, values.cbegin() + i);
+                    ++out;
+                }
+            }
+        }
+        else {
+            double tChild;
+            if (rayBoxIntersection(nodes[node.right].box, origin, invDirection, maxT, tChild))
+                stack.push(node.right, tChild);
+            if (rayBoxIntersection(nodes[entry.node + 1].box, origin, invDirection, maxT, tChild))
+                stack.push(entry.node + 1, tChild);
+        }
+    }
+
+    return out;
+}
+
+
+
+/* ----- DISTANCE QUERIES ----- */
+
+/**
+ * @brief Get the object nearest to a point. The nodes are visited best-first
+ * (ordered by the distance between their box and the point) and the visit
+ * stops when the nearest box is farther than the current best object.
+ *
+ * The distance function must never be smaller than the euclidean distance
+ * between the point and the bounding box of the key (e.g. the euclidean
+ * distance between the point and the object).
+ *
+ * @param[in] point Query point
+ * @param[in] distanceFunction Distance between a key and a point
+ * @param[out] distance Distance of the nearest object
+ * @return Iterator to the nearest object, end() if the tree is empty
+ */
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::iterator StaticAABBTree<D,K,T>::nearest(
+        const Point& point,
+        DistanceFunction distanceFunction,
+        double& distance)
+{
+    const size_t noResult = values.size();
+
+    size_t bestIndex = noResult;
+    double bestDistance = std::numeric_limits<double>::max();
+
+    if (nodes.empty())
+        return this->end();
+
+    NodeQueue queue;
+    queue.push(QueueEntry(boxDistance(nodes[0].box, point), 0));
+
+    while (!queue.empty()) {
+        QueueEntry entry = queue.top();
+        queue.pop();
+
+        //All the remaining nodes are farther than the best object
+        if (entry.first >= bestDistance)
+            break;
+
+        const Node& node = nodes[entry.second];
+
+        if (node.size > 0) {
+            for (size_t i = node.first; i < node.first + node.size; i++) {
+                if (boxDistance(boxes[i], point) < bestDistance) {
+                    double objectDistance = distanceFunction(keys[i], point);
+                    if (objectDistance < bestDistance) {
+                        bestDistance = objectDistance;
+                        bestIndex = i;
+                    }
+                }
+            }
+        }
+        else {
+            size_t left = entry.second + 1;
+            size_t right = node.right;
+
+            double leftDistance = boxDistance(nodes[left].box, point);
+            if (leftDistance < bestDistance)
+                queue.push(QueueEntry(leftDistance, left));
+
+            double rightDistance = boxDistance(nodes[right].box, point);
+            if (rightDistance < bestDistance)
+                queue.push(QueueEntry(rightDistance, right));
+        }
+    }
+
+    if (bestIndex == noResult)
+        return this->end();
+
+    distance = bestDistance;
+    return values.begin() + bestIndex;
+}
+
+/**
+ * @brief Get the k objects nearest to a point, sorted by increasing distance.
+ * The nodes are visited best-first and pruned using the distance of the
+ * k-th nearest object found so far.
+ *
+ * The distance function must satisfy the same requirements of nearest().
+ *
+ * @param[in] point Query point
+ * @param[in] k Number of objects
+ * @param[in] distanceFunction Distance between a key and a point
+ * @param[out] out Output iterator (of iterators of the tree)
+ * @return Output iterator after the last written element
+ */
+template <int D, class K, class T>
+template <class OutputIterator>
+OutputIterator StaticAABBTree<D,K,T>::kNearest(
+        const Point& point,
+        size_t k,
+        DistanceFunction distanceFunction,
+        OutputIterator out)
+{
+    if (nodes.empty() || k == 0)
+        return out;
+
+    //Max-heap of the k best objects (distance, index)
+    std::priority_queue<QueueEntry> best;
+
+    NodeQueue queue;
+    queue.push(QueueEntry(boxDistance(nodes[0].box, point), 0));
+
+    while (!queue.empty()) {
+        QueueEntry entry = queue.top();
+        queue.pop();
+
+        double bound = best.size() < k ? std::numeric_limits<double>::max() : best.top().first;
+        if (entry.first >= bound)
+            break;
+
+        const Node& node = nodes[entry.second];
+
+        if (node.size > 0) {
+            for (size_t i = node.first; i < node.first + node.size; i++) {
+                if (boxDistance(boxes[i], point) < bound) {
+                    double objectDistance = distanceFunction(keys[i], point);
+                    if (objectDistance < bound) {
+                        best.push(QueueEntry(objectDistance, i));
+                        if (best.size() > k)
+                            best.pop();
+                        if (best.size() == k)
+                            bound = best.top().first;
+                    }
+                }
+            }
+        }
+        else {
+            size_t left = entry.second + 1;
+            size_t right = node.right;
+
+            double leftDistance = boxDistance(nodes[left].box, point);
+            if (leftDistance < bound)
+                queue.push(QueueEntry(leftDistance, left));
+
+            double rightDistance = boxDistance(nodes[right].box, point);
+            if (rightDistance < bound)
+                queue.push(QueueEntry(rightDistance, right));
+        }
+    }
+
+    std::vector<size_t> result(best.size());
+    for (size_t i = best.size(); i > 0; i--) {
+        result[i-1] = best.top().second;
+        best.pop();
+    }
+
+    for (size_t index : result) {
+        *out = values.begin() + index;
+        out++;
+    }
+
+    return out;
+}
+
+
+
+/* ----- ITERATORS ----- */
+
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::iterator StaticAABBTree<D,K,T>::begin()
+{
+    return values.begin();
+}
+
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::iterator StaticAABBTree<D,K,T>::end()
+{
+    return values.end();
+}
+
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::const_iterator StaticAABBTree<D,K,T>::begin() const
+{
+    return values.begin();
+}
+
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::const_iterator StaticAABBTree<D,K,T>::end() const
+{
+    return values.end();
+}
+
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::const_iterator StaticAABBTree<D,K,T>::cbegin() const
+{
+    return values.cbegin();
+}
+
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::const_iterator StaticAABBTree<D,K,T>::cend() const
+{
+    return values.cend();
+}
+
+
+
+/* ----- HELPERS ----- */
+
+/**
+ * @brief Build the hierarchy and store keys and values in leaf order.
+ * @param vec Vector of pairs key/value
+ * @param buildMethod Construction algorithm of the hierarchy
+ */
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::buildTree(
+        std::vector<std::pair<K,T>>& vec,
+        BuildMethod buildMethod)
+{
+    this->clear();
+
+    if (vec.empty())
+        return;
+
+    const size_t n = vec.size();
+
+    std::vector<Box> unsortedBoxes(n);
+    std::vector<Point> centroids(n);
+    std::vector<size_t> indices(n);
+
+    parallelFor(n, [&] (size_t i) {
+        unsortedBoxes[i] = computeBox(vec[i].first);
+        for (int d = 0; d < D; d++) {
+            centroids[i][d] = (unsortedBoxes[i].min[d] + unsortedBoxes[i].max[d]) / 2.0;
+        }
+        indices[i] = i;
+    });
+
+    boxes.swap(unsortedBoxes);
+
+    if (buildMethod == LBVH) {
+        buildLBVH(indices, centroids);
+    }
+    else {
+        nodes.reserve(2 * (n / MAX_LEAF_SIZE + 1));
+        buildNode(indices, centroids, 0, n, 0);
+    }
+
+    //Permutation of the objects in leaf order
+    std::vector<Box> sortedBoxes;
+    sortedBoxes.reserve(n);
+    keys.reserve(n);
+    values.reserve(n);
+
+    for (size_t i = 0; i < n; i++) {
+        sortedBoxes.push_back(boxes[indices[i]]);
+        keys.push_back(vec[indices[i]].first);
+        values.push_back(vec[indices[i]].second);
+    }
+
+    boxes.swap(sortedBoxes);
+
+    //Boxes of the LBVH nodes are computed bottom-up when the objects are sorted
+    if (buildMethod == LBVH) {
+        for (size_t i = nodes.size(); i > 0; i--) {
+            Node& node = nodes[i-1];
+            if (node.size > 0) {
+                node.box = boxes[node.first];
+                for (size_t j = node.first + 1; j < node.first + node.size; j++)
+                    mergeBox(node.box, boxes[j]);
+            }
+            else {
+                node.box = nodes[i].box;
+                mergeBox(node.box, nodes[node.right].box);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Build a node of the hierarchy for the objects in [begin, end)
+ * @return Index of the node
+ */
+template <int D, class K, class T>
+size_t StaticAABBTree<D,K,T>::buildNode(
+        std::vector<size_t>& indices,
+        const std::vector<Point>& centroids,
+        size_t begin,
+        size_t end,
+        size_t depth)
+{
+    assert(end > begin);
+
+    size_t nodeIndex = nodes.size();
+    nodes.push_back(Node());
+
+    Box box = boxes[indices[begin]];
+    for (size_t i = begin + 1; i < end; i++) {
+        mergeBox(box, boxes[indices[i]]);
+    }
+
+    nodes[nodeIndex].box = box;
+    nodes[nodeIndex].first = begin;
+    nodes[nodeIndex].size = 0;
+    nodes[nodeIndex].right = 0;
+
+    height = std::max(height, depth + 1);
+
+    if (end - begin <= MAX_LEAF_SIZE) {
+        nodes[nodeIndex].size = end - begin;
+        return nodeIndex;
+    }
+
+    //Split axis: widest extent of the centroids
+    Point minCentroid = centroids[indices[begin]];
+    Point maxCentroid = centroids[indices[begin]];
+    for (size_t i = begin + 1; i < end; i++) {
+        for (int d = 0; d < D; d++) {
+            minCentroid[d] = std::min(minCentroid[d], centroids[indices[i]][d]);
+            maxCentroid[d] = std::max(maxCentroid[d], centroids[indices[i]][d]);
+        }
+    }
+
+    int axis = 0;
+    for (int d = 1; d < D; d++) {
+        if (maxCentroid[d] - minCentroid[d] > maxCentroid[axis] - minCentroid[axis])
+            axis = d;
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(
+                indices.begin() + begin,
+                indices.begin() + mid,
+                indices.begin() + end,
+                [&centroids, axis] (size_t a, size_t b) {
+                    return centroids[a][axis] < centroids[b][axis];
+                });
+
+    buildNode(indices, centroids, begin, mid, depth + 1);
+    size_t right = buildNode(indices, centroids, mid, end, depth + 1);
+    nodes[nodeIndex].right = right;
+
+    return nodeIndex;
+}
+
+/**
+ * @brief Linear BVH construction: the centroids are sorted by Morton code
+ * (parallel radix sort) and the binary radix tree of the sorted codes is
+ * built in parallel (each internal node is computed independently, as in
+ * Karras, "Maximizing Parallelism in the Construction of BVHs, Octrees,
+ * and k-d Trees", 2012). The radix tree is finally emitted in depth-first
+ * order, collapsing small subtrees in leaves.
+ *
+ * Boxes of the nodes are computed by buildTree after sorting the objects.
+ *
+ * @param indices Indices of the objects: at the end they are sorted by Morton code
+ * @param centroids Centroids of the objects
+ */
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::buildLBVH(
+        std::vector<size_t>& indices,
+        const std::vector<Point>& centroids)
+{
+    const size_t n = indices.size();
+
+    //Bounds of the centroids, used to normalize them
+    Point minCentroid = centroids[0];
+    Point maxCentroid = centroids[0];
+    for (size_t i = 1; i < n; i++) {
+        for (int d = 0; d < D; d++) {
+            minCentroid[d] = std::min(minCentroid[d], centroids[i][d]);
+            maxCentroid[d] = std::max(maxCentroid[d], centroids[i][d]);
+        }
+    }
+
+    std::vector<uint64_t> codes(n);
+
+    parallelFor(n, [&] (size_t i) {
+        Point normalized;
+        for (int d = 0; d < D; d++) {
+            double extent = maxCentroid[d] - minCentroid[d];
+            normalized[d] = extent > 0 ? (centroids[i][d] - minCentroid[d]) / extent : 0;
+        }
+        codes[i] = mortonCode(normalized);
+    });
+
+    radixSort(codes, indices);
+
+    if (n == 1) {
+        nodes.resize(1);
+        nodes[0].first = 0;
+        nodes[0].size = 1;
+        nodes[0].right = 0;
+        height = 1;
+        return;
+    }
+
+    //Common prefix between the codes in position i and j (-1 if j is out of range).
+    //Equal codes are disambiguated using their positions.
+    auto delta = [&codes, n] (size_t i, long long j) -> int {
+        if (j < 0 || j >= (long long) n)
+            return -1;
+        if (codes[i] == codes[j])
+            return 64 + countLeadingZeros((uint64_t) i ^ (uint64_t) j);
+        return countLeadingZeros(codes[i] ^ codes[j]);
+    };
+
+    //Internal nodes of the radix tree: children[2*i] and children[2*i+1]
+    //are the children of the node i. Leaves are encoded as n-1 + position.
+    std::vector<size_t> children(2 * (n - 1));
+    std::vector<size_t> rangeFirst(n - 1);
+    std::vector<size_t> rangeLast(n - 1);
+
+    parallelFor(n - 1, [&] (size_t i) {
+        long long li = (long long) i;
+
+        //Direction of the range
+        int direction = (delta(i, li + 1) - delta(i, li - 1)) >= 0 ? 1 : -1;
+        int deltaMin = delta(i, li - direction);
+
+        //Upper bound of the length of the range
+        long long maxLength = 2;
+        while (delta(i, li + maxLength * direction) > deltaMin)
+            maxLength *= 2;
+
+        //Length of the range (binary search)
+        long long length = 0;
+        for (long long t = maxLength / 2; t >= 1; t /= 2) {
+            if (delta(i, li + (length + t) * direction) > deltaMin)
+                length += t;
+        }
+        long long j = li + length * direction;
+
+        //Split position (binary search)
+        int deltaNode = delta(i, j);
+        long long split = 0;
+        long long t = length;
+        do {
+            t = (t + 1) / 2;
+            if (delta(i, li + (split + t) * direction) > deltaNode)
+                split += t;
+        } while (t > 1);
+        long long gamma = li + split * direction + std::min(direction, 0);
+
+        size_t first = (size_t) std::min(li, j);
+        size_t last = (size_t) std::max(li, j);
+
+        children[2*i] = (first == (size_t) gamma) ? (n - 1) + gamma : gamma;
+        children[2*i+1] = (last == (size_t) gamma + 1) ? (n - 1) + gamma + 1 : gamma + 1;
+        rangeFirst[i] = first;
+        rangeLast[i] = last;
+    });
+
+    emitLBVH(children, rangeFirst, rangeLast, n);
+}
+
+/**
+ * @brief Emit the radix tree in the depth-first node layout of the tree.
+ * Subtrees with at most MAX_LEAF_SIZE objects become leaves.
+ */
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::emitLBVH(
+        const std::vector<size_t>& children,
+        const std::vector<size_t>& rangeFirst,
+        const std::vector<size_t>& rangeLast,
+        size_t n)
+{
+    //Stack of (radix tree node, parent node to be linked as right child, depth)
+    struct EmitEntry {
+        size_t radixNode;
+        size_t parent;
+        size_t depth;
+    };
+
+    const size_t noParent = std::numeric_limits<size_t>::max();
+
+    nodes.reserve(2 * (n / MAX_LEAF_SIZE + 1));
+
+    std::vector<EmitEntry> stack;
+    EmitEntry root;
+    root.radixNode = 0;
+    root.parent = noParent;
+    root.depth = 0;
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        EmitEntry entry = stack.back();
+        stack.pop_back();
+
+        size_t nodeIndex = nodes.size();
+        nodes.push_back(Node());
+
+        if (entry.parent != noParent)
+            nodes[entry.parent].right = nodeIndex;
+
+        height = std::max(height, entry.depth + 1);
+
+        size_t first, last;
+        bool isLeaf = entry.radixNode >= n - 1;
+        if (isLeaf) {
+            first = last = entry.radixNode - (n - 1);
+        }
+        else {
+            first = rangeFirst[entry.radixNode];
+            last = rangeLast[entry.radixNode];
+        }
+
+        Node& node = nodes[nodeIndex];
+        node.right = 0;
+
+        if (isLeaf || last - first + 1 <= MAX_LEAF_SIZE) {
+            node.first = first;
+            node.size = last - first + 1;
+        }
+        else {
+            node.first = first;
+            node.size = 0;
+
+            //Right child is pushed first, so the left child is the next node
+            EmitEntry right;
+            right.radixNode = children[2 * entry.radixNode + 1];
+            right.parent = nodeIndex;
+            right.depth = entry.depth + 1;
+            stack.push_back(right);
+
+            EmitEntry left;
+            left.radixNode = children[2 * entry.radixNode];
+            left.parent = noParent;
+            left.depth = entry.depth + 1;
+            stack.push_back(left);
+        }
+    }
+}
+
+/**
+ * @brief Compute the bounding box of a key using the value extractor
+ */
+template <int D, class K, class T>
+typename StaticAABBTree<D,K,T>::Box StaticAABBTree<D,K,T>::computeBox(const K& key) const
+{
+    Box box;
+    for (int d = 0; d < D; d++) {
+        box.min[d] = aabbValueExtractor(key, AABBValueType::MIN, d+1);
+        box.max[d] = aabbValueExtractor(key, AABBValueType::MAX, d+1);
+    }
+    return box;
+}
+
+/**
+ * @brief Visit the objects overlapping the bounding box of a key. The
+ * function f(index) is called for each object found: if it returns false,
+ * the traversal is stopped.
+ */
+template <int D, class K, class T>
+template <class F>
+void StaticAABBTree<D,K,T>::overlapTraversal(
+        const K& key,
+        KeyOverlapChecker keyOverlapChecker,
+        F f) const
+{
+    if (nodes.empty())
+        return;
+
+    const Box box = computeBox(key);
+
+    if (!boxOverlap(nodes[0].box, box))
+        return;
+
+    TraversalStack stack(height);
+    stack.push(0, 0);
+
+    while (!stack.empty()) {
+        StackEntry entry = stack.pop();
+
+        const Node& node = nodes[entry.node];
+
+        if (node.size > 0) {
+            for (size_t i = node.first; i < node.first + node.size; i++) {
+                if (boxOverlap(boxes[i], box) &&
+                        (keyOverlapChecker == nullptr || keyOverlapChecker(keys[i], key)))
+                {
+                    if (!f(i))
+                        return;
+                }
+            }
+        }
+        else {
+            if (boxOverlap(nodes[node.right].box, box))
+                stack.push(node.right, 0);
+            if (boxOverlap(nodes[entry.node + 1].box, box))
+                stack.push(entry.node + 1, 0);
+        }
+    }
+}
+
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::mergeBox(Box& box, const Box& other)
+{
+    for (int d = 0; d < D; d++) {
+        box.min[d] = std::min(box.min[d], other.min[d]);
+        box.max[d] = std::max(box.max[d], other.max[d]);
+    }
+}
+
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::invertDirection(const Point& direction, Point& invDirection)
+{
+    //Division by zero gives infinity, which is handled by the slab test
+    for (int d = 0; d < D; d++) {
+        invDirection[d] = 1.0 / direction[d];
+    }
+}
+
+/**
+ * @brief Morton code of a centroid normalized in [0,1]^D. Bits of the
+ * quantized coordinates are interleaved (32 bits for each coordinate in
+ * 2D, 21 bits in 3D, 64/D bits in the other dimensions).
+ */
+template <int D, class K, class T>
+uint64_t StaticAABBTree<D,K,T>::mortonCode(const Point& normalizedCentroid)
+{
+    const int bits = (D == 1) ? 32 : 64 / D;
+    const double scale = (double) ((((uint64_t) 1) << bits) - 1);
+
+    uint64_t quantized[D];
+    for (int d = 0; d < D; d++) {
+        double value = std::min(std::max(normalizedCentroid[d], 0.0), 1.0);
+        quantized[d] = (uint64_t) (value * scale);
+    }
+
+    if (D == 2) {
+        return (expandBits2D(quantized[0]) << 1) | expandBits2D(quantized[D-1]);
+    }
+    if (D == 3) {
+        return (expandBits3D(quantized[0]) << 2) |
+               (expandBits3D(quantized[1 % D]) << 1) |
+                expandBits3D(quantized[D-1]);
+    }
+
+    uint64_t code = 0;
+    for (int b = bits - 1; b >= 0; b--) {
+        for (int d = 0; d < D; d++) {
+            code = (code << 1) | ((quantized[d] >> b) & 1);
+        }
+    }
+    return code;
+}
+
+/**
+ * @brief Insert a zero bit between the (32) bits of a value
+ */
+template <int D, class K, class T>
+uint64_t StaticAABBTree<D,K,T>::expandBits2D(uint64_t value)
+{
+    value &= 0x00000000FFFFFFFFull;
+    value = (value | (value << 16)) & 0x0000FFFF0000FFFFull;
+    value = (value | (value << 8)) & 0x00FF00FF00FF00FFull;
+    value = (value | (value << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    value = (value | (value << 2)) & 0x3333333333333333ull;
+    value = (value | (value << 1)) & 0x5555555555555555ull;
+    return value;
+}
+
+/**
+ * @brief Insert two zero bits between the (21) bits of a value
+ */
+template <int D, class K, class T>
+uint64_t StaticAABBTree<D,K,T>::expandBits3D(uint64_t value)
+{
+    value &= 0x00000000001FFFFFull;
+    value = (value | (value << 32)) & 0x001F00000000FFFFull;
+    value = (value | (value << 16)) & 0x001F0000FF0000FFull;
+    value = (value | (value << 8)) & 0x100F00F00F00F00Full;
+    value = (value | (value << 4)) & 0x10C30C30C30C30C3ull;
+    value = (value | (value << 2)) & 0x1249249249249249ull;
+    return value;
+}
+
+template <int D, class K, class T>
+int StaticAABBTree<D,K,T>::countLeadingZeros(uint64_t value)
+{
+    if (value == 0)
+        return 64;
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    while (!(value & (((uint64_t) 1) << 63))) {
+        value <<= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Parallel LSD radix sort (8 bits for each pass) of the codes,
+ * applying the same permutation to the indices. Passes on bytes which
+ * are equal for all the codes are skipped.
+ */
+template <int D, class K, class T>
+void StaticAABBTree<D,K,T>::radixSort(
+        std::vector<uint64_t>& codes,
+        std::vector<size_t>& indices)
+{
+    const size_t n = codes.size();
+    const size_t radix = 256;
+    const unsigned int nThreads = (unsigned int) std::min(
+                (size_t) numberOfThreads(), std::max(n / 4096, (size_t) 1));
+    const size_t blockSize = (n + nThreads - 1) / nThreads;
+
+    std::vector<uint64_t> tmpCodes(n);
+    std::vector<size_t> tmpIndices(n);
+
+    //histograms[t * radix + digit]
+    std::vector<size_t> histograms(nThreads * radix);
+
+    uint64_t differentBits = 0;
+    for (size_t i = 1; i < n; i++)
+        differentBits |= codes[i] ^ codes[0];
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        if (((differentBits >> shift) & 0xFF) == 0)
+            continue;
+
+        std::fill(histograms.begin(), histograms.end(), 0);
+
+        parallelForThreads([&] (unsigned int t) {
+            size_t begin = std::min(n, t * blockSize);
+            size_t end = std::min(n, begin + blockSize);
+            size_t* histogram = &histograms[t * radix];
+            for (size_t i = begin; i < end; i++)
+                histogram[(codes[i] >> shift) & 0xFF]++;
+        }, nThreads);
+
+        //Exclusive prefix sum in (digit, thread) order
+        size_t sum = 0;
+        for (size_t digit = 0; digit < radix; digit++) {
+            for (unsigned int t = 0; t < nThreads; t++) {
+                size_t count = histograms[t * radix + digit];
+                histograms[t * radix + digit] = sum;
+                sum += count;
+            }
+        }
+
+        parallelForThreads([&] (unsigned int t) {
+            size_t begin = std::min(n, t * blockSize);
+            size_t end = std::min(n, begin + blockSize);
+            size_t* offsets = &histograms[t * radix];
+            for (size_t i = begin; i < end; i++) {
+                size_t position = offsets[(codes[i] >> shift) & 0xFF]++;
+                tmpCodes[position] = codes[i];
+                tmpIndices[position] = indices[i];
+            }
+        }, nThreads);
+
+        codes.swap(tmpCodes);
+        indices.swap(tmpIndices);
+    }
+}
+
+template <int D, class K, class T>
+bool StaticAABBTree<D,K,T>::boxOverlap(const Box& box1, const Box& box2)
+{
+    for (int d = 0; d < D; d++) {
+        if (box1.min[d] > box2.max[d] || box1.max[d] < box2.min[d])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Euclidean distance between a box and a point (0 if the point is inside)
+ */
+template <int D, class K, class T>
+double StaticAABBTree<D,K,T>::boxDistance(const Box& box, const Point& point)
+{
+    double squaredDistance = 0;
+    for (int d = 0; d < D; d++) {
+        double delta = 0;
+        if (point[d] < box.min[d])
+            delta = box.min[d] - point[d];
+        else if (point[d] > box.max[d])
+            delta = point[d] - box.max[d];
+        squaredDistance += delta * delta;
+    }
+    return std::sqrt(squaredDistance);
+}
+
+/**
+ * @brief Slab test between a ray and a box
+ * @param[in] box Box
+ * @param[in] origin Origin of the ray
+ * @param[in] invDirection Inverse of the direction of the ray
+ * @param[in] maxT Maximum value of the parameter t
+ * @param[out] tEntry Parameter of the entry point of the ray in the box
+ * @return True if the ray enters the box with a parameter in [0, maxT]
+ */
+template <int D, class K, class T>
+bool StaticAABBTree<D,K,T>::rayBoxIntersection(
+        const Box& box,
+        const Point& origin,
+        const Point& invDirection,
+        double maxT,
+        double& tEntry)
+{
+    double tMin = 0;
+    double tMax = maxT;
+
+    for (int d = 0; d < D; d++) {
+        double t1 = (box.min[d] - origin[d]) * invDirection[d];
+        double t2 = (box.max[d] - origin[d]) * invDirection[d];
+
+        if (t1 > t2)
+            std::swap(t1, t2);
+
+        //NaN values (ray on the slab plane) are ignored by the comparisons
+        if (t1 > tMin)
+            tMin = t1;
+        if (t2 < tMax)
+            tMax = t2;
+
+        if (tMin > tMax)
+            return false;
+    }
+
+    tEntry = tMin;
+    return true;
+}
+
+}
@@ -0,0 +1,36 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_EDGE_LIST_H
+#define CG3_EDGE_LIST_H
+
+#include <string>
+
+#include "extensions/data_structures/graphs/indexed_graph.h"
+
+namespace cg3 {
+
+/**
+ * @brief Text formats of edge lists
+ *
+ * EDGE_LIST: one edge per line "source target [weight]", separated by
+ * spaces, tabs or commas; lines starting with '#' or '%' are comments
+ * (SNAP, KONECT and CSV edge lists).
+ * MATRIX_MARKET: coordinate Matrix Market file; the first line which is
+ * not a comment is the size line "rows columns entries" and it is skipped.
+ */
+enum EdgeListFormat { EDGE_LIST, MATRIX_MARKET };
+
+template <class T>
+bool loadEdgeList(
+        const std::string& filename,
+        IndexedGraph<T>& graph,
+        EdgeListFormat format = EDGE_LIST,
+        unsigned int nThreads = 0);
+
+}
+
+#include "edge_list.tpp"
+
+#endif // CG3_EDGE_LIST_H
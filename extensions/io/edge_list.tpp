@@ -0,0 +1,252 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "edge_list.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include "extensions/utilities/parallel.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/**
+ * @brief Edge read from a text file, before the values are mapped to ids
+ */
+struct ParsedEdge {
+    long long source;
+    long long target;
+    double weight;
+};
+
+inline bool isEdgeListSeparator(char c);
+inline const char* edgeListLineEnd(const char* begin, const char* end);
+inline const char* skipEdgeListHeader(const char* begin, const char* end, EdgeListFormat format);
+
+inline bool parseEdgeLines(
+        const char* begin,
+        const char* end,
+        std::vector<ParsedEdge>& edges);
+
+}
+
+
+/* ----- EDGE LISTS ----- */
+
+/**
+ * @brief Load an edge list text file in an indexed graph. The nodes are
+ * identified by integer values; a node is created for each value which is
+ * not already in the graph, and the edges are added with
+ * IndexedGraph::addEdges (weight 0 if it is not in the file, duplicated
+ * edges are merged).
+ *
+ * The file is read in memory and split in blocks of lines, which are
+ * parsed by different threads.
+ *
+ * @param[in] filename Name of the file
+ * @param[out] graph Graph in which nodes and edges are added
+ * @param[in] format Format of the file
+ * @param[in] nThreads Number of threads, 0 for the number of hardware threads
+ * @return True if the file has been read, false if it cannot be opened or
+ * it contains a malformed line (in that case the graph is not modified)
+ */
+template <class T>
+bool loadEdgeList(
+        const std::string& filename,
+        IndexedGraph<T>& graph,
+        EdgeListFormat format,
+        unsigned int nThreads)
+{
+    typedef typename IndexedGraph<T>::NodeId NodeId;
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+
+    std::string text(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    if (!file.read(&text[0], text.size()))
+        return false;
+
+    const char* begin = internal::skipEdgeListHeader(text.data(), text.data() + text.size(), format);
+    const char* end = text.data() + text.size();
+
+    //Blocks of lines: boundaries moved after the next newline (at most
+    //a thread for each byte, so the blocks are not empty)
+    nThreads = static_cast<unsigned int>(std::min<size_t>(
+                numberOfThreads(nThreads),
+                std::max<size_t>(1, end - begin)));
+    std::vector<const char*> boundaries(nThreads + 1, begin);
+    for (unsigned int t = 1; t <= nThreads; t++) {
+        const char* boundary = begin + (end - begin) * t / nThreads;
+        if (boundary > boundaries[t - 1] && boundary < end && boundary[-1] != '\n')
+            boundary = std::min(end, internal::edgeListLineEnd(boundary, end) + 1);
+        boundaries[t] = std::max(boundary, boundaries[t - 1]);
+    }
+
+    std::vector<std::vector<internal::ParsedEdge>> threadEdges(nThreads);
+    std::vector<char> valid(nThreads, true);
+
+    parallelForThreads([&] (unsigned int t) {
+        valid[t] = internal::parseEdgeLines(boundaries[t], boundaries[t + 1], threadEdges[t]);
+    }, nThreads);
+
+    if (std::find(valid.begin(), valid.end(), false) != valid.end())
+        return false;
+
+    std::vector<size_t> firstEdge(nThreads + 1, 0);
+    for (unsigned int t = 0; t < nThreads; t++)
+        firstEdge[t + 1] = firstEdge[t] + threadEdges[t].size();
+
+    const size_t m = firstEdge[nThreads];
+
+    //Values of the nodes, sorted and unique
+    std::vector<T> values(2 * m);
+    parallelForThreads([&] (unsigned int t) {
+        for (size_t i = 0; i < threadEdges[t].size(); i++) {
+            values[2 * (firstEdge[t] + i)] = static_cast<T>(threadEdges[t][i].source);
+            values[2 * (firstEdge[t] + i) + 1] = static_cast<T>(threadEdges[t][i].target);
+        }
+    }, nThreads);
+
+    parallelSort(values.begin(), values.end(), std::less<T>(), nThreads);
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    std::vector<NodeId> ids = graph.addNodes(values);
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (ids[i] == IndexedGraph<T>::NOT_FOUND)
+            ids[i] = graph.findNode(values[i]);
+    }
+
+    //Edges with the ids of the nodes
+    std::vector<std::pair<NodeId, NodeId>> edges(m);
+    std::vector<double> weights(m);
+
+    parallelForThreads([&] (unsigned int t) {
+        for (size_t i = 0; i < threadEdges[t].size(); i++) {
+            const internal::ParsedEdge& edge = threadEdges[t][i];
+            size_t e = firstEdge[t] + i;
+
+            edges[e].first = ids[std::lower_bound(values.begin(), values.end(), static_cast<T>(edge.source)) - values.begin()];
+            edges[e].second = ids[std::lower_bound(values.begin(), values.end(), static_cast<T>(edge.target)) - values.begin()];
+            weights[e] = edge.weight;
+        }
+        std::vector<internal::ParsedEdge>().swap(threadEdges[t]);
+    }, nThreads);
+
+    graph.addEdges(edges, weights);
+
+    return true;
+}
+
+
+
+namespace internal {
+
+/**
+ * @brief Check if a character separates the fields of a line
+ */
+inline bool isEdgeListSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+/**
+ * @brief Position of the newline at the end of the line (end if it is the
+ * last line)
+ */
+inline const char* edgeListLineEnd(const char* begin, const char* end)
+{
+    const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    return lineEnd == nullptr ? end : lineEnd;
+}
+
+/**
+ * @brief Skip the lines before the edges: the size line of Matrix Market
+ * files (and the comments before it)
+ */
+inline const char* skipEdgeListHeader(const char* begin, const char* end, EdgeListFormat format)
+{
+    if (format != MATRIX_MARKET)
+        return begin;
+
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = edgeListLineEnd(p, end);
+
+        const char* first = p;
+        while (first < lineEnd && isEdgeListSeparator(*first))
+            first++;
+
+        p = std::min(end, lineEnd + 1);
+
+        if (first < lineEnd && *first != '%')
+            break;
+    }
+
+    return p;
+}
+
+/**
+ * @brief Parse the lines in [begin, end), which must start at the beginning
+ * of a line. Fields after the weight are ignored.
+ * @return False if a line is malformed
+ */
+inline bool parseEdgeLines(
+        const char* begin,
+        const char* end,
+        std::vector<ParsedEdge>& edges)
+{
+    const char* p = begin;
+    char* next;
+
+    while (p < end) {
+        const char* lineEnd = edgeListLineEnd(p, end);
+
+        while (p < lineEnd && isEdgeListSeparator(*p))
+            p++;
+
+        if (p < lineEnd && *p != '#' && *p != '%') {
+            ParsedEdge edge;
+
+            edge.source = std::strtoll(p, &next, 10);
+            if (next == p || next > lineEnd)
+                return false;
+            p = next;
+
+            while (p < lineEnd && isEdgeListSeparator(*p))
+                p++;
+
+            edge.target = std::strtoll(p, &next, 10);
+            if (p == lineEnd || next == p || next > lineEnd)
+                return false;
+            p = next;
+
+            while (p < lineEnd && isEdgeListSeparator(*p))
+                p++;
+
+            edge.weight = 0;
+            if (p < lineEnd) {
+                edge.weight = std::strtod(p, &next);
+                if (next == p || next > lineEnd)
+                    return false;
+            }
+
+            edges.push_back(edge);
+        }
+
+        p = lineEnd + 1;
+    }
+
+    return true;
+}
+
+}
+
+}
@@ -0,0 +1,419 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "dcel_aabbtree.h"
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Directions of the rays used by the inside/outside test: they are not
+ * aligned with the axes, so rays rarely hit edges or vertices of meshes
+ * which are modeled on a grid */
+static const double INSIDE_RAY_DIRECTIONS[3][3] = {
+    { 0.5773502691896258, 0.5773502691896258, 0.5773502691896258 },
+    { -0.3015113445777636, 0.9045340337332909, -0.3015113445777636 },
+    { 0.2672612419124244, -0.5345224838248488, -0.8017837257372732 }
+};
+
+/* Relative tolerance used to merge hits of adjacent triangles on a shared edge */
+static const double CROSSING_EPSILON = 1e-9;
+
+}
+
+
+/* ----- CONSTRUCTORS ----- */
+
+/**
+ * @brief Default constructor: empty tree
+ */
+DcelAABBTree::DcelAABBTree() :
+    tree(&triangleValueExtractor)
+{
+
+}
+
+/**
+ * @brief Constructor with a mesh
+ * @param mesh Input mesh
+ * @param buildMethod Construction algorithm of the hierarchy
+ */
+DcelAABBTree::DcelAABBTree(const Dcel& mesh, BuildMethod buildMethod) :
+    tree(&triangleValueExtractor)
+{
+    this->construction(mesh, buildMethod);
+}
+
+
+
+/* ----- PUBLIC METHODS ----- */
+
+/**
+ * @brief Build the tree on the faces of a mesh. Previous content is deleted.
+ * @param mesh Input mesh
+ * @param buildMethod Construction algorithm of the hierarchy
+ */
+void DcelAABBTree::construction(const Dcel& mesh, BuildMethod buildMethod)
+{
+    std::vector<std::pair<Triangle, const Dcel::Face*>> triangles;
+    triangles.reserve(mesh.numberFaces());
+
+    std::vector<Pointd> boundary;
+
+    for (const Dcel::Face* face : mesh.faceIterator()) {
+        boundary.clear();
+
+        const Dcel::HalfEdge* first = face->outerHalfEdge();
+        const Dcel::HalfEdge* halfEdge = first;
+        do {
+            boundary.push_back(halfEdge->fromVertex()->coordinate());
+            halfEdge = halfEdge->next();
+        } while (halfEdge != first && halfEdge != nullptr);
+
+        for (size_t i = 1; i + 1 < boundary.size(); i++) {
+            Triangle triangle;
+            triangle.v1 = boundary[0];
+            triangle.v2 = boundary[i];
+            triangle.v3 = boundary[i+1];
+            triangles.push_back(std::make_pair(triangle, face));
+        }
+    }
+
+    tree.construction(triangles, buildMethod);
+}
+
+/**
+ * @brief Get the number of triangles in the tree
+ */
+size_t DcelAABBTree::numberTriangles() const
+{
+    return tree.size();
+}
+
+/**
+ * @brief Check if the tree is empty
+ */
+bool DcelAABBTree::empty() const
+{
+    return tree.empty();
+}
+
+/**
+ * @brief Clear the tree
+ */
+void DcelAABBTree::clear()
+{
+    tree.clear();
+}
+
+/**
+ * @brief Get the height of the tree
+ */
+size_t DcelAABBTree::getHeight() const
+{
+    return tree.getHeight();
+}
+
+
+
+/* ----- QUERIES ----- */
+
+/**
+ * @brief Get the point of the mesh nearest to a given point
+ * @param[in] point Query point
+ * @param[out] closest Point of the mesh nearest to the query point
+ * @param[out] distance Distance between the query point and the mesh
+ * @return Face containing the closest point, nullptr if the tree is empty
+ */
+const Dcel::Face* DcelAABBTree::closestPoint(
+        const Pointd& point,
+        Pointd& closest,
+        double& distance)
+{
+    Tree::iterator it = tree.nearest(toTreePoint(point), &trianglePointDistance, distance);
+    if (it == tree.end())
+        return nullptr;
+
+    closest = triangleClosestPoint(tree.key(it), point);
+
+    return *it;
+}
+
+/**
+ * @brief Get the first face hit by a ray
+ * @param[in] origin Origin of the ray
+ * @param[in] direction Direction of the ray
+ * @param[out] t Parameter of the hit point (origin + t*direction)
+ * @return First face hit by the ray, nullptr if no face is hit
+ */
+const Dcel::Face* DcelAABBTree::rayIntersection(
+        const Pointd& origin,
+        const Pointd& direction,
+        double& t)
+{
+    Tree::iterator it = tree.rayCast(
+                toTreePoint(origin),
+                toTreePoint(direction),
+                &triangleRayIntersection,
+                t);
+
+    if (it == tree.end())
+        return nullptr;
+
+    return *it;
+}
+
+/**
+ * @brief Check if a ray (or a segment, using maxT) hits the mesh
+ * @param[in] origin Origin of the ray
+ * @param[in] direction Direction of the ray
+ * @param[in] maxT Maximum value of the parameter t of the hit point
+ * @return True if the ray hits the mesh
+ */
+bool DcelAABBTree::rayIntersects(
+        const Pointd& origin,
+        const Pointd& direction,
+        double maxT) const
+{
+    return tree.rayCastAny(
+                toTreePoint(origin),
+                toTreePoint(direction),
+                &triangleRayIntersection,
+                maxT);
+}
+
+/**
+ * @brief Check if a point is inside the mesh, which is supposed to be
+ * closed. The crossings of three rays starting from the point are counted:
+ * the point is inside if most of the rays cross the mesh an odd number
+ * of times. The vote makes the test robust to rays which hit edges or
+ * vertices of the mesh.
+ * @param[in] point Query point
+ * @return True if the point is inside the mesh
+ */
+bool DcelAABBTree::isInside(const Pointd& point) const
+{
+    int oddRays = 0;
+
+    for (int i = 0; i < 3; i++) {
+        Pointd direction(
+                    internal::INSIDE_RAY_DIRECTIONS[i][0],
+                    internal::INSIDE_RAY_DIRECTIONS[i][1],
+                    internal::INSIDE_RAY_DIRECTIONS[i][2]);
+
+        if (rayCrossings(point, direction) % 2 == 1)
+            oddRays++;
+
+        //The result is already decided by the first two rays
+        if (i == 1 && oddRays != 1)
+            break;
+    }
+
+    return oddRays >= 2;
+}
+
+
+
+/* ----- TRIANGLE FUNCTIONS ----- */
+
+/**
+ * @brief Bounding box values of a triangle
+ */
+double DcelAABBTree::triangleValueExtractor(
+        const Triangle& triangle,
+        const AABBValueType& valueType,
+        const int& dim)
+{
+    double c1, c2, c3;
+    switch (dim) {
+    case 1:
+        c1 = triangle.v1.x(); c2 = triangle.v2.x(); c3 = triangle.v3.x();
+        break;
+    case 2:
+        c1 = triangle.v1.y(); c2 = triangle.v2.y(); c3 = triangle.v3.y();
+        break;
+    default:
+        c1 = triangle.v1.z(); c2 = triangle.v2.z(); c3 = triangle.v3.z();
+        break;
+    }
+
+    if (valueType == AABBValueType::MIN)
+        return std::min(c1, std::min(c2, c3));
+    return std::max(c1, std::max(c2, c3));
+}
+
+/**
+ * @brief Intersection between a ray and a triangle (Möller-Trumbore)
+ * @param[in] triangle Input triangle
+ * @param[in] origin Origin of the ray
+ * @param[in] direction Direction of the ray
+ * @param[out] t Parameter of the hit point (origin + t*direction)
+ * @return True if the ray hits the triangle
+ */
+bool DcelAABBTree::triangleRayIntersection(
+        const Triangle& triangle,
+        const Tree::Point& origin,
+        const Tree::Point& direction,
+        double& t)
+{
+    Pointd o(origin[0], origin[1], origin[2]);
+    Pointd d(direction[0], direction[1], direction[2]);
+
+    Pointd edge1 = triangle.v2 - triangle.v1;
+    Pointd edge2 = triangle.v3 - triangle.v1;
+
+    Pointd p = d.cross(edge2);
+    double determinant = edge1.dot(p);
+
+    if (determinant == 0)
+        return false;
+
+    double invDeterminant = 1.0 / determinant;
+
+    Pointd s = o - triangle.v1;
+    double u = s.dot(p) * invDeterminant;
+    if (u < 0 || u > 1)
+        return false;
+
+    Pointd q = s.cross(edge1);
+    double v = d.dot(q) * invDeterminant;
+    if (v < 0 || u + v > 1)
+        return false;
+
+    t = edge2.dot(q) * invDeterminant;
+
+    return t >= 0;
+}
+
+/**
+ * @brief Euclidean distance between a triangle and a point
+ */
+double DcelAABBTree::trianglePointDistance(
+        const Triangle& triangle,
+        const Tree::Point& point)
+{
+    Pointd p(point[0], point[1], point[2]);
+    return triangleClosestPoint(triangle, p).dist(p);
+}
+
+/**
+ * @brief Point of a triangle nearest to a given point (Ericson,
+ * "Real-Time Collision Detection", 5.1.5)
+ * @param[in] triangle Input triangle
+ * @param[in] point Query point
+ * @return Closest point on the triangle
+ */
+Pointd DcelAABBTree::triangleClosestPoint(
+        const Triangle& triangle,
+        const Pointd& point)
+{
+    const Pointd& a = triangle.v1;
+    const Pointd& b = triangle.v2;
+    const Pointd& c = triangle.v3;
+
+    Pointd ab = b - a;
+    Pointd ac = c - a;
+
+    //Vertex region of a
+    Pointd ap = point - a;
+    double d1 = ab.dot(ap);
+    double d2 = ac.dot(ap);
+    if (d1 <= 0 && d2 <= 0)
+        return a;
+
+    //Vertex region of b
+    Pointd bp = point - b;
+    double d3 = ab.dot(bp);
+    double d4 = ac.dot(bp);
+    if (d3 >= 0 && d4 <= d3)
+        return b;
+
+    //Edge region of ab
+    double vc = d1*d4 - d3*d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+        double v = d1 / (d1 - d3);
+        return a + ab * v;
+    }
+
+    //Vertex region of c
+    Pointd cp = point - c;
+    double d5 = ab.dot(cp);
+    double d6 = ac.dot(cp);
+    if (d6 >= 0 && d5 <= d6)
+        return c;
+
+    //Edge region of ac
+    double vb = d5*d2 - d1*d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+        double w = d2 / (d2 - d6);
+        return a + ac * w;
+    }
+
+    //Edge region of bc
+    double va = d3*d6 - d5*d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+        double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return b + (c - b) * w;
+    }
+
+    //Face region
+    double denominator = 1.0 / (va + vb + vc);
+    double v = vb * denominator;
+    double w = vc * denominator;
+    return a + ab * v + ac * w;
+}
+
+
+
+/* ----- HELPERS ----- */
+
+/**
+ * @brief Convert a point to the point type of the tree
+ */
+DcelAABBTree::Tree::Point DcelAABBTree::toTreePoint(const Pointd& point)
+{
+    Tree::Point treePoint = {{point.x(), point.y(), point.z()}};
+    return treePoint;
+}
+
+/**
+ * @brief Number of crossings between a ray and the mesh. Hits with
+ * the same parameter t (adjacent triangles hit on their shared edge)
+ * are counted once.
+ */
+size_t DcelAABBTree::rayCrossings(const Pointd& origin, const Pointd& direction) const
+{
+    std::vector<std::pair<double, Tree::const_iterator>> hits;
+
+    tree.rayCastAll(
+                toTreePoint(origin),
+                toTreePoint(direction),
+                &triangleRayIntersection,
+                std::back_inserter(hits));
+
+    if (hits.empty())
+        return 0;
+
+    std::sort(hits.begin(), hits.end(),
+        [] (const std::pair<double, Tree::const_iterator>& hit1,
+            const std::pair<double, Tree::const_iterator>& hit2) {
+            return hit1.first < hit2.first;
+        });
+
+    size_t crossings = 1;
+    for (size_t i = 1; i < hits.size(); i++) {
+        double tolerance = internal::CROSSING_EPSILON * std::max(1.0, hits[i].first);
+        if (hits[i].first - hits[i-1].first > tolerance)
+            crossings++;
+    }
+
+    return crossings;
+}
+
+}
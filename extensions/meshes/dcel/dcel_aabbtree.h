@@ -0,0 +1,116 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_DCEL_AABBTREE_H
+#define CG3_DCEL_AABBTREE_H
+
+#include <cg3/meshes/dcel/dcel.h>
+#include <cg3/geometry/point.h>
+
+#include "extensions/data_structures/trees/static_aabbtree.h"
+
+namespace cg3 {
+
+/**
+ * @brief 3D AABB tree on the faces of a Dcel, for closest point, ray
+ * intersection and inside/outside queries. Faces with more than three
+ * vertices are triangulated as a fan of their outer boundary.
+ *
+ * The tree refers to the faces of the mesh: it must be built again if
+ * the mesh is modified or destroyed.
+ */
+class DcelAABBTree
+{
+
+public:
+
+    /* Typedefs */
+
+    struct Triangle {
+        Pointd v1;
+        Pointd v2;
+        Pointd v3;
+    };
+
+    typedef StaticAABBTree<3, Triangle, const Dcel::Face*> Tree;
+    typedef Tree::BuildMethod BuildMethod;
+
+
+    /* Constructors */
+
+    DcelAABBTree();
+    DcelAABBTree(const Dcel& mesh, BuildMethod buildMethod = Tree::MEDIAN_SPLIT);
+
+
+    /* Public methods */
+
+    void construction(const Dcel& mesh, BuildMethod buildMethod = Tree::MEDIAN_SPLIT);
+
+    size_t numberTriangles() const;
+    bool empty() const;
+    void clear();
+
+    size_t getHeight() const;
+
+
+    /* Queries */
+
+    const Dcel::Face* closestPoint(
+            const Pointd& point,
+            Pointd& closest,
+            double& distance);
+
+    const Dcel::Face* rayIntersection(
+            const Pointd& origin,
+            const Pointd& direction,
+            double& t);
+
+    bool rayIntersects(
+            const Pointd& origin,
+            const Pointd& direction,
+            double maxT = std::numeric_limits<double>::max()) const;
+
+    bool isInside(const Pointd& point) const;
+
+
+    /* Triangle functions */
+
+    static double triangleValueExtractor(
+            const Triangle& triangle,
+            const AABBValueType& valueType,
+            const int& dim);
+
+    static bool triangleRayIntersection(
+            const Triangle& triangle,
+            const Tree::Point& origin,
+            const Tree::Point& direction,
+            double& t);
+
+    static double trianglePointDistance(
+            const Triangle& triangle,
+            const Tree::Point& point);
+
+    static Pointd triangleClosestPoint(
+            const Triangle& triangle,
+            const Pointd& point);
+
+
+protected:
+
+    /* Protected fields */
+
+    Tree tree;
+
+
+    /* Helpers */
+
+    static Tree::Point toTreePoint(const Pointd& point);
+
+    size_t rayCrossings(const Pointd& origin, const Pointd& direction) const;
+
+};
+
+}
+
+#endif // CG3_DCEL_AABBTREE_H
@@ -0,0 +1,34 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef CG3_PARALLEL_H
+#define CG3_PARALLEL_H
+
+#include <cstddef>
+
+namespace cg3 {
+
+inline unsigned int numberOfThreads(unsigned int nThreads = 0);
+
+template <class F>
+void parallelFor(size_t n, F f, unsigned int nThreads = 0);
+
+template <class F>
+void parallelForChunks(size_t n, size_t chunkSize, F f, unsigned int nThreads = 0);
+
+template <class F>
+void parallelForThreads(F f, unsigned int nThreads);
+
+template <class RandomAccessIterator, class Compare>
+void parallelSort(
+        RandomAccessIterator first,
+        RandomAccessIterator last,
+        Compare compare,
+        unsigned int nThreads = 0);
+
+}
+
+#include "parallel.tpp"
+
+#endif // CG3_PARALLEL_H
@@ -0,0 +1,178 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "parallel.h"
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Minimum number of elements sorted by each thread of parallelSort */
+static const size_t PARALLEL_SORT_MIN_BLOCK = 4096;
+
+}
+
+/**
+ * @brief Get the number of threads to be used
+ * @param nThreads Requested number of threads, 0 for the number
+ * of hardware threads
+ * @return Number of threads (at least 1)
+ */
+inline unsigned int numberOfThreads(unsigned int nThreads)
+{
+    if (nThreads == 0)
+        nThreads = std::thread::hardware_concurrency();
+    return std::max(nThreads, 1u);
+}
+
+/**
+ * @brief Execute f(i) for each i in [0, n) using nThreads threads.
+ * The indices are split in contiguous blocks, one for each thread.
+ * @param n Number of indices
+ * @param f Function to be executed for each index
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <class F>
+void parallelFor(size_t n, F f, unsigned int nThreads)
+{
+    nThreads = (unsigned int) std::min((size_t) numberOfThreads(nThreads), std::max(n, (size_t) 1));
+
+    if (nThreads == 1) {
+        for (size_t i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+
+    size_t blockSize = (n + nThreads - 1) / nThreads;
+
+    for (unsigned int t = 1; t < nThreads; t++) {
+        size_t begin = std::min(n, t * blockSize);
+        size_t end = std::min(n, begin + blockSize);
+        threads.push_back(std::thread([&f, begin, end] () {
+            for (size_t i = begin; i < end; i++)
+                f(i);
+        }));
+    }
+
+    for (size_t i = 0; i < std::min(n, blockSize); i++)
+        f(i);
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+/**
+ * @brief Execute f(threadIndex, chunkIndex, begin, end) for chunks of
+ * [0, n) of size chunkSize. The chunks are assigned dynamically to the
+ * threads, so uneven workloads are balanced. The thread index can be
+ * used to access per-thread buffers.
+ * @param n Number of indices
+ * @param chunkSize Number of indices for each chunk
+ * @param f Function to be executed for each chunk
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <class F>
+void parallelForChunks(size_t n, size_t chunkSize, F f, unsigned int nThreads)
+{
+    chunkSize = std::max(chunkSize, (size_t) 1);
+    size_t nChunks = (n + chunkSize - 1) / chunkSize;
+
+    nThreads = (unsigned int) std::min((size_t) numberOfThreads(nThreads), std::max(nChunks, (size_t) 1));
+
+    std::atomic<size_t> nextChunk(0);
+
+    parallelForThreads([&] (unsigned int threadIndex) {
+        size_t chunk;
+        while ((chunk = nextChunk.fetch_add(1)) < nChunks) {
+            size_t begin = chunk * chunkSize;
+            size_t end = std::min(n, begin + chunkSize);
+            f(threadIndex, chunk, begin, end);
+        }
+    }, nThreads);
+}
+
+/**
+ * @brief Execute f(threadIndex) on nThreads threads (the calling thread
+ * is used as thread 0) and wait for all of them.
+ * @param f Function to be executed
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <class F>
+void parallelForThreads(F f, unsigned int nThreads)
+{
+    nThreads = numberOfThreads(nThreads);
+
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+
+    for (unsigned int t = 1; t < nThreads; t++) {
+        threads.push_back(std::thread([&f, t] () {
+            f(t);
+        }));
+    }
+
+    f(0);
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+/**
+ * @brief Sort a range using nThreads threads: the range is split in one
+ * block for each thread, the blocks are sorted with std::sort and then
+ * merged in pairs (in parallel) with std::inplace_merge. The sort is not stable.
+ * @param first Begin of the range
+ * @param last End of the range
+ * @param compare Comparison function
+ * @param nThreads Number of threads, 0 for the number of hardware threads
+ */
+template <class RandomAccessIterator, class Compare>
+void parallelSort(
+        RandomAccessIterator first,
+        RandomAccessIterator last,
+        Compare compare,
+        unsigned int nThreads)
+{
+    size_t n = last - first;
+
+    nThreads = (unsigned int) std::min(
+                (size_t) numberOfThreads(nThreads),
+                std::max(n / internal::PARALLEL_SORT_MIN_BLOCK, (size_t) 1));
+
+    if (nThreads == 1) {
+        std::sort(first, last, compare);
+        return;
+    }
+
+    std::vector<size_t> bounds(nThreads + 1);
+    for (unsigned int t = 0; t <= nThreads; t++)
+        bounds[t] = n * t / nThreads;
+
+    parallelFor(nThreads, [&] (size_t t) {
+        std::sort(first + bounds[t], first + bounds[t + 1], compare);
+    }, nThreads);
+
+    for (size_t width = 1; width < nThreads; width *= 2) {
+        size_t nMerges = (nThreads + 2 * width - 1) / (2 * width);
+
+        parallelFor(nMerges, [&] (size_t m) {
+            size_t begin = m * 2 * width;
+            size_t middle = std::min(begin + width, (size_t) nThreads);
+            size_t end = std::min(begin + 2 * width, (size_t) nThreads);
+
+            if (middle < end)
+                std::inplace_merge(first + bounds[begin], first + bounds[middle], first + bounds[end], compare);
+        }, nThreads);
+    }
+}
+
+}
@@ -35,6 +35,10 @@
 #include "tests/graphtest.h"
 #endif
 
+#ifdef BIPARTITEGRAPHTEST
+#include "tests/bipartitegraphtest.h"
+#endif
+
 #ifdef BSTSAMPLE
 #include "samples/bstsample.h"
 #endif
@@ -116,6 +120,12 @@ int main(int argc, char *argv[]) {
     AABBTest::testRandom();
     AABBTest::testMixed();
     AABBTest::testProgressive();
+    AABBTest::testRayCast();
+    AABBTest::testNearest();
+    AABBTest::testBatchQuery();
+#ifdef CG3_DCEL_DEFINED
+    AABBTest::testDcel();
+#endif
 
     std::cout << std::endl << std::endl;
 #endif
@@ -144,6 +154,37 @@ int main(int argc, char *argv[]) {
 
     GraphTests::testCorrectness();
     GraphTests::testDijkstra();
+    GraphTests::testDijkstraQueues();
+    GraphTests::testAllPairsShortestPaths();
+    GraphTests::testShortestPath();
+    GraphTests::testIndexedGraph();
+    GraphTests::testIndexedGraphCompaction();
+    GraphTests::testTraversal();
+    GraphTests::testMinimumSpanningTree();
+    GraphTests::testGraphSerialization();
+    GraphTests::testGraphCopy();
+    GraphTests::testEdgeWeights();
+    GraphTests::testDynamicShortestPaths();
+    GraphTests::testEdgeIteration();
+    GraphTests::testGraphReordering();
+    GraphTests::testMaxFlow();
+
+    std::cout << std::endl << std::endl;
+#endif
+
+#ifdef BIPARTITEGRAPHTEST
+    std::cout << std::endl << std::endl <<
+                 "##########################################################################" <<
+                 " Bipartite graph test " <<
+                 "##########################################################################" <<
+                 std::endl << std::endl;
+
+    BipartiteGraphTests::testCorrectness();
+    BipartiteGraphTests::testIndexedBipartiteGraph();
+    BipartiteGraphTests::testBulkDeletion();
+    BipartiteGraphTests::testMaximumMatching();
+    BipartiteGraphTests::testAssignment();
+    BipartiteGraphTests::testProjection();
 
     std::cout << std::endl << std::endl;
 #endif
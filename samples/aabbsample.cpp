@@ -9,9 +9,12 @@
 #include <iostream>
 
 #include <set>
+#include <cmath>
 
 #include <cg3/data_structures/trees/aabbtree.h>
 
+#include "extensions/data_structures/trees/static_aabbtree.h"
+
 #include <cg3/geometry/2d/point2d.h>
 #include <cg3/geometry/segment.h>
 
@@ -26,6 +29,14 @@ double aabbValueExtractor(
         const int& dim);
 bool segment2DIntersectionChecker(const Segment2D& segment1, const Segment2D& segment2);
 bool segment2DCustomComparator(const Segment2D& o1, const Segment2D& o2);
+bool segment2DRayIntersector(
+        const Segment2D& segment,
+        const std::array<double, 2>& origin,
+        const std::array<double, 2>& direction,
+        double& t);
+double segment2DPointDistance(
+        const Segment2D& segment,
+        const std::array<double, 2>& point);
 
 
 void AABBSample::execute()
@@ -189,6 +200,66 @@ void AABBSample::execute()
 
 
     std::cout << std::endl;
+
+
+
+    /* ----- STATIC AABB TREE ----- */
+
+    //The static AABB tree cannot be modified after the construction,
+    //but it supports ray queries
+    typedef cg3::StaticAABBTree<2, Segment2D, std::string> StaticAABBTree;
+
+    std::cout << "Creating static AABB tree..." << std::endl;
+    segmentVec.push_back(std::make_pair(Segment2D(Point2D(-1,-5),Point2D(3,2)), "([-1,-5], [3,2])"));
+    segmentVec.push_back(std::make_pair(Segment2D(Point2D(1,2),Point2D(4,3)), "([1,2], [4,3])"));
+    segmentVec.push_back(std::make_pair(Segment2D(Point2D(4,3),Point2D(4,8)), "([4,3], [4,8])"));
+    StaticAABBTree staticTree(segmentVec, &aabbValueExtractor);
+
+    //Ray cast (closest hit) from (0,5) with direction (1,0)
+    StaticAABBTree::Point origin = {{0, 5}};
+    StaticAABBTree::Point direction = {{1, 0}};
+    double t;
+    std::cout << "Ray cast from (0,5) with direction (1,0) -> ";
+    StaticAABBTree::iterator hitIt = staticTree.rayCast(origin, direction, &segment2DRayIntersector, t);
+    if (hitIt != staticTree.end()) {
+        std::cout << *hitIt << " hit at t = " << t;
+    }
+    else {
+        std::cout << "No hits";
+    }
+    std::cout << std::endl;
+
+    //Segment cast (any hit) from (0,5) to (3,5): direction is (3,0), max t is 1
+    direction[0] = 3;
+    std::cout << "Segment cast from (0,5) to (3,5) -> ";
+    if (staticTree.rayCastAny(origin, direction, &segment2DRayIntersector, 1)) {
+        std::cout << "Found at least a hit";
+    }
+    else {
+        std::cout << "Found NO hits";
+    }
+    std::cout << std::endl;
+
+    //Nearest segment to the point (0,0)
+    StaticAABBTree::Point queryPoint = {{0, 0}};
+    double distance;
+    std::cout << "Nearest segment to (0,0) -> ";
+    StaticAABBTree::iterator nearestIt = staticTree.nearest(queryPoint, &segment2DPointDistance, distance);
+    if (nearestIt != staticTree.end()) {
+        std::cout << *nearestIt << " at distance " << distance;
+    }
+    std::cout << std::endl;
+
+    //The 3 nearest segments to the point (0,0), sorted by distance
+    std::cout << "3 nearest segments to (0,0) -> ";
+    std::vector<StaticAABBTree::iterator> nearestResults;
+    staticTree.kNearest(queryPoint, 3, &segment2DPointDistance, std::back_inserter(nearestResults));
+    for (StaticAABBTree::iterator& it : nearestResults) {
+        std::cout << *it << " | ";
+    }
+    std::cout << std::endl;
+
+    std::cout << std::endl;
 }
 
 
@@ -277,3 +348,54 @@ bool segment2DCustomComparator(const Segment2D& o1, const Segment2D& o2) {
         return false;
     return o1.p2() < o2.p2();
 }
+
+
+/*
+ * Returns true if the ray origin + t*direction (t >= 0) hits
+ * the segment, setting the parameter t of the hit point
+ */
+bool segment2DRayIntersector(
+        const Segment2D& segment,
+        const std::array<double, 2>& origin,
+        const std::array<double, 2>& direction,
+        double& t)
+{
+    double ex = segment.p2().x() - segment.p1().x();
+    double ey = segment.p2().y() - segment.p1().y();
+    double wx = segment.p1().x() - origin[0];
+    double wy = segment.p1().y() - origin[1];
+
+    double den = direction[0]*ey - direction[1]*ex;
+
+    /* The ray and the segment are parallel */
+    if (den == 0)
+        return false;
+
+    t = (wx*ey - wy*ex) / den;
+    double u = (wx*direction[1] - wy*direction[0]) / den;
+
+    return t >= 0 && u >= 0 && u <= 1;
+}
+
+
+/*
+ * Euclidean distance between a segment and a point
+ */
+double segment2DPointDistance(
+        const Segment2D& segment,
+        const std::array<double, 2>& point)
+{
+    double ex = segment.p2().x() - segment.p1().x();
+    double ey = segment.p2().y() - segment.p1().y();
+    double wx = point[0] - segment.p1().x();
+    double wy = point[1] - segment.p1().y();
+
+    double length = ex*ex + ey*ey;
+    double u = (length == 0) ? 0 : (wx*ex + wy*ey) / length;
+    u = std::max(0.0, std::min(1.0, u));
+
+    double dx = wx - u*ex;
+    double dy = wy - u*ey;
+
+    return std::sqrt(dx*dx + dy*dy);
+}
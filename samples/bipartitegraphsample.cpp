@@ -4,6 +4,9 @@
 
 #include <cg3/data_structures/graphs/bipartite_graph.h>
 
+#include "extensions/data_structures/graphs/indexed_bipartite_graph.h"
+#include "extensions/algorithms/bipartite_projection.h"
+
 void BipartiteGraphSample::execute() {
 
     //this bipartite graph connects strings to integers
@@ -63,4 +66,63 @@ void BipartiteGraphSample::execute() {
 
     bigraph.addArc("4", 22); //no arcs are added here
 
+
+    //The indexed bipartite graph identifies the nodes by ids: the values
+    //are looked up only to find the ids
+    typedef cg3::IndexedBipartiteGraph<std::string, int> IndexedBipartiteGraph;
+
+    IndexedBipartiteGraph indexedBigraph(bigraph);
+
+    IndexedBipartiteGraph::LeftId u3;
+    if (indexedBigraph.tryFindLeftNode("3", u3)) {
+        std::cout << "\nMultiples of 3 (indexed graph): \n";
+        for (IndexedBipartiteGraph::RightId v : indexedBigraph.adjacentRightNodes(u3)){
+            std::cout << "\t" << std::to_string(indexedBigraph.rightValue(v)) << "\n";
+        }
+    }
+
+    //Missing nodes are reported without exceptions
+    IndexedBipartiteGraph::RightId v22;
+    if (!indexedBigraph.tryFindRightNode(22, v22)) {
+        std::cout << "\n22 not found in the indexed graph.\n";
+    }
+
+    //Arcs are added by ids, and they are merged in the arrays of the
+    //graph at the first query
+    IndexedBipartiteGraph::LeftId u6 = indexedBigraph.addLeftNode("6");
+    IndexedBipartiteGraph::RightId v18 = indexedBigraph.addRightNode(18);
+    IndexedBipartiteGraph::RightId v12, v24;
+    indexedBigraph.tryFindRightNode(12, v12);
+    indexedBigraph.tryFindRightNode(24, v24);
+    indexedBigraph.addArcs({{u3, v18}, {u6, v12}, {u6, v18}, {u6, v24}});
+
+    std::cout << "\nDivisors of 18 (indexed graph): \n";
+    for (IndexedBipartiteGraph::LeftId u : indexedBigraph.adjacentLeftNodes(v18)){
+        std::cout << "\t" << indexedBigraph.leftValue(u) << "\n";
+    }
+
+    //Two-hop query: the divisors which share a multiple with 3
+    cg3::TwoHopQuery<std::string, int> twoHop(indexedBigraph);
+    std::vector<IndexedBipartiteGraph::LeftId> neighbors;
+    twoHop.leftNeighbors(u3, neighbors);
+
+    std::cout << "\nDivisors sharing a multiple with 3 (indexed graph): \n";
+    for (IndexedBipartiteGraph::LeftId u : neighbors){
+        std::cout << "\t" << indexedBigraph.leftValue(u) << "\n";
+    }
+
+    //Projection on the divisors: the weight of each edge is the number
+    //of common multiples
+    cg3::Graph<std::string> projection = cg3::leftProjection(bigraph);
+    std::cout << "\nCommon multiples of 2 and 5: " << projection.getWeight("2", "5") << "\n";
+
+    //Deleted nodes are left as tombstones in the adjacency of their
+    //neighbors, which are purged together at the next query
+    indexedBigraph.deleteLeftNodes({u3, u6});
+
+    std::cout << "\nDivisors of 24 after deleting 3 and 6 (indexed graph): \n";
+    for (IndexedBipartiteGraph::LeftId u : indexedBigraph.adjacentLeftNodes(v24)){
+        std::cout << "\t" << indexedBigraph.leftValue(u) << "\n";
+    }
+
 }
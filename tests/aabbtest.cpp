@@ -5,6 +5,7 @@
  * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
  */
 #include "aabbtest.h"
+#include "testdata.h"
 
 #include <iostream>
 #include <random>
@@ -12,13 +13,26 @@
 #include <iomanip>
 
 #include <set>
+#include <array>
+#include <string>
 #include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <thread>
 
 #include "cg3/geometry/2d/point2d.h"
 #include "cg3/geometry/segment.h"
 
 #include "cg3/data_structures/trees/aabbtree.h"
 
+#include "extensions/data_structures/trees/static_aabbtree.h"
+
+#ifdef CG3_DCEL_DEFINED
+#include <cg3/meshes/dcel/dcel.h>
+#include "extensions/meshes/dcel/dcel_aabbtree.h"
+#endif
+
 #include <cg3/cg3lib.h>
 #include <cg3/utilities/timer.h>
 
@@ -31,6 +45,12 @@
 #define QUERY_RANDOM_DIV 10
 #define ONLYEFFICIENT (INPUTSIZE > 10000)
 
+#define RAYQUERIES 10000
+#define NEARESTQUERIES 10000
+#define KNEAREST 10
+#define BATCHQUERIES 100000
+#define DCELQUERIES 1000
+
 namespace AABBTest {
 
 /* ----- TYPEDEFS ----- */
@@ -40,6 +60,10 @@ typedef cg3::Point2D<int> Point2D;
 typedef cg3::Segment<Point2D> Segment2D;
 
 template <int D, class T> using AABBTree = typename cg3::AABBTree<D,T>;
+template <int D, class T> using StaticAABBTree = typename cg3::StaticAABBTree<D,T>;
+
+typedef StaticAABBTree<2, Segment2D>::Point RayPoint;
+typedef StaticAABBTree<3, std::array<double,3>>::Point Point3D;
 
 typedef cg3::AABBValueType AABBValueType;
 
@@ -58,6 +82,20 @@ double aabbValueExtractor(const Segment2D& segment, const AABBValueType& valueTy
 bool segmentIntersection(const Segment1D& segment1, const Segment1D& segment2);
 bool segmentIntersection(const Segment2D& segment1, const Segment2D& segment2);
 
+bool segmentRayIntersection(const Segment2D& segment, const RayPoint& origin, const RayPoint& direction, double& t);
+void segmentToRay(const Segment2D& segment, RayPoint& origin, RayPoint& direction);
+double segmentPointDistance(const Segment2D& segment, const RayPoint& point);
+
+/*
+ * Bounding box of a 3D point
+ */
+double aabbValueExtractor(const Point3D& point, const AABBValueType& valueType, const int& dim);
+
+/*
+ * Euclidean distance between two 3D points
+ */
+double pointDistance(const Point3D& point1, const Point3D& point2);
+
 
 void doTestsOnInput(std::vector<int>& testNumbers, std::vector<int>& randomNumbers);
 
@@ -67,6 +105,30 @@ void testAABBTree1D(std::vector<Segment1D>& testSegments, std::vector<Segment1D>
 void testBrute2D(std::vector<Segment2D>& testSegments, std::vector<Segment2D>& randomSegments);
 void testAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<Segment2D>& randomSegment);
 
+void printBuildHeader();
+template <int D, class S>
+void testBuildAABBTree(std::vector<S>& testSegments, std::vector<S>& randomSegments);
+template <int D, class S>
+void testBuildStaticAABBTree(
+        std::vector<S>& testSegments,
+        std::vector<S>& randomSegments,
+        typename StaticAABBTree<D,S>::BuildMethod buildMethod);
+
+void printRayHeader();
+void testRayAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<Segment2D>& querySegments);
+void testRayStaticAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<Segment2D>& querySegments);
+
+void printBatchHeader();
+
+#ifdef CG3_DCEL_DEFINED
+void printDcelHeader();
+void testDcelMesh(const std::string& name, const std::string& fileName);
+#endif
+
+void printNearestHeader();
+void testNearestBrute2D(std::vector<Segment2D>& testSegments, std::vector<RayPoint>& queryPoints);
+void testNearestStaticAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<RayPoint>& queryPoints);
+
 
 /* ----- IMPLEMENTATION ----- */
 
@@ -94,6 +156,93 @@ void testCorrectness() {
                 std::move(
                     AABBTree<2, Segment2D>(vec, &aabbValueExtractor)));
     tree3.clear();
+
+
+    //Static tree: ray cast
+    StaticAABBTree<2, Segment2D> staticTree(vec, &aabbValueExtractor);
+    assert(staticTree.size() == vec.size());
+
+    RayPoint origin, direction;
+    double t;
+
+    //Vertical ray which hits the first segment in (1,2)
+    origin[0] = 1; origin[1] = -10;
+    direction[0] = 0; direction[1] = 1;
+    StaticAABBTree<2, Segment2D>::iterator hitIt =
+            staticTree.rayCast(origin, direction, &segmentRayIntersection, t);
+    assert(hitIt != staticTree.end());
+    assert(*hitIt == Segment2D(Point2D(0,1), Point2D(2,3)));
+    assert(t == 12);
+    CG3_SUPPRESS_WARNING(hitIt);
+    assert(staticTree.rayCastAny(origin, direction, &segmentRayIntersection));
+
+    //Same ray as a segment cast which stops before the first segment
+    direction[0] = 0; direction[1] = 5;
+    assert(staticTree.rayCast(origin, direction, &segmentRayIntersection, t, 1) == staticTree.end());
+    assert(!staticTree.rayCastAny(origin, direction, &segmentRayIntersection, 1));
+
+    //Ray pointing away from the segments
+    direction[0] = 0; direction[1] = -1;
+    assert(staticTree.rayCast(origin, direction, &segmentRayIntersection, t) == staticTree.end());
+    assert(!staticTree.rayCastAny(origin, direction, &segmentRayIntersection));
+
+    //Nearest segment to (5,5) is ([4,5], [6,7]) at distance sqrt(0.5)
+    RayPoint queryPoint = {{5, 5}};
+    double distance;
+    hitIt = staticTree.nearest(queryPoint, &segmentPointDistance, distance);
+    assert(hitIt != staticTree.end());
+    assert(*hitIt == Segment2D(Point2D(4,5), Point2D(6,7)));
+    assert(std::abs(distance - std::sqrt(0.5)) < 1e-9);
+
+    //Three nearest segments to (5,5)
+    std::vector<StaticAABBTree<2, Segment2D>::iterator> nearestResults;
+    staticTree.kNearest(queryPoint, 3, &segmentPointDistance, std::back_inserter(nearestResults));
+    assert(nearestResults.size() == 3);
+    assert(*nearestResults[0] == Segment2D(Point2D(4,5), Point2D(6,7)));
+    assert(*nearestResults[1] == Segment2D(Point2D(0,1), Point2D(2,3)));
+    assert(*nearestResults[2] == Segment2D(Point2D(8,9), Point2D(10,11)));
+
+    //LBVH construction gives the same results
+    StaticAABBTree<2, Segment2D> lbvhTree(vec, &aabbValueExtractor, StaticAABBTree<2, Segment2D>::LBVH);
+    assert(lbvhTree.size() == vec.size());
+    direction[0] = 0; direction[1] = 1;
+    hitIt = lbvhTree.rayCast(origin, direction, &segmentRayIntersection, t);
+    assert(hitIt != lbvhTree.end());
+    assert(*hitIt == Segment2D(Point2D(0,1), Point2D(2,3)));
+    assert(t == 12);
+    hitIt = lbvhTree.nearest(queryPoint, &segmentPointDistance, distance);
+    assert(hitIt != lbvhTree.end());
+    assert(*hitIt == Segment2D(Point2D(4,5), Point2D(6,7)));
+
+    //LBVH in 3D (with duplicated points), nearest compared with brute force
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> coordinateDistribution(-100, 100);
+    std::vector<Point3D> points;
+    for (int i = 0; i < 5000; i++) {
+        Point3D point = {{coordinateDistribution(rng), coordinateDistribution(rng), coordinateDistribution(rng)}};
+        points.push_back(point);
+        if (i % 10 == 0)
+            points.push_back(point);
+    }
+
+    StaticAABBTree<3, Point3D> lbvhTree3D(points, &aabbValueExtractor, StaticAABBTree<3, Point3D>::LBVH);
+    assert(lbvhTree3D.size() == points.size());
+    for (int i = 0; i < 100; i++) {
+        Point3D query = {{coordinateDistribution(rng), coordinateDistribution(rng), coordinateDistribution(rng)}};
+
+        double bruteDistance = std::numeric_limits<double>::max();
+        for (const Point3D& point : points)
+            bruteDistance = std::min(bruteDistance, pointDistance(point, query));
+
+        assert(lbvhTree3D.nearest(query, &pointDistance, distance) != lbvhTree3D.end());
+        assert(distance == bruteDistance);
+        CG3_SUPPRESS_WARNING(bruteDistance);
+    }
+
+    staticTree.clear();
+    assert(staticTree.empty());
+    assert(staticTree.nearest(queryPoint, &segmentPointDistance, distance) == staticTree.end());
+    assert(staticTree.rayCast(origin, direction, &segmentRayIntersection, t) == staticTree.end());
 }
 
 void testRandom() {
@@ -194,6 +343,58 @@ void testProgressive() {
 }
 
 
+void testRayCast() {
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distIn(0,RANDOM_MAX*2);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distLength(0,MAXLENGTH*2);
+
+    std::vector<Segment2D> testSegments;
+    std::vector<Segment2D> querySegments;
+
+    //Random segments with maximum length
+    for (int i = 0; i < INPUTSIZE; i++) {
+        Point2D p1(distIn(rng)-RANDOM_MAX, distIn(rng)-RANDOM_MAX);
+        Point2D p2(p1.x() + distLength(rng) - MAXLENGTH, p1.y() + distLength(rng) - MAXLENGTH);
+        testSegments.push_back(Segment2D(p1,p2));
+    }
+
+    //Random query segments (segment casts) of any length
+    for (int i = 0; i < RAYQUERIES; i++) {
+        Point2D p1(distIn(rng)-RANDOM_MAX, distIn(rng)-RANDOM_MAX);
+        Point2D p2((distIn(rng)-RANDOM_MAX)/QUERY_RANDOM_DIV, (distIn(rng)-RANDOM_MAX)/QUERY_RANDOM_DIV);
+        querySegments.push_back(Segment2D(p1,p2));
+    }
+
+    std::cout << std::endl << " ------ RAY CAST ------ " << std::endl << std::endl;
+
+    printRayHeader();
+
+    for (int t = 0; t < ITERATION; t++) {
+        std::cout << std::setw(INDENTSPACE) << std::left;
+        std::cout << "AABB2D";
+        testRayAABBTree2D(testSegments, querySegments);
+    }
+    if (ITERATION > 1) {
+        std::cout << std::endl;
+    }
+
+    for (int t = 0; t < ITERATION; t++) {
+        std::cout << std::setw(INDENTSPACE) << std::left;
+        std::cout << "STATIC2D";
+        testRayStaticAABBTree2D(testSegments, querySegments);
+    }
+    if (ITERATION > 1) {
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+
 
 /* ----- FUNCTION IMPLEMENTATION ----- */
 
@@ -315,6 +516,263 @@ bool segmentIntersection(const Segment2D &segment1, const Segment2D &segment2) {
 }
 
 
+void testNearest() {
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distIn(0,RANDOM_MAX*2);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distLength(0,MAXLENGTH*2);
+
+    std::vector<Segment2D> testSegments;
+    std::vector<RayPoint> queryPoints;
+
+    //Random segments with maximum length
+    for (int i = 0; i < INPUTSIZE; i++) {
+        Point2D p1(distIn(rng)-RANDOM_MAX, distIn(rng)-RANDOM_MAX);
+        Point2D p2(p1.x() + distLength(rng) - MAXLENGTH, p1.y() + distLength(rng) - MAXLENGTH);
+        testSegments.push_back(Segment2D(p1,p2));
+    }
+
+    //Random query points
+    for (int i = 0; i < NEARESTQUERIES; i++) {
+        RayPoint point;
+        point[0] = (double) distIn(rng) - RANDOM_MAX;
+        point[1] = (double) distIn(rng) - RANDOM_MAX;
+        queryPoints.push_back(point);
+    }
+
+    std::cout << std::endl << " ------ NEAREST ------ " << std::endl << std::endl;
+
+    printNearestHeader();
+
+    if (!ONLYEFFICIENT) {
+        for (int t = 0; t < ITERATION; t++) {
+            std::cout << std::setw(INDENTSPACE) << std::left;
+            std::cout << "BRUTE2D";
+            testNearestBrute2D(testSegments, queryPoints);
+        }
+        if (ITERATION > 1) {
+            std::cout << std::endl;
+        }
+    }
+
+    for (int t = 0; t < ITERATION; t++) {
+        std::cout << std::setw(INDENTSPACE) << std::left;
+        std::cout << "STATIC2D";
+        testNearestStaticAABBTree2D(testSegments, queryPoints);
+    }
+    if (ITERATION > 1) {
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+
+void testBatchQuery() {
+    typedef StaticAABBTree<2,Segment2D>::iterator Iterator;
+    typedef StaticAABBTree<2,Segment2D>::OverlapQueryResult OverlapQueryResult;
+
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distIn(0,RANDOM_MAX*2);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distLength(0,MAXLENGTH*2);
+
+    std::vector<Segment2D> testSegments;
+    std::vector<Segment2D> querySegments;
+
+    //Random segments with maximum length
+    for (int i = 0; i < INPUTSIZE; i++) {
+        Point2D p1(distIn(rng)-RANDOM_MAX, distIn(rng)-RANDOM_MAX);
+        Point2D p2(p1.x() + distLength(rng) - MAXLENGTH, p1.y() + distLength(rng) - MAXLENGTH);
+        testSegments.push_back(Segment2D(p1,p2));
+    }
+    for (int i = 0; i < BATCHQUERIES; i++) {
+        Point2D p1(distIn(rng)-RANDOM_MAX, distIn(rng)-RANDOM_MAX);
+        Point2D p2(p1.x() + distLength(rng) - MAXLENGTH, p1.y() + distLength(rng) - MAXLENGTH);
+        querySegments.push_back(Segment2D(p1,p2));
+    }
+
+    StaticAABBTree<2, Segment2D> tree(testSegments, &aabbValueExtractor);
+
+    std::cout << std::endl << " ------ BATCH OVERLAP QUERIES ------ " << std::endl << std::endl;
+
+    printBatchHeader();
+
+    cg3::Timer timer("Step");
+
+
+    /* One query at a time */
+
+    timer.start();
+
+    size_t foundLoop = 0;
+    for (const Segment2D& segment : querySegments) {
+        std::vector<Iterator> out;
+
+        tree.aabbOverlapQuery(segment, std::back_inserter(out));
+        foundLoop += out.size();
+    }
+
+    timer.stop();
+
+    double loopTime = timer.delay();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << "LOOP";
+    std::cout << std::setw(INDENTSPACE) << std::left << 1;
+    std::cout << std::setw(INDENTSPACE) << std::left << loopTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << (size_t) (querySegments.size() / loopTime);
+    std::cout << std::setw(INDENTSPACE) << std::left << foundLoop;
+    std::cout << std::setw(INDENTSPACE) << std::left << 1.0;
+    std::cout << std::endl;
+
+
+    /* Batched queries */
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        OverlapQueryResult result;
+
+        timer.start();
+
+        tree.aabbOverlapQuery(querySegments.begin(), querySegments.end(), result, nullptr, nThreads);
+
+        timer.stop();
+
+        size_t foundBatch = result.indices.size();
+
+        assert(result.offsets.size() == querySegments.size() + 1);
+        assert(foundBatch == foundLoop);
+
+        std::cout << std::setw(INDENTSPACE) << std::left << "BATCH";
+        std::cout << std::setw(INDENTSPACE) << std::left << nThreads;
+        std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+        std::cout << std::setw(INDENTSPACE) << std::left << (size_t) (querySegments.size() / timer.delay());
+        std::cout << std::setw(INDENTSPACE) << std::left << foundBatch;
+        std::cout << std::setw(INDENTSPACE) << std::left << loopTime / timer.delay();
+        std::cout << std::endl;
+
+        /* Check results of some queries */
+        for (size_t i = 0; i < querySegments.size(); i += querySegments.size() / 100 + 1) {
+            std::vector<Iterator> out;
+            tree.aabbOverlapQuery(querySegments[i], std::back_inserter(out));
+
+            assert(out.size() == result.offsets[i+1] - result.offsets[i]);
+            for (size_t j = result.offsets[i]; j < result.offsets[i+1]; j++) {
+                CG3_SUPPRESS_WARNING(j);
+                assert(std::find(out.begin(), out.end(), tree.begin() + result.indices[j]) != out.end());
+            }
+        }
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+    std::cout << std::endl;
+}
+
+
+#ifdef CG3_DCEL_DEFINED
+void testDcel() {
+    std::cout << std::endl << " ------ DCEL AABB TREE ------ " << std::endl << std::endl;
+
+    printDcelHeader();
+
+    testDcelMesh("BUNNY", "bunny.obj");
+    testDcelMesh("AIRPLANE", "airplane.obj");
+    testDcelMesh("BIMBA", "bimba.obj");
+
+    std::cout << std::endl;
+}
+#endif
+
+
+/*
+ * Intersection between a segment and a ray origin + t*direction
+ */
+bool segmentRayIntersection(const Segment2D& segment, const RayPoint& origin, const RayPoint& direction, double& t) {
+    double ex = segment.p2().x() - segment.p1().x();
+    double ey = segment.p2().y() - segment.p1().y();
+    double wx = segment.p1().x() - origin[0];
+    double wy = segment.p1().y() - origin[1];
+
+    double den = direction[0]*ey - direction[1]*ex;
+
+    /* The ray and the segment are parallel */
+    if (den == 0) {
+        double dd = direction[0]*direction[0] + direction[1]*direction[1];
+
+        /* Not collinear */
+        if (dd == 0 || wx*direction[1] - wy*direction[0] != 0)
+            return false;
+
+        double t1 = (wx*direction[0] + wy*direction[1]) / dd;
+        double t2 = ((wx+ex)*direction[0] + (wy+ey)*direction[1]) / dd;
+        if (t1 > t2)
+            std::swap(t1, t2);
+
+        if (t2 < 0)
+            return false;
+
+        t = std::max(t1, 0.0);
+        return true;
+    }
+
+    t = (wx*ey - wy*ex) / den;
+    double u = (wx*direction[1] - wy*direction[0]) / den;
+
+    return t >= 0 && u >= 0 && u <= 1;
+}
+
+/*
+ * Origin and direction of a segment cast (maximum t is 1)
+ */
+void segmentToRay(const Segment2D& segment, RayPoint& origin, RayPoint& direction) {
+    origin[0] = segment.p1().x();
+    origin[1] = segment.p1().y();
+    direction[0] = segment.p2().x() - segment.p1().x();
+    direction[1] = segment.p2().y() - segment.p1().y();
+}
+
+
+/*
+ * Euclidean distance between a segment and a point
+ */
+double segmentPointDistance(const Segment2D& segment, const RayPoint& point) {
+    double ex = segment.p2().x() - segment.p1().x();
+    double ey = segment.p2().y() - segment.p1().y();
+    double wx = point[0] - segment.p1().x();
+    double wy = point[1] - segment.p1().y();
+
+    double length = ex*ex + ey*ey;
+    double u = (length == 0) ? 0 : (wx*ex + wy*ey) / length;
+    u = std::max(0.0, std::min(1.0, u));
+
+    double dx = wx - u*ex;
+    double dy = wy - u*ey;
+
+    return std::sqrt(dx*dx + dy*dy);
+}
+
+double aabbValueExtractor(const Point3D& point, const AABBValueType& valueType, const int& dim) {
+    CG3_SUPPRESS_WARNING(valueType);
+    return point[dim-1];
+}
+
+double pointDistance(const Point3D& point1, const Point3D& point2) {
+    double dx = point1[0] - point2[0];
+    double dy = point1[1] - point2[1];
+    double dz = point1[2] - point2[2];
+    return std::sqrt(dx*dx + dy*dy + dz*dz);
+}
+
+
 
 
 void printHeader() {
@@ -462,6 +920,37 @@ void doTestsOnInput(std::vector<int> &testNumbers, std::vector<int> &randomNumbe
     }
 
 
+    std::cout << std::endl;
+
+    printBuildHeader();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "AABB1D";
+    testBuildAABBTree<1>(testSegment1D, randomSegment1D);
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "STATIC1D";
+    testBuildStaticAABBTree<1>(testSegment1D, randomSegment1D, StaticAABBTree<1, Segment1D>::MEDIAN_SPLIT);
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "LBVH1D";
+    testBuildStaticAABBTree<1>(testSegment1D, randomSegment1D, StaticAABBTree<1, Segment1D>::LBVH);
+
+    std::cout << std::endl;
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "AABB2D";
+    testBuildAABBTree<2>(testSegment2D, randomSegment2D);
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "STATIC2D";
+    testBuildStaticAABBTree<2>(testSegment2D, randomSegment2D, StaticAABBTree<2, Segment2D>::MEDIAN_SPLIT);
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "LBVH2D";
+    testBuildStaticAABBTree<2>(testSegment2D, randomSegment2D, StaticAABBTree<2, Segment2D>::LBVH);
+
+
     testSegment1D.clear();
     randomSegment1D.clear();
 
@@ -474,10 +963,26 @@ void doTestsOnInput(std::vector<int> &testNumbers, std::vector<int> &randomNumbe
 
 
 
-void testBrute1D(std::vector<Segment1D>& testSegments, std::vector<Segment1D>& randomSegments) {
+void printBuildHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "STRUCTURE" <<
+         std::setw(INDENTSPACE) << std::left << "CONSTR." <<
+         std::setw(INDENTSPACE) << std::left << "(NUM)" <<
+         std::setw(INDENTSPACE) << std::left << "(HEIGHT)" <<
+         std::setw(INDENTSPACE) << std::left << "OVQUERY" <<
+         std::setw(INDENTSPACE) << std::left << "FOUND" <<
+         std::setw(INDENTSPACE) << std::left << "TOTAL" <<
+         std::endl << std::endl;
+}
 
-    typedef std::set<Segment1D>::iterator Iterator;
+/**
+ * @brief Construction and overlap queries of the dynamic tree, to be
+ * compared with the static trees
+ */
+template <int D, class S>
+void testBuildAABBTree(std::vector<S>& testSegments, std::vector<S>& randomSegments) {
 
+    typedef typename AABBTree<D,S>::iterator Iterator;
 
     cg3::Timer totalTimer("Total");
     cg3::Timer timer("Step");
@@ -489,80 +994,209 @@ void testBrute1D(std::vector<Segment1D>& testSegments, std::vector<Segment1D>& r
 
     timer.start();
 
-    std::set<Segment1D>* set = new std::set<Segment1D>(testSegments.begin(), testSegments.end());
+    AABBTree<D,S> tree(testSegments, &aabbValueExtractor);
 
     timer.stop();
 
-
     std::cout << std::setw(INDENTSPACE) << std::left;
     std::cout << timer.delay();
 
 
-
-
     /* Number of elements */
 
-    size_t numOfEntriesConstruction = set->size();
     std::cout << std::setw(INDENTSPACE) << std::left;
-    std::cout << numOfEntriesConstruction;
+    std::cout << tree.size();
     std::cout << std::setw(INDENTSPACE) << std::left;
-    std::cout << "?";
-
+    std::cout << tree.getHeight();
 
 
-    /* Query (construction) */
+    /* Overlap query */
 
     timer.start();
 
-    size_t foundConstruction = 0;
-
-    for (const Segment1D& segment : testSegments) {
-        Iterator it = set->find(segment);
-        bool found = (it != set->end());
-
-        if (found)
-            foundConstruction++;
-
-        assert(found);
-    }
-
-    for (const Segment1D& segment : randomSegments) {
-        Iterator it = set->find(segment);
-        if (it != set->end()) {
-            foundConstruction++;
-        }
+    size_t foundOverlap = 0;
+    for (const S& segment : randomSegments) {
+        std::vector<Iterator> out;
+        tree.aabbOverlapQuery(segment, std::back_inserter(out));
+        foundOverlap += out.size();
     }
 
     timer.stop();
 
     std::cout << std::setw(INDENTSPACE) << std::left;
     std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << foundOverlap;
 
 
-    /* Number of results */
+    totalTimer.stop();
 
     std::cout << std::setw(INDENTSPACE) << std::left;
-    std::cout << foundConstruction;
+    std::cout << totalTimer.delay();
 
+    std::cout << std::endl;
+}
 
+/**
+ * @brief Construction and overlap queries of the static tree with the
+ * given construction algorithm
+ */
+template <int D, class S>
+void testBuildStaticAABBTree(
+        std::vector<S>& testSegments,
+        std::vector<S>& randomSegments,
+        typename StaticAABBTree<D,S>::BuildMethod buildMethod) {
 
-    /* Overlap query (construction) */
+    typedef typename StaticAABBTree<D,S>::iterator Iterator;
 
-    timer.start();
+    cg3::Timer totalTimer("Total");
+    cg3::Timer timer("Step");
 
-    for (const Segment1D& segment : testSegments) {
-        std::vector<Segment1D> out;
+    totalTimer.start();
 
-        for (const Segment1D& setSegment : *set) {
-            if (aabbOverlap(segment, setSegment)) {
-                out.push_back(setSegment);
-            }
-        }
 
-        assert(out.size() >= 1);
-    }
+    /* Construction */
 
-    size_t foundOverlapConstruction = 0;
+    timer.start();
+
+    StaticAABBTree<D,S> tree(testSegments, &aabbValueExtractor, buildMethod);
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+
+
+    /* Number of elements */
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << tree.size();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << tree.getHeight();
+
+
+    /* Overlap query */
+
+    timer.start();
+
+    size_t foundOverlap = 0;
+    for (const S& segment : randomSegments) {
+        std::vector<Iterator> out;
+        tree.aabbOverlapQuery(segment, std::back_inserter(out));
+        foundOverlap += out.size();
+
+        for (Iterator outIt : out) {
+            CG3_SUPPRESS_WARNING(outIt);
+            assert(aabbOverlap(*outIt, segment));
+        }
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << foundOverlap;
+
+
+    totalTimer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalTimer.delay();
+
+    std::cout << std::endl;
+}
+
+
+void testBrute1D(std::vector<Segment1D>& testSegments, std::vector<Segment1D>& randomSegments) {
+
+    typedef std::set<Segment1D>::iterator Iterator;
+
+
+    cg3::Timer totalTimer("Total");
+    cg3::Timer timer("Step");
+
+    totalTimer.start();
+
+
+    /* Construction */
+
+    timer.start();
+
+    std::set<Segment1D>* set = new std::set<Segment1D>(testSegments.begin(), testSegments.end());
+
+    timer.stop();
+
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+
+
+
+
+    /* Number of elements */
+
+    size_t numOfEntriesConstruction = set->size();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << numOfEntriesConstruction;
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "?";
+
+
+
+    /* Query (construction) */
+
+    timer.start();
+
+    size_t foundConstruction = 0;
+
+    for (const Segment1D& segment : testSegments) {
+        Iterator it = set->find(segment);
+        bool found = (it != set->end());
+
+        if (found)
+            foundConstruction++;
+
+        assert(found);
+    }
+
+    for (const Segment1D& segment : randomSegments) {
+        Iterator it = set->find(segment);
+        if (it != set->end()) {
+            foundConstruction++;
+        }
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+
+
+    /* Number of results */
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << foundConstruction;
+
+
+
+    /* Overlap query (construction) */
+
+    timer.start();
+
+    for (const Segment1D& segment : testSegments) {
+        std::vector<Segment1D> out;
+
+        for (const Segment1D& setSegment : *set) {
+            if (aabbOverlap(segment, setSegment)) {
+                out.push_back(setSegment);
+            }
+        }
+
+        assert(out.size() >= 1);
+    }
+
+    size_t foundOverlapConstruction = 0;
     for (size_t i = 0; i < randomSegments.size()-1; i++) {
         Segment1D& segment = randomSegments.at(i);
         std::vector<Segment1D> out;
@@ -2036,4 +2670,663 @@ void testAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<Segment2D>
 
 
 
+void printRayHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "STRUCTURE" <<
+         std::setw(INDENTSPACE) << std::left << "CONSTR." <<
+         std::setw(INDENTSPACE) << std::left << "(NUM)" <<
+         std::setw(INDENTSPACE) << std::left << "(HEIGHT)" <<
+         std::setw(INDENTSPACE) << std::left << "RAYCAST" <<
+         std::setw(INDENTSPACE) << std::left << "FOUND" <<
+         std::setw(INDENTSPACE) << std::left << "ANYHIT" <<
+         std::setw(INDENTSPACE) << std::left << "FOUND" <<
+         std::setw(INDENTSPACE) << std::left << "TOTAL" <<
+         std::endl << std::endl;
+}
+
+
+/*
+ * Ray cast with the dynamic AABB tree: overlap query on the bounding
+ * box of the segment cast, then the hits are sorted by t.
+ */
+void testRayAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<Segment2D>& querySegments) {
+
+    typedef AABBTree<2,Segment2D>::iterator Iterator;
+
+    cg3::Timer totalTimer("Total");
+    cg3::Timer timer("Step");
+
+    totalTimer.start();
+
+
+    /* Construction */
+
+    timer.start();
+
+    AABBTree<2, Segment2D> tree(testSegments, &aabbValueExtractor);
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+
+
+    /* Number of elements */
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << tree.size();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << tree.getHeight();
+
+
+    /* Ray cast (closest hit) */
+
+    timer.start();
+
+    size_t foundRayCast = 0;
+
+    for (const Segment2D& querySegment : querySegments) {
+        RayPoint origin, direction;
+        segmentToRay(querySegment, origin, direction);
+
+        std::vector<Iterator> out;
+        tree.aabbOverlapQuery(querySegment, std::back_inserter(out));
+
+        std::vector<double> hits;
+        for (Iterator it : out) {
+            double t;
+            if (segmentRayIntersection(*it, origin, direction, t) && t <= 1) {
+                hits.push_back(t);
+            }
+        }
+        std::sort(hits.begin(), hits.end());
+
+        if (!hits.empty())
+            foundRayCast++;
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << foundRayCast;
+
+
+    /* Ray cast (any hit) */
+
+    timer.start();
+
+    size_t foundAnyHit = 0;
+
+    for (const Segment2D& querySegment : querySegments) {
+        RayPoint origin, direction;
+        segmentToRay(querySegment, origin, direction);
+
+        std::vector<Iterator> out;
+        tree.aabbOverlapQuery(querySegment, std::back_inserter(out));
+
+        for (Iterator it : out) {
+            double t;
+            if (segmentRayIntersection(*it, origin, direction, t) && t <= 1) {
+                foundAnyHit++;
+                break;
+            }
+        }
+    }
+
+    timer.stop();
+
+    assert(foundAnyHit == foundRayCast);
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << foundAnyHit;
+
+
+    /* Total */
+
+    totalTimer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalTimer.delay();
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Ray cast with the static AABB tree (front-to-back traversal)
+ */
+void testRayStaticAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<Segment2D>& querySegments) {
+
+    typedef StaticAABBTree<2,Segment2D>::iterator Iterator;
+
+    cg3::Timer totalTimer("Total");
+    cg3::Timer timer("Step");
+
+    totalTimer.start();
+
+
+    /* Construction */
+
+    timer.start();
+
+    StaticAABBTree<2, Segment2D> tree(testSegments, &aabbValueExtractor);
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+
+
+    /* Number of elements */
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << tree.size();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << tree.getHeight();
+
+
+    /* Ray cast (closest hit) */
+
+    timer.start();
+
+    size_t foundRayCast = 0;
+
+    for (const Segment2D& querySegment : querySegments) {
+        RayPoint origin, direction;
+        segmentToRay(querySegment, origin, direction);
+
+        double t;
+        Iterator it = tree.rayCast(origin, direction, &segmentRayIntersection, t, 1);
+
+        if (it != tree.end())
+            foundRayCast++;
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << foundRayCast;
+
+
+    /* Ray cast (any hit) */
+
+    timer.start();
+
+    size_t foundAnyHit = 0;
+
+    for (const Segment2D& querySegment : querySegments) {
+        RayPoint origin, direction;
+        segmentToRay(querySegment, origin, direction);
+
+        if (tree.rayCastAny(origin, direction, &segmentRayIntersection, 1))
+            foundAnyHit++;
+    }
+
+    timer.stop();
+
+    assert(foundAnyHit == foundRayCast);
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << foundAnyHit;
+
+
+    /* Check closest hits with brute force */
+
+    for (const Segment2D& querySegment : querySegments) {
+        RayPoint origin, direction;
+        segmentToRay(querySegment, origin, direction);
+
+        double bestT = 2;
+        for (const Segment2D& segment : testSegments) {
+            double t;
+            if (segmentRayIntersection(segment, origin, direction, t) && t <= 1 && t < bestT)
+                bestT = t;
+        }
+
+        double t;
+        Iterator it = tree.rayCast(origin, direction, &segmentRayIntersection, t, 1);
+        CG3_SUPPRESS_WARNING(it);
+
+        assert((it == tree.end()) == (bestT > 1));
+        assert(it == tree.end() || t == bestT);
+    }
+
+
+    /* Total */
+
+    totalTimer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalTimer.delay();
+
+    std::cout << std::endl;
+}
+
+
+void printBatchHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "MODE" <<
+         std::setw(INDENTSPACE) << std::left << "THREADS" <<
+         std::setw(INDENTSPACE) << std::left << "OVQUERY" <<
+         std::setw(INDENTSPACE) << std::left << "QUERIES/S" <<
+         std::setw(INDENTSPACE) << std::left << "FOUND" <<
+         std::setw(INDENTSPACE) << std::left << "SPEEDUP" <<
+         std::endl << std::endl;
+}
+
+
+void printNearestHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "STRUCTURE" <<
+         std::setw(INDENTSPACE) << std::left << "CONSTR." <<
+         std::setw(INDENTSPACE) << std::left << "NEAREST" <<
+         std::setw(INDENTSPACE) << std::left << "(AVG DIST)" <<
+         std::setw(INDENTSPACE) << std::left << "KNEAREST" <<
+         std::setw(INDENTSPACE) << std::left << "(AVG DIST)" <<
+         std::setw(INDENTSPACE) << std::left << "TOTAL" <<
+         std::endl << std::endl;
+}
+
+
+/*
+ * Nearest and k-nearest queries with a scan of all the segments
+ */
+void testNearestBrute2D(std::vector<Segment2D>& testSegments, std::vector<RayPoint>& queryPoints) {
+
+    cg3::Timer totalTimer("Total");
+    cg3::Timer timer("Step");
+
+    totalTimer.start();
+
+
+    /* Construction */
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << "?";
+
+
+    /* Nearest */
+
+    timer.start();
+
+    double totalDistance = 0;
+
+    for (const RayPoint& point : queryPoints) {
+        double bestDistance = std::numeric_limits<double>::max();
+
+        for (const Segment2D& segment : testSegments) {
+            double distance = segmentPointDistance(segment, point);
+            if (distance < bestDistance)
+                bestDistance = distance;
+        }
+
+        totalDistance += bestDistance;
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalDistance / queryPoints.size();
+
+
+    /* K-nearest */
+
+    timer.start();
+
+    double totalKDistance = 0;
+
+    for (const RayPoint& point : queryPoints) {
+        std::vector<double> distances;
+        distances.reserve(testSegments.size());
+
+        for (const Segment2D& segment : testSegments) {
+            distances.push_back(segmentPointDistance(segment, point));
+        }
+
+        size_t k = std::min((size_t) KNEAREST, distances.size());
+        std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+
+        if (k > 0)
+            totalKDistance += distances[k-1];
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalKDistance / queryPoints.size();
+
+
+    /* Total */
+
+    totalTimer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalTimer.delay();
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Nearest and k-nearest queries with the static AABB tree (best-first traversal)
+ */
+void testNearestStaticAABBTree2D(std::vector<Segment2D>& testSegments, std::vector<RayPoint>& queryPoints) {
+
+    typedef StaticAABBTree<2,Segment2D>::iterator Iterator;
+
+    cg3::Timer totalTimer("Total");
+    cg3::Timer timer("Step");
+
+    totalTimer.start();
+
+
+    /* Construction */
+
+    timer.start();
+
+    StaticAABBTree<2, Segment2D> tree(testSegments, &aabbValueExtractor);
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+
+
+    /* Nearest */
+
+    timer.start();
+
+    double totalDistance = 0;
+
+    for (const RayPoint& point : queryPoints) {
+        double distance;
+        Iterator it = tree.nearest(point, &segmentPointDistance, distance);
+
+        if (it != tree.end())
+            totalDistance += distance;
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalDistance / queryPoints.size();
+
+
+    /* K-nearest */
+
+    timer.start();
+
+    double totalKDistance = 0;
+
+    for (const RayPoint& point : queryPoints) {
+        std::vector<Iterator> out;
+        tree.kNearest(point, KNEAREST, &segmentPointDistance, std::back_inserter(out));
+
+        if (!out.empty())
+            totalKDistance += segmentPointDistance(tree.key(out.back()), point);
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalKDistance / queryPoints.size();
+
+
+    /* Check results with brute force */
+
+    for (size_t i = 0; i < queryPoints.size(); i += queryPoints.size() / 100 + 1) {
+        const RayPoint& point = queryPoints[i];
+
+        std::vector<double> distances;
+        for (const Segment2D& segment : testSegments) {
+            distances.push_back(segmentPointDistance(segment, point));
+        }
+        std::sort(distances.begin(), distances.end());
+
+        double distance;
+        Iterator it = tree.nearest(point, &segmentPointDistance, distance);
+        CG3_SUPPRESS_WARNING(it);
+        assert(it != tree.end() && distance == distances[0]);
+
+        std::vector<Iterator> out;
+        tree.kNearest(point, KNEAREST, &segmentPointDistance, std::back_inserter(out));
+        assert(out.size() == std::min((size_t) KNEAREST, distances.size()));
+
+        for (size_t j = 0; j < out.size(); j++) {
+            assert(segmentPointDistance(tree.key(out[j]), point) == distances[j]);
+        }
+    }
+
+
+    /* Total */
+
+    totalTimer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left;
+    std::cout << totalTimer.delay();
+
+    std::cout << std::endl;
+}
+
+
+
+#ifdef CG3_DCEL_DEFINED
+void printDcelHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "MESH" <<
+         std::setw(INDENTSPACE) << std::left << "(FACES)" <<
+         std::setw(INDENTSPACE) << std::left << "CONSTR." <<
+         std::setw(INDENTSPACE) << std::left << "(HEIGHT)" <<
+         std::setw(INDENTSPACE) << std::left << "LBVH" <<
+         std::setw(INDENTSPACE) << std::left << "(HEIGHT)" <<
+         std::setw(INDENTSPACE) << std::left << "CLOSEST" <<
+         std::setw(INDENTSPACE) << std::left << "BRUTE" <<
+         std::setw(INDENTSPACE) << std::left << "RAY" <<
+         std::setw(INDENTSPACE) << std::left << "BRUTE" <<
+         std::setw(INDENTSPACE) << std::left << "(HITS)" <<
+         std::setw(INDENTSPACE) << std::left << "INSIDE" <<
+         std::setw(INDENTSPACE) << std::left << "(IN)" <<
+         std::endl << std::endl;
+}
+
+/*
+ * Closest point, ray and inside/outside queries on a mesh, compared
+ * with brute force on the triangles
+ */
+void testDcelMesh(const std::string& name, const std::string& fileName) {
+    typedef cg3::DcelAABBTree::Triangle Triangle;
+    typedef cg3::DcelAABBTree::Tree::Point TreePoint;
+
+    cg3::Dcel mesh(dataPath(fileName));
+
+    cg3::Timer timer("Step");
+
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << mesh.numberFaces();
+
+
+    /* Construction */
+
+    timer.start();
+
+    cg3::DcelAABBTree tree(mesh);
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left << tree.getHeight();
+
+    timer.start();
+
+    cg3::DcelAABBTree lbvhTree(mesh, cg3::DcelAABBTree::Tree::LBVH);
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left << lbvhTree.getHeight();
+
+
+    /* Triangles and bounding box of the mesh */
+
+    std::vector<Triangle> triangles;
+    double minCoord[3], maxCoord[3];
+    for (int d = 0; d < 3; d++) {
+        minCoord[d] = std::numeric_limits<double>::max();
+        maxCoord[d] = -std::numeric_limits<double>::max();
+    }
+
+    for (const cg3::Dcel::Face* face : mesh.faceIterator()) {
+        const cg3::Dcel::HalfEdge* halfEdge = face->outerHalfEdge();
+        Triangle triangle;
+        triangle.v1 = halfEdge->fromVertex()->coordinate();
+        triangle.v2 = halfEdge->next()->fromVertex()->coordinate();
+        triangle.v3 = halfEdge->next()->next()->fromVertex()->coordinate();
+        triangles.push_back(triangle);
+
+        for (int d = 1; d <= 3; d++) {
+            minCoord[d-1] = std::min(minCoord[d-1], cg3::DcelAABBTree::triangleValueExtractor(triangle, AABBValueType::MIN, d));
+            maxCoord[d-1] = std::max(maxCoord[d-1], cg3::DcelAABBTree::triangleValueExtractor(triangle, AABBValueType::MAX, d));
+        }
+    }
+
+
+    /* Random query points in the (enlarged) bounding box */
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> distUnit(0, 1);
+    std::vector<cg3::Pointd> queryPoints;
+    std::vector<cg3::Pointd> queryDirections;
+
+    for (int i = 0; i < DCELQUERIES; i++) {
+        double coords[3];
+        for (int d = 0; d < 3; d++) {
+            double extent = maxCoord[d] - minCoord[d];
+            coords[d] = minCoord[d] - extent * 0.1 + distUnit(rng) * extent * 1.2;
+        }
+        queryPoints.push_back(cg3::Pointd(coords[0], coords[1], coords[2]));
+
+        cg3::Pointd direction(distUnit(rng) - 0.5, distUnit(rng) - 0.5, distUnit(rng) - 0.5);
+        queryDirections.push_back(direction / direction.length());
+    }
+
+
+    /* Closest point */
+
+    std::vector<double> treeDistances(queryPoints.size());
+
+    timer.start();
+
+    for (size_t i = 0; i < queryPoints.size(); i++) {
+        cg3::Pointd closest;
+        const cg3::Dcel::Face* face = tree.closestPoint(queryPoints[i], closest, treeDistances[i]);
+
+        assert(face != nullptr);
+        assert(std::abs(closest.dist(queryPoints[i]) - treeDistances[i]) < 1e-9);
+        CG3_SUPPRESS_WARNING(face);
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+
+    timer.start();
+
+    for (size_t i = 0; i < queryPoints.size(); i++) {
+        TreePoint point = {{queryPoints[i].x(), queryPoints[i].y(), queryPoints[i].z()}};
+
+        double bruteDistance = std::numeric_limits<double>::max();
+        for (const Triangle& triangle : triangles)
+            bruteDistance = std::min(bruteDistance, cg3::DcelAABBTree::trianglePointDistance(triangle, point));
+
+        assert(bruteDistance == treeDistances[i]);
+        CG3_SUPPRESS_WARNING(bruteDistance);
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+
+
+    /* Ray intersection */
+
+    std::vector<double> treeT(queryPoints.size());
+    size_t hits = 0;
+
+    timer.start();
+
+    for (size_t i = 0; i < queryPoints.size(); i++) {
+        if (tree.rayIntersection(queryPoints[i], queryDirections[i], treeT[i]) != nullptr)
+            hits++;
+        else
+            treeT[i] = -1;
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+
+    timer.start();
+
+    for (size_t i = 0; i < queryPoints.size(); i++) {
+        TreePoint origin = {{queryPoints[i].x(), queryPoints[i].y(), queryPoints[i].z()}};
+        TreePoint direction = {{queryDirections[i].x(), queryDirections[i].y(), queryDirections[i].z()}};
+
+        double bruteT = std::numeric_limits<double>::max();
+        for (const Triangle& triangle : triangles) {
+            double t;
+            if (cg3::DcelAABBTree::triangleRayIntersection(triangle, origin, direction, t))
+                bruteT = std::min(bruteT, t);
+        }
+
+        if (bruteT == std::numeric_limits<double>::max())
+            bruteT = -1;
+
+        assert(bruteT == treeT[i]);
+        assert((bruteT >= 0) == tree.rayIntersects(queryPoints[i], queryDirections[i]));
+        CG3_SUPPRESS_WARNING(bruteT);
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left << hits;
+
+
+    /* Inside/outside */
+
+    size_t inside = 0;
+
+    timer.start();
+
+    for (const cg3::Pointd& point : queryPoints) {
+        if (tree.isInside(point))
+            inside++;
+    }
+
+    timer.stop();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left << inside;
+
+    std::cout << std::endl;
+}
+#endif
+
+
 }
@@ -14,6 +14,12 @@ void testCorrectness();
 void testRandom();
 void testProgressive();
 void testMixed();
+void testRayCast();
+void testNearest();
+void testBatchQuery();
+#ifdef CG3_DCEL_DEFINED
+void testDcel();
+#endif
 
 }
 
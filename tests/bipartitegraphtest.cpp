@@ -0,0 +1,1350 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "bipartitegraphtest.h"
+
+#include <iostream>
+#include <random>
+#include <assert.h>
+#include <iomanip>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <numeric>
+#include <thread>
+#include <set>
+#include <iterator>
+
+#include <cg3/data_structures/graphs/bipartite_graph.h>
+
+#include "extensions/data_structures/graphs/indexed_bipartite_graph.h"
+#include "extensions/algorithms/bipartite_matching.h"
+#include "extensions/algorithms/bipartite_assignment.h"
+#include "extensions/algorithms/bipartite_projection.h"
+
+#include <cg3/utilities/utils.h>
+
+#include <cg3/cg3lib.h>
+#include <cg3/utilities/timer.h>
+
+#define INDENTSPACE 12
+
+#define INPUTSIZE 1000
+
+#define INDEXEDLEFTSIZE (INPUTSIZE*100)
+#define INDEXEDRIGHTSIZE (INPUTSIZE*100)
+#define INDEXEDARCS (INDEXEDLEFTSIZE*10)
+#define INDEXEDMISSES (INPUTSIZE*100)
+
+#define MATCHINGMINSIZE (INPUTSIZE*10)
+#define MATCHINGMAXSIZE (INPUTSIZE*200)
+#define MATCHINGSIZEFACTOR 4
+#define MATCHINGMINDEGREE 2
+#define MATCHINGMAXDEGREE 8
+#define MATCHINGRANDOMTESTS 100
+#define MATCHINGRANDOMSIZE 20
+
+#define ASSIGNMENTMAXWEIGHT 1000
+#define ASSIGNMENTRANDOMTESTS 100
+#define ASSIGNMENTRANDOMSIZE 7
+#define ASSIGNMENTSMALLMIN 4
+#define ASSIGNMENTSMALLMAX 10
+#define ASSIGNMENTDENSEMIN (INPUTSIZE/4)
+#define ASSIGNMENTDENSEMAX INPUTSIZE
+#define ASSIGNMENTSPARSEMIN (INPUTSIZE*2)
+#define ASSIGNMENTSPARSEMAX (INPUTSIZE*32)
+#define ASSIGNMENTSPARSEDEGREE 8
+#define ASSIGNMENTMAXMATRIX (INPUTSIZE*INPUTSIZE*4)
+
+#define DELETIONSIZE (INPUTSIZE*100)
+#define DELETIONARCS (DELETIONSIZE*10)
+#define DELETIONFACTOR 2
+
+#define PROJECTIONRANDOMTESTS 100
+#define PROJECTIONRANDOMSIZE 70
+#define PROJECTIONMINSIZE (INPUTSIZE*10)
+#define PROJECTIONMAXSIZE (INPUTSIZE*160)
+#define PROJECTIONSIZEFACTOR 4
+#define PROJECTIONRIGHTFACTOR 4
+#define PROJECTIONDEGREE 4
+#define PROJECTIONGRAPHMAXSIZE (INPUTSIZE*40)
+
+
+
+namespace BipartiteGraphTests {
+
+
+/* ----- TYPEDEFS ----- */
+
+typedef cg3::BipartiteGraph<std::string, int> DivisorGraph;
+typedef cg3::IndexedBipartiteGraph<std::string, int> IndexedDivisorGraph;
+typedef cg3::BipartiteGraph<int, int> IntBipartiteGraph;
+typedef cg3::IndexedBipartiteGraph<int, int> IndexedIntBipartiteGraph;
+
+
+/* ----- FUNCTION DECLARATION ----- */
+
+void printIndexedHeader();
+void printIndexedRow(const std::string& name, double nodeTime, double arcTime, double visitTime, double missTime);
+
+template <class T1, class T2>
+bool sameGraph(const cg3::BipartiteGraph<T1, T2>& graph, const cg3::IndexedBipartiteGraph<T1, T2>& indexedGraph);
+
+void printMatchingHeader();
+void printMatchingRow(const std::string& name, size_t n, size_t degree, unsigned int nThreads, double time, size_t size);
+bool validMatching(
+        const IndexedIntBipartiteGraph& graph,
+        const std::vector<size_t>& leftMatches,
+        const std::vector<size_t>& rightMatches,
+        size_t size);
+size_t referenceMatchingSize(const IndexedIntBipartiteGraph& graph);
+bool augmentingPath(
+        const IndexedIntBipartiteGraph& graph,
+        size_t u,
+        std::vector<size_t>& rightMatches,
+        std::vector<bool>& visited);
+
+void printDeletionHeader();
+void printDeletionRow(const std::string& name, size_t deleted, double time, size_t numArcs);
+void printAssignmentHeader();
+void printAssignmentRow(const std::string& name, const IndexedIntBipartiteGraph& graph, unsigned int nThreads, double time, double cost);
+void randomAssignmentGraph(IndexedIntBipartiteGraph& graph, size_t nLeft, size_t nRight, size_t degree, std::mt19937& rng);
+double referenceAssignmentCost(const IndexedIntBipartiteGraph& graph);
+double bruteForceAssignment(
+        const IndexedIntBipartiteGraph& graph,
+        size_t u,
+        std::vector<bool>& assigned);
+void printProjectionHeader();
+void printProjectionRow(const std::string& name, const IndexedIntBipartiteGraph& graph, unsigned int nThreads, double time, size_t size);
+void randomProjectionGraph(IndexedIntBipartiteGraph& graph, size_t nLeft, size_t nRight, size_t numArcs, std::mt19937& rng);
+size_t commonRightNeighbors(const IndexedIntBipartiteGraph& graph, size_t u, size_t w);
+
+
+
+/* ----- TEST CORRECTNESS ----- */
+
+void testCorrectness() {
+
+    //Test indexed bipartite graph: every arc between u and v means that
+    //u is divisor of v
+    IndexedDivisorGraph indexedGraph;
+    assert(indexedGraph.empty());
+    assert(indexedGraph.numArcs() == 0);
+
+    IndexedDivisorGraph::LeftId l2 = indexedGraph.addLeftNode("2");
+    IndexedDivisorGraph::LeftId l3 = indexedGraph.addLeftNode("3");
+    std::vector<IndexedDivisorGraph::LeftId> leftIds = indexedGraph.addLeftNodes({"4", "5", "3"});
+    std::vector<IndexedDivisorGraph::RightId> rightIds = indexedGraph.addRightNodes({10, 12, 15, 17, 20, 24});
+    IndexedDivisorGraph::LeftId l4 = leftIds[0], l5 = leftIds[1];
+    IndexedDivisorGraph::RightId r10 = rightIds[0], r12 = rightIds[1], r15 = rightIds[2], r17 = rightIds[3], r20 = rightIds[4], r24 = rightIds[5];
+    CG3_SUPPRESS_WARNING(r17);
+
+    assert(l2 == 0 && l3 == 1 && l4 == 2 && l5 == 3);
+    assert(leftIds[2] == IndexedDivisorGraph::NOT_FOUND);
+    assert(indexedGraph.addLeftNode("2") == IndexedDivisorGraph::NOT_FOUND);
+    assert(indexedGraph.addRightNode(24) == IndexedDivisorGraph::NOT_FOUND);
+    assert(indexedGraph.numLeftNodes() == 4);
+    assert(indexedGraph.numRightNodes() == 6);
+    assert(indexedGraph.leftValue(l3) == "3");
+    assert(indexedGraph.rightValue(r20) == 20);
+
+    indexedGraph.addArc(l2, r10);
+    indexedGraph.addArc(l2, r12);
+    indexedGraph.addArc(l2, r20);
+    indexedGraph.addArc(l2, r24);
+    indexedGraph.addArc(l3, r12);
+    indexedGraph.addArc(l3, r15);
+    indexedGraph.addArcs({{l3, r24}, {l4, r24}, {l4, r12}, {l4, r20}, {l5, r10}, {l5, r15}, {l5, r20}, {l5, 100}});
+    assert(!indexedGraph.addArc(l5, 100));
+    assert(!indexedGraph.addArc(100, r10));
+    assert(indexedGraph.numArcs() == 13);
+
+    //Repeated arcs are stored once
+    indexedGraph.addArc(l2, r10);
+    indexedGraph.addArc(l2, r10);
+    assert(indexedGraph.numArcs() == 13);
+
+    assert(indexedGraph.isAdjacent(l3, r24));
+    assert(!indexedGraph.isAdjacent(l3, r20));
+    assert(!indexedGraph.isAdjacent(l3, 100));
+
+    std::vector<int> multiples;
+    for (IndexedDivisorGraph::RightId v : indexedGraph.adjacentRightNodes(l3))
+        multiples.push_back(indexedGraph.rightValue(v));
+    assert(multiples == std::vector<int>({12, 15, 24}));
+
+    std::vector<std::string> divisors;
+    for (IndexedDivisorGraph::LeftId u : indexedGraph.adjacentLeftNodes(r24))
+        divisors.push_back(indexedGraph.leftValue(u));
+    assert(divisors == std::vector<std::string>({"2", "3", "4"}));
+
+    assert(indexedGraph.leftDegree(l2) == 4);
+    assert(indexedGraph.rightDegree(r17) == 0);
+    assert(indexedGraph.leftDegree(100) == 0);
+
+    //Missing values are reported without exceptions
+    IndexedDivisorGraph::RightId r22;
+    IndexedDivisorGraph::LeftId l6;
+    CG3_SUPPRESS_WARNING(r22);
+    CG3_SUPPRESS_WARNING(l6);
+    assert(!indexedGraph.tryFindRightNode(22, r22));
+    assert(r22 == IndexedDivisorGraph::NOT_FOUND);
+    assert(indexedGraph.adjacentLeftNodes(r22).size() == 0);
+    assert(!indexedGraph.tryFindLeftNode("6", l6));
+    assert(indexedGraph.tryFindRightNode(15, r22) && r22 == r15);
+
+    //Nodes added after the build
+    IndexedDivisorGraph::LeftId l6Added = indexedGraph.addLeftNode("6");
+    IndexedDivisorGraph::RightId r30 = indexedGraph.addRightNode(30);
+    assert(indexedGraph.leftDegree(l6Added) == 0);
+    indexedGraph.addArc(l6Added, r12);
+    indexedGraph.addArc(l6Added, r24);
+    indexedGraph.addArc(l6Added, r30);
+    indexedGraph.addArc(l3, r30);
+    assert(indexedGraph.numArcs() == 17);
+    assert(indexedGraph.rightDegree(r30) == 2);
+    assert(indexedGraph.isAdjacent(l6Added, r24));
+
+    //Weights of the arcs: repeated arcs keep the last weight
+    indexedGraph.addArc(l2, r12, 3);
+    indexedGraph.addArcs({{l2, r12}, {l2, r20}}, {5, 7});
+    assert(indexedGraph.numArcs() == 17);
+    assert(indexedGraph.getWeight(l2, r12) == 5);
+    assert(indexedGraph.getWeight(l2, r20) == 7);
+    assert(indexedGraph.getWeight(l2, r10) == 0);
+    assert(indexedGraph.getWeight(l2, r15) == IndexedDivisorGraph::MAX_WEIGHT);
+
+    indexedGraph.setWeight(l2, r20, 2);
+    indexedGraph.setWeight(l3, r20, 9);
+    IndexedDivisorGraph::WeightRange r20Weights = indexedGraph.adjacentLeftWeights(r20);
+    assert(std::vector<double>(r20Weights.begin(), r20Weights.end()) == std::vector<double>({2, 0, 0}));
+    IndexedDivisorGraph::WeightRange l2Weights = indexedGraph.adjacentRightWeights(l2);
+    assert(std::vector<double>(l2Weights.begin(), l2Weights.end()) == std::vector<double>({0, 5, 2, 0}));
+    CG3_SUPPRESS_WARNING(r20Weights);
+    CG3_SUPPRESS_WARNING(l2Weights);
+
+    //Deleted nodes: their arcs are removed from the adjacency of both the
+    //sides, the ids of the other nodes do not change
+    IndexedDivisorGraph prunedGraph = indexedGraph;
+    prunedGraph.setCompactionPolicy(1);
+    assert(prunedGraph.deleteLeftNode(l2));
+    assert(!prunedGraph.deleteLeftNode(l2));
+    assert(!prunedGraph.isValidLeft(l2));
+    assert(prunedGraph.numLeftNodes() == 4 && prunedGraph.leftIdBound() == 5);
+    assert(prunedGraph.numArcs() == 13);
+    assert(prunedGraph.getWeight(l2, r10) == IndexedDivisorGraph::MAX_WEIGHT);
+
+    divisors.clear();
+    for (IndexedDivisorGraph::LeftId u : prunedGraph.adjacentLeftNodes(r24))
+        divisors.push_back(prunedGraph.leftValue(u));
+    assert(divisors == std::vector<std::string>({"3", "4", "6"}));
+
+    assert(prunedGraph.deleteRightNodes({r12, r24, r12, 100}) == 2);
+    assert(prunedGraph.numArcs() == 7);
+    assert(prunedGraph.numRightNodes() == 5);
+
+    multiples.clear();
+    for (IndexedDivisorGraph::RightId v : prunedGraph.adjacentRightNodes(l3))
+        multiples.push_back(prunedGraph.rightValue(v));
+    assert(multiples == std::vector<int>({15, 30}));
+
+    assert(prunedGraph.tombstoneRatio() > 0);
+    prunedGraph.compact();
+    assert(prunedGraph.tombstoneRatio() == 0);
+    assert(prunedGraph.numArcs() == 7);
+    assert(prunedGraph.isAdjacent(l5, r20));
+
+    //The value of a deleted node can be added again, with a new id
+    IndexedDivisorGraph::LeftId l2Added = prunedGraph.addLeftNode("2");
+    CG3_SUPPRESS_WARNING(l2Added);
+    assert(l2Added == 5);
+    assert(prunedGraph.addArc(l2Added, r10));
+    assert(!prunedGraph.addArc(l2Added, r24));
+    assert(prunedGraph.rightDegree(r10) == 2);
+    assert(prunedGraph.numArcs() == 8);
+
+    //Copy of a cg3::BipartiteGraph
+    DivisorGraph bigraph;
+    bigraph.addLeftNode("2");
+    bigraph.addLeftNode("3");
+    bigraph.addLeftNode("5");
+    bigraph.addRightNode(10);
+    bigraph.addRightNode(12);
+    bigraph.addRightNode(15);
+    bigraph.addArc("2", 10);
+    bigraph.addArc("2", 12);
+    bigraph.addArc("3", 12);
+    bigraph.addArc("3", 15);
+    bigraph.addArc("5", 10);
+    bigraph.addArc("5", 15);
+
+    IndexedDivisorGraph copiedGraph(bigraph);
+    assert(copiedGraph.numArcs() == 6);
+    assert(sameGraph(bigraph, copiedGraph));
+
+    copiedGraph.clear();
+    assert(copiedGraph.empty());
+    assert(copiedGraph.numArcs() == 0);
+
+
+    //Test maximum matching: each divisor is matched to a different multiple
+    std::vector<std::pair<std::string, int>> matching = cg3::maximumMatching(bigraph);
+    assert(matching.size() == 3);
+    for (const std::pair<std::string, int>& pair : matching) {
+        assert(std::stoi(pair.first) > 0 && pair.second % std::stoi(pair.first) == 0);
+        CG3_SUPPRESS_WARNING(pair);
+    }
+
+    std::vector<size_t> leftMatches, rightMatches;
+    assert(cg3::maximumMatching(indexedGraph, leftMatches, rightMatches) == 5);
+    assert(rightMatches[r17] == IndexedDivisorGraph::NOT_FOUND);
+
+    assert(cg3::maximumMatching(prunedGraph, leftMatches, rightMatches) == 4);
+    assert(leftMatches[l2] == IndexedDivisorGraph::NOT_FOUND);
+
+    //Star: the greedy matching takes the leaves first
+    IndexedIntBipartiteGraph starGraph;
+    starGraph.addLeftNodes({0, 1, 2});
+    starGraph.addRightNodes({0, 1, 2});
+    starGraph.addArcs({{0, 0}, {0, 1}, {0, 2}, {1, 0}, {2, 1}});
+    assert(cg3::greedyMatching(starGraph, leftMatches, rightMatches) == 3);
+
+    //Path with a single augmenting path after the initial matching
+    IndexedIntBipartiteGraph pathGraph;
+    pathGraph.addLeftNodes({0, 1, 2});
+    pathGraph.addRightNodes({0, 1, 2});
+    pathGraph.addArcs({{0, 0}, {0, 1}, {1, 1}, {1, 2}, {2, 2}});
+    leftMatches = {1, 2, IndexedIntBipartiteGraph::NOT_FOUND};
+    rightMatches = {IndexedIntBipartiteGraph::NOT_FOUND, 0, 1};
+    assert(cg3::hopcroftKarp(pathGraph, leftMatches, rightMatches, 1) == 3);
+    assert(leftMatches == std::vector<size_t>({0, 1, 2}));
+
+    //Random graphs compared with simple augmenting paths
+    std::mt19937 rng;
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, MATCHINGRANDOMSIZE-1);
+
+    for (int test = 0; test < MATCHINGRANDOMTESTS; test++) {
+        IndexedIntBipartiteGraph randomGraph;
+        for (int i = 0; i < MATCHINGRANDOMSIZE; i++) {
+            randomGraph.addLeftNode(i);
+            randomGraph.addRightNode(i);
+        }
+        for (int i = 0; i < test % (MATCHINGRANDOMSIZE*3); i++)
+            randomGraph.addArc(distNode(rng), distNode(rng));
+
+        size_t expectedSize = referenceMatchingSize(randomGraph);
+        CG3_SUPPRESS_WARNING(expectedSize);
+
+        for (unsigned int nThreads = 1; nThreads <= 2; nThreads++) {
+            leftMatches.clear();
+            size_t size = cg3::hopcroftKarp(randomGraph, leftMatches, rightMatches, nThreads);
+            assert(size == expectedSize);
+            assert(validMatching(randomGraph, leftMatches, rightMatches, size));
+
+            size = cg3::maximumMatching(randomGraph, leftMatches, rightMatches, nThreads);
+            assert(size == expectedSize);
+            assert(validMatching(randomGraph, leftMatches, rightMatches, size));
+            CG3_SUPPRESS_WARNING(size);
+        }
+    }
+
+
+    //Test minimum cost assignment
+    IndexedIntBipartiteGraph costGraph;
+    costGraph.addLeftNodes({0, 1, 2});
+    costGraph.addRightNodes({0, 1, 2});
+    costGraph.addArcs(
+                {{0, 0}, {0, 1}, {0, 2}, {1, 0}, {1, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}},
+                {4, 1, 3, 2, 0, 5, 3, 2, 2});
+    for (cg3::AssignmentAlgorithm algorithm : {cg3::JONKER_VOLGENANT, cg3::AUCTION}) {
+        assert(cg3::minimumCostAssignment(costGraph, leftMatches, rightMatches, algorithm, 1) == 5);
+        assert(leftMatches == std::vector<size_t>({1, 0, 2}));
+        CG3_SUPPRESS_WARNING(algorithm);
+    }
+
+    //No assignment of all the left nodes
+    costGraph.addLeftNode(3);
+    assert(cg3::jonkerVolgenant(costGraph, leftMatches, rightMatches) == IndexedIntBipartiteGraph::MAX_WEIGHT);
+    assert(std::count(leftMatches.begin(), leftMatches.end(), IndexedIntBipartiteGraph::NOT_FOUND) == 4);
+
+    //Deleted nodes are not assigned
+    costGraph.deleteLeftNode(3);
+    for (cg3::AssignmentAlgorithm algorithm : {cg3::JONKER_VOLGENANT, cg3::AUCTION}) {
+        assert(cg3::minimumCostAssignment(costGraph, leftMatches, rightMatches, algorithm, 2) == 5);
+        assert(leftMatches[3] == IndexedIntBipartiteGraph::NOT_FOUND);
+        CG3_SUPPRESS_WARNING(algorithm);
+    }
+
+    //Random graphs compared with the brute force
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, ASSIGNMENTMAXWEIGHT);
+
+    for (int test = 0; test < ASSIGNMENTRANDOMTESTS; test++) {
+        size_t nLeft = 1 + test % ASSIGNMENTRANDOMSIZE;
+        size_t nRight = nLeft + test % 3;
+        std::uniform_int_distribution<std::mt19937::result_type>
+                distRight(0, nRight-1);
+
+        IndexedIntBipartiteGraph randomGraph;
+        for (size_t i = 0; i < nRight; i++) {
+            if (i < nLeft)
+                randomGraph.addLeftNode(i);
+            randomGraph.addRightNode(i);
+        }
+        for (size_t u = 0; u < nLeft; u++) {
+            for (size_t i = 0; i < 1 + test % nRight; i++)
+                randomGraph.addArc(u, distRight(rng), distWeight(rng));
+        }
+
+        double expectedCost = referenceAssignmentCost(randomGraph);
+        bool complete = expectedCost != IndexedIntBipartiteGraph::MAX_WEIGHT;
+        CG3_SUPPRESS_WARNING(complete);
+
+        double cost = cg3::jonkerVolgenant(randomGraph, leftMatches, rightMatches);
+        assert(cost == expectedCost);
+        assert(!complete || validMatching(randomGraph, leftMatches, rightMatches, nLeft));
+
+        for (unsigned int nThreads = 1; nThreads <= 2; nThreads++) {
+            cost = cg3::auctionAssignment(randomGraph, leftMatches, rightMatches, nThreads);
+            assert(cost == expectedCost);
+            assert(!complete || validMatching(randomGraph, leftMatches, rightMatches, nLeft));
+        }
+        CG3_SUPPRESS_WARNING(cost);
+    }
+
+    //Test two-hop queries: the divisors which share a multiple with a
+    //divisor, and the multiples which share a divisor with a multiple
+    cg3::TwoHopQuery<std::string, int> twoHop(indexedGraph);
+    std::vector<size_t> neighbors;
+    assert(twoHop.leftNeighbors(l5, neighbors) == 3);
+    assert(neighbors == std::vector<size_t>({l2, l3, l4}));
+    assert(twoHop.leftNeighbors(l2, neighbors) == 4);
+    assert(neighbors == std::vector<size_t>({l3, l4, l5, l6Added}));
+    assert(twoHop.rightNeighbors(r30, neighbors) == 3);
+    assert(neighbors == std::vector<size_t>({r12, r15, r24}));
+    assert(twoHop.rightNeighbors(r17, neighbors) == 0);
+    assert(twoHop.leftNeighbors(100, neighbors) == 0);
+
+    //Deleted nodes are not reported
+    cg3::TwoHopQuery<std::string, int> prunedTwoHop(prunedGraph);
+    assert(prunedTwoHop.leftNeighbors(l2, neighbors) == 0);
+    assert(prunedTwoHop.leftNeighbors(l5, neighbors) == 3);
+    assert(neighbors == std::vector<size_t>({l3, l4, l2Added}));
+    assert(prunedTwoHop.rightNeighbors(r12, neighbors) == 0);
+
+
+    //Test one-mode projection: pairs of divisors weighted with the number
+    //of common multiples
+    std::vector<std::pair<size_t, size_t>> edges;
+    std::vector<double> weights;
+    for (unsigned int nThreads = 1; nThreads <= 2; nThreads++) {
+        assert(cg3::leftProjection(indexedGraph, edges, weights, nThreads) == 9);
+        assert(edges.front() == std::make_pair(l2, l3) && edges.back() == std::make_pair(l4, l6Added));
+        assert(weights == std::vector<double>({2, 3, 2, 2, 2, 1, 3, 1, 2}));
+    }
+
+    assert(cg3::rightProjection(prunedGraph, edges, weights, 1) == 4);
+    std::vector<std::pair<size_t, size_t>> expectedEdges = {{r10, r15}, {r10, r20}, {r15, r20}, {r15, r30}};
+    assert(edges == expectedEdges);
+    assert(weights == std::vector<double>({1, 1, 1, 1}));
+
+    //Projections of a cg3::BipartiteGraph
+    bigraph.addRightNode(30);
+    bigraph.addArc("2", 30);
+    bigraph.addArc("3", 30);
+
+    cg3::Graph<std::string> divisorProjection = cg3::leftProjection(bigraph, 2);
+    assert(divisorProjection.numNodes() == 3);
+    assert(divisorProjection.getWeight("2", "3") == 2 && divisorProjection.getWeight("3", "2") == 2);
+    assert(divisorProjection.getWeight("3", "5") == 1);
+
+    cg3::Graph<int> multipleProjection = cg3::rightProjection(bigraph, 2);
+    assert(multipleProjection.numNodes() == 4);
+    assert(multipleProjection.getWeight(12, 30) == 2);
+    assert(multipleProjection.getWeight(10, 15) == 1);
+    assert(!multipleProjection.isAdjacent(15, 15));
+
+    //Random graphs compared with the intersections of the adjacencies
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distProjection(0, PROJECTIONRANDOMSIZE-1);
+
+    for (int test = 0; test < PROJECTIONRANDOMTESTS; test++) {
+        IndexedIntBipartiteGraph randomGraph;
+        randomProjectionGraph(randomGraph, PROJECTIONRANDOMSIZE, PROJECTIONRANDOMSIZE, test * 5, rng);
+        if (test % 2 == 1) {
+            randomGraph.deleteLeftNode(distProjection(rng));
+            randomGraph.deleteRightNode(distProjection(rng));
+        }
+
+        cg3::TwoHopQuery<int, int> randomTwoHop(randomGraph);
+        std::vector<double> expectedWeights;
+        expectedEdges.clear();
+        for (size_t u = 0; u < randomGraph.leftIdBound(); u++) {
+            std::vector<size_t> expectedNeighbors;
+            for (size_t w = 0; w < randomGraph.leftIdBound(); w++) {
+                size_t common = commonRightNeighbors(randomGraph, u, w);
+                if (w == u || common == 0)
+                    continue;
+
+                expectedNeighbors.push_back(w);
+                if (u < w) {
+                    expectedEdges.push_back(std::make_pair(u, w));
+                    expectedWeights.push_back(common);
+                }
+            }
+
+            randomTwoHop.leftNeighbors(u, neighbors);
+            assert(neighbors == expectedNeighbors);
+        }
+
+        for (unsigned int nThreads = 1; nThreads <= 2; nThreads++) {
+            cg3::leftProjection(randomGraph, edges, weights, nThreads);
+            assert(edges == expectedEdges);
+            assert(weights == expectedWeights);
+        }
+    }
+}
+
+
+
+
+/* ----- INDEXED BIPARTITE GRAPH ----- */
+
+void testIndexedBipartiteGraph()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distLeft(0, INDEXEDLEFTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distRight(0, INDEXEDRIGHTSIZE-1);
+
+    //Left values are even and right values are multiples of 3, so the
+    //odd values are missing on the left
+    std::vector<int> leftNumbers, rightNumbers;
+    for (int i = 0; i < INDEXEDLEFTSIZE; i++)
+        leftNumbers.push_back(i * 2);
+    for (int i = 0; i < INDEXEDRIGHTSIZE; i++)
+        rightNumbers.push_back(i * 3);
+    std::shuffle(leftNumbers.begin(), leftNumbers.end(), rng);
+    std::shuffle(rightNumbers.begin(), rightNumbers.end(), rng);
+
+    std::vector<std::pair<size_t, size_t>> testArcs;
+    for (int i = 0; i < INDEXEDARCS; i++) {
+        testArcs.push_back(std::make_pair(distLeft(rng), distRight(rng)));
+    }
+
+    std::vector<int> missingNumbers;
+    for (int i = 0; i < INDEXEDMISSES; i++) {
+        missingNumbers.push_back(distLeft(rng) * 2 + 1);
+    }
+
+    std::cout << std::endl << " ------ INDEXED BIPARTITE GRAPH ------ " << std::endl << std::endl;
+
+    printIndexedHeader();
+
+    cg3::Timer timer("Step");
+
+
+    /* Graph with maps */
+
+    IntBipartiteGraph graph;
+
+    timer.start();
+    for (int number : leftNumbers)
+        graph.addLeftNode(number);
+    for (int number : rightNumbers)
+        graph.addRightNode(number);
+    timer.stop();
+    double nodeTime = timer.delay();
+
+    timer.start();
+    for (const std::pair<size_t, size_t>& arc : testArcs)
+        graph.addArc(leftNumbers[arc.first], rightNumbers[arc.second]);
+    timer.stop();
+    double arcTime = timer.delay();
+
+    long long mapSum = 0;
+    timer.start();
+    for (int number : leftNumbers) {
+        for (const int& adjacent : graph.adjacentLeftNodeIterator(number))
+            mapSum += adjacent;
+    }
+    for (int number : rightNumbers) {
+        for (const int& adjacent : graph.adjacentRightNodeIterator(number))
+            mapSum += adjacent;
+    }
+    timer.stop();
+    double visitTime = timer.delay();
+
+    size_t mapMisses = 0;
+    timer.start();
+    for (int number : missingNumbers) {
+        try {
+            for (const int& adjacent : graph.adjacentLeftNodeIterator(number))
+                CG3_SUPPRESS_WARNING(adjacent);
+        }
+        catch (std::out_of_range&) {
+            mapMisses++;
+        }
+    }
+    timer.stop();
+    double missTime = timer.delay();
+
+    printIndexedRow("MAP", nodeTime, arcTime, visitTime, missTime);
+
+
+    /* Indexed graph */
+
+    IndexedIntBipartiteGraph indexedGraph;
+
+    timer.start();
+    indexedGraph.reserve(INDEXEDLEFTSIZE, INDEXEDRIGHTSIZE, INDEXEDARCS);
+    indexedGraph.addLeftNodes(leftNumbers);
+    indexedGraph.addRightNodes(rightNumbers);
+    timer.stop();
+    nodeTime = timer.delay();
+
+    //Ids are assigned in order, so the positions in the values are the ids
+    timer.start();
+    indexedGraph.addArcs(testArcs);
+    indexedGraph.build();
+    timer.stop();
+    arcTime = timer.delay();
+
+    long long indexedSum = 0;
+    timer.start();
+    for (size_t u = 0; u < indexedGraph.numLeftNodes(); u++) {
+        for (size_t v : indexedGraph.adjacentRightNodes(u))
+            indexedSum += indexedGraph.rightValue(v);
+    }
+    for (size_t v = 0; v < indexedGraph.numRightNodes(); v++) {
+        for (size_t u : indexedGraph.adjacentLeftNodes(v))
+            indexedSum += indexedGraph.leftValue(u);
+    }
+    timer.stop();
+    visitTime = timer.delay();
+
+    size_t indexedMisses = 0;
+    timer.start();
+    for (int number : missingNumbers) {
+        size_t u;
+        if (!indexedGraph.tryFindLeftNode(number, u))
+            indexedMisses++;
+    }
+    timer.stop();
+    missTime = timer.delay();
+
+    printIndexedRow("INDEXED", nodeTime, arcTime, visitTime, missTime);
+
+    assert(indexedSum == mapSum);
+    assert(indexedMisses == mapMisses && indexedMisses == INDEXEDMISSES);
+    CG3_SUPPRESS_WARNING(indexedSum);
+    CG3_SUPPRESS_WARNING(mapSum);
+    CG3_SUPPRESS_WARNING(indexedMisses);
+    CG3_SUPPRESS_WARNING(mapMisses);
+
+
+    /* Copy of the graph with maps */
+
+    timer.start();
+    IndexedIntBipartiteGraph copiedGraph(graph);
+    timer.stop();
+
+    std::cout << std::endl << "Copy of the graph with maps: " << timer.delay() << std::endl;
+
+    assert(copiedGraph.numArcs() == indexedGraph.numArcs());
+    assert(sameGraph(graph, copiedGraph));
+
+    std::cout << std::endl;
+}
+
+
+
+
+/* ----- BULK DELETION ----- */
+
+void testBulkDeletion()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, DELETIONSIZE-1);
+
+    std::vector<int> numbers(DELETIONSIZE);
+    std::iota(numbers.begin(), numbers.end(), 0);
+
+    std::vector<std::pair<size_t, size_t>> testArcs;
+    for (int i = 0; i < DELETIONARCS; i++) {
+        testArcs.push_back(std::make_pair(distNode(rng), distNode(rng)));
+    }
+
+    std::cout << std::endl << " ------ BULK DELETION ------ " << std::endl << std::endl;
+
+    printDeletionHeader();
+
+    cg3::Timer timer("Step");
+
+    for (size_t numDeleted = DELETIONSIZE / 8; numDeleted < DELETIONSIZE; numDeleted *= DELETIONFACTOR) {
+        std::vector<size_t> deletedIds(numbers.begin(), numbers.end());
+        std::shuffle(deletedIds.begin(), deletedIds.end(), rng);
+        deletedIds.resize(numDeleted);
+
+
+        /* Graph with maps: each deletion updates the adjacent nodes */
+
+        IntBipartiteGraph graph;
+        for (int number : numbers) {
+            graph.addLeftNode(number);
+            graph.addRightNode(number);
+        }
+        for (const std::pair<size_t, size_t>& arc : testArcs)
+            graph.addArc(numbers[arc.first], numbers[arc.second]);
+
+        timer.start();
+        for (size_t id : deletedIds)
+            graph.deleteLeftNode(numbers[id]);
+        timer.stop();
+
+        size_t expectedArcs = 0;
+        for (int number : graph.leftNodeIterator()) {
+            for (const int& adjacent : graph.adjacentLeftNodeIterator(number)) {
+                CG3_SUPPRESS_WARNING(adjacent);
+                expectedArcs++;
+            }
+        }
+
+        printDeletionRow("MAP", numDeleted, timer.delay(), expectedArcs);
+
+
+        /* Indexed graph: tombstones purged by build() */
+
+        IndexedIntBipartiteGraph indexedGraph;
+        indexedGraph.addLeftNodes(numbers);
+        indexedGraph.addRightNodes(numbers);
+        indexedGraph.addArcs(testArcs);
+        indexedGraph.build();
+
+        IndexedIntBipartiteGraph bulkGraph = indexedGraph;
+
+        timer.start();
+        for (size_t id : deletedIds)
+            indexedGraph.deleteLeftNode(id);
+        indexedGraph.build();
+        timer.stop();
+
+        assert(indexedGraph.numArcs() == expectedArcs);
+        assert(sameGraph(graph, indexedGraph));
+
+        printDeletionRow("SINGLE", numDeleted, timer.delay(), indexedGraph.numArcs());
+
+        timer.start();
+        bulkGraph.deleteLeftNodes(deletedIds);
+        bulkGraph.build();
+        timer.stop();
+
+        assert(bulkGraph.numArcs() == expectedArcs);
+
+        printDeletionRow("BULK", numDeleted, timer.delay(), bulkGraph.numArcs());
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+
+/* ----- MAXIMUM MATCHING ----- */
+
+void testMaximumMatching()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+
+    std::cout << std::endl << " ------ MAXIMUM MATCHING ------ " << std::endl << std::endl;
+
+    printMatchingHeader();
+
+    cg3::Timer timer("Step");
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (size_t n = MATCHINGMINSIZE; n <= MATCHINGMAXSIZE; n *= MATCHINGSIZEFACTOR) {
+        std::uniform_int_distribution<std::mt19937::result_type>
+                distNode(0, n-1);
+
+        for (size_t degree = MATCHINGMINDEGREE; degree <= MATCHINGMAXDEGREE; degree *= 2) {
+            //Random graph with the given average degree
+            std::vector<int> testNumbers(n);
+            std::iota(testNumbers.begin(), testNumbers.end(), 0);
+
+            std::vector<std::pair<size_t, size_t>> testArcs;
+            for (size_t i = 0; i < n * degree; i++) {
+                testArcs.push_back(std::make_pair(distNode(rng), distNode(rng)));
+            }
+
+            IndexedIntBipartiteGraph graph;
+            graph.addLeftNodes(testNumbers);
+            graph.addRightNodes(testNumbers);
+            graph.addArcs(testArcs);
+            graph.build();
+
+            std::vector<size_t> leftMatches, rightMatches;
+
+            //Greedy matching
+            timer.start();
+            size_t greedySize = cg3::greedyMatching(graph, leftMatches, rightMatches);
+            timer.stop();
+
+            printMatchingRow("GREEDY", n, degree, 1, timer.delay(), greedySize);
+
+            //Hopcroft-Karp from the empty matching
+            leftMatches.clear();
+            timer.start();
+            size_t expectedSize = cg3::hopcroftKarp(graph, leftMatches, rightMatches, 1);
+            timer.stop();
+
+            assert(validMatching(graph, leftMatches, rightMatches, expectedSize));
+
+            printMatchingRow("HK", n, degree, 1, timer.delay(), expectedSize);
+
+            //Hopcroft-Karp with greedy warm start
+            for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+                timer.start();
+                size_t size = cg3::maximumMatching(graph, leftMatches, rightMatches, nThreads);
+                timer.stop();
+
+                assert(size == expectedSize);
+                assert(validMatching(graph, leftMatches, rightMatches, size));
+
+                printMatchingRow("WARM-HK", n, degree, nThreads, timer.delay(), size);
+
+                if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+                    nThreads = maxThreads / 2;
+            }
+
+            std::cout << std::endl;
+        }
+    }
+}
+
+
+
+
+/* ----- MINIMUM COST ASSIGNMENT ----- */
+
+void testAssignment()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+
+    std::cout << std::endl << " ------ MINIMUM COST ASSIGNMENT ------ " << std::endl << std::endl;
+
+    printAssignmentHeader();
+
+    cg3::Timer timer("Step");
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<std::pair<size_t, size_t>> sizes;
+    for (size_t n = ASSIGNMENTSMALLMIN; n <= ASSIGNMENTSMALLMAX; n += 2)
+        sizes.push_back(std::make_pair(n, n));
+    for (size_t n = ASSIGNMENTDENSEMIN; n <= ASSIGNMENTDENSEMAX; n *= 2)
+        sizes.push_back(std::make_pair(n, n));
+    for (size_t n = ASSIGNMENTSPARSEMIN; n <= ASSIGNMENTSPARSEMAX; n *= 4)
+        sizes.push_back(std::make_pair(n, ASSIGNMENTSPARSEDEGREE));
+
+    for (const std::pair<size_t, size_t>& size : sizes) {
+        size_t n = size.first;
+        size_t degree = size.second;
+
+        IndexedIntBipartiteGraph graph;
+        randomAssignmentGraph(graph, n, n, degree, rng);
+        graph.build();
+
+        std::vector<size_t> leftMatches, rightMatches;
+        double expectedCost = IndexedIntBipartiteGraph::MAX_WEIGHT;
+
+        //Brute force on the small graphs
+        if (n <= ASSIGNMENTSMALLMAX) {
+            timer.start();
+            expectedCost = referenceAssignmentCost(graph);
+            timer.stop();
+
+            printAssignmentRow("BRUTE", graph, 1, timer.delay(), expectedCost);
+        }
+
+        //Jonker-Volgenant if the cost matrix is not too large
+        if (n * n <= ASSIGNMENTMAXMATRIX) {
+            timer.start();
+            double cost = cg3::jonkerVolgenant(graph, leftMatches, rightMatches);
+            timer.stop();
+
+            assert(expectedCost == IndexedIntBipartiteGraph::MAX_WEIGHT || cost == expectedCost);
+            assert(validMatching(graph, leftMatches, rightMatches, n));
+            expectedCost = cost;
+
+            printAssignmentRow("JV", graph, 1, timer.delay(), cost);
+        }
+
+        //Auction
+        for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+            timer.start();
+            double cost = cg3::auctionAssignment(graph, leftMatches, rightMatches, nThreads);
+            timer.stop();
+
+            assert(expectedCost == IndexedIntBipartiteGraph::MAX_WEIGHT || cost == expectedCost);
+            assert(validMatching(graph, leftMatches, rightMatches, n));
+            CG3_SUPPRESS_WARNING(cost);
+
+            printAssignmentRow("AUCTION", graph, nThreads, timer.delay(), cost);
+
+            if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+                nThreads = maxThreads / 2;
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+
+/* ----- PROJECTION ----- */
+
+void testProjection()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+
+    std::cout << std::endl << " ------ PROJECTION ------ " << std::endl << std::endl;
+
+    printProjectionHeader();
+
+    cg3::Timer timer("Step");
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (size_t n = PROJECTIONMINSIZE; n <= PROJECTIONMAXSIZE; n *= PROJECTIONSIZEFACTOR) {
+        IndexedIntBipartiteGraph graph;
+        randomProjectionGraph(graph, n, n / PROJECTIONRIGHTFACTOR, n * PROJECTIONDEGREE, rng);
+        graph.build();
+
+        //Two-hop queries of all the left nodes, deduplicated with a set
+        timer.start();
+        size_t expectedNeighbors = 0;
+        for (size_t u = 0; u < graph.leftIdBound(); u++) {
+            std::set<size_t> neighborSet;
+            for (size_t v : graph.adjacentRightNodes(u)) {
+                for (size_t w : graph.adjacentLeftNodes(v)) {
+                    if (w != u)
+                        neighborSet.insert(w);
+                }
+            }
+            expectedNeighbors += neighborSet.size();
+        }
+        timer.stop();
+
+        printProjectionRow("SET", graph, 1, timer.delay(), expectedNeighbors);
+
+        //Two-hop queries of all the left nodes, deduplicated with the bitset
+        cg3::TwoHopQuery<int, int> twoHop(graph);
+        std::vector<size_t> neighbors;
+
+        timer.start();
+        size_t numNeighbors = 0;
+        for (size_t u = 0; u < graph.leftIdBound(); u++)
+            numNeighbors += twoHop.leftNeighbors(u, neighbors);
+        timer.stop();
+
+        assert(numNeighbors == expectedNeighbors);
+
+        printProjectionRow("BITSET", graph, 1, timer.delay(), numNeighbors);
+
+        //Projection on the left nodes
+        std::vector<std::pair<size_t, size_t>> edges;
+        std::vector<double> weights;
+        for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+            timer.start();
+            size_t numEdges = cg3::leftProjection(graph, edges, weights, nThreads);
+            timer.stop();
+
+            assert(numEdges * 2 == expectedNeighbors);
+
+            printProjectionRow("PROJECTION", graph, nThreads, timer.delay(), numEdges);
+
+            if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+                nThreads = maxThreads / 2;
+        }
+
+        //Projection of a cg3::BipartiteGraph, with the insertion in the cg3::Graph
+        if (n <= PROJECTIONGRAPHMAXSIZE) {
+            IntBipartiteGraph bigraph;
+            for (size_t u = 0; u < graph.leftIdBound(); u++)
+                bigraph.addLeftNode(graph.leftValue(u));
+            for (size_t v = 0; v < graph.rightIdBound(); v++)
+                bigraph.addRightNode(graph.rightValue(v));
+            for (size_t u = 0; u < graph.leftIdBound(); u++) {
+                for (size_t v : graph.adjacentRightNodes(u))
+                    bigraph.addArc(graph.leftValue(u), graph.rightValue(v));
+            }
+
+            timer.start();
+            cg3::Graph<int> projection = cg3::leftProjection(bigraph, maxThreads);
+            timer.stop();
+
+            assert(projection.numNodes() == n);
+
+            printProjectionRow("CG3-GRAPH", graph, maxThreads, timer.delay(), edges.size());
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+
+/* ----- UTILITY FUNCTIONS ----- */
+
+void printIndexedHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "API" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "ARCS" <<
+         std::setw(INDENTSPACE) << std::left << "INS-N" <<
+         std::setw(INDENTSPACE) << std::left << "INS-A" <<
+         std::setw(INDENTSPACE) << std::left << "VISIT" <<
+         std::setw(INDENTSPACE) << std::left << "MISSES" <<
+         std::endl << std::endl;
+}
+
+void printIndexedRow(const std::string& name, double nodeTime, double arcTime, double visitTime, double missTime) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << INDEXEDLEFTSIZE + INDEXEDRIGHTSIZE;
+    std::cout << std::setw(INDENTSPACE) << std::left << INDEXEDARCS;
+    std::cout << std::setw(INDENTSPACE) << std::left << nodeTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << arcTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << visitTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << missTime;
+    std::cout << std::endl;
+}
+
+/*
+ * Check that a bipartite graph and an indexed bipartite graph have the
+ * same nodes and the same arcs
+ */
+template <class T1, class T2>
+bool sameGraph(const cg3::BipartiteGraph<T1, T2>& graph, const cg3::IndexedBipartiteGraph<T1, T2>& indexedGraph)
+{
+    if (graph.sizeLeftNodes() != indexedGraph.numLeftNodes() || graph.sizeRightNodes() != indexedGraph.numRightNodes())
+        return false;
+
+    size_t numArcs = 0;
+    for (const T1& u : graph.leftNodeIterator()) {
+        size_t uId;
+        if (!indexedGraph.tryFindLeftNode(u, uId))
+            return false;
+
+        for (const T2& v : graph.adjacentLeftNodeIterator(u)) {
+            size_t vId;
+            if (!indexedGraph.tryFindRightNode(v, vId) || !indexedGraph.isAdjacent(uId, vId))
+                return false;
+            numArcs++;
+        }
+    }
+
+    return numArcs == indexedGraph.numArcs();
+}
+
+
+void printDeletionHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "API" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "ARCS" <<
+         std::setw(INDENTSPACE) << std::left << "DELETED" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "REMAINING" <<
+         std::endl << std::endl;
+}
+
+void printDeletionRow(const std::string& name, size_t deleted, double time, size_t numArcs) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << DELETIONSIZE * 2;
+    std::cout << std::setw(INDENTSPACE) << std::left << DELETIONARCS;
+    std::cout << std::setw(INDENTSPACE) << std::left << deleted;
+    std::cout << std::setw(INDENTSPACE) << std::left << time;
+    std::cout << std::setw(INDENTSPACE) << std::left << numArcs;
+    std::cout << std::endl;
+}
+
+
+void printMatchingHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "METHOD" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "DEGREE" <<
+         std::setw(INDENTSPACE) << std::left << "THREADS" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "MATCHING" <<
+         std::endl << std::endl;
+}
+
+void printMatchingRow(const std::string& name, size_t n, size_t degree, unsigned int nThreads, double time, size_t size) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << n;
+    std::cout << std::setw(INDENTSPACE) << std::left << degree;
+    std::cout << std::setw(INDENTSPACE) << std::left << nThreads;
+    std::cout << std::setw(INDENTSPACE) << std::left << time;
+    std::cout << std::setw(INDENTSPACE) << std::left << size;
+    std::cout << std::endl;
+}
+
+/*
+ * Check that the matches are arcs of the graph, that they are consistent
+ * in the two directions and that they are the given number
+ */
+bool validMatching(
+        const IndexedIntBipartiteGraph& graph,
+        const std::vector<size_t>& leftMatches,
+        const std::vector<size_t>& rightMatches,
+        size_t size)
+{
+    const size_t notFound = IndexedIntBipartiteGraph::NOT_FOUND;
+
+    size_t count = 0;
+    for (size_t u = 0; u < graph.leftIdBound(); u++) {
+        size_t v = leftMatches[u];
+        if (v == notFound)
+            continue;
+        if (!graph.isAdjacent(u, v) || rightMatches[v] != u)
+            return false;
+        count++;
+    }
+
+    size_t rightCount = graph.rightIdBound() - std::count(rightMatches.begin(), rightMatches.end(), notFound);
+
+    return count == size && rightCount == size;
+}
+
+/*
+ * Size of the maximum matching with an augmenting path search from each
+ * left node (quadratic, for small graphs)
+ */
+size_t referenceMatchingSize(const IndexedIntBipartiteGraph& graph)
+{
+    std::vector<size_t> rightMatches(graph.rightIdBound(), IndexedIntBipartiteGraph::NOT_FOUND);
+
+    size_t size = 0;
+    for (size_t u = 0; u < graph.leftIdBound(); u++) {
+        std::vector<bool> visited(graph.rightIdBound(), false);
+        if (augmentingPath(graph, u, rightMatches, visited))
+            size++;
+    }
+
+    return size;
+}
+
+bool augmentingPath(
+        const IndexedIntBipartiteGraph& graph,
+        size_t u,
+        std::vector<size_t>& rightMatches,
+        std::vector<bool>& visited)
+{
+    for (size_t v : graph.adjacentRightNodes(u)) {
+        if (visited[v])
+            continue;
+        visited[v] = true;
+
+        if (rightMatches[v] == IndexedIntBipartiteGraph::NOT_FOUND || augmentingPath(graph, rightMatches[v], rightMatches, visited)) {
+            rightMatches[v] = u;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void printAssignmentHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "METHOD" <<
+         std::setw(INDENTSPACE) << std::left << "LEFT" <<
+         std::setw(INDENTSPACE) << std::left << "RIGHT" <<
+         std::setw(INDENTSPACE) << std::left << "ARCS" <<
+         std::setw(INDENTSPACE) << std::left << "THREADS" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "COST" <<
+         std::endl << std::endl;
+}
+
+void printAssignmentRow(const std::string& name, const IndexedIntBipartiteGraph& graph, unsigned int nThreads, double time, double cost) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numLeftNodes();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numRightNodes();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numArcs();
+    std::cout << std::setw(INDENTSPACE) << std::left << nThreads;
+    std::cout << std::setw(INDENTSPACE) << std::left << time;
+    std::cout << std::setw(INDENTSPACE) << std::left << cost;
+    std::cout << std::endl;
+}
+
+/*
+ * Random graph with integer weights: complete if the degree is at least
+ * the number of right nodes, otherwise a random perfect matching (so an
+ * assignment exists) plus random arcs up to the given average degree
+ */
+void randomAssignmentGraph(IndexedIntBipartiteGraph& graph, size_t nLeft, size_t nRight, size_t degree, std::mt19937& rng)
+{
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distRight(0, nRight-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, ASSIGNMENTMAXWEIGHT);
+
+    std::vector<int> leftNumbers(nLeft);
+    std::vector<int> rightNumbers(nRight);
+    std::iota(leftNumbers.begin(), leftNumbers.end(), 0);
+    std::iota(rightNumbers.begin(), rightNumbers.end(), 0);
+    graph.addLeftNodes(leftNumbers);
+    graph.addRightNodes(rightNumbers);
+
+    std::vector<std::pair<size_t, size_t>> arcs;
+    if (degree >= nRight) {
+        for (size_t u = 0; u < nLeft; u++) {
+            for (size_t v = 0; v < nRight; v++)
+                arcs.push_back(std::make_pair(u, v));
+        }
+    }
+    else {
+        std::vector<size_t> permutation(nRight);
+        std::iota(permutation.begin(), permutation.end(), 0);
+        std::shuffle(permutation.begin(), permutation.end(), rng);
+        for (size_t u = 0; u < nLeft; u++) {
+            arcs.push_back(std::make_pair(u, permutation[u]));
+            for (size_t i = 1; i < degree; i++)
+                arcs.push_back(std::make_pair(u, distRight(rng)));
+        }
+    }
+
+    std::vector<double> weights(arcs.size());
+    for (double& weight : weights)
+        weight = distWeight(rng);
+
+    graph.addArcs(arcs, weights);
+}
+
+/*
+ * Cost of the minimum cost assignment with the brute force (exponential,
+ * for small graphs), MAX_WEIGHT if there is no assignment
+ */
+double referenceAssignmentCost(const IndexedIntBipartiteGraph& graph)
+{
+    std::vector<bool> assigned(graph.rightIdBound(), false);
+    return bruteForceAssignment(graph, 0, assigned);
+}
+
+double bruteForceAssignment(
+        const IndexedIntBipartiteGraph& graph,
+        size_t u,
+        std::vector<bool>& assigned)
+{
+    if (u == graph.leftIdBound())
+        return 0;
+    if (!graph.isValidLeft(u))
+        return bruteForceAssignment(graph, u + 1, assigned);
+
+    double best = IndexedIntBipartiteGraph::MAX_WEIGHT;
+
+    const double* weight = graph.adjacentRightWeights(u).begin();
+    for (size_t v : graph.adjacentRightNodes(u)) {
+        double arcWeight = *weight++;
+        if (assigned[v])
+            continue;
+
+        assigned[v] = true;
+        double cost = bruteForceAssignment(graph, u + 1, assigned);
+        assigned[v] = false;
+
+        if (cost != IndexedIntBipartiteGraph::MAX_WEIGHT)
+            best = std::min(best, arcWeight + cost);
+    }
+
+    return best;
+}
+
+
+void printProjectionHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "METHOD" <<
+         std::setw(INDENTSPACE) << std::left << "LEFT" <<
+         std::setw(INDENTSPACE) << std::left << "RIGHT" <<
+         std::setw(INDENTSPACE) << std::left << "ARCS" <<
+         std::setw(INDENTSPACE) << std::left << "THREADS" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "RESULTS" <<
+         std::endl << std::endl;
+}
+
+void printProjectionRow(const std::string& name, const IndexedIntBipartiteGraph& graph, unsigned int nThreads, double time, size_t size) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numLeftNodes();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numRightNodes();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numArcs();
+    std::cout << std::setw(INDENTSPACE) << std::left << nThreads;
+    std::cout << std::setw(INDENTSPACE) << std::left << time;
+    std::cout << std::setw(INDENTSPACE) << std::left << size;
+    std::cout << std::endl;
+}
+
+/*
+ * Random graph with the given number of random arcs (repeated arcs are
+ * stored once)
+ */
+void randomProjectionGraph(IndexedIntBipartiteGraph& graph, size_t nLeft, size_t nRight, size_t numArcs, std::mt19937& rng)
+{
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distLeft(0, nLeft-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distRight(0, nRight-1);
+
+    std::vector<int> leftNumbers(nLeft);
+    std::vector<int> rightNumbers(nRight);
+    std::iota(leftNumbers.begin(), leftNumbers.end(), 0);
+    std::iota(rightNumbers.begin(), rightNumbers.end(), 0);
+    graph.addLeftNodes(leftNumbers);
+    graph.addRightNodes(rightNumbers);
+
+    std::vector<std::pair<size_t, size_t>> arcs;
+    for (size_t i = 0; i < numArcs; i++)
+        arcs.push_back(std::make_pair(distLeft(rng), distRight(rng)));
+
+    graph.addArcs(arcs);
+}
+
+/*
+ * Number of right nodes adjacent to both the left nodes, intersecting
+ * their sorted adjacencies
+ */
+size_t commonRightNeighbors(const IndexedIntBipartiteGraph& graph, size_t u, size_t w)
+{
+    IndexedIntBipartiteGraph::AdjacentRange uRange = graph.adjacentRightNodes(u);
+    IndexedIntBipartiteGraph::AdjacentRange wRange = graph.adjacentRightNodes(w);
+
+    std::vector<size_t> common;
+    std::set_intersection(uRange.begin(), uRange.end(), wRange.begin(), wRange.end(), std::back_inserter(common));
+
+    return common.size();
+}
+
+}
@@ -0,0 +1,21 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef BIPARTITEGRAPHTEST_H
+#define BIPARTITEGRAPHTEST_H
+
+
+namespace BipartiteGraphTests {
+
+    void testCorrectness();
+    void testIndexedBipartiteGraph();
+    void testBulkDeletion();
+    void testMaximumMatching();
+    void testAssignment();
+    void testProjection();
+
+}
+
+
+#endif // BIPARTITEGRAPHTEST_H
@@ -5,6 +5,7 @@
  * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
  */
 #include "graphtest.h"
+#include "testdata.h"
 
 #include <iostream>
 #include <random>
@@ -12,15 +13,41 @@
 #include <iomanip>
 
 #include <vector>
+#include <list>
+#include <map>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <type_traits>
+#include <fstream>
 
 #include <cg3/data_structures/graphs/graph.h>
+#include <cg3/geometry/2d/point2d.h>
 #include <cg3/algorithms/graph_algorithms.h>
 
+#include "extensions/data_structures/graphs/compiled_graph.h"
+#include "extensions/data_structures/graphs/indexed_graph.h"
+#include "extensions/algorithms/compiled_graph_algorithms.h"
+#include "extensions/algorithms/graph_traversal.h"
+#include "extensions/algorithms/minimum_spanning_tree.h"
+#include "extensions/data_structures/graphs/binary_graph.h"
+#include "extensions/io/edge_list.h"
+#include "extensions/algorithms/dynamic_shortest_paths.h"
+#include "extensions/algorithms/graph_reordering.h"
+#include "extensions/algorithms/max_flow.h"
+
 #include <cg3/utilities/utils.h>
 
 #include <cg3/cg3lib.h>
 #include <cg3/utilities/timer.h>
 
+#ifdef CG3_DCEL_DEFINED
+#include <cg3/meshes/dcel/dcel.h>
+#endif
+
 #define ITERATION 3
 #define INDENTSPACE 12
 
@@ -29,6 +56,62 @@
 #define MAXEDGES INPUTSIZE*10
 #define MAXWEIGHT 100
 
+#define QUEUEINPUTSIZE (INPUTSIZE*10)
+#define QUEUEEDGES (QUEUEINPUTSIZE*10)
+#define QUEUESOURCES 100
+
+#define APSPEDGES (INPUTSIZE*10)
+#define APSPCHECKEDSOURCES 10
+
+#define GRIDSIZE 200
+#define SHORTESTPATHQUERIES 100
+#define SHORTESTPATHEPSILON 1e-9
+
+#define INDEXEDINPUTSIZE (INPUTSIZE*100)
+#define INDEXEDEDGES (INDEXEDINPUTSIZE*10)
+
+#define CHURNINPUTSIZE (INPUTSIZE*10)
+#define CHURNEDGESPERNODE 10
+#define CHURNOPERATIONS (CHURNINPUTSIZE*10)
+#define CHURNCOMPACTIONPERIOD (CHURNOPERATIONS/10)
+
+#define TRAVERSALINPUTSIZE (INPUTSIZE*100)
+#define TRAVERSALEDGES (TRAVERSALINPUTSIZE*5)
+
+#define MSTINPUTSIZE (INPUTSIZE*100)
+#define MSTMINDENSITY 1
+#define MSTMAXDENSITY 16
+
+#define WEIGHTSINPUTSIZE (INPUTSIZE*100)
+#define WEIGHTSEDGES (WEIGHTSINPUTSIZE*10)
+#define WEIGHTSSOURCES 10
+
+#define COPYINPUTSIZE (INPUTSIZE*100)
+#define COPYEDGES (COPYINPUTSIZE*10)
+
+#define IOINPUTSIZE (INPUTSIZE*100)
+#define IOEDGES (IOINPUTSIZE*10)
+#define IOBINARYFILE "graphtest_graph.bin"
+#define IOTEXTFILE "graphtest_graph.txt"
+
+#define DYNAMICINPUTSIZE (INPUTSIZE*100)
+#define DYNAMICEDGES (DYNAMICINPUTSIZE*5)
+#define DYNAMICUPDATES 1000
+#define DYNAMICCHECKPERIOD 250
+
+#define EDGESCANINPUTSIZE (INPUTSIZE*100)
+#define EDGESCANEDGES (EDGESCANINPUTSIZE*10)
+
+#define REORDERGRIDSIZE 400
+#define REORDERSOURCES 10
+#define REORDERPARTS 32
+
+#define MAXFLOWMINGRID 64
+#define MAXFLOWMAXGRID 256
+#define MAXFLOWTERMINALFRACTION 0.05
+#define MAXFLOWTERMINALCAPACITY 1e9
+#define MAXFLOWEPSILON 1e-6
+
 
 
 namespace GraphTests {
@@ -37,6 +120,13 @@ namespace GraphTests {
 /* ----- TYPEDEFS ----- */
 
 typedef cg3::Graph<int> IntGraph;
+typedef cg3::CompiledGraph<int> CompiledIntGraph;
+typedef cg3::IndexedGraph<int> IndexedIntGraph;
+typedef cg3::Graph<cg3::Point2Dd> PointGraph;
+typedef cg3::CompiledGraph<cg3::Point2Dd> CompiledPointGraph;
+typedef cg3::CompiledGraph<int, float> FloatCompiledIntGraph;
+typedef cg3::CompiledGraph<int, int> IntegerCompiledIntGraph;
+typedef cg3::CompiledGraph<int, cg3::Unweighted> UnweightedCompiledIntGraph;
 
 
 /* ----- FUNCTION DECLARATION ----- */
@@ -46,6 +136,65 @@ void printHeader();
 
 void testDijkstra();
 
+void printQueueHeader();
+void printAllPairsHeader();
+void printAllPairsRow(const std::string& name, unsigned int nThreads, double time, double sequentialTime);
+
+template <class Queue>
+double testDijkstraQueue(
+        const CompiledIntGraph& graph,
+        const std::vector<std::vector<double>>& expectedDistances);
+
+double zeroHeuristic(const int& node, const int& destination);
+
+void printShortestPathHeader();
+void printShortestPathRow(const std::string& name, double time, double dijkstraTime, double cost);
+
+void printIndexedHeader();
+void printIndexedRow(const std::string& name, double nodeTime, double edgeTime, double adjacencyTime);
+
+void printCompactionHeader();
+
+bool samePartition(const std::vector<size_t>& labels1, const std::vector<size_t>& labels2);
+void printMSTHeader();
+
+void printWeightsHeader();
+
+template <class W>
+void testWeightType(
+        const std::string& name,
+        const IndexedIntGraph& graph,
+        const std::vector<size_t>& sources,
+        std::vector<double>& expectedDistances);
+
+void printCopyHeader();
+void printCopyRow(const std::string& name, double copyTime, double moveTime);
+
+bool sameCompiledGraph(const CompiledIntGraph& graph1, const CompiledIntGraph& graph2);
+void patchBinaryFile(const std::string& filename, size_t position, uint64_t value);
+
+void printDynamicHeader();
+bool sameDistances(const IndexedIntGraph& graph, const cg3::DynamicShortestPaths<int>& shortestPaths);
+
+void printReorderingHeader();
+double averageEdgeGap(const CompiledIntGraph& graph);
+
+void printMaxFlowHeader();
+double testMaxFlowGraph(const std::string& name, const CompiledIntGraph& graph, size_t source, size_t sink);
+double cutCapacity(const CompiledIntGraph& graph, const std::vector<bool>& sourceSide);
+#ifdef CG3_DCEL_DEFINED
+CompiledIntGraph meshFlowGraph(const std::string& fileName, size_t& source, size_t& sink);
+#endif
+
+void referenceBFS(const CompiledIntGraph& graph, size_t source, std::vector<size_t>& levels);
+size_t referenceComponents(const CompiledIntGraph& graph, std::vector<size_t>& components);
+void testCompactionPolicy(
+        const std::string& name,
+        double maxTombstoneRatio,
+        size_t stepSize,
+        size_t compactionPeriod,
+        unsigned int seed);
+
 
 /* ----- IMPLEMENTATION ----- */
 
@@ -232,6 +381,604 @@ void testCorrectness() {
         assert(n == 4);
     }
     assert(number == 1);
+
+
+    //Test compiled graph
+    cg3::Graph<int> weightedGraph;
+    for (int i = 0; i < 6; i++)
+        weightedGraph.addNode(i*10);
+    weightedGraph.addEdge(0, 10, 7);
+    weightedGraph.addEdge(0, 20, 9);
+    weightedGraph.addEdge(0, 50, 14);
+    weightedGraph.addEdge(10, 20, 10);
+    weightedGraph.addEdge(10, 30, 15);
+    weightedGraph.addEdge(20, 30, 11);
+    weightedGraph.addEdge(20, 50, 2);
+    weightedGraph.addEdge(30, 40, 6);
+    weightedGraph.addEdge(50, 40, 9);
+
+    CompiledIntGraph compiledGraph = cg3::compile(weightedGraph);
+    assert(compiledGraph.numNodes() == weightedGraph.numNodes());
+    assert(compiledGraph.numEdges() == weightedGraph.numEdges());
+    assert(compiledGraph.index(25) == CompiledIntGraph::NOT_FOUND);
+
+    for (size_t i = 0; i < compiledGraph.numNodes(); i++) {
+        for (size_t e = compiledGraph.edgeBegin(i); e < compiledGraph.edgeEnd(i); e++) {
+            const int& source = compiledGraph.value(i);
+            const int& target = compiledGraph.value(compiledGraph.target(e));
+            CG3_SUPPRESS_WARNING(source);
+            CG3_SUPPRESS_WARNING(target);
+            assert(weightedGraph.isAdjacent(source, target));
+            assert(weightedGraph.getWeight(source, target) == compiledGraph.weight(e));
+        }
+    }
+
+    cg3::DijkstraResult<int> graphResult = cg3::dijkstra(weightedGraph, 0);
+    cg3::DijkstraResult<int> compiledResult = cg3::dijkstra(compiledGraph, 0);
+    assert(graphResult.size() == compiledResult.size());
+    for (const std::pair<const int, cg3::GraphPath<int>>& entry : graphResult) {
+        CG3_SUPPRESS_WARNING(entry);
+        assert(compiledResult[entry.first].cost == entry.second.cost);
+    }
+
+    cg3::GraphPath<int> compiledPath = cg3::dijkstra(compiledGraph, 0, 40);
+    assert(compiledPath.cost == 20);
+    assert(compiledPath.path == std::list<int>({0, 20, 50, 40}));
+    assert(cg3::dijkstra(compiledGraph, 40, 0).path.empty());
+
+    //Test weight types of compiled graph
+    FloatCompiledIntGraph floatGraph = cg3::compile<float>(weightedGraph);
+    IntegerCompiledIntGraph integerGraph = cg3::compile<int>(weightedGraph);
+    UnweightedCompiledIntGraph unweightedGraph = cg3::compile<cg3::Unweighted>(weightedGraph);
+    assert(floatGraph.maxWeight() == 15);
+    assert(cg3::dijkstra(floatGraph, 0, 40).cost == 20);
+    assert(cg3::dijkstra(integerGraph, 0, 40).path == std::list<int>({0, 20, 50, 40}));
+    assert(unweightedGraph.weight(0) == 1);
+    assert(unweightedGraph.maxWeight() == 1);
+    assert(cg3::dijkstra(unweightedGraph, 0, 40).path == std::list<int>({0, 50, 40}));
+    assert(cg3::shortestPath(unweightedGraph, 0, 30).cost == 2);
+    assert(cg3::EdgeWeights<cg3::Unweighted>::WEIGHT_SIZE == 0);
+
+    IntegerCompiledIntGraph roundedGraph({1, 2}, {0, 1, 1}, {1}, {2.6});
+    assert(roundedGraph.weight(0) == 3);
+    assert(roundedGraph.reverseWeight(0) == 3);
+
+    //The integer key queues are replaced by a binary heap if the weights
+    //are not integers (they would truncate the distances)
+    CompiledIntGraph fractionalGraph({0, 1, 2}, {0, 2, 3, 3}, {1, 2, 2}, {0.6, 1.0, 0.3});
+    assert(!fractionalGraph.integerWeights());
+    assert(compiledGraph.integerWeights() && unweightedGraph.integerWeights());
+
+    std::vector<double> fractionalDistances;
+    std::vector<size_t> fractionalPredecessors;
+    cg3::DialQueue dialQueue;
+    cg3::RadixHeapQueue radixQueue;
+    cg3::dijkstra(fractionalGraph, 0, fractionalDistances, fractionalPredecessors, dialQueue);
+    assert(std::fabs(fractionalDistances[2] - 0.9) < 1e-9 && fractionalPredecessors[2] == 1);
+    cg3::dijkstra(fractionalGraph, 0, fractionalDistances, fractionalPredecessors, radixQueue);
+    assert(std::fabs(fractionalDistances[2] - 0.9) < 1e-9 && fractionalPredecessors[2] == 1);
+    assert(cg3::allPairsShortestPaths<cg3::DialQueue>(fractionalGraph, 2) == cg3::allPairsShortestPaths(fractionalGraph, 2));
+
+    //They are replaced by a radix heap or a binary heap if the weights are
+    //out of their range (too many buckets, or distances not exact)
+    CompiledIntGraph heavyGraph({0, 1, 2}, {0, 2, 3, 3}, {1, 2, 2}, {1e9, 3e9, 1});
+    assert(heavyGraph.integerWeights());
+    assert(!cg3::DialQueue::supportsMaxWeight(3, 1e9) && cg3::RadixHeapQueue::supportsMaxWeight(3, 1e9));
+    cg3::dijkstra(heavyGraph, 0, fractionalDistances, fractionalPredecessors, dialQueue);
+    assert(fractionalDistances[2] == 1e9 + 1 && fractionalPredecessors[2] == 1);
+    assert(cg3::allPairsShortestPaths<cg3::DialQueue>(heavyGraph, 2) == cg3::allPairsShortestPaths(heavyGraph, 2));
+
+    CompiledIntGraph hugeGraph({0, 1, 2}, {0, 2, 3, 3}, {1, 2, 2}, {1e30, 3e30, 1});
+    assert(!cg3::RadixHeapQueue::supportsMaxWeight(3, 3e30));
+    cg3::dijkstra(hugeGraph, 0, fractionalDistances, fractionalPredecessors, radixQueue);
+    assert(fractionalDistances[1] == 1e30 && fractionalPredecessors[2] == 1);
+
+    //Test point to point shortest paths
+    cg3::GraphPath<int> bidirectionalPath = cg3::shortestPath(compiledGraph, 0, 40);
+    assert(bidirectionalPath.cost == 20);
+    assert(bidirectionalPath.path == std::list<int>({0, 20, 50, 40}));
+    assert(cg3::shortestPath(weightedGraph, 0, 40).cost == 20);
+    assert(cg3::shortestPath(compiledGraph, 40, 0).path.empty());
+    assert(cg3::shortestPath(compiledGraph, 10, 10).path == std::list<int>({10}));
+
+    cg3::GraphPath<int> aStarPath = cg3::aStar(compiledGraph, 0, 40, zeroHeuristic);
+    assert(aStarPath.cost == 20);
+    assert(aStarPath.path == std::list<int>({0, 20, 50, 40}));
+    assert(cg3::aStar(weightedGraph, 0, 40, zeroHeuristic).cost == 20);
+    assert(cg3::aStar(compiledGraph, 40, 0, zeroHeuristic).path.empty());
+
+    CG3_SUPPRESS_WARNING(bidirectionalPath);
+    CG3_SUPPRESS_WARNING(aStarPath);
+
+
+    //Test indexed graph
+    IndexedIntGraph indexedGraph;
+    IndexedIntGraph::NodeId id0 = indexedGraph.addNode(0);
+    assert(id0 == 0);
+    assert(indexedGraph.addNode(0) == IndexedIntGraph::NOT_FOUND);
+
+    std::vector<IndexedIntGraph::NodeId> ids = indexedGraph.addNodes({30, 10, 10, 0, 20});
+    assert(ids == std::vector<IndexedIntGraph::NodeId>({1, 2, IndexedIntGraph::NOT_FOUND, IndexedIntGraph::NOT_FOUND, 3}));
+    assert(indexedGraph.numNodes() == 4);
+    assert(indexedGraph.findNode(10) == 2);
+    assert(indexedGraph.findNode(25) == IndexedIntGraph::NOT_FOUND);
+    assert(indexedGraph.value(1) == 30);
+
+    indexedGraph.addEdge(0, 2, 7);
+    indexedGraph.addEdges({{0, 3}, {2, 3}, {3, 1}, {0, 3}}, {9, 10, 11, 5});
+    assert(indexedGraph.numEdges() == 4);
+    assert(indexedGraph.isAdjacent(0, 3));
+    assert(!indexedGraph.isAdjacent(3, 0));
+    assert(indexedGraph.getWeight(0, 3) == 5);
+    assert(indexedGraph.getWeight(3, 0) == IntGraph::MAX_WEIGHT);
+
+    indexedGraph.setWeight(0, 3, 9);
+    assert(indexedGraph.getWeight(0, 3) == 9);
+    assert(indexedGraph.deleteEdge(2, 3));
+    assert(!indexedGraph.deleteEdge(2, 3));
+    assert(indexedGraph.outDegree(2) == 0);
+
+    assert(indexedGraph.deleteNode(3));
+    assert(!indexedGraph.isValid(3));
+    assert(indexedGraph.numNodes() == 3);
+    assert(indexedGraph.numEdges() == 1);
+    assert(indexedGraph.findNode(20) == IndexedIntGraph::NOT_FOUND);
+    assert(indexedGraph.findNode(30) == 1);
+
+    IndexedIntGraph undirectedIndexedGraph(IndexedIntGraph::UNDIRECTED);
+    undirectedIndexedGraph.addNodes({1, 2, 3});
+    undirectedIndexedGraph.addEdges({{0, 1}, {1, 2}}, {4, 6});
+    undirectedIndexedGraph.addEdge(2, 0, 1);
+    assert(undirectedIndexedGraph.numEdges() == 6);
+    assert(undirectedIndexedGraph.getWeight(2, 1) == 6);
+    undirectedIndexedGraph.setWeight(1, 0, 3);
+    assert(undirectedIndexedGraph.getWeight(0, 1) == 3);
+    undirectedIndexedGraph.deleteNode(1);
+    assert(undirectedIndexedGraph.numEdges() == 2);
+    assert(undirectedIndexedGraph.isAdjacent(0, 2));
+
+    IndexedIntGraph indexedWeightedGraph(weightedGraph);
+    assert(indexedWeightedGraph.numNodes() == weightedGraph.numNodes());
+    assert(indexedWeightedGraph.numEdges() == weightedGraph.numEdges());
+    CompiledIntGraph compiledIndexedGraph = cg3::compile(indexedWeightedGraph);
+    assert(cg3::dijkstra(compiledIndexedGraph, 0, 40).path == std::list<int>({0, 20, 50, 40}));
+
+    CG3_SUPPRESS_WARNING(id0);
+
+
+    //Test tombstones and compaction of indexed graph
+    IndexedIntGraph churnGraph;
+    churnGraph.setCompactionPolicy(1, 1);
+    churnGraph.addNodes({0, 1, 2, 3});
+    churnGraph.addEdges({{0, 3}, {1, 3}, {2, 3}, {3, 0}});
+
+    churnGraph.deleteNode(3);
+    assert(churnGraph.numEdges() == 0);
+    assert(churnGraph.numTombstoneEdges() == 3);
+    assert(churnGraph.numTombstoneNodes() == 1);
+    assert(!churnGraph.isAdjacent(0, 3));
+    assert(churnGraph.outDegree(0) == 0);
+    assert(churnGraph.adjacentEdges(0).begin() == churnGraph.adjacentEdges(0).end());
+
+    std::vector<IndexedIntGraph::NodeId> liveIds;
+    for (IndexedIntGraph::NodeId id : churnGraph.nodes())
+        liveIds.push_back(id);
+    assert(liveIds == std::vector<IndexedIntGraph::NodeId>({0, 1, 2}));
+
+    assert(churnGraph.addNode(4) == 4);
+    churnGraph.compact();
+    assert(churnGraph.numTombstoneEdges() == 0);
+    assert(churnGraph.numTombstoneNodes() == 0);
+    assert(churnGraph.compactionStats().removedEdges == 3);
+    assert(churnGraph.compactionStats().recycledIds == 1);
+
+    assert(churnGraph.addNode(5) == 3);
+    assert(churnGraph.findNode(5) == 3);
+    assert(churnGraph.numNodes() == 5);
+    assert(!churnGraph.isAdjacent(0, 3));
+    churnGraph.addEdge(1, 3, 2);
+    assert(churnGraph.numEdges() == 1);
+
+    //Test copy and move of indexed graph
+    static_assert(std::is_nothrow_move_constructible<IndexedIntGraph>::value, "IndexedGraph move must not throw");
+    static_assert(std::is_nothrow_move_assignable<IndexedIntGraph>::value, "IndexedGraph move must not throw");
+
+    IndexedIntGraph copiedGraph(churnGraph);
+    copiedGraph.addEdge(0, 1, 4);
+    copiedGraph.deleteEdge(1, 3);
+    assert(churnGraph.isAdjacent(1, 3));
+    assert(!churnGraph.isAdjacent(0, 1));
+    assert(!copiedGraph.isAdjacent(1, 3));
+    assert(copiedGraph.getWeight(0, 1) == 4);
+
+    IndexedIntGraph movedGraph(std::move(copiedGraph));
+    assert(copiedGraph.empty());
+    assert(movedGraph.numEdges() == 1);
+    assert(movedGraph.findNode(5) == 3);
+    copiedGraph = std::move(movedGraph);
+    assert(copiedGraph.isAdjacent(0, 1));
+
+    //Test value lookup of indexed graph across the merges of the values
+    IndexedIntGraph lookupGraph;
+    lookupGraph.setCompactionPolicy(1, 1);
+    for (int i = 0; i < 1000; i++)
+        assert(lookupGraph.addNode(999 - i) == static_cast<IndexedIntGraph::NodeId>(i));
+    assert(lookupGraph.addNode(500) == IndexedIntGraph::NOT_FOUND);
+    for (int i = 0; i < 1000; i += 2)
+        lookupGraph.deleteNode(lookupGraph.findNode(i));
+    lookupGraph.compact();
+    for (int i = 0; i < 1000; i++)
+        assert((lookupGraph.findNode(i) == IndexedIntGraph::NOT_FOUND) == (i % 2 == 0));
+    assert(lookupGraph.addNode(2000) < 1000);
+    std::vector<IndexedIntGraph::NodeId> lookupIds = lookupGraph.addNodes({3000, 1, 4});
+    assert(lookupIds[0] == lookupGraph.findNode(3000));
+    assert(lookupIds[1] == IndexedIntGraph::NOT_FOUND);
+    assert(lookupIds[2] == lookupGraph.findNode(4));
+    assert(lookupGraph.findNode(1) == 998);
+    assert(lookupGraph.findNode(2000) != IndexedIntGraph::NOT_FOUND);
+
+    IndexedIntGraph lookupCopy(lookupGraph);
+    assert(lookupCopy.findNode(2000) == lookupGraph.findNode(2000));
+    assert(lookupCopy.numNodes() == lookupGraph.numNodes());
+
+
+    //Test breadth first search and components
+    std::vector<size_t> levels, parents;
+    cg3::bfs(compiledGraph, compiledGraph.index(0), levels, parents);
+    assert(levels[compiledGraph.index(0)] == 0);
+    assert(levels[compiledGraph.index(50)] == 1);
+    assert(levels[compiledGraph.index(40)] == 2);
+    assert(parents[compiledGraph.index(0)] == CompiledIntGraph::NOT_FOUND);
+    assert(parents[compiledGraph.index(30)] != CompiledIntGraph::NOT_FOUND);
+    cg3::bfs(compiledGraph, compiledGraph.index(40), levels, parents);
+    assert(levels[compiledGraph.index(0)] == CompiledIntGraph::NOT_FOUND);
+
+    cg3::Graph<int> cyclicGraph;
+    for (int i = 1; i <= 7; i++)
+        cyclicGraph.addNode(i);
+    cyclicGraph.addEdge(1, 2);
+    cyclicGraph.addEdge(2, 3);
+    cyclicGraph.addEdge(3, 1);
+    cyclicGraph.addEdge(3, 4);
+    cyclicGraph.addEdge(4, 5);
+    cyclicGraph.addEdge(5, 4);
+    cyclicGraph.addEdge(6, 5);
+
+    std::vector<std::vector<int>> components = cg3::connectedComponents(cyclicGraph);
+    assert(components.size() == 2);
+    assert(components[1] == std::vector<int>({7}));
+
+    components = cg3::stronglyConnectedComponents(cyclicGraph);
+    assert(components.size() == 4);
+    std::vector<std::vector<int>> kosarajuComponents = cg3::stronglyConnectedComponents(cyclicGraph, cg3::KOSARAJU);
+    assert(kosarajuComponents.size() == 4);
+    for (std::vector<int>& component : components) {
+        std::sort(component.begin(), component.end());
+        if (component.front() == 1)
+            assert(component == std::vector<int>({1, 2, 3}));
+        if (component.front() == 4)
+            assert(component == std::vector<int>({4, 5}));
+    }
+
+    CompiledIntGraph compiledCyclicGraph = cg3::compile(cyclicGraph);
+    std::vector<size_t> tarjanLabels, kosarajuLabels;
+    cg3::stronglyConnectedComponents(compiledCyclicGraph, tarjanLabels, cg3::TARJAN);
+    cg3::stronglyConnectedComponents(compiledCyclicGraph, kosarajuLabels, cg3::KOSARAJU);
+    assert(samePartition(tarjanLabels, kosarajuLabels));
+
+
+    //Test minimum spanning tree
+    cg3::Graph<int> mstGraph(cg3::Graph<int>::UNDIRECTED);
+    for (int i = 1; i <= 8; i++)
+        mstGraph.addNode(i);
+    mstGraph.addEdge(1, 2, 1);
+    mstGraph.addEdge(2, 3, 2);
+    mstGraph.addEdge(1, 3, 3);
+    mstGraph.addEdge(3, 4, 1);
+    mstGraph.addEdge(4, 5, 5);
+    mstGraph.addEdge(3, 5, 4);
+    mstGraph.addEdge(7, 8, 2);
+
+    std::vector<cg3::SpanningTreeEdge<int>> kruskalTree = cg3::minimumSpanningTree(mstGraph, cg3::KRUSKAL);
+    std::vector<cg3::SpanningTreeEdge<int>> boruvkaTree = cg3::minimumSpanningTree(mstGraph, cg3::BORUVKA);
+    assert(kruskalTree.size() == 5);
+    assert(boruvkaTree.size() == 5);
+    assert(cg3::spanningTreeWeight(kruskalTree) == 10);
+    assert(cg3::spanningTreeWeight(boruvkaTree) == 10);
+    for (const cg3::SpanningTreeEdge<int>& edge : boruvkaTree) {
+        CG3_SUPPRESS_WARNING(edge);
+        assert(mstGraph.getWeight(edge.source, edge.target) == edge.weight);
+        assert(!(edge.source == 1 && edge.target == 3) && !(edge.source == 4 && edge.target == 5));
+    }
+
+
+    //Test binary graph files
+    bool saved = cg3::saveBinaryGraph(compiledGraph, IOBINARYFILE);
+    assert(saved);
+    CG3_SUPPRESS_WARNING(saved);
+
+    cg3::MappedGraph<int> mappedGraph(IOBINARYFILE);
+    assert(mappedGraph.isOpen());
+    assert(mappedGraph.numNodes() == compiledGraph.numNodes());
+    assert(mappedGraph.numEdges() == compiledGraph.numEdges());
+    assert(mappedGraph.maxWeight() == compiledGraph.maxWeight());
+    assert(mappedGraph.index(25) == cg3::MappedGraph<int>::NOT_FOUND);
+    for (size_t i = 0; i < mappedGraph.numNodes(); i++) {
+        assert(mappedGraph.index(mappedGraph.value(i)) == i);
+        assert(mappedGraph.outDegree(i) == compiledGraph.outDegree(i));
+        for (size_t e = mappedGraph.edgeBegin(i); e < mappedGraph.edgeEnd(i); e++) {
+            assert(mappedGraph.target(e) == compiledGraph.target(e));
+            assert(mappedGraph.weight(e) == compiledGraph.weight(e));
+        }
+    }
+    mappedGraph.close();
+
+    CompiledIntGraph loadedGraph;
+    bool loaded = cg3::loadBinaryGraph(IOBINARYFILE, loadedGraph);
+    assert(loaded);
+    assert(sameCompiledGraph(compiledGraph, loadedGraph));
+    assert(loadedGraph.inDegree(loadedGraph.index(40)) == 2);
+    assert(!cg3::loadBinaryGraph(IOTEXTFILE, loadedGraph));
+    assert(!cg3::MappedGraph<double>(IOBINARYFILE).isOpen());
+    assert(cg3::MappedGraph<int>(IOBINARYFILE).validate());
+
+    //Corrupt files: the header is 40 bytes (numNodes at 16, numEdges at
+    //24), then the offsets of the 6 nodes and the targets
+    patchBinaryFile(IOBINARYFILE, 16, (uint64_t) 1 << 61); //The size of the offsets overflows
+    assert(!cg3::MappedGraph<int>(IOBINARYFILE).isOpen());
+    patchBinaryFile(IOBINARYFILE, 16, compiledGraph.numNodes());
+    patchBinaryFile(IOBINARYFILE, 24, ~(uint64_t) 0 / 8);
+    assert(!cg3::MappedGraph<int>(IOBINARYFILE).isOpen());
+    patchBinaryFile(IOBINARYFILE, 24, compiledGraph.numEdges());
+
+    patchBinaryFile(IOBINARYFILE, 96, 1000); //Target out of range
+    assert(cg3::MappedGraph<int>(IOBINARYFILE).isOpen());
+    assert(!cg3::MappedGraph<int>(IOBINARYFILE).validate());
+    assert(cg3::MappedGraph<int>(IOBINARYFILE).toCompiledGraph().empty());
+    assert(!cg3::loadBinaryGraph(IOBINARYFILE, loadedGraph));
+    patchBinaryFile(IOBINARYFILE, 96, compiledGraph.target(0));
+    assert(cg3::loadBinaryGraph(IOBINARYFILE, loadedGraph));
+
+    patchBinaryFile(IOBINARYFILE, 48, 1000); //Decreasing offsets
+    assert(!cg3::loadBinaryGraph(IOBINARYFILE, loadedGraph));
+    patchBinaryFile(IOBINARYFILE, 48, compiledGraph.edgeBegin(1));
+    assert(cg3::loadBinaryGraph(IOBINARYFILE, loadedGraph));
+
+    //Sorted indices out of order: the first one is the largest value
+    std::ifstream binaryFile(IOBINARYFILE, std::ios::binary | std::ios::ate);
+    size_t sortedPosition = static_cast<size_t>(binaryFile.tellg()) - 8 * compiledGraph.numNodes();
+    binaryFile.close();
+    size_t largestNode = 0;
+    for (size_t i = 0; i < compiledGraph.numNodes(); i++) {
+        if (compiledGraph.value(largestNode) < compiledGraph.value(i))
+            largestNode = i;
+    }
+    patchBinaryFile(IOBINARYFILE, sortedPosition, largestNode);
+    assert(!cg3::MappedGraph<int>(IOBINARYFILE).validate());
+    assert(!cg3::loadBinaryGraph(IOBINARYFILE, loadedGraph));
+
+    std::vector<size_t> mappedIndices = {mappedGraph.index(10), cg3::MappedGraph<int>::NOT_FOUND};
+    assert(std::find(mappedIndices.begin(), mappedIndices.end(), cg3::MappedGraph<int>::NOT_FOUND) != mappedIndices.end());
+
+    CG3_SUPPRESS_WARNING(loaded);
+    std::remove(IOBINARYFILE);
+
+    //Test edge lists
+    std::ofstream textFile(IOTEXTFILE);
+    textFile << "# Directed graph" << std::endl;
+    textFile << "10 20 1.5" << std::endl;
+    textFile << "  20\t30" << std::endl;
+    textFile << std::endl;
+    textFile << "% comment" << std::endl;
+    textFile << "30,10,2" << std::endl;
+    textFile << "10 20 3";
+    textFile.close();
+
+    IndexedIntGraph edgeListGraph;
+    edgeListGraph.addNode(30);
+    loaded = cg3::loadEdgeList(IOTEXTFILE, edgeListGraph);
+    assert(loaded);
+    assert(edgeListGraph.numNodes() == 3);
+    assert(edgeListGraph.numEdges() == 3);
+    assert(edgeListGraph.findNode(30) == 0);
+    assert(edgeListGraph.getWeight(edgeListGraph.findNode(10), edgeListGraph.findNode(20)) == 3);
+    assert(edgeListGraph.getWeight(edgeListGraph.findNode(20), edgeListGraph.findNode(30)) == 0);
+    assert(edgeListGraph.getWeight(edgeListGraph.findNode(30), edgeListGraph.findNode(10)) == 2);
+
+    textFile.open(IOTEXTFILE);
+    textFile << "%%MatrixMarket matrix coordinate real general" << std::endl;
+    textFile << "3 3 2" << std::endl;
+    textFile << "1 2 0.5" << std::endl;
+    textFile << "2 3 1.5" << std::endl;
+    textFile.close();
+
+    IndexedIntGraph matrixMarketGraph;
+    loaded = cg3::loadEdgeList(IOTEXTFILE, matrixMarketGraph, cg3::MATRIX_MARKET, 3);
+    assert(loaded);
+    assert(matrixMarketGraph.numNodes() == 3);
+    assert(matrixMarketGraph.numEdges() == 2);
+    assert(matrixMarketGraph.getWeight(matrixMarketGraph.findNode(2), matrixMarketGraph.findNode(3)) == 1.5);
+
+    textFile.open(IOTEXTFILE);
+    textFile << "1 2" << std::endl << "3" << std::endl;
+    textFile.close();
+    IndexedIntGraph malformedGraph;
+    assert(!cg3::loadEdgeList(IOTEXTFILE, malformedGraph));
+    assert(!cg3::loadEdgeList(IOTEXTFILE, malformedGraph, cg3::EDGE_LIST, 16));
+    assert(malformedGraph.numNodes() == 0);
+
+    //More threads than bytes
+    textFile.open(IOTEXTFILE);
+    textFile << "1 2" << std::endl;
+    textFile.close();
+    IndexedIntGraph shortGraph;
+    assert(cg3::loadEdgeList(IOTEXTFILE, shortGraph, cg3::EDGE_LIST, 16));
+    assert(shortGraph.numEdges() == 1);
+    std::remove(IOTEXTFILE);
+
+
+    //Test dynamic shortest paths
+    IndexedIntGraph dynamicGraph;
+    dynamicGraph.addNodes(std::vector<int>({0, 1, 2, 3, 4}));
+    dynamicGraph.addEdge(0, 1, 1);
+    dynamicGraph.addEdge(1, 2, 1);
+    dynamicGraph.addEdge(0, 2, 5);
+    dynamicGraph.addEdge(2, 3, 1);
+    dynamicGraph.addEdge(3, 4, 1);
+
+    cg3::DynamicShortestPaths<int> dynamicPaths(dynamicGraph, 0);
+    assert(dynamicPaths.distances() == std::vector<double>({0, 1, 2, 3, 4}));
+    assert(dynamicPaths.numAffectedNodes() == 5);
+
+    dynamicPaths.setWeight(1, 2, 10);
+    assert(dynamicPaths.distances() == std::vector<double>({0, 1, 5, 6, 7}));
+    assert(dynamicPaths.predecessor(2) == 0);
+    assert(dynamicPaths.numAffectedNodes() == 3);
+
+    dynamicPaths.addEdge(1, 3, 1);
+    assert(dynamicPaths.distances() == std::vector<double>({0, 1, 5, 2, 3}));
+    assert(dynamicPaths.numAffectedNodes() == 2);
+
+    dynamicPaths.setWeight(0, 2, 7);
+    assert(dynamicPaths.distance(2) == 7);
+    assert(dynamicPaths.numAffectedNodes() == 1);
+
+    assert(dynamicPaths.deleteEdge(0, 1));
+    assert(!dynamicPaths.deleteEdge(0, 1));
+    assert(!dynamicGraph.isAdjacent(0, 1));
+    assert(dynamicPaths.distance(1) == IntGraph::MAX_WEIGHT);
+    assert(dynamicPaths.distances() == std::vector<double>({0, IntGraph::MAX_WEIGHT, 7, 8, 9}));
+    assert(dynamicPaths.path(4) == std::vector<size_t>({0, 2, 3, 4}));
+    assert(dynamicPaths.path(1).empty());
+
+    size_t dynamicNode = dynamicGraph.addNode(5);
+    dynamicPaths.addEdge(4, dynamicNode, 0);
+    assert(dynamicPaths.distance(dynamicNode) == 9);
+    assert(sameDistances(dynamicGraph, dynamicPaths));
+
+    IndexedIntGraph undirectedDynamicGraph(IndexedIntGraph::UNDIRECTED);
+    undirectedDynamicGraph.addNodes(std::vector<int>({0, 1, 2}));
+    undirectedDynamicGraph.addEdge(0, 1, 1);
+    undirectedDynamicGraph.addEdge(1, 2, 1);
+    undirectedDynamicGraph.addEdge(0, 2, 3);
+
+    cg3::DynamicShortestPaths<int> undirectedDynamicPaths(undirectedDynamicGraph, 0);
+    undirectedDynamicPaths.deleteEdge(1, 0);
+    assert(undirectedDynamicPaths.distances() == std::vector<double>({0, 4, 3}));
+    undirectedDynamicPaths.setWeight(2, 0, 1);
+    assert(undirectedDynamicPaths.distances() == std::vector<double>({0, 2, 1}));
+    assert(sameDistances(undirectedDynamicGraph, undirectedDynamicPaths));
+
+
+    //Test edge iteration
+    IndexedIntGraph iterationGraph;
+    iterationGraph.addNodes(std::vector<int>({0, 1, 2, 3}));
+    iterationGraph.addEdge(0, 1, 1);
+    iterationGraph.addEdge(0, 2, 2);
+    iterationGraph.addEdge(2, 3, 3);
+    iterationGraph.addEdge(3, 1, 4);
+    iterationGraph.addEdge(1, 0, 5);
+    iterationGraph.deleteNode(2);
+
+    std::vector<double> iteratedWeights;
+    for (IndexedIntGraph::EdgeHandle edge : iterationGraph.edges()) {
+        assert(iterationGraph.getWeight(edge.source, edge.target) == edge.weight);
+        iteratedWeights.push_back(edge.weight);
+    }
+    assert(iteratedWeights == std::vector<double>({1, 5, 4}));
+    assert(IndexedIntGraph().edges().begin() == IndexedIntGraph().edges().end());
+
+    std::vector<double> sourceWeights(iterationGraph.idBound(), 0);
+    iterationGraph.forEachEdge([&] (size_t source, size_t target, double weight) {
+        CG3_SUPPRESS_WARNING(target);
+        sourceWeights[source] += weight;
+    }, 2);
+    assert(sourceWeights == std::vector<double>({1, 5, 0, 4}));
+
+    CompiledIntGraph compiledIterationGraph = cg3::compile(iterationGraph);
+    std::vector<double> compiledSourceWeights(compiledIterationGraph.numNodes(), 0);
+    compiledIterationGraph.forEachEdge([&] (size_t source, size_t target, double weight) {
+        CG3_SUPPRESS_WARNING(target);
+        assert(compiledIterationGraph.value(source) != 2 && compiledIterationGraph.value(target) != 2);
+        compiledSourceWeights[source] += weight;
+    }, 2);
+    assert(compiledSourceWeights == std::vector<double>({1, 5, 4}));
+
+
+    //Test reordering
+    cg3::Graph<int> pathGraph(cg3::Graph<int>::UNDIRECTED);
+    for (int value : {3, 5, 1, 4, 2})
+        pathGraph.addNode(value);
+    for (int i = 1; i < 5; i++)
+        pathGraph.addEdge(i, i + 1, i);
+
+    for (cg3::NodeOrdering ordering : {cg3::BFS_ORDER, cg3::REVERSE_CUTHILL_MCKEE}) {
+        CompiledIntGraph pathCompiledGraph = cg3::reorder(pathGraph, ordering);
+        assert(pathCompiledGraph.numEdges() == 8);
+        assert(averageEdgeGap(pathCompiledGraph) <= (ordering == cg3::BFS_ORDER ? 2 : 1));
+        for (size_t i = 0; i < pathCompiledGraph.numNodes(); i++) {
+            for (size_t e = pathCompiledGraph.edgeBegin(i); e < pathCompiledGraph.edgeEnd(i); e++) {
+                CG3_SUPPRESS_WARNING(e);
+                assert(pathGraph.getWeight(pathCompiledGraph.value(i), pathCompiledGraph.value(pathCompiledGraph.target(e))) == pathCompiledGraph.weight(e));
+            }
+        }
+    }
+
+    CompiledIntGraph degreeOrderGraph = cg3::reorder(pathGraph, cg3::DEGREE_ORDER);
+    assert(degreeOrderGraph.outDegree(0) == 2 && degreeOrderGraph.outDegree(4) == 1);
+    assert(degreeOrderGraph.index(1) > 2 && degreeOrderGraph.index(5) > 2);
+
+    IntGraph cliquesGraph(IntGraph::UNDIRECTED);
+    for (int i = 0; i < 8; i++)
+        cliquesGraph.addNode(i);
+    for (int i = 0; i < 8; i++) {
+        for (int j = i + 1; j < 8; j++) {
+            if (i / 4 == j / 4)
+                cliquesGraph.addEdge(i, j, 1);
+        }
+    }
+    cliquesGraph.addEdge(3, 4, 1);
+
+    CompiledIntGraph compiledCliquesGraph = cg3::compile(cliquesGraph);
+    std::vector<size_t> cliquesParts = cg3::partitionGraph(compiledCliquesGraph, 2);
+    assert(cg3::edgeCut(compiledCliquesGraph, cliquesParts) == 2);
+    assert(std::count(cliquesParts.begin(), cliquesParts.end(), cliquesParts[0]) == 4);
+    assert(cg3::partitionGraph(compiledCliquesGraph, 1) == std::vector<size_t>(8, 0));
+
+
+    //Test maximum flow
+    IntGraph flowGraph;
+    for (int i = 0; i < 6; i++)
+        flowGraph.addNode(i);
+    flowGraph.addEdge(0, 1, 16);
+    flowGraph.addEdge(0, 2, 13);
+    flowGraph.addEdge(2, 1, 4);
+    flowGraph.addEdge(1, 3, 12);
+    flowGraph.addEdge(3, 2, 9);
+    flowGraph.addEdge(2, 4, 14);
+    flowGraph.addEdge(4, 3, 7);
+    flowGraph.addEdge(3, 5, 20);
+    flowGraph.addEdge(4, 5, 4);
+
+    for (cg3::MaxFlowAlgorithm algorithm : {cg3::PUSH_RELABEL, cg3::BOYKOV_KOLMOGOROV}) {
+        cg3::MaxFlowResult<int> flowResult = cg3::maxFlow(flowGraph, 0, 5, algorithm);
+        assert(flowResult.flow == 23);
+
+        std::sort(flowResult.sourceSide.begin(), flowResult.sourceSide.end());
+        assert(flowResult.sourceSide == std::vector<int>({0, 1, 2, 4}));
+        assert(flowResult.sinkSide.size() == 2);
+
+        std::vector<double> balances(6, 0);
+        for (const cg3::FlowEdge<int>& edge : flowResult.edgeFlows) {
+            assert(edge.flow <= flowGraph.getWeight(edge.source, edge.target));
+            balances[edge.source] -= edge.flow;
+            balances[edge.target] += edge.flow;
+        }
+        assert(balances == std::vector<double>({-23, 0, 0, 0, 0, 23}));
+    }
+
+    assert(cg3::maxFlow(flowGraph, 5, 0).flow == 0);
+    assert(cg3::maxFlow(flowGraph, 0, 10).sourceSide.empty());
 }
 
 
@@ -253,6 +1000,8 @@ void printHeader() {
          std::setw(INDENTSPACE) << std::left << "NODES" <<
          std::setw(INDENTSPACE) << std::left << "EDGES" <<
          std::setw(INDENTSPACE) << std::left << "DIJKSTRA" <<
+         std::setw(INDENTSPACE) << std::left << "COMPILE" <<
+         std::setw(INDENTSPACE) << std::left << "DIJKSTRA-C" <<
          std::setw(INDENTSPACE) << std::left << "COPY" <<
          std::setw(INDENTSPACE) << std::left << "DIJKSTRA" <<
          std::setw(INDENTSPACE) << std::left << "ERA-N-V" <<
@@ -477,6 +1226,36 @@ void testDijkstra()
 
 
 
+        /* Compile graph */
+
+        timer.start();
+
+        CompiledIntGraph compiledGraph = cg3::compile(graph);
+
+        timer.stop();
+
+        std::cout << std::setw(INDENTSPACE) << std::left;
+        std::cout << timer.delay();
+
+
+
+        /* Dijkstra (compiled graph) */
+
+        timer.start();
+
+        std::vector<double> distances;
+        std::vector<size_t> predecessors;
+        for (size_t n = 0; n < compiledGraph.numNodes(); n++) {
+            cg3::dijkstra(compiledGraph, n, distances, predecessors);
+        }
+
+        timer.stop();
+
+        std::cout << std::setw(INDENTSPACE) << std::left;
+        std::cout << timer.delay();
+
+
+
         /* Copy graph */
 
         timer.start();
@@ -624,4 +1403,1989 @@ void testDijkstra()
 
 }
 
+
+
+void printQueueHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "QUEUE" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "SOURCES" <<
+         std::setw(INDENTSPACE) << std::left << "DIJKSTRA" <<
+         std::setw(INDENTSPACE) << std::left << "SPEEDUP" <<
+         std::endl << std::endl;
+}
+
+
+void testDijkstraQueues()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, QUEUEINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    //Random graph with integer weights
+    IntGraph graph;
+    for (int i = 0; i < QUEUEINPUTSIZE; i++) {
+        graph.addNode(i);
+    }
+    for (int i = 0; i < QUEUEEDGES; i++) {
+        graph.addEdge((int) distNode(rng), (int) distNode(rng), distWeight(rng));
+    }
+
+    CompiledIntGraph compiledGraph = cg3::compile(graph);
+
+    //Expected distances (binary heap)
+    std::vector<std::vector<double>> expectedDistances(QUEUESOURCES);
+    std::vector<size_t> predecessors;
+    for (size_t i = 0; i < QUEUESOURCES; i++) {
+        cg3::dijkstra(compiledGraph, i, expectedDistances[i], predecessors);
+    }
+
+    std::cout << std::endl << " ------ DIJKSTRA QUEUES ------ " << std::endl << std::endl;
+
+    printQueueHeader();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << "BINARY";
+    double binaryTime = testDijkstraQueue<cg3::BinaryHeapQueue>(compiledGraph, expectedDistances);
+    std::cout << std::setw(INDENTSPACE) << std::left << 1.0 << std::endl;
+
+    std::cout << std::setw(INDENTSPACE) << std::left << "4-ARY";
+    double time = testDijkstraQueue<cg3::QuaternaryHeapQueue>(compiledGraph, expectedDistances);
+    std::cout << std::setw(INDENTSPACE) << std::left << binaryTime / time << std::endl;
+
+    std::cout << std::setw(INDENTSPACE) << std::left << "RADIX";
+    time = testDijkstraQueue<cg3::RadixHeapQueue>(compiledGraph, expectedDistances);
+    std::cout << std::setw(INDENTSPACE) << std::left << binaryTime / time << std::endl;
+
+    std::cout << std::setw(INDENTSPACE) << std::left << "DIAL";
+    time = testDijkstraQueue<cg3::DialQueue>(compiledGraph, expectedDistances);
+    std::cout << std::setw(INDENTSPACE) << std::left << binaryTime / time << std::endl;
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Dijkstra from the first sources of the graph with a priority queue
+ * policy, checking the distances
+ */
+template <class Queue>
+double testDijkstraQueue(
+        const CompiledIntGraph& graph,
+        const std::vector<std::vector<double>>& expectedDistances)
+{
+    cg3::Timer timer("Step");
+
+    Queue queue;
+    std::vector<double> distances;
+    std::vector<size_t> predecessors;
+
+    double time = 0;
+
+    for (size_t i = 0; i < expectedDistances.size(); i++) {
+        timer.start();
+
+        cg3::dijkstra(graph, i, distances, predecessors, queue);
+
+        timer.stop();
+        time += timer.delay();
+
+        assert(distances == expectedDistances[i]);
+    }
+
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numNodes();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numEdges();
+    std::cout << std::setw(INDENTSPACE) << std::left << expectedDistances.size();
+    std::cout << std::setw(INDENTSPACE) << std::left << time;
+
+    return time;
+}
+
+
+
+void printAllPairsHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "ALGORITHM" <<
+         std::setw(INDENTSPACE) << std::left << "THREADS" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "SPEEDUP" <<
+         std::endl << std::endl;
+}
+
+void printAllPairsRow(const std::string& name, unsigned int nThreads, double time, double sequentialTime) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << nThreads;
+    std::cout << std::setw(INDENTSPACE) << std::left << time;
+    std::cout << std::setw(INDENTSPACE) << std::left << sequentialTime / time;
+    std::cout << std::endl;
+}
+
+
+void testAllPairsShortestPaths()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, INPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    //Random graph
+    IntGraph graph;
+    for (int i = 0; i < INPUTSIZE; i++) {
+        graph.addNode(i);
+    }
+    for (int i = 0; i < APSPEDGES; i++) {
+        graph.addEdge((int) distNode(rng), (int) distNode(rng), distWeight(rng));
+    }
+
+    CompiledIntGraph compiledGraph = cg3::compile(graph);
+
+    std::cout << std::endl << " ------ ALL PAIRS SHORTEST PATHS ------ " << std::endl << std::endl;
+
+    printAllPairsHeader();
+
+    cg3::Timer timer("Step");
+
+
+    /* Dijkstra from each node on the graph */
+
+    timer.start();
+
+    //Results of the first sources are kept for checking
+    std::vector<cg3::DijkstraResult<int>> graphResults;
+    for (IntGraph::NodeIterator it = graph.nodeBegin(); it != graph.nodeEnd(); it++) {
+        cg3::DijkstraResult<int> result = cg3::dijkstra(graph, *it);
+        if (graphResults.size() < APSPCHECKEDSOURCES)
+            graphResults.push_back(result);
+    }
+
+    timer.stop();
+
+    double graphTime = timer.delay();
+    printAllPairsRow("GRAPH", 1, graphTime, graphTime);
+
+
+    /* Dijkstra from each node on the compiled graph */
+
+    timer.start();
+
+    cg3::DistanceMatrix loopMatrix(compiledGraph.numNodes(), IntGraph::MAX_WEIGHT);
+    std::vector<double> distances;
+    std::vector<size_t> predecessors;
+    for (size_t i = 0; i < compiledGraph.numNodes(); i++) {
+        cg3::dijkstra(compiledGraph, i, distances, predecessors);
+        std::copy(distances.begin(), distances.end(), loopMatrix.row(i));
+    }
+
+    timer.stop();
+
+    printAllPairsRow("LOOP", 1, timer.delay(), graphTime);
+
+    //Check the compiled graph results with the graph results
+    for (size_t i = 0; i < graphResults.size(); i++) {
+        for (const std::pair<const int, cg3::GraphPath<int>>& entry : graphResults[i]) {
+            CG3_SUPPRESS_WARNING(entry);
+            assert(loopMatrix(i, compiledGraph.index(entry.first)) == entry.second.cost);
+        }
+    }
+
+
+    /* Parallel all pairs shortest paths and Floyd-Warshall */
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        timer.start();
+
+        cg3::DistanceMatrix matrix = cg3::allPairsShortestPaths(compiledGraph, nThreads);
+
+        timer.stop();
+
+        assert(matrix == loopMatrix);
+
+        printAllPairsRow("APSP", nThreads, timer.delay(), graphTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        timer.start();
+
+        cg3::DistanceMatrix matrix = cg3::allPairsShortestPaths<cg3::DialQueue>(compiledGraph, nThreads);
+
+        timer.stop();
+
+        assert(matrix == loopMatrix);
+
+        printAllPairsRow("APSP-DIAL", nThreads, timer.delay(), graphTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        timer.start();
+
+        cg3::DistanceMatrix matrix = cg3::floydWarshall(compiledGraph, nThreads);
+
+        timer.stop();
+
+        assert(matrix == loopMatrix);
+
+        printAllPairsRow("FLOYD", nThreads, timer.delay(), graphTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+    std::cout << std::endl;
+}
+
+
+
+void printShortestPathHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "ALGORITHM" <<
+         std::setw(INDENTSPACE) << std::left << "QUERIES" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "SPEEDUP" <<
+         std::setw(INDENTSPACE) << std::left << "AVG COST" <<
+         std::endl << std::endl;
+}
+
+void printShortestPathRow(const std::string& name, double time, double dijkstraTime, double cost) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << SHORTESTPATHQUERIES;
+    std::cout << std::setw(INDENTSPACE) << std::left << time;
+    std::cout << std::setw(INDENTSPACE) << std::left << dijkstraTime / time;
+    std::cout << std::setw(INDENTSPACE) << std::left << cost / SHORTESTPATHQUERIES;
+    std::cout << std::endl;
+}
+
+
+void testShortestPath()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, GRIDSIZE-1);
+    std::uniform_real_distribution<double>
+            distFactor(1.0, 2.0);
+
+    //Grid graph: weights are the lengths of the edges multiplied by a random factor
+    PointGraph graph;
+    for (int i = 0; i < GRIDSIZE; i++) {
+        for (int j = 0; j < GRIDSIZE; j++) {
+            graph.addNode(cg3::Point2Dd(i, j));
+        }
+    }
+    for (int i = 0; i < GRIDSIZE; i++) {
+        for (int j = 0; j < GRIDSIZE; j++) {
+            cg3::Point2Dd p(i, j);
+            if (i + 1 < GRIDSIZE) {
+                cg3::Point2Dd q(i + 1, j);
+                graph.addEdge(p, q, p.dist(q) * distFactor(rng));
+                graph.addEdge(q, p, p.dist(q) * distFactor(rng));
+            }
+            if (j + 1 < GRIDSIZE) {
+                cg3::Point2Dd q(i, j + 1);
+                graph.addEdge(p, q, p.dist(q) * distFactor(rng));
+                graph.addEdge(q, p, p.dist(q) * distFactor(rng));
+            }
+        }
+    }
+
+    CompiledPointGraph compiledGraph = cg3::compile(graph);
+
+    std::vector<std::pair<cg3::Point2Dd, cg3::Point2Dd>> queries;
+    for (int i = 0; i < SHORTESTPATHQUERIES; i++) {
+        queries.push_back(std::make_pair(
+                cg3::Point2Dd(distNode(rng), distNode(rng)),
+                cg3::Point2Dd(distNode(rng), distNode(rng))));
+    }
+
+    std::cout << std::endl << " ------ POINT TO POINT SHORTEST PATHS ------ " << std::endl << std::endl;
+
+    printShortestPathHeader();
+
+    cg3::Timer timer("Step");
+
+
+    /* Dijkstra (compiled graph) */
+
+    std::vector<double> expectedCosts;
+
+    timer.start();
+
+    for (const std::pair<cg3::Point2Dd, cg3::Point2Dd>& query : queries) {
+        expectedCosts.push_back(cg3::dijkstra(compiledGraph, query.first, query.second).cost);
+    }
+
+    timer.stop();
+
+    double dijkstraTime = timer.delay();
+    double totalCost = 0;
+    for (double cost : expectedCosts)
+        totalCost += cost;
+    printShortestPathRow("DIJKSTRA", dijkstraTime, dijkstraTime, totalCost);
+
+
+    /* Bidirectional Dijkstra */
+
+    std::vector<double> costs;
+
+    timer.start();
+
+    for (const std::pair<cg3::Point2Dd, cg3::Point2Dd>& query : queries) {
+        costs.push_back(cg3::shortestPath(compiledGraph, query.first, query.second).cost);
+    }
+
+    timer.stop();
+
+    totalCost = 0;
+    for (size_t i = 0; i < costs.size(); i++) {
+        assert(std::fabs(costs[i] - expectedCosts[i]) <= SHORTESTPATHEPSILON * std::max(1.0, expectedCosts[i]));
+        totalCost += costs[i];
+    }
+    printShortestPathRow("BIDIR", timer.delay(), dijkstraTime, totalCost);
+
+
+    /* A* with euclidean heuristic */
+
+    costs.clear();
+
+    timer.start();
+
+    for (const std::pair<cg3::Point2Dd, cg3::Point2Dd>& query : queries) {
+        costs.push_back(cg3::aStar(compiledGraph, query.first, query.second, cg3::EuclideanHeuristic()).cost);
+    }
+
+    timer.stop();
+
+    totalCost = 0;
+    for (size_t i = 0; i < costs.size(); i++) {
+        assert(std::fabs(costs[i] - expectedCosts[i]) <= SHORTESTPATHEPSILON * std::max(1.0, expectedCosts[i]));
+        totalCost += costs[i];
+    }
+    printShortestPathRow("ASTAR", timer.delay(), dijkstraTime, totalCost);
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Null heuristic: A* behaves as Dijkstra
+ */
+double zeroHeuristic(const int& node, const int& destination)
+{
+    CG3_SUPPRESS_WARNING(node);
+    CG3_SUPPRESS_WARNING(destination);
+    return 0;
+}
+
+
+
+void printIndexedHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "API" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "INS-N" <<
+         std::setw(INDENTSPACE) << std::left << "INS-E" <<
+         std::setw(INDENTSPACE) << std::left << "ADJ" <<
+         std::setw(INDENTSPACE) << std::left << "TOTAL" <<
+         std::endl << std::endl;
+}
+
+void printIndexedRow(const std::string& name, double nodeTime, double edgeTime, double adjacencyTime) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << INDEXEDINPUTSIZE;
+    std::cout << std::setw(INDENTSPACE) << std::left << INDEXEDEDGES;
+    std::cout << std::setw(INDENTSPACE) << std::left << nodeTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << edgeTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << adjacencyTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << nodeTime + edgeTime + adjacencyTime;
+    std::cout << std::endl;
+}
+
+
+void testIndexedGraph()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distIn(0, RANDOM_MAX*2);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, INDEXEDINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    //Random distinct values and random edges (as positions in the values)
+    std::vector<int> testNumbers;
+    while (testNumbers.size() < INDEXEDINPUTSIZE) {
+        for (int i = testNumbers.size(); i < INDEXEDINPUTSIZE; i++)
+            testNumbers.push_back((int) distIn(rng) * 10);
+        std::sort(testNumbers.begin(), testNumbers.end());
+        testNumbers.erase(std::unique(testNumbers.begin(), testNumbers.end()), testNumbers.end());
+    }
+    std::shuffle(testNumbers.begin(), testNumbers.end(), rng);
+
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    std::vector<double> testWeights;
+    for (int i = 0; i < INDEXEDEDGES; i++) {
+        testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+        testWeights.push_back(distWeight(rng));
+    }
+
+    std::cout << std::endl << " ------ INDEXED GRAPH ------ " << std::endl << std::endl;
+
+    printIndexedHeader();
+
+    cg3::Timer timer("Step");
+
+
+    /* Graph with values */
+
+    IntGraph graph;
+
+    timer.start();
+    for (int n : testNumbers) {
+        graph.addNode(n);
+    }
+    timer.stop();
+    double nodeTime = timer.delay();
+
+    timer.start();
+    for (size_t i = 0; i < testEdges.size(); i++) {
+        graph.addEdge(testNumbers[testEdges[i].first], testNumbers[testEdges[i].second], testWeights[i]);
+    }
+    timer.stop();
+    double edgeTime = timer.delay();
+
+    size_t graphAdjacent = 0;
+    timer.start();
+    for (size_t i = 0; i < testEdges.size(); i++) {
+        if (graph.isAdjacent(testNumbers[testEdges[i].second], testNumbers[testEdges[i].first]))
+            graphAdjacent++;
+    }
+    timer.stop();
+
+    printIndexedRow("VALUES", nodeTime, edgeTime, timer.delay());
+
+
+    /* Indexed graph, one node/edge at a time */
+
+    IndexedIntGraph indexedGraph;
+
+    timer.start();
+    std::vector<IndexedIntGraph::NodeId> ids;
+    for (int n : testNumbers) {
+        ids.push_back(indexedGraph.addNode(n));
+    }
+    timer.stop();
+    nodeTime = timer.delay();
+
+    timer.start();
+    for (size_t i = 0; i < testEdges.size(); i++) {
+        indexedGraph.addEdge(ids[testEdges[i].first], ids[testEdges[i].second], testWeights[i]);
+    }
+    timer.stop();
+    edgeTime = timer.delay();
+
+    size_t indexedAdjacent = 0;
+    timer.start();
+    for (size_t i = 0; i < testEdges.size(); i++) {
+        if (indexedGraph.isAdjacent(ids[testEdges[i].second], ids[testEdges[i].first]))
+            indexedAdjacent++;
+    }
+    timer.stop();
+
+    assert(indexedAdjacent == graphAdjacent);
+    assert(indexedGraph.numEdges() == graph.numEdges());
+
+    printIndexedRow("IDS", nodeTime, edgeTime, timer.delay());
+
+
+    /* Indexed graph, bulk insertion */
+
+    IndexedIntGraph bulkGraph;
+
+    timer.start();
+    ids = bulkGraph.addNodes(testNumbers);
+    timer.stop();
+    nodeTime = timer.delay();
+
+    timer.start();
+    bulkGraph.addEdges(testEdges, testWeights);
+    timer.stop();
+    edgeTime = timer.delay();
+
+    assert(bulkGraph.numEdges() == indexedGraph.numEdges());
+    for (IndexedIntGraph::NodeId id = 0; id < bulkGraph.idBound(); id++) {
+        assert(bulkGraph.value(id) == indexedGraph.value(id));
+        for (const IndexedIntGraph::Edge& edge : bulkGraph.adjacentEdges(id)) {
+            CG3_SUPPRESS_WARNING(edge);
+            assert(indexedGraph.getWeight(id, edge.target) == edge.weight);
+        }
+    }
+
+    printIndexedRow("BULK", nodeTime, edgeTime, 0);
+
+    std::cout << std::endl;
+
+    CG3_SUPPRESS_WARNING(graphAdjacent);
+    CG3_SUPPRESS_WARNING(indexedAdjacent);
+}
+
+
+
+void printCompactionHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "POLICY" <<
+         std::setw(INDENTSPACE) << std::left << "OPS" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "MAX-OP" <<
+         std::setw(INDENTSPACE) << std::left << "ID-BOUND" <<
+         std::setw(INDENTSPACE) << std::left << "STORED-E" <<
+         std::setw(INDENTSPACE) << std::left << "CYCLES" <<
+         std::endl << std::endl;
+}
+
+
+void testIndexedGraphCompaction()
+{
+    unsigned int seed = std::random_device()();
+
+    std::cout << std::endl << " ------ INDEXED GRAPH COMPACTION ------ " << std::endl << std::endl;
+
+    printCompactionHeader();
+
+    testCompactionPolicy("NONE", 2, 1, 0, seed);
+    testCompactionPolicy("FULL", 2, 1, CHURNCOMPACTIONPERIOD, seed);
+    testCompactionPolicy("INCREMENTAL", 0.25, 4096, 0, seed);
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Continuous deletion and insertion of nodes in a directed graph: each
+ * operation deletes a random node and adds a node with random outgoing and
+ * incoming edges. If compactionPeriod is not 0, a complete compaction is
+ * executed every compactionPeriod operations.
+ */
+void testCompactionPolicy(
+        const std::string& name,
+        double maxTombstoneRatio,
+        size_t stepSize,
+        size_t compactionPeriod,
+        unsigned int seed)
+{
+    std::mt19937 rng;
+    rng.seed(seed);
+
+    IndexedIntGraph graph;
+    graph.setCompactionPolicy(maxTombstoneRatio, stepSize);
+
+    std::vector<IndexedIntGraph::NodeId> liveIds;
+    for (int i = 0; i < CHURNINPUTSIZE; i++) {
+        liveIds.push_back(graph.addNode(i));
+    }
+    for (IndexedIntGraph::NodeId id : liveIds) {
+        for (int j = 0; j < CHURNEDGESPERNODE; j++) {
+            graph.addEdge(id, liveIds[rng() % liveIds.size()], 1);
+        }
+    }
+
+    cg3::Timer timer("Step");
+
+    double totalTime = 0;
+    double maxTime = 0;
+
+    for (int op = 0; op < CHURNOPERATIONS; op++) {
+        size_t position = rng() % liveIds.size();
+
+        timer.start();
+
+        graph.deleteNode(liveIds[position]);
+
+        IndexedIntGraph::NodeId id = graph.addNode(CHURNINPUTSIZE + op);
+        liveIds[position] = id;
+        for (int j = 0; j < CHURNEDGESPERNODE; j++) {
+            graph.addEdge(id, liveIds[rng() % liveIds.size()], 1);
+            graph.addEdge(liveIds[rng() % liveIds.size()], id, 1);
+        }
+
+        if (compactionPeriod > 0 && (op + 1) % compactionPeriod == 0)
+            graph.compact();
+
+        timer.stop();
+
+        totalTime += timer.delay();
+        maxTime = std::max(maxTime, timer.delay());
+    }
+
+    assert(graph.numNodes() == CHURNINPUTSIZE);
+
+    size_t numEdges = 0;
+    for (IndexedIntGraph::NodeId id : graph.nodes()) {
+        for (const IndexedIntGraph::Edge& edge : graph.adjacentEdges(id)) {
+            CG3_SUPPRESS_WARNING(edge);
+            assert(graph.isValid(edge.target));
+            numEdges++;
+        }
+    }
+    assert(numEdges == graph.numEdges());
+    CG3_SUPPRESS_WARNING(numEdges);
+
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << CHURNOPERATIONS;
+    std::cout << std::setw(INDENTSPACE) << std::left << totalTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << maxTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.idBound();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numEdges() + graph.numTombstoneEdges();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.compactionStats().numCycles;
+    std::cout << std::endl;
+}
+
+
+
+void testTraversal()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, TRAVERSALINPUTSIZE-1);
+
+    //Random undirected and directed graphs with the same edges
+    std::vector<int> testNumbers;
+    for (int i = 0; i < TRAVERSALINPUTSIZE; i++) {
+        testNumbers.push_back(i);
+    }
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    for (int i = 0; i < TRAVERSALEDGES; i++) {
+        testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+    }
+
+    IndexedIntGraph undirectedGraph(IndexedIntGraph::UNDIRECTED);
+    undirectedGraph.addNodes(testNumbers);
+    undirectedGraph.addEdges(testEdges);
+    CompiledIntGraph compiledUndirectedGraph = cg3::compile(undirectedGraph);
+
+    IndexedIntGraph directedGraph;
+    directedGraph.addNodes(testNumbers);
+    directedGraph.addEdges(testEdges);
+    CompiledIntGraph compiledDirectedGraph = cg3::compile(directedGraph);
+
+    std::cout << std::endl << " ------ TRAVERSAL AND COMPONENTS ------ " << std::endl << std::endl;
+
+    printAllPairsHeader();
+
+    cg3::Timer timer("Step");
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+
+    /* Breadth first search */
+
+    std::vector<size_t> expectedLevels;
+
+    timer.start();
+    referenceBFS(compiledUndirectedGraph, 0, expectedLevels);
+    timer.stop();
+
+    double referenceTime = timer.delay();
+    printAllPairsRow("BFS-QUEUE", 1, referenceTime, referenceTime);
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        std::vector<size_t> levels, parents;
+
+        timer.start();
+        cg3::bfs(compiledUndirectedGraph, 0, levels, parents, nThreads);
+        timer.stop();
+
+        assert(levels == expectedLevels);
+        for (size_t i = 1; i < levels.size(); i++) {
+            assert(levels[i] == CompiledIntGraph::NOT_FOUND || levels[parents[i]] + 1 == levels[i]);
+        }
+
+        printAllPairsRow("BFS", nThreads, timer.delay(), referenceTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+
+    /* Connected components */
+
+    std::vector<size_t> expectedComponents;
+
+    timer.start();
+    size_t expectedNumComponents = referenceComponents(compiledUndirectedGraph, expectedComponents);
+    timer.stop();
+
+    referenceTime = timer.delay();
+    printAllPairsRow("CC-BFS", 1, referenceTime, referenceTime);
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        std::vector<size_t> components;
+
+        timer.start();
+        size_t numComponents = cg3::connectedComponents(compiledUndirectedGraph, components, nThreads);
+        timer.stop();
+
+        assert(numComponents == expectedNumComponents);
+        assert(samePartition(components, expectedComponents));
+        CG3_SUPPRESS_WARNING(numComponents);
+
+        printAllPairsRow("CC-AFFOREST", nThreads, timer.delay(), referenceTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+    CG3_SUPPRESS_WARNING(expectedNumComponents);
+
+
+    /* Strongly connected components */
+
+    std::vector<size_t> tarjanComponents, kosarajuComponents;
+
+    timer.start();
+    size_t tarjanNumComponents = cg3::stronglyConnectedComponents(compiledDirectedGraph, tarjanComponents, cg3::TARJAN);
+    timer.stop();
+
+    referenceTime = timer.delay();
+    printAllPairsRow("TARJAN", 1, referenceTime, referenceTime);
+
+    timer.start();
+    size_t kosarajuNumComponents = cg3::stronglyConnectedComponents(compiledDirectedGraph, kosarajuComponents, cg3::KOSARAJU);
+    timer.stop();
+
+    assert(tarjanNumComponents == kosarajuNumComponents);
+    assert(samePartition(tarjanComponents, kosarajuComponents));
+    CG3_SUPPRESS_WARNING(tarjanNumComponents);
+    CG3_SUPPRESS_WARNING(kosarajuNumComponents);
+
+    printAllPairsRow("KOSARAJU", 1, timer.delay(), referenceTime);
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Check if two labelings of the nodes define the same partition
+ */
+bool samePartition(const std::vector<size_t>& labels1, const std::vector<size_t>& labels2)
+{
+    if (labels1.size() != labels2.size())
+        return false;
+
+    //Each label of a labeling must correspond to a single label of the other one
+    std::map<size_t, size_t> map1, map2;
+    for (size_t i = 0; i < labels1.size(); i++) {
+        if (map1.insert(std::make_pair(labels1[i], labels2[i])).first->second != labels2[i])
+            return false;
+        if (map2.insert(std::make_pair(labels2[i], labels1[i])).first->second != labels1[i])
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Sequential breadth first search with a queue
+ */
+void referenceBFS(const CompiledIntGraph& graph, size_t source, std::vector<size_t>& levels)
+{
+    levels.assign(graph.numNodes(), CompiledIntGraph::NOT_FOUND);
+    levels[source] = 0;
+
+    std::vector<size_t> queue(1, source);
+    for (size_t i = 0; i < queue.size(); i++) {
+        size_t u = queue[i];
+        for (size_t v : graph.adjacentIterator(u)) {
+            if (levels[v] == CompiledIntGraph::NOT_FOUND) {
+                levels[v] = levels[u] + 1;
+                queue.push_back(v);
+            }
+        }
+    }
+}
+
+/*
+ * Connected components of an undirected graph with sequential breadth first searches
+ */
+size_t referenceComponents(const CompiledIntGraph& graph, std::vector<size_t>& components)
+{
+    components.assign(graph.numNodes(), CompiledIntGraph::NOT_FOUND);
+
+    size_t numComponents = 0;
+    std::vector<size_t> queue;
+    for (size_t root = 0; root < graph.numNodes(); root++) {
+        if (components[root] != CompiledIntGraph::NOT_FOUND)
+            continue;
+
+        components[root] = numComponents;
+        queue.assign(1, root);
+        for (size_t i = 0; i < queue.size(); i++) {
+            for (size_t v : graph.adjacentIterator(queue[i])) {
+                if (components[v] == CompiledIntGraph::NOT_FOUND) {
+                    components[v] = numComponents;
+                    queue.push_back(v);
+                }
+            }
+        }
+        numComponents++;
+    }
+
+    return numComponents;
+}
+
+
+
+void printMSTHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "ALGORITHM" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "THREADS" <<
+         std::setw(INDENTSPACE) << std::left << "TIME" <<
+         std::setw(INDENTSPACE) << std::left << "WEIGHT" <<
+         std::endl << std::endl;
+}
+
+
+void testMinimumSpanningTree()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, MSTINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    std::vector<int> testNumbers;
+    for (int i = 0; i < MSTINPUTSIZE; i++) {
+        testNumbers.push_back(i);
+    }
+
+    std::cout << std::endl << " ------ MINIMUM SPANNING TREE ------ " << std::endl << std::endl;
+
+    printMSTHeader();
+
+    cg3::Timer timer("Step");
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    //Sweep of the number of edges for each node
+    for (int density = MSTMINDENSITY; density <= MSTMAXDENSITY; density *= 4) {
+        std::vector<std::pair<size_t, size_t>> testEdges;
+        std::vector<double> testWeights;
+        for (int i = 0; i < MSTINPUTSIZE * density; i++) {
+            testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+            testWeights.push_back(distWeight(rng));
+        }
+
+        IndexedIntGraph graph(IndexedIntGraph::UNDIRECTED);
+        graph.addNodes(testNumbers);
+        graph.addEdges(testEdges, testWeights);
+        CompiledIntGraph compiledGraph = cg3::compile(graph);
+
+        double expectedWeight = 0;
+        size_t expectedSize = 0;
+
+        for (int a = 0; a < 2; a++) {
+            cg3::MSTAlgorithm algorithm = (a == 0 ? cg3::KRUSKAL : cg3::BORUVKA);
+
+            for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+                timer.start();
+
+                std::vector<cg3::SpanningTreeEdge<size_t>> tree =
+                        cg3::minimumSpanningTree(compiledGraph, algorithm, nThreads);
+
+                timer.stop();
+
+                double weight = cg3::spanningTreeWeight(tree);
+                if (a == 0 && nThreads == 1) {
+                    expectedWeight = weight;
+                    expectedSize = tree.size();
+                }
+                assert(weight == expectedWeight);
+                assert(tree.size() == expectedSize);
+
+                std::cout << std::setw(INDENTSPACE) << std::left << (a == 0 ? "KRUSKAL" : "BORUVKA");
+                std::cout << std::setw(INDENTSPACE) << std::left << compiledGraph.numNodes();
+                std::cout << std::setw(INDENTSPACE) << std::left << compiledGraph.numEdges() / 2;
+                std::cout << std::setw(INDENTSPACE) << std::left << nThreads;
+                std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+                std::cout << std::setw(INDENTSPACE) << std::left << weight;
+                std::cout << std::endl;
+
+                if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+                    nThreads = maxThreads / 2;
+            }
+        }
+
+        CG3_SUPPRESS_WARNING(expectedWeight);
+        CG3_SUPPRESS_WARNING(expectedSize);
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+
+bool sameCompiledGraph(const CompiledIntGraph& graph1, const CompiledIntGraph& graph2)
+{
+    if (graph1.numNodes() != graph2.numNodes() || graph1.numEdges() != graph2.numEdges())
+        return false;
+
+    for (size_t i = 0; i < graph1.numNodes(); i++) {
+        if (graph1.value(i) != graph2.value(i) || graph1.edgeBegin(i) != graph2.edgeBegin(i))
+            return false;
+    }
+    for (size_t e = 0; e < graph1.numEdges(); e++) {
+        if (graph1.target(e) != graph2.target(e) || graph1.weight(e) != graph2.weight(e))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Overwrite a 64 bit number of a file
+ */
+void patchBinaryFile(const std::string& filename, size_t position, uint64_t value)
+{
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(position);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+
+void testGraphSerialization()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, IOINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    std::vector<int> testNumbers;
+    for (int i = 0; i < IOINPUTSIZE; i++) {
+        testNumbers.push_back(i);
+    }
+
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    std::vector<double> testWeights;
+    for (int i = 0; i < IOEDGES; i++) {
+        testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+        testWeights.push_back(distWeight(rng));
+    }
+
+    std::cout << std::endl << " ------ GRAPH SERIALIZATION ------ " << std::endl << std::endl;
+
+    printAllPairsHeader();
+
+    cg3::Timer timer("Step");
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+
+    //Rebuild the graph from scratch
+    timer.start();
+
+    IntGraph graph;
+    for (int i = 0; i < IOINPUTSIZE; i++)
+        graph.addNode(testNumbers[i]);
+    for (int i = 0; i < IOEDGES; i++)
+        graph.addEdge(testNumbers[testEdges[i].first], testNumbers[testEdges[i].second], testWeights[i]);
+    CompiledIntGraph compiledGraph = cg3::compile(graph);
+
+    timer.stop();
+
+    double rebuildTime = timer.delay();
+    printAllPairsRow("REBUILD", 1, rebuildTime, rebuildTime);
+
+
+    //Binary file
+    timer.start();
+    bool saved = cg3::saveBinaryGraph(compiledGraph, IOBINARYFILE);
+    timer.stop();
+    assert(saved);
+    CG3_SUPPRESS_WARNING(saved);
+    printAllPairsRow("BIN-SAVE", 1, timer.delay(), rebuildTime);
+
+    timer.start();
+    CompiledIntGraph loadedGraph;
+    bool loaded = cg3::loadBinaryGraph(IOBINARYFILE, loadedGraph);
+    timer.stop();
+    assert(loaded);
+    assert(sameCompiledGraph(compiledGraph, loadedGraph));
+    printAllPairsRow("BIN-LOAD", 1, timer.delay(), rebuildTime);
+
+    timer.start();
+    cg3::MappedGraph<int> mappedGraph(IOBINARYFILE);
+    timer.stop();
+    assert(mappedGraph.isOpen());
+    printAllPairsRow("MMAP-OPEN", 1, timer.delay(), rebuildTime);
+
+    //Scan of all the edges: the pages of the file are loaded on access
+    timer.start();
+    double mappedWeight = 0;
+    for (size_t i = 0; i < mappedGraph.numNodes(); i++)
+        for (size_t e = mappedGraph.edgeBegin(i); e < mappedGraph.edgeEnd(i); e++)
+            mappedWeight += mappedGraph.weight(e);
+    timer.stop();
+    printAllPairsRow("MMAP-SCAN", 1, timer.delay(), rebuildTime);
+
+    double compiledWeight = 0;
+    for (size_t e = 0; e < compiledGraph.numEdges(); e++)
+        compiledWeight += compiledGraph.weight(e);
+    assert(mappedWeight == compiledWeight);
+    CG3_SUPPRESS_WARNING(compiledWeight);
+
+    mappedGraph.close();
+    std::remove(IOBINARYFILE);
+
+
+    //Edge list text file
+    std::ofstream textFile(IOTEXTFILE);
+    for (int i = 0; i < IOEDGES; i++)
+        textFile << testEdges[i].first << " " << testEdges[i].second << " " << testWeights[i] << "\n";
+    textFile.close();
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        timer.start();
+        IndexedIntGraph textGraph;
+        loaded = cg3::loadEdgeList(IOTEXTFILE, textGraph, cg3::EDGE_LIST, nThreads);
+        timer.stop();
+
+        assert(loaded);
+        assert(textGraph.numEdges() == compiledGraph.numEdges());
+        printAllPairsRow("TEXT-PARSE", nThreads, timer.delay(), rebuildTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+    CG3_SUPPRESS_WARNING(loaded);
+
+    std::remove(IOTEXTFILE);
+
+    std::cout << std::endl;
+}
+
+
+
+
+void printCopyHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "GRAPH" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "COPY" <<
+         std::setw(INDENTSPACE) << std::left << "MOVE" <<
+         std::endl << std::endl;
+}
+
+void printCopyRow(const std::string& name, double copyTime, double moveTime) {
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << COPYINPUTSIZE;
+    std::cout << std::setw(INDENTSPACE) << std::left << COPYEDGES;
+    std::cout << std::setw(INDENTSPACE) << std::left << copyTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << moveTime;
+    std::cout << std::endl;
+}
+
+
+void testGraphCopy()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, COPYINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    std::vector<int> testNumbers;
+    for (int i = 0; i < COPYINPUTSIZE; i++) {
+        testNumbers.push_back(i);
+    }
+
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    std::vector<double> testWeights;
+    for (int i = 0; i < COPYEDGES; i++) {
+        testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+        testWeights.push_back(distWeight(rng));
+    }
+
+    IntGraph graph;
+    for (int n : testNumbers)
+        graph.addNode(n);
+    for (size_t i = 0; i < testEdges.size(); i++)
+        graph.addEdge(testNumbers[testEdges[i].first], testNumbers[testEdges[i].second], testWeights[i]);
+
+    IndexedIntGraph indexedGraph;
+    indexedGraph.addNodes(testNumbers);
+    for (size_t i = 0; i < testEdges.size(); i++)
+        indexedGraph.addEdge(testEdges[i].first, testEdges[i].second, testWeights[i]);
+
+    CompiledIntGraph compiledGraph = cg3::compile(indexedGraph);
+
+    std::cout << std::endl << " ------ GRAPH COPY ------ " << std::endl << std::endl;
+
+    printCopyHeader();
+
+    cg3::Timer timer("Step");
+
+
+    /* Graph with values */
+
+    timer.start();
+    IntGraph graphCopy(graph);
+    timer.stop();
+    double copyTime = timer.delay();
+
+    timer.start();
+    IntGraph movedGraph(std::move(graphCopy));
+    timer.stop();
+
+    assert(movedGraph.numEdges() == graph.numEdges());
+    printCopyRow("VALUES", copyTime, timer.delay());
+
+
+    /* Indexed graph */
+
+    timer.start();
+    IndexedIntGraph indexedCopy(indexedGraph);
+    timer.stop();
+    copyTime = timer.delay();
+
+    timer.start();
+    IndexedIntGraph movedIndexedGraph(std::move(indexedCopy));
+    timer.stop();
+
+    assert(movedIndexedGraph.numEdges() == indexedGraph.numEdges());
+    assert(indexedCopy.empty());
+    printCopyRow("INDEXED", copyTime, timer.delay());
+
+
+    /* Compiled graph */
+
+    timer.start();
+    CompiledIntGraph compiledCopy(compiledGraph);
+    timer.stop();
+    copyTime = timer.delay();
+
+    timer.start();
+    CompiledIntGraph movedCompiledGraph(std::move(compiledCopy));
+    timer.stop();
+
+    assert(sameCompiledGraph(movedCompiledGraph, compiledGraph));
+    printCopyRow("COMPILED", copyTime, timer.delay());
+
+    std::cout << std::endl;
+}
+
+
+
+
+void printWeightsHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "WEIGHTS" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGE-MB" <<
+         std::setw(INDENTSPACE) << std::left << "COMPILE" <<
+         std::setw(INDENTSPACE) << std::left << "DIJKSTRA" <<
+         std::setw(INDENTSPACE) << std::left << "BFS" <<
+         std::endl << std::endl;
+}
+
+
+void testEdgeWeights()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, WEIGHTSINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    std::vector<int> testNumbers;
+    for (int i = 0; i < WEIGHTSINPUTSIZE; i++) {
+        testNumbers.push_back(i);
+    }
+
+    //Integer weights: they are represented exactly by every weight type
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    std::vector<double> testWeights;
+    for (int i = 0; i < WEIGHTSEDGES; i++) {
+        testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+        testWeights.push_back(distWeight(rng));
+    }
+
+    IndexedIntGraph graph;
+    graph.addNodes(testNumbers);
+    graph.addEdges(testEdges, testWeights);
+
+    std::vector<size_t> sources;
+    for (int i = 0; i < WEIGHTSSOURCES; i++) {
+        sources.push_back(distNode(rng));
+    }
+
+    std::cout << std::endl << " ------ EDGE WEIGHT TYPES ------ " << std::endl << std::endl;
+
+    printWeightsHeader();
+
+    std::vector<double> expectedDistances;
+    testWeightType<double>("DOUBLE", graph, sources, expectedDistances);
+    testWeightType<float>("FLOAT", graph, sources, expectedDistances);
+    testWeightType<int>("INT", graph, sources, expectedDistances);
+    testWeightType<cg3::Unweighted>("UNWEIGHTED", graph, sources, expectedDistances);
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Compile the graph with weights of type W, then time the shortest paths
+ * and the breadth first searches from the sources. The distances must be
+ * equal to the expected ones (set by the first call).
+ */
+template <class W>
+void testWeightType(
+        const std::string& name,
+        const IndexedIntGraph& graph,
+        const std::vector<size_t>& sources,
+        std::vector<double>& expectedDistances)
+{
+    cg3::Timer timer("Step");
+
+    timer.start();
+    cg3::CompiledGraph<int, W> compiledGraph = cg3::compile<W>(graph);
+    timer.stop();
+    double compileTime = timer.delay();
+
+    //Outgoing and incoming edges: target/source and weight
+    double edgeMemory = 2.0 * compiledGraph.numEdges() *
+            (sizeof(size_t) + cg3::EdgeWeights<W>::WEIGHT_SIZE) / (1024 * 1024);
+
+    std::vector<double> distances, allDistances;
+    std::vector<size_t> predecessors;
+
+    timer.start();
+    for (size_t source : sources) {
+        cg3::dijkstra(compiledGraph, source, distances, predecessors);
+        allDistances.insert(allDistances.end(), distances.begin(), distances.end());
+    }
+    timer.stop();
+    double dijkstraTime = timer.delay();
+
+    if (expectedDistances.empty())
+        expectedDistances = allDistances;
+    if (cg3::EdgeWeights<W>::WEIGHT_SIZE > 0)
+        assert(allDistances == expectedDistances);
+
+    std::vector<size_t> levels, parents;
+
+    timer.start();
+    for (size_t source : sources) {
+        cg3::bfs(compiledGraph, source, levels, parents, 1);
+    }
+    timer.stop();
+
+    //Without weights, the distances are the levels of the search
+    if (cg3::EdgeWeights<W>::WEIGHT_SIZE == 0) {
+        for (size_t i = 0; i < levels.size(); i++) {
+            CG3_SUPPRESS_WARNING(i);
+            assert(levels[i] == CompiledIntGraph::NOT_FOUND ? distances[i] == IntGraph::MAX_WEIGHT : distances[i] == levels[i]);
+        }
+    }
+
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << compiledGraph.numEdges();
+    std::cout << std::setw(INDENTSPACE) << std::left << edgeMemory;
+    std::cout << std::setw(INDENTSPACE) << std::left << compileTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << dijkstraTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+    std::cout << std::endl;
+}
+
+
+
+
+void printDynamicHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "UPDATE" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "UPDATES" <<
+         std::setw(INDENTSPACE) << std::left << "AVG-UPDATE" <<
+         std::setw(INDENTSPACE) << std::left << "DIJKSTRA" <<
+         std::setw(INDENTSPACE) << std::left << "SPEEDUP" <<
+         std::setw(INDENTSPACE) << std::left << "AVG-NODES" <<
+         std::endl << std::endl;
+}
+
+
+void testDynamicShortestPaths()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, DYNAMICINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(1, MAXWEIGHT);
+
+    std::vector<int> testNumbers;
+    for (int i = 0; i < DYNAMICINPUTSIZE; i++) {
+        testNumbers.push_back(i);
+    }
+
+    //Integer weights: the distances are computed exactly
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    std::vector<double> testWeights;
+    for (int i = 0; i < DYNAMICEDGES; i++) {
+        testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+        testWeights.push_back(distWeight(rng));
+    }
+
+    IndexedIntGraph graph;
+    graph.addNodes(testNumbers);
+    graph.addEdges(testEdges, testWeights);
+
+    const size_t source = distNode(rng);
+    cg3::DynamicShortestPaths<int> shortestPaths(graph, source);
+
+    std::cout << std::endl << " ------ DYNAMIC SHORTEST PATHS ------ " << std::endl << std::endl;
+
+    printDynamicHeader();
+
+    cg3::Timer timer("Step");
+
+    //Full recompute: Dijkstra on the compiled graph (compilation excluded)
+    CompiledIntGraph compiledGraph = cg3::compile(graph);
+    std::vector<double> distances;
+    std::vector<size_t> predecessors;
+
+    timer.start();
+    for (int i = 0; i < ITERATION; i++) {
+        cg3::dijkstra(compiledGraph, source, distances, predecessors);
+    }
+    timer.stop();
+    double dijkstraTime = timer.delay() / ITERATION;
+
+    const std::string names[] = {"DECREASE", "INCREASE", "ADD", "DELETE"};
+
+    for (int type = 0; type < 4; type++) {
+        double updateTime = 0;
+        size_t affectedNodes = 0;
+
+        for (int i = 0; i < DYNAMICUPDATES; i++) {
+            //Decreased and added edges are random; increased and deleted
+            //edges are in the shortest path tree (the other ones do not
+            //change the distances)
+            size_t node = distNode(rng);
+            size_t target = distNode(rng);
+            double weight = distWeight(rng);
+
+            if (type == 0) {
+                while (graph.outDegree(node) == 0)
+                    node = distNode(rng);
+                target = (*graph.adjacentEdges(node).begin()).target;
+                weight = std::floor(graph.getWeight(node, target) / 2);
+            }
+            else if (type != 2) {
+                while (shortestPaths.predecessor(target) == cg3::DynamicShortestPaths<int>::NOT_FOUND)
+                    target = distNode(rng);
+                node = shortestPaths.predecessor(target);
+                weight += graph.getWeight(node, target);
+            }
+
+            timer.start();
+            if (type == 0 || type == 1)
+                shortestPaths.setWeight(node, target, weight);
+            else if (type == 2)
+                shortestPaths.addEdge(node, target, weight);
+            else
+                shortestPaths.deleteEdge(node, target);
+            timer.stop();
+
+            updateTime += timer.delay();
+            affectedNodes += shortestPaths.numAffectedNodes();
+
+            if ((i + 1) % DYNAMICCHECKPERIOD == 0) {
+                assert(sameDistances(graph, shortestPaths));
+            }
+        }
+
+        double averageTime = updateTime / DYNAMICUPDATES;
+
+        std::cout << std::setw(INDENTSPACE) << std::left << names[type];
+        std::cout << std::setw(INDENTSPACE) << std::left << graph.numNodes();
+        std::cout << std::setw(INDENTSPACE) << std::left << graph.numEdges();
+        std::cout << std::setw(INDENTSPACE) << std::left << DYNAMICUPDATES;
+        std::cout << std::setw(INDENTSPACE) << std::left << averageTime;
+        std::cout << std::setw(INDENTSPACE) << std::left << dijkstraTime;
+        std::cout << std::setw(INDENTSPACE) << std::left << dijkstraTime / averageTime;
+        std::cout << std::setw(INDENTSPACE) << std::left << static_cast<double>(affectedNodes) / DYNAMICUPDATES;
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Check the distances maintained by the dynamic shortest paths against a
+ * Dijkstra visit of the compiled graph (the nodes are not deleted, so the
+ * indices of the compiled graph are the ids)
+ */
+bool sameDistances(const IndexedIntGraph& graph, const cg3::DynamicShortestPaths<int>& shortestPaths)
+{
+    CompiledIntGraph compiledGraph = cg3::compile(graph);
+
+    std::vector<double> distances;
+    std::vector<size_t> predecessors;
+    cg3::dijkstra(compiledGraph, shortestPaths.source(), distances, predecessors);
+
+    for (size_t i = 0; i < distances.size(); i++) {
+        if (distances[i] != shortestPaths.distance(i))
+            return false;
+
+        //The predecessors form a shortest path tree
+        size_t predecessor = shortestPaths.predecessor(i);
+        if (predecessor != CompiledIntGraph::NOT_FOUND &&
+                shortestPaths.distance(predecessor) + graph.getWeight(predecessor, i) != distances[i])
+            return false;
+    }
+
+    return true;
+}
+
+
+
+
+void testEdgeIteration()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distNode(0, EDGESCANINPUTSIZE-1);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    std::vector<int> testNumbers;
+    for (int i = 0; i < EDGESCANINPUTSIZE; i++) {
+        testNumbers.push_back(i);
+    }
+
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    std::vector<double> testWeights;
+    for (int i = 0; i < EDGESCANEDGES; i++) {
+        testEdges.push_back(std::make_pair(distNode(rng), distNode(rng)));
+        testWeights.push_back(distWeight(rng));
+    }
+
+    IntGraph graph;
+    for (int n : testNumbers)
+        graph.addNode(n);
+    for (size_t i = 0; i < testEdges.size(); i++)
+        graph.addEdge(testNumbers[testEdges[i].first], testNumbers[testEdges[i].second], testWeights[i]);
+
+    IndexedIntGraph indexedGraph;
+    indexedGraph.addNodes(testNumbers);
+    indexedGraph.addEdges(testEdges, testWeights);
+
+    CompiledIntGraph compiledGraph = cg3::compile(indexedGraph);
+
+    std::cout << std::endl << " ------ EDGE ITERATION ------ " << std::endl << std::endl;
+
+    printAllPairsHeader();
+
+    cg3::Timer timer("Step");
+
+    //Each scan sums the weights of the outgoing edges of each node (the
+    //values of the nodes are equal to the ids and to the indices)
+    std::vector<double> expectedSums(EDGESCANINPUTSIZE, 0);
+    std::vector<double> sums(EDGESCANINPUTSIZE, 0);
+
+
+    /* Graph with values: pairs of values, then the weight */
+
+    timer.start();
+    for (std::pair<const int, const int> pair : graph.edgeIterator()) {
+        expectedSums[pair.first] += graph.getWeight(pair.first, pair.second);
+    }
+    timer.stop();
+    double pairTime = timer.delay();
+
+    printAllPairsRow("PAIRS", 1, pairTime, pairTime);
+
+
+    /* Graph with values: adjacent iterators */
+
+    timer.start();
+    for (IntGraph::NodeIterator it = graph.nodeBegin(); it != graph.nodeEnd(); it++) {
+        for (IntGraph::AdjacentIterator adjIt = graph.adjacentBegin(it); adjIt != graph.adjacentEnd(it); adjIt++) {
+            sums[*it] += graph.getWeight(it, adjIt);
+        }
+    }
+    timer.stop();
+
+    assert(sums == expectedSums);
+    printAllPairsRow("ADJACENT", 1, timer.delay(), pairTime);
+
+
+    /* Indexed graph: edge handles */
+
+    std::fill(sums.begin(), sums.end(), 0);
+
+    timer.start();
+    for (IndexedIntGraph::EdgeHandle edge : indexedGraph.edges()) {
+        sums[edge.source] += edge.weight;
+    }
+    timer.stop();
+
+    assert(sums == expectedSums);
+    printAllPairsRow("HANDLES", 1, timer.delay(), pairTime);
+
+
+    /* Edge visitors */
+
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        std::fill(sums.begin(), sums.end(), 0);
+
+        timer.start();
+        indexedGraph.forEachEdge([&] (size_t source, size_t, double weight) {
+            sums[source] += weight;
+        }, nThreads);
+        timer.stop();
+
+        assert(sums == expectedSums);
+        printAllPairsRow("FOREACH", nThreads, timer.delay(), pairTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        std::fill(sums.begin(), sums.end(), 0);
+
+        timer.start();
+        compiledGraph.forEachEdge([&] (size_t source, size_t, double weight) {
+            sums[source] += weight;
+        }, nThreads);
+        timer.stop();
+
+        assert(sums == expectedSums);
+        printAllPairsRow("FOREACH-C", nThreads, timer.delay(), pairTime);
+
+        if (nThreads < maxThreads && nThreads * 2 > maxThreads)
+            nThreads = maxThreads / 2;
+    }
+
+    std::cout << std::endl;
+}
+
+
+
+
+
+void printReorderingHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "ORDERING" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "ORDER-TIME" <<
+         std::setw(INDENTSPACE) << std::left << "DIJKSTRA" <<
+         std::setw(INDENTSPACE) << std::left << "SPEEDUP" <<
+         std::setw(INDENTSPACE) << std::left << "AVG-GAP" <<
+         std::endl << std::endl;
+}
+
+
+void testGraphReordering()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(0, MAXWEIGHT-1);
+
+    //Grid graph, whose nodes are added in random order: the locality of
+    //the grid is hidden by the ids
+    const size_t n = REORDERGRIDSIZE * REORDERGRIDSIZE;
+
+    std::vector<size_t> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    std::vector<int> testNumbers;
+    for (size_t i = 0; i < n; i++) {
+        testNumbers.push_back(i);
+    }
+
+    std::vector<std::pair<size_t, size_t>> testEdges;
+    std::vector<double> testWeights;
+    for (size_t i = 0; i < REORDERGRIDSIZE; i++) {
+        for (size_t j = 0; j < REORDERGRIDSIZE; j++) {
+            size_t node = ids[i * REORDERGRIDSIZE + j];
+            if (i + 1 < REORDERGRIDSIZE) {
+                testEdges.push_back(std::make_pair(node, ids[(i + 1) * REORDERGRIDSIZE + j]));
+                testEdges.push_back(std::make_pair(testEdges.back().second, node));
+            }
+            if (j + 1 < REORDERGRIDSIZE) {
+                testEdges.push_back(std::make_pair(node, ids[i * REORDERGRIDSIZE + j + 1]));
+                testEdges.push_back(std::make_pair(testEdges.back().second, node));
+            }
+        }
+    }
+    for (size_t i = 0; i < testEdges.size(); i++) {
+        testWeights.push_back(distWeight(rng));
+    }
+
+    IndexedIntGraph indexedGraph;
+    indexedGraph.addNodes(testNumbers);
+    indexedGraph.addEdges(testEdges, testWeights);
+
+    CompiledIntGraph graph = cg3::compile(indexedGraph);
+
+    std::vector<size_t> sources;
+    for (int i = 0; i < REORDERSOURCES; i++) {
+        sources.push_back(ids[rng() % n]);
+    }
+
+    std::cout << std::endl << " ------ GRAPH REORDERING ------ " << std::endl << std::endl;
+
+    printReorderingHeader();
+
+    cg3::Timer timer("Step");
+
+    std::vector<double> distances;
+    std::vector<size_t> predecessors;
+    std::vector<std::vector<double>> expectedDistances;
+
+    timer.start();
+    for (size_t source : sources) {
+        cg3::dijkstra(graph, source, distances, predecessors);
+        expectedDistances.push_back(distances);
+    }
+    timer.stop();
+    double originalTime = timer.delay();
+
+    std::cout << std::setw(INDENTSPACE) << std::left << "ORIGINAL";
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numNodes();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numEdges();
+    std::cout << std::setw(INDENTSPACE) << std::left << 0;
+    std::cout << std::setw(INDENTSPACE) << std::left << originalTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << 1;
+    std::cout << std::setw(INDENTSPACE) << std::left << averageEdgeGap(graph);
+    std::cout << std::endl;
+
+    const cg3::NodeOrdering orderings[] = {cg3::BFS_ORDER, cg3::REVERSE_CUTHILL_MCKEE, cg3::DEGREE_ORDER, cg3::PARTITION_ORDER};
+    const std::string names[] = {"BFS", "RCM", "DEGREE", "PARTITION"};
+
+    for (int o = 0; o < 4; o++) {
+        timer.start();
+        std::vector<size_t> order = cg3::nodeOrdering(graph, orderings[o]);
+        CompiledIntGraph reorderedGraph = cg3::reorder(graph, order);
+        timer.stop();
+        double orderTime = timer.delay();
+
+        std::vector<size_t> ranks(n, CompiledIntGraph::NOT_FOUND);
+        for (size_t i = 0; i < n; i++)
+            ranks[order[i]] = i;
+        assert(std::find(ranks.begin(), ranks.end(), CompiledIntGraph::NOT_FOUND) == ranks.end());
+
+        std::vector<std::vector<double>> reorderedDistances;
+
+        timer.start();
+        for (size_t source : sources) {
+            cg3::dijkstra(reorderedGraph, ranks[source], distances, predecessors);
+            reorderedDistances.push_back(distances);
+        }
+        timer.stop();
+
+        for (size_t s = 0; s < sources.size(); s++) {
+            for (size_t i = 0; i < n; i++) {
+                CG3_SUPPRESS_WARNING(i);
+                assert(reorderedDistances[s][ranks[i]] == expectedDistances[s][i]);
+            }
+        }
+
+        std::cout << std::setw(INDENTSPACE) << std::left << names[o];
+        std::cout << std::setw(INDENTSPACE) << std::left << reorderedGraph.numNodes();
+        std::cout << std::setw(INDENTSPACE) << std::left << reorderedGraph.numEdges();
+        std::cout << std::setw(INDENTSPACE) << std::left << orderTime;
+        std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+        std::cout << std::setw(INDENTSPACE) << std::left << originalTime / timer.delay();
+        std::cout << std::setw(INDENTSPACE) << std::left << averageEdgeGap(reorderedGraph);
+        std::cout << std::endl;
+    }
+
+    std::vector<size_t> parts = cg3::partitionGraph(graph, REORDERPARTS);
+    std::cout << std::endl << "Partition in " << REORDERPARTS << " parts: " <<
+                 cg3::edgeCut(graph, parts) << " cut edges" << std::endl;
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Average distance between the indices of the nodes of the edges
+ */
+double averageEdgeGap(const CompiledIntGraph& graph)
+{
+    double gap = 0;
+    for (size_t i = 0; i < graph.numNodes(); i++) {
+        for (size_t e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+            size_t target = graph.target(e);
+            gap += target > i ? target - i : i - target;
+        }
+    }
+    return graph.numEdges() > 0 ? gap / graph.numEdges() : 0;
+}
+
+
+
+
+
+void printMaxFlowHeader() {
+    std::cout <<
+         std::setw(INDENTSPACE) << std::left << "GRAPH" <<
+         std::setw(INDENTSPACE) << std::left << "NODES" <<
+         std::setw(INDENTSPACE) << std::left << "EDGES" <<
+         std::setw(INDENTSPACE) << std::left << "PUSH-RELAB" <<
+         std::setw(INDENTSPACE) << std::left << "BK" <<
+         std::setw(INDENTSPACE) << std::left << "FLOW" <<
+         std::setw(INDENTSPACE) << std::left << "SOURCE-SIDE" <<
+         std::endl << std::endl;
+}
+
+
+void testMaxFlow()
+{
+    //Setup random generator
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distWeight(1, MAXWEIGHT);
+    std::uniform_int_distribution<std::mt19937::result_type>
+            distTerminal(0, 2*MAXWEIGHT);
+
+    std::cout << std::endl << " ------ MAXIMUM FLOW ------ " << std::endl << std::endl;
+
+    printMaxFlowHeader();
+
+    //Small network checked by hand: the maximum flow is 19, the minimum
+    //cut separates {0, 2} from the other nodes (edges 0->1 and 2->4)
+    CompiledIntGraph smallGraph(
+                {0, 1, 2, 3, 4, 5},
+                {0, 2, 5, 6, 7, 9, 9},
+                {1, 2, 2, 3, 4, 4, 5, 3, 5},
+                {10, 10, 2, 4, 8, 9, 10, 6, 10});
+    double smallFlow = testMaxFlowGraph("SMALL", smallGraph, 0, 5);
+    assert(smallFlow == 19);
+    CG3_SUPPRESS_WARNING(smallFlow);
+
+    //Grid graphs as in image segmentation: each node is connected to its
+    //4 neighbors, to the source and to the sink
+    for (size_t size = MAXFLOWMINGRID; size <= MAXFLOWMAXGRID; size *= 2) {
+        const size_t n = size * size;
+        const size_t source = n;
+        const size_t sink = n + 1;
+
+        std::vector<int> testNumbers;
+        for (size_t i = 0; i < n + 2; i++) {
+            testNumbers.push_back(i);
+        }
+
+        std::vector<std::pair<size_t, size_t>> testEdges;
+        std::vector<double> testWeights;
+        for (size_t i = 0; i < size; i++) {
+            for (size_t j = 0; j < size; j++) {
+                size_t node = i * size + j;
+                if (i + 1 < size) {
+                    testEdges.push_back(std::make_pair(node, node + size));
+                    testEdges.push_back(std::make_pair(node + size, node));
+                }
+                if (j + 1 < size) {
+                    testEdges.push_back(std::make_pair(node, node + 1));
+                    testEdges.push_back(std::make_pair(node + 1, node));
+                }
+            }
+        }
+        for (size_t i = 0; i < testEdges.size(); i++) {
+            testWeights.push_back(distWeight(rng));
+        }
+        for (size_t node = 0; node < n; node++) {
+            double dataTerm = distTerminal(rng);
+            testEdges.push_back(std::make_pair(source, node));
+            testWeights.push_back(dataTerm);
+            testEdges.push_back(std::make_pair(node, sink));
+            testWeights.push_back(2*MAXWEIGHT - dataTerm);
+        }
+
+        IndexedIntGraph indexedGraph;
+        indexedGraph.addNodes(testNumbers);
+        indexedGraph.addEdges(testEdges, testWeights);
+
+        testMaxFlowGraph("GRID-" + std::to_string(size), cg3::compile(indexedGraph), source, sink);
+    }
+
+#ifdef CG3_DCEL_DEFINED
+    //Graphs of the vertices of meshes: the cut separates the two ends of
+    //the mesh along the x axis, cutting short edges
+    const std::string meshNames[] = {"BUNNY", "AIRPLANE", "BIMBA"};
+    const std::string meshFiles[] = {"bunny.obj", "airplane.obj", "bimba.obj"};
+
+    for (int m = 0; m < 3; m++) {
+        size_t source, sink;
+        CompiledIntGraph meshGraph = meshFlowGraph(meshFiles[m], source, sink);
+        testMaxFlowGraph(meshNames[m], meshGraph, source, sink);
+    }
+#endif
+
+    std::cout << std::endl;
+}
+
+
+/*
+ * Compute the maximum flow with both the algorithms: the flows must be
+ * equal to the capacity of the cuts. It returns the value of the flow.
+ */
+double testMaxFlowGraph(const std::string& name, const CompiledIntGraph& graph, size_t source, size_t sink)
+{
+    cg3::Timer timer("Step");
+
+    std::vector<double> flows;
+    std::vector<bool> sourceSide;
+
+    timer.start();
+    double pushRelabelFlow = cg3::maxFlow(graph, source, sink, flows, sourceSide, cg3::PUSH_RELABEL);
+    timer.stop();
+    double pushRelabelTime = timer.delay();
+
+    assert(std::fabs(cutCapacity(graph, sourceSide) - pushRelabelFlow) <= MAXFLOWEPSILON * pushRelabelFlow);
+
+    timer.start();
+    double bkFlow = cg3::maxFlow(graph, source, sink, flows, sourceSide, cg3::BOYKOV_KOLMOGOROV);
+    timer.stop();
+
+    assert(std::fabs(cutCapacity(graph, sourceSide) - bkFlow) <= MAXFLOWEPSILON * bkFlow);
+    assert(std::fabs(pushRelabelFlow - bkFlow) <= MAXFLOWEPSILON * bkFlow);
+    CG3_SUPPRESS_WARNING(pushRelabelFlow);
+
+    std::cout << std::setw(INDENTSPACE) << std::left << name;
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numNodes();
+    std::cout << std::setw(INDENTSPACE) << std::left << graph.numEdges();
+    std::cout << std::setw(INDENTSPACE) << std::left << pushRelabelTime;
+    std::cout << std::setw(INDENTSPACE) << std::left << timer.delay();
+    std::cout << std::setw(INDENTSPACE) << std::left << bkFlow;
+    std::cout << std::setw(INDENTSPACE) << std::left << std::count(sourceSide.begin(), sourceSide.end(), true);
+    std::cout << std::endl;
+
+    return bkFlow;
+}
+
+
+/*
+ * Capacity of the edges from the side of the source to the side of the sink
+ */
+double cutCapacity(const CompiledIntGraph& graph, const std::vector<bool>& sourceSide)
+{
+    double capacity = 0;
+    for (size_t i = 0; i < graph.numNodes(); i++) {
+        for (size_t e = graph.edgeBegin(i); e < graph.edgeEnd(i); e++) {
+            if (sourceSide[i] && !sourceSide[graph.target(e)])
+                capacity += graph.weight(e);
+        }
+    }
+    return capacity;
+}
+
+
+#ifdef CG3_DCEL_DEFINED
+/*
+ * Graph of the vertices and the edges of a mesh, with the length of the
+ * edges as capacity. The source is connected to the vertices with the
+ * smallest x coordinates, the sink to the ones with the largest.
+ */
+CompiledIntGraph meshFlowGraph(const std::string& fileName, size_t& source, size_t& sink)
+{
+    cg3::Dcel mesh(dataPath(fileName));
+
+    const size_t n = mesh.numberVertices();
+    source = n;
+    sink = n + 1;
+
+    std::vector<int> values;
+    for (size_t i = 0; i < n + 2; i++) {
+        values.push_back(i);
+    }
+
+    std::vector<std::pair<size_t, size_t>> edges;
+    std::vector<double> capacities;
+    std::vector<double> coordinates(n);
+
+    for (const cg3::Dcel::Face* face : mesh.faceIterator()) {
+        const cg3::Dcel::HalfEdge* halfEdge = face->outerHalfEdge();
+        do {
+            const cg3::Dcel::Vertex* from = halfEdge->fromVertex();
+            const cg3::Dcel::Vertex* to = halfEdge->next()->fromVertex();
+
+            double length = from->coordinate().dist(to->coordinate());
+            edges.push_back(std::make_pair(from->id(), to->id()));
+            edges.push_back(std::make_pair(to->id(), from->id()));
+            capacities.push_back(length);
+            capacities.push_back(length);
+            coordinates[from->id()] = from->coordinate().x();
+
+            halfEdge = halfEdge->next();
+        } while (halfEdge != face->outerHalfEdge());
+    }
+
+    std::vector<size_t> sorted(n);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::sort(sorted.begin(), sorted.end(), [&] (size_t a, size_t b) {
+        return coordinates[a] < coordinates[b];
+    });
+
+    const size_t numTerminals = n * MAXFLOWTERMINALFRACTION;
+    for (size_t i = 0; i < numTerminals; i++) {
+        edges.push_back(std::make_pair(source, sorted[i]));
+        edges.push_back(std::make_pair(sorted[n - 1 - i], sink));
+        capacities.push_back(MAXFLOWTERMINALCAPACITY);
+        capacities.push_back(MAXFLOWTERMINALCAPACITY);
+    }
+
+    IndexedIntGraph graph;
+    graph.addNodes(values);
+    graph.addEdges(edges, capacities);
+
+    return cg3::compile(graph);
+}
+#endif
+
 }
@@ -12,6 +12,20 @@ namespace GraphTests {
 
     void testCorrectness();
     void testDijkstra();
+    void testDijkstraQueues();
+    void testAllPairsShortestPaths();
+    void testShortestPath();
+    void testIndexedGraph();
+    void testIndexedGraphCompaction();
+    void testTraversal();
+    void testMinimumSpanningTree();
+    void testGraphSerialization();
+    void testGraphCopy();
+    void testEdgeWeights();
+    void testDynamicShortestPaths();
+    void testEdgeIteration();
+    void testGraphReordering();
+    void testMaxFlow();
 
 }
 
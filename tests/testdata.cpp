@@ -0,0 +1,25 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#include "testdata.h"
+
+#include <algorithm>
+
+#include <cg3/cg3lib.h>
+
+/*
+ * Path of a file in the data folder
+ */
+std::string dataPath(const std::string& fileName) {
+    #ifdef _WIN32
+    std::string p0(CG3_STRINGIFY(CG3_SAMPLES_HOME));
+    p0.erase(p0.begin());
+    p0.erase(p0.begin() + p0.size()-1);
+    std::string fp = p0 + "/data/" + fileName;
+    std::replace(fp.begin(), fp.end(), '/', '\\');
+    return fp;
+    #else
+    return std::string(CG3_STRINGIFY(CG3_SAMPLES_HOME) "/data/") + fileName;
+    #endif
+}
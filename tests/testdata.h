@@ -0,0 +1,12 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+#ifndef TESTDATA_H
+#define TESTDATA_H
+
+#include <string>
+
+std::string dataPath(const std::string& fileName);
+
+#endif // TESTDATA_H